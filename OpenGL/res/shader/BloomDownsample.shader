@@ -0,0 +1,67 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Source;
+uniform vec2 u_TexelSize;		//Of the source
+//Threshold and soft knee, only for the first level, a threshold of 0 copies everything
+uniform vec2 u_Threshold;
+uniform int u_Prefilter;
+
+float Luminance(vec3 c)
+{
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+vec3 Prefilter(vec3 c)
+{
+    //Quadratic curve between threshold - knee and threshold + knee, linear above
+    float brightness = max(c.r, max(c.g, c.b));
+    float soft = clamp(brightness - u_Threshold.x + u_Threshold.y, 0.0, 2.0 * u_Threshold.y);
+    soft = soft * soft / (4.0 * u_Threshold.y + 0.00001);
+    float contribution = max(soft, brightness - u_Threshold.x) / max(brightness, 0.00001);
+    return c * contribution;
+}
+
+void main()
+{
+    //Four bilinear taps at the corners of the destination texel average a 4x4 block of the source
+    vec3 a = texture(u_Source, v_TexCoord + u_TexelSize * vec2(-1.0, -1.0)).rgb;
+    vec3 b = texture(u_Source, v_TexCoord + u_TexelSize * vec2( 1.0, -1.0)).rgb;
+    vec3 c = texture(u_Source, v_TexCoord + u_TexelSize * vec2(-1.0,  1.0)).rgb;
+    vec3 d = texture(u_Source, v_TexCoord + u_TexelSize * vec2( 1.0,  1.0)).rgb;
+
+    if (u_Prefilter != 0)
+    {
+        //Weighting by 1 / (1 + luminance) keeps single very bright pixels from flickering as the image moves
+        a = Prefilter(a);
+        b = Prefilter(b);
+        c = Prefilter(c);
+        d = Prefilter(d);
+        float wa = 1.0 / (1.0 + Luminance(a));
+        float wb = 1.0 / (1.0 + Luminance(b));
+        float wc = 1.0 / (1.0 + Luminance(c));
+        float wd = 1.0 / (1.0 + Luminance(d));
+        color = vec4((a * wa + b * wb + c * wc + d * wd) / (wa + wb + wc + wd), 1.0);
+    }
+    else
+    {
+        color = vec4((a + b + c + d) * 0.25, 1.0);
+    }
+};
@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+//The next smaller level of the chain and the downsampled level of this size it is added to
+uniform sampler2D u_Source;
+uniform sampler2D u_Base;
+uniform vec2 u_TexelSize;		//Of the source
+uniform float u_Radius;
+
+void main()
+{
+    //3x3 tent filter, 1 2 1 / 2 4 2 / 1 2 1
+    vec2 d = u_TexelSize * u_Radius;
+    vec3 sum = texture(u_Source, v_TexCoord).rgb * 4.0;
+    sum += (texture(u_Source, v_TexCoord + vec2(-d.x, 0.0)).rgb + texture(u_Source, v_TexCoord + vec2(d.x, 0.0)).rgb +
+            texture(u_Source, v_TexCoord + vec2(0.0, -d.y)).rgb + texture(u_Source, v_TexCoord + vec2(0.0, d.y)).rgb) * 2.0;
+    sum += texture(u_Source, v_TexCoord - d).rgb + texture(u_Source, v_TexCoord + d).rgb +
+           texture(u_Source, v_TexCoord + vec2(-d.x, d.y)).rgb + texture(u_Source, v_TexCoord + vec2(d.x, -d.y)).rgb;
+
+    color = vec4(texture(u_Base, v_TexCoord).rgb + sum / 16.0, 1.0);
+};
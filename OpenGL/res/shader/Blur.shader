@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Source;
+//One texel along the blurred axis
+uniform vec2 u_Direction;
+//x = offset in texels, y = weight. Tap 0 is the center, the others are sampled on both sides. Except for the center the
+//offsets lie between two texels, so the bilinear filter returns both of them weighted by one fetch.
+uniform vec4 u_Taps[17];
+uniform int u_TapCount;
+
+void main()
+{
+    vec4 sum = texture(u_Source, v_TexCoord) * u_Taps[0].y;
+    for (int i = 1; i < u_TapCount; i++)
+    {
+        vec2 offset = u_Direction * u_Taps[i].x;
+        sum += (texture(u_Source, v_TexCoord - offset) + texture(u_Source, v_TexCoord + offset)) * u_Taps[i].y;
+    }
+    color = sum;
+};
@@ -0,0 +1,34 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Scene;
+uniform sampler2D u_Glow;
+uniform float u_Intensity;
+//Shown in the lower left corner if enabled
+uniform sampler2D u_Depth;
+uniform int u_ShowDepth;
+
+void main()
+{
+    vec3 result = texture(u_Scene, v_TexCoord).rgb + texture(u_Glow, v_TexCoord).rgb * u_Intensity;
+    if (u_ShowDepth != 0 && v_TexCoord.x < 0.3 && v_TexCoord.y < 0.3)
+        result = texture(u_Depth, v_TexCoord / 0.3).rgb;
+    color = vec4(result, 1.0);
+};
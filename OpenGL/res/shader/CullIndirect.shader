@@ -0,0 +1,59 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 64) in;
+
+struct Object {
+	mat4 Model;
+	vec4 BoundingSphere;
+	uint Mesh;
+	uint Padding0, Padding1, Padding2;
+};
+
+struct Mesh {
+	uint IndexCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint Padding;
+};
+
+struct DrawCommand {
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Objects { Object objects[]; };
+layout(std430, binding = 1) readonly buffer Meshes { Mesh meshes[]; };
+layout(std430, binding = 2) writeonly buffer Commands { DrawCommand commands[]; };
+layout(std430, binding = 3) buffer DrawCount { uint drawCount; };
+
+uniform vec4 u_Planes[6];
+uniform uint u_ObjectCount;
+//Append visible commands and count them (for glMultiDrawElementsIndirectCount) instead of one slot per object
+uniform bool u_Compact;
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= u_ObjectCount)
+		return;
+
+	vec4 sphere = objects[index].BoundingSphere;
+	bool visible = true;
+	for (int i = 0; i < 6; ++i)
+		visible = visible && dot(u_Planes[i].xyz, sphere.xyz) + u_Planes[i].w >= -sphere.w;
+
+	Mesh mesh = meshes[objects[index].Mesh];
+	//BaseInstance selects the object's model matrix from the instanced vertex attribute
+	DrawCommand command = DrawCommand(mesh.IndexCount, visible ? 1u : 0u, mesh.FirstIndex, mesh.BaseVertex, index);
+
+	if (u_Compact) {
+		if (visible)
+			commands[atomicAdd(drawCount, 1u)] = command;
+	}
+	else
+		commands[index] = command;
+}
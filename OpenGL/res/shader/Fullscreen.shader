@@ -0,0 +1,36 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    //One triangle covering the viewport, built from the vertex index: (-1, -1), (3, -1), (-1, 3)
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Source;
+//With u_Far > 0 the source is a depth buffer that is shown as linear distance
+uniform float u_Near;
+uniform float u_Far;
+
+void main()
+{
+    color = texture(u_Source, v_TexCoord);
+    if (u_Far > 0.0)
+    {
+        float z = color.r * 2.0 - 1.0;
+        float distance = 2.0 * u_Near * u_Far / (u_Far + u_Near - z * (u_Far - u_Near));
+        color = vec4(vec3(1.0 - distance / u_Far), 1.0);
+    }
+};
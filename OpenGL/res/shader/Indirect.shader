@@ -0,0 +1,32 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec3 normal;
+//Per instance, the draw command's BaseInstance picks the object
+layout(location = 3) in mat4 model;
+
+out vec3 v_Normal;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+	gl_Position = u_ViewProjection * model * vec4(position, 1.0);
+	v_Normal = mat3(model) * normal;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+
+void main()
+{
+	float light = max(dot(normalize(v_Normal), normalize(vec3(0.4, 0.8, 0.6))), 0.0) * 0.8 + 0.2;
+	color = vec4(vec3(0.8, 0.6, 0.4) * light, 1.0);
+};
@@ -0,0 +1,49 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform float u_Time;
+uniform float u_Aspect;
+
+//HDR test image: a dim background with a fine grid and moving lights far above 1.0
+void main()
+{
+    vec2 p = v_TexCoord * vec2(u_Aspect, 1.0);
+    vec3 result = mix(vec3(0.02, 0.03, 0.05), vec3(0.12, 0.09, 0.06), v_TexCoord.y);
+
+    vec2 cell = abs(fract(p * 24.0) - 0.5);
+    result += vec3(0.08) * step(0.46, max(cell.x, cell.y));
+
+    for (int i = 0; i < 16; i++)
+    {
+        float f = float(i);
+        vec2 center = vec2(0.5 * u_Aspect + cos(u_Time * (0.2 + f * 0.03) + f * 1.7) * 0.4 * u_Aspect,
+                           0.5 + sin(u_Time * (0.3 + f * 0.02) + f * 2.3) * 0.35);
+        vec3 light = 0.5 + 0.5 * cos(vec3(0.0, 2.1, 4.2) + f);
+        float radius = 0.004 + 0.012 * fract(f * 0.37);
+        float d = length(p - center);
+        result += light * (4.0 + 12.0 * fract(f * 0.61)) * (1.0 - smoothstep(radius * 0.6, radius, d));
+    }
+
+    //A bright bar that gives a long horizontal streak of bloom
+    float bar = step(abs(v_TexCoord.y - 0.15), 0.002) * step(abs(v_TexCoord.x - 0.5), 0.3);
+    result += vec3(8.0, 6.0, 3.0) * bar;
+
+    color = vec4(result, 1.0);
+};
@@ -0,0 +1,42 @@
+#shader vertex
+#version 330 core
+
+//One instance per glyph, the corners of the quad come from gl_VertexID (triangle strip of 4 vertices)
+layout(location = 0) in vec4 rect;
+layout(location = 1) in vec4 texRect;
+layout(location = 2) in vec4 color;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+   vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+   gl_Position = u_MVP * vec4(mix(rect.xy, rect.zw, corner), 0.0, 1.0);
+   v_TexCoord = mix(texRect.xy, texRect.zw, corner);
+   v_Color = color;
+
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+uniform sampler2D u_Atlas;
+
+void main()
+{
+    //0.5 is the outline, the edge is smoothed over about one screen pixel at any scale
+    float distance = texture(u_Atlas, v_TexCoord).r;
+    float width = max(fwidth(distance) * 0.7, 0.001);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    color = vec4(v_Color.rgb, v_Color.a * alpha);
+
+};
@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+//One instance per chunk: the tile rectangle it covers, the corners of the quad come from gl_VertexID
+layout(location = 0) in ivec4 chunk;
+
+out vec2 v_Tile;
+
+uniform mat4 u_MVP;
+uniform float u_TileSize;
+
+void main()
+{
+   vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+   v_Tile = vec2(chunk.xy) + corner * vec2(chunk.zw);
+   gl_Position = u_MVP * vec4(v_Tile * u_TileSize, 0.0, 1.0);
+
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+//Position in tiles, the integer part is the tile and the fraction the position inside of it
+in vec2 v_Tile;
+
+uniform usampler2D u_TileIndices;
+uniform sampler2DArray u_TileTextures;
+
+void main()
+{
+    uint tile = texelFetch(u_TileIndices, ivec2(v_Tile), 0).r;
+    if (tile == 0u)
+        discard;
+
+    //Gradients of the continuous coordinate, fract() jumps at tile borders and would select the smallest mip there
+    color = textureGrad(u_TileTextures, vec3(fract(v_Tile), float(tile - 1u)), dFdx(v_Tile), dFdy(v_Tile));
+
+};
@@ -0,0 +1,44 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Scene;
+uniform sampler2D u_Bloom;
+uniform sampler2D u_Blur;
+uniform float u_BloomIntensity;
+uniform float u_BlurAmount;
+uniform float u_Exposure;
+//0 = Reinhard, 1 = ACES (Narkowicz fit)
+uniform int u_Tonemapper;
+
+vec3 Aces(vec3 x)
+{
+    return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+void main()
+{
+    vec3 hdr = texture(u_Scene, v_TexCoord).rgb;
+    hdr = mix(hdr, texture(u_Blur, v_TexCoord).rgb, u_BlurAmount);
+    hdr += texture(u_Bloom, v_TexCoord).rgb * u_BloomIntensity;
+    hdr *= u_Exposure;
+
+    vec3 ldr = u_Tonemapper == 1 ? Aces(hdr) : hdr / (1.0 + hdr);
+    color = vec4(pow(ldr, vec3(1.0 / 2.2)), 1.0);
+};
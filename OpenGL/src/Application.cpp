@@ -1,10 +1,33 @@
 #include "VertexBufferLayout.h"
 #include "VertexBuffer.h"
 #include "Texture.h"
+#include "AssetManager.h"
+#include "FrameCapture.h"
+#include "FramePacer.h"
+#include "DebugDraw.h"
 
 #include "tests/Test.h"
 #include "tests/TestClearColor.h"
 #include "tests/TestTexture2D.h"
+#include "tests/TestVertexPacking.h"
+#include "tests/TestMeshOptimizer.h"
+#include "tests/TestMeshLoading.h"
+#include "tests/TestFrustumCulling.h"
+#include "tests/TestBvh.h"
+#include "tests/TestTransformHierarchy.h"
+#include "tests/TestEcs.h"
+#include "tests/TestIndirectDraw.h"
+#include "tests/TestTextureArray.h"
+#include "tests/TestTextureCompression.h"
+#include "tests/TestTextureStreaming.h"
+#include "tests/TestImageDecoding.h"
+#include "tests/TestTextureCache.h"
+#include "tests/TestImGuiBackend.h"
+#include "tests/TestText.h"
+#include "tests/TestTilemap.h"
+#include "tests/TestDebugDraw.h"
+#include "tests/TestRenderGraph.h"
+#include "tests/TestPostProcess.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -15,12 +38,62 @@
 #include "Timer.h"
 
 #include <GLFW/glfw3.h>
-   
 
-int main(void)
+#include <cstdlib>
+#include <string>
+
+
+//Start/stop buttons and the cost of the capture, shown under every test
+static void RenderCaptureControls(FrameCapture& capture)
+{
+    if (!ImGui::CollapsingHeader("Frame Capture"))
+        return;
+
+    if (!capture.IsCapturing())
+    {
+        if (ImGui::Button("Capture PNGs"))
+            capture.Start("res/generated/capture", CaptureFormat::PNG);
+        ImGui::SameLine();
+        if (ImGui::Button("Capture Video"))
+            capture.Start("res/generated/capture.y4m", CaptureFormat::Y4M);
+    }
+    else if (ImGui::Button("Stop"))
+        capture.Stop();
+
+    ImGui::Text("%u frames captured, %u written, %u queued, %u stalls", capture.GetFramesCaptured(), capture.GetFramesWritten(),
+        capture.GetFramesQueued(), capture.GetStalls());
+    ImGui::Text("Overhead %.3f ms per frame (last %.3f ms), writer %.2f ms per frame", capture.GetAverageOverheadMs(),
+        capture.GetLastOverheadMs(), capture.GetAverageWriteMs());
+}
+
+
+int main(int argc, char** argv)
 {
     GLFWwindow* window;
 
+    //--offscreen: hidden window without VSync, --test <name>: starts a test, --frames <n>: quits after n frames
+    //--capture <directory or .y4m file>: captures every frame from the start, as PNGs or as video
+    //--idle: only renders after input or while the test animates
+    bool offscreen = false, idle = false;
+    std::string startTest, capturePath;
+    int frameLimit = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--offscreen")
+            offscreen = true;
+        else if (argument == "--idle")
+            idle = true;
+        else if (argument == "--test" && i + 1 < argc)
+            startTest = argv[++i];
+        else if (argument == "--capture" && i + 1 < argc)
+            capturePath = argv[++i];
+        else if (argument == "--frames" && i + 1 < argc)
+            frameLimit = atoi(argv[++i]);
+        else
+            std::cout << "Unknown argument " << argument << '\n';
+    }
+
     /* Initialize the library */
     if (!glfwInit())
         return -1;
@@ -29,6 +102,8 @@ int main(void)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (offscreen)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
 
     /* Create a windowed mode window and its OpenGL context */
@@ -43,8 +118,8 @@ int main(void)
     /* Make the window's context current */
     glfwMakeContextCurrent(window);
 
-    //Activates VSync
-    glfwSwapInterval(1);
+    //Activates VSync, offscreen runs as fast as possible
+    glfwSwapInterval(offscreen ? 0 : 1);
 
     if (GLEW_OK != glewInit()) {
         return -1;
@@ -66,6 +141,10 @@ int main(void)
         ImGui_ImplGlfwGL3_Init(window, true);
         ImGui::StyleColorsDark();
 
+        //After ImGui, so the pacer's callbacks pass the events on to ImGui's
+        FramePacer::Get().Attach(window);
+        FramePacer::Get().SetIdleMode(idle);
+
 
         test::Test* currentTest = nullptr;
         test::TestMenu* testMenu = new test::TestMenu(currentTest);
@@ -73,9 +152,54 @@ int main(void)
 
         testMenu->RegisterTest<test::TestClearColor>("Clear Color");
         testMenu->RegisterTest<test::TestTexture2D>("2D Texture");
+        testMenu->RegisterTest<test::TestVertexPacking>("Vertex Packing");
+        testMenu->RegisterTest<test::TestMeshOptimizer>("Mesh Optimizer");
+        testMenu->RegisterTest<test::TestMeshLoading>("Mesh Loading");
+        testMenu->RegisterTest<test::TestFrustumCulling>("Frustum Culling");
+        testMenu->RegisterTest<test::TestBvh>("BVH");
+        testMenu->RegisterTest<test::TestTransformHierarchy>("Transform Hierarchy");
+        testMenu->RegisterTest<test::TestEcs>("ECS");
+        testMenu->RegisterTest<test::TestIndirectDraw>("Indirect Draw");
+        testMenu->RegisterTest<test::TestTextureArray>("Texture Array");
+        testMenu->RegisterTest<test::TestTextureCompression>("Texture Compression");
+        testMenu->RegisterTest<test::TestTextureStreaming>("Texture Streaming");
+        testMenu->RegisterTest<test::TestImageDecoding>("Image Decoding");
+        testMenu->RegisterTest<test::TestTextureCache>("Texture Cache");
+        testMenu->RegisterTest<test::TestImGuiBackend>("ImGui Backend");
+        testMenu->RegisterTest<test::TestText>("SDF Text");
+        testMenu->RegisterTest<test::TestTilemap>("Tilemap");
+        testMenu->RegisterTest<test::TestDebugDraw>("Debug Draw");
+        testMenu->RegisterTest<test::TestRenderGraph>("Render Graph");
+        testMenu->RegisterTest<test::TestPostProcess>("Post Processing");
+
+        if (!startTest.empty() && !testMenu->StartTest(startTest))
+            std::cout << "No test named " << startTest << '\n';
+
+        FrameCapture capture;
+        if (!capturePath.empty())
+        {
+            bool video = capturePath.size() > 4 && capturePath.compare(capturePath.size() - 4, 4, ".y4m") == 0;
+            capture.Start(capturePath, video ? CaptureFormat::Y4M : CaptureFormat::PNG);
+        }
+        int frameCount = 0;
+
+        //Tests get the framebuffer size when they start and when the window is resized
+        test::Test* resizedTest = nullptr;
+        int viewportWidth = 0, viewportHeight = 0;
 
         while (!glfwWindowShouldClose(window))
         {
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+            if (width > 0 && height > 0 && (width != viewportWidth || height != viewportHeight || currentTest != resizedTest))
+            {
+                viewportWidth = width;
+                viewportHeight = height;
+                GLCall(glViewport(0, 0, width, height));
+                if (currentTest)
+                    currentTest->OnResize(width, height);
+                resizedTest = currentTest;
+            }
 
             renderer.SetClearColor();
             renderer.Clear();
@@ -92,23 +216,45 @@ int main(void)
                 {
                     delete currentTest;
                     currentTest = testMenu;
+                    DebugDraw::Get().Clear();
                 }
                 currentTest->OnImGuiRender();
 
+                ImGui::Separator();
+                RenderCaptureControls(capture);
+
                 ImGui::End();
             }
 
             ImGui::Render();
             ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
 
+            //Reads the back buffer, so the frame is captured the way it is presented
+            capture.CaptureFrame(viewportWidth, viewportHeight);
+
             glfwSwapBuffers(window);
 
-            glfwPollEvents();
+            if (frameLimit > 0 && ++frameCount >= frameLimit)
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+            //Assets the last test released stay cached for a while, in case the next test uses them too
+            AssetManager::Get().EndFrame();
+            DebugDraw::Get().EndFrame();
+
+            //A focused text field blinks its cursor, and a capture needs every frame
+            bool animating = (currentTest && currentTest->IsAnimating()) || capture.IsCapturing() || ImGui::GetIO().WantTextInput;
+            FramePacer::Get().EndFrame(animating);
         }
 
+        //Writes the frames that are still in flight
+        capture.Stop();
+
         delete currentTest;
         if(currentTest != testMenu)
             delete testMenu;
+
+        DebugDraw::Get().Shutdown();
+        AssetManager::Get().Clear();
     }
 
     ImGui_ImplGlfwGL3_Shutdown();
@@ -0,0 +1,32 @@
+#include "AssetManager.h"
+
+#include <algorithm>
+
+
+AssetManager::AssetManager()
+	: m_Frame(0), m_UnusedLifetime(600)
+{
+
+}
+
+
+AssetManager& AssetManager::Get() {
+	static AssetManager s_Instance;
+	return s_Instance;
+}
+
+
+void AssetManager::EndFrame() {
+
+	++m_Frame;
+
+	uint64_t lifetime = std::max(m_UnusedLifetime, FramesInFlight);
+	m_Shaders.Collect(m_Frame, lifetime);
+	m_Textures.Collect(m_Frame, lifetime);
+}
+
+
+void AssetManager::Clear() {
+	m_Shaders.Clear();
+	m_Textures.Clear();
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "Shader.h"
+#include "Texture.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+//Slot index plus the generation the slot had when the handle was made, so a handle to a destroyed asset resolves to nullptr
+template<typename T>
+struct AssetHandle {
+	uint32_t Index;
+	uint32_t Generation;
+
+	inline bool operator==(const AssetHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+	inline bool operator!=(const AssetHandle& other) const { return !(*this == other); }
+};
+
+
+//Assets of one type, loaded once per normalized path and reference counted
+template<typename T>
+class AssetCache {
+public:
+	//Returns the cached instance if the path was loaded before, the reference count is not touched
+	AssetHandle<T> Load(const std::string& path, uint64_t frame);
+
+	void AddRef(AssetHandle<T> handle);
+	void Release(AssetHandle<T> handle, uint64_t frame);
+	T* Get(AssetHandle<T> handle) const;
+
+	//Destroys assets that have been unreferenced for at least lifetime frames
+	void Collect(uint64_t frame, uint64_t lifetime);
+	void Clear();
+
+	inline size_t GetCount() const { return m_Lookup.size(); }
+
+private:
+	struct Slot {
+		std::unique_ptr<T> Asset;
+		std::string Path;
+		uint32_t Generation;
+		uint32_t RefCount;
+		uint64_t ReleasedFrame;
+	};
+
+	void Destroy(uint32_t index);
+
+private:
+	std::vector<Slot> m_Slots;
+	std::vector<uint32_t> m_FreeSlots;
+	std::unordered_map<std::string, uint32_t> m_Lookup;
+};
+
+
+template<typename T>
+class AssetRef;
+
+
+//Shared Shader and Texture instances for all tests, so switching between tests doesn't load the same files again
+//An asset nobody references anymore is kept for UnusedLifetime frames and revived if it is loaded again in that time,
+//it is never destroyed before FramesInFlight frames have passed, so the GPU is done with it
+class AssetManager {
+public:
+	static constexpr unsigned int FramesInFlight = 3;
+
+	AssetManager();
+
+	AssetManager(const AssetManager&) = delete;
+	AssetManager& operator=(const AssetManager&) = delete;
+
+	static AssetManager& Get();
+
+	template<typename T>
+	AssetRef<T> Load(const std::string& path);
+
+	template<typename T>
+	inline T* Resolve(AssetHandle<T> handle) { return GetCache<T>().Get(handle); }
+	template<typename T>
+	inline void AddRef(AssetHandle<T> handle) { GetCache<T>().AddRef(handle); }
+	template<typename T>
+	inline void Release(AssetHandle<T> handle) { GetCache<T>().Release(handle, m_Frame); }
+
+	//Call once per frame after the buffers were swapped, destroys expired assets
+	void EndFrame();
+	//Destroys every asset, has to run while the GL context still exists
+	void Clear();
+
+	void SetUnusedLifetime(unsigned int frames) { m_UnusedLifetime = frames; }
+	inline unsigned int GetUnusedLifetime() const { return m_UnusedLifetime; }
+
+	inline size_t GetShaderCount() const { return m_Shaders.GetCount(); }
+	inline size_t GetTextureCount() const { return m_Textures.GetCount(); }
+
+private:
+	template<typename T>
+	AssetCache<T>& GetCache();
+
+private:
+	AssetCache<Shader> m_Shaders;
+	AssetCache<Texture> m_Textures;
+	uint64_t m_Frame;
+	unsigned int m_UnusedLifetime;
+};
+
+template<>
+inline AssetCache<Shader>& AssetManager::GetCache<Shader>() { return m_Shaders; }
+template<>
+inline AssetCache<Texture>& AssetManager::GetCache<Texture>() { return m_Textures; }
+
+
+//Counted reference to an asset, used like a std::shared_ptr
+template<typename T>
+class AssetRef {
+public:
+	AssetRef() : m_Handle{ 0, 0 }, m_Valid(false) {}
+	explicit AssetRef(AssetHandle<T> handle) : m_Handle(handle), m_Valid(true) { AssetManager::Get().AddRef(m_Handle); }
+	AssetRef(const AssetRef& other) : m_Handle(other.m_Handle), m_Valid(other.m_Valid) { if (m_Valid) AssetManager::Get().AddRef(m_Handle); }
+	AssetRef(AssetRef&& other) : m_Handle(other.m_Handle), m_Valid(other.m_Valid) { other.m_Valid = false; }
+	~AssetRef() { Reset(); }
+
+	AssetRef& operator=(AssetRef other) {
+		std::swap(m_Handle, other.m_Handle);
+		std::swap(m_Valid, other.m_Valid);
+		return *this;
+	}
+
+	void Reset() {
+		if (m_Valid)
+			AssetManager::Get().Release(m_Handle);
+		m_Valid = false;
+	}
+
+	inline T* Get() const { return m_Valid ? AssetManager::Get().Resolve(m_Handle) : nullptr; }
+	inline T* operator->() const { return Get(); }
+	inline T& operator*() const { return *Get(); }
+	inline explicit operator bool() const { return m_Valid; }
+
+	inline AssetHandle<T> GetHandle() const { return m_Handle; }
+
+private:
+	AssetHandle<T> m_Handle;
+	bool m_Valid;
+};
+
+
+template<typename T>
+AssetRef<T> AssetManager::Load(const std::string& path) {
+	return AssetRef<T>(GetCache<T>().Load(path, m_Frame));
+}
+
+
+template<typename T>
+AssetHandle<T> AssetCache<T>::Load(const std::string& path, uint64_t frame) {
+
+	//"res/shader/Basic.shader" and "res/./shader/Basic.shader" are the same asset
+	std::string key = std::filesystem::path(path).lexically_normal().generic_string();
+
+	auto it = m_Lookup.find(key);
+	if (it != m_Lookup.end())
+		return { it->second, m_Slots[it->second].Generation };
+
+	uint32_t index;
+	if (!m_FreeSlots.empty()) {
+		index = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+	}
+	else {
+		index = (uint32_t)m_Slots.size();
+		m_Slots.push_back({ nullptr, std::string(), 0, 0, 0 });
+	}
+
+	Slot& slot = m_Slots[index];
+	slot.Asset = std::make_unique<T>(key);
+	slot.Path = key;
+	slot.RefCount = 0;
+	slot.ReleasedFrame = frame;
+	m_Lookup[key] = index;
+	return { index, slot.Generation };
+}
+
+
+template<typename T>
+void AssetCache<T>::AddRef(AssetHandle<T> handle) {
+	if (Get(handle))
+		++m_Slots[handle.Index].RefCount;
+}
+
+
+template<typename T>
+void AssetCache<T>::Release(AssetHandle<T> handle, uint64_t frame) {
+	if (!Get(handle))
+		return;
+
+	Slot& slot = m_Slots[handle.Index];
+	if (--slot.RefCount == 0)
+		slot.ReleasedFrame = frame;
+}
+
+
+template<typename T>
+T* AssetCache<T>::Get(AssetHandle<T> handle) const {
+	if (handle.Index >= m_Slots.size() || m_Slots[handle.Index].Generation != handle.Generation)
+		return nullptr;
+	return m_Slots[handle.Index].Asset.get();
+}
+
+
+template<typename T>
+void AssetCache<T>::Destroy(uint32_t index) {
+	Slot& slot = m_Slots[index];
+	m_Lookup.erase(slot.Path);
+	slot.Asset.reset();
+	slot.Path.clear();
+	++slot.Generation;
+	m_FreeSlots.push_back(index);
+}
+
+
+template<typename T>
+void AssetCache<T>::Collect(uint64_t frame, uint64_t lifetime) {
+	for (uint32_t i = 0; i < (uint32_t)m_Slots.size(); ++i) {
+		const Slot& slot = m_Slots[i];
+		if (slot.Asset && slot.RefCount == 0 && frame - slot.ReleasedFrame >= lifetime)
+			Destroy(i);
+	}
+}
+
+
+template<typename T>
+void AssetCache<T>::Clear() {
+	for (uint32_t i = 0; i < (uint32_t)m_Slots.size(); ++i) {
+		if (m_Slots[i].Asset)
+			Destroy(i);
+	}
+}
@@ -0,0 +1,501 @@
+#include "Bvh.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+
+
+static const unsigned int s_NoParent = 0xFFFFFFFF;
+static const unsigned int s_BinCount = 16;
+static const unsigned int s_MaxLeafSize = 4;
+//Traversal stacks are fixed arrays, nodes at this depth become leaves no matter how big they are
+static const unsigned int s_MaxDepth = 64;
+//Subtrees/ranges bigger than this get built/binned on the JobSystem
+static const unsigned int s_ParallelThreshold = 16384;
+
+
+AABB AABB::Empty() {
+	return { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+}
+
+
+void AABB::Grow(const glm::vec3& point) {
+	Min = glm::min(Min, point);
+	Max = glm::max(Max, point);
+}
+
+
+void AABB::Grow(const AABB& other) {
+	Min = glm::min(Min, other.Min);
+	Max = glm::max(Max, other.Max);
+}
+
+
+float AABB::GetSurfaceArea() const {
+	glm::vec3 size = Max - Min;
+	if (size.x < 0.0f || size.y < 0.0f || size.z < 0.0f)
+		return 0.0f;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+
+bool AABB::Overlaps(const AABB& other) const {
+	return Min.x <= other.Max.x && Max.x >= other.Min.x &&
+		   Min.y <= other.Max.y && Max.y >= other.Min.y &&
+		   Min.z <= other.Max.z && Max.z >= other.Min.z;
+}
+
+
+Ray Ray::FromScreen(const glm::vec2& mouse, const glm::vec2& viewportSize, const glm::mat4& viewProjection) {
+
+	float x = 2.0f * mouse.x / viewportSize.x - 1.0f;
+	float y = 1.0f - 2.0f * mouse.y / viewportSize.y;
+
+	glm::mat4 inverse = glm::inverse(viewProjection);
+	glm::vec4 nearPoint = inverse * glm::vec4(x, y, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverse * glm::vec4(x, y, 1.0f, 1.0f);
+	nearPoint /= nearPoint.w;
+	farPoint /= farPoint.w;
+
+	return { glm::vec3(nearPoint), glm::normalize(glm::vec3(farPoint - nearPoint)) };
+}
+
+
+//Slab test, returns the entry distance or a negative value on a miss
+static float IntersectRay(const AABB& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance) {
+	glm::vec3 t1 = (box.Min - origin) * inverseDirection;
+	glm::vec3 t2 = (box.Max - origin) * inverseDirection;
+	glm::vec3 tMin = glm::min(t1, t2), tMax = glm::max(t1, t2);
+
+	float entry = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+	float exit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+	return entry <= exit ? entry : -1.0f;
+}
+
+
+//0 = outside, 1 = intersecting, 2 = fully inside the plane
+static int ClassifyBox(const glm::vec4& plane, const AABB& box) {
+	glm::vec3 center = box.GetCenter(), extent = box.GetExtent();
+	float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+	float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+	if (distance < -radius)
+		return 0;
+	return distance < radius ? 1 : 2;
+}
+
+
+Bvh::Bvh()
+	: m_NodeCount(0)
+{
+}
+
+
+unsigned int Bvh::AllocateNodes() {
+	return m_NodeCount.fetch_add(2);
+}
+
+
+void Bvh::Build(const AABB* bounds, size_t count, bool parallel) {
+
+	m_Bounds.assign(bounds, bounds + count);
+	m_Objects.resize(count);
+	m_ObjectLeaf.resize(count);
+	m_DirtyLeaves.clear();
+
+	std::vector<glm::vec3> centers(count);
+	for (size_t i = 0; i < count; ++i) {
+		m_Objects[i] = (unsigned int)i;
+		centers[i] = bounds[i].GetCenter();
+	}
+
+	//A binary tree with at least one object per leaf never needs more than 2n - 1 nodes
+	m_Nodes.resize(std::max<size_t>(count * 2, 1));
+	m_NodeCount = 1;
+
+	Node& root = m_Nodes[0];
+	root.Bounds = AABB::Empty();
+	root.Left = 0;
+	root.Parent = s_NoParent;
+	root.First = 0;
+	root.Count = (unsigned int)count;
+	root.Dirty = false;
+
+	if (count > 0)
+		BuildNode(0, centers.data(), 0, parallel);
+
+	m_Nodes.resize(m_NodeCount);
+}
+
+
+void Bvh::BuildNode(unsigned int nodeIndex, const glm::vec3* centers, unsigned int depth, bool parallel) {
+
+	Node& node = m_Nodes[nodeIndex];
+	unsigned int* objects = m_Objects.data() + node.First;
+	bool parallelRange = parallel && node.Count > s_ParallelThreshold;
+
+	struct Bin {
+		AABB Bounds;
+		unsigned int Count;
+	};
+
+	//Bounds of the objects and of their centers
+	AABB bounds = AABB::Empty(), centerBounds = AABB::Empty();
+	auto gatherBounds = [&](size_t begin, size_t end, AABB& outBounds, AABB& outCenters) {
+		for (size_t i = begin; i < end; ++i) {
+			outBounds.Grow(m_Bounds[objects[i]]);
+			outCenters.Grow(centers[objects[i]]);
+		}
+	};
+
+	if (parallelRange) {
+		size_t batches = (node.Count + s_ParallelThreshold - 1) / s_ParallelThreshold;
+		std::vector<AABB> partialBounds(batches, AABB::Empty()), partialCenters(batches, AABB::Empty());
+		JobSystem::Get().ParallelFor(node.Count, s_ParallelThreshold, [&](size_t begin, size_t end) {
+			gatherBounds(begin, end, partialBounds[begin / s_ParallelThreshold], partialCenters[begin / s_ParallelThreshold]);
+		});
+		for (size_t batch = 0; batch < batches; ++batch) {
+			bounds.Grow(partialBounds[batch]);
+			centerBounds.Grow(partialCenters[batch]);
+		}
+	}
+	else
+		gatherBounds(0, node.Count, bounds, centerBounds);
+
+	node.Bounds = bounds;
+
+	auto makeLeaf = [&]() {
+		node.Left = 0;
+		for (unsigned int i = 0; i < node.Count; ++i)
+			m_ObjectLeaf[objects[i]] = nodeIndex;
+	};
+
+	if (node.Count <= 2 || depth + 1 >= s_MaxDepth) {
+		makeLeaf();
+		return;
+	}
+
+	//Bin the centers along every axis and sweep the split planes between the bins
+	glm::vec3 centerSize = centerBounds.Max - centerBounds.Min;
+	glm::vec3 binScale;
+	for (int axis = 0; axis < 3; ++axis)
+		binScale[axis] = centerSize[axis] > 0.0f ? s_BinCount * 0.9999f / centerSize[axis] : 0.0f;
+
+	auto binIndex = [&](const glm::vec3& center, int axis) {
+		return std::min((unsigned int)((center[axis] - centerBounds.Min[axis]) * binScale[axis]), s_BinCount - 1);
+	};
+
+	Bin bins[3][s_BinCount];
+	auto fillBins = [&](size_t begin, size_t end, Bin (*out)[s_BinCount]) {
+		for (int axis = 0; axis < 3; ++axis)
+			for (Bin& bin : out[axis])
+				bin = { AABB::Empty(), 0 };
+
+		for (size_t i = begin; i < end; ++i) {
+			const AABB& objectBounds = m_Bounds[objects[i]];
+			const glm::vec3& center = centers[objects[i]];
+			for (int axis = 0; axis < 3; ++axis) {
+				Bin& bin = out[axis][binIndex(center, axis)];
+				bin.Bounds.Grow(objectBounds);
+				bin.Count++;
+			}
+		}
+	};
+
+	if (parallelRange) {
+		size_t batches = (node.Count + s_ParallelThreshold - 1) / s_ParallelThreshold;
+		std::vector<Bin> partialBins(batches * 3 * s_BinCount);
+		JobSystem::Get().ParallelFor(node.Count, s_ParallelThreshold, [&](size_t begin, size_t end) {
+			fillBins(begin, end, (Bin (*)[s_BinCount])&partialBins[begin / s_ParallelThreshold * 3 * s_BinCount]);
+		});
+
+		fillBins(0, 0, bins);
+		for (size_t batch = 0; batch < batches; ++batch) {
+			for (unsigned int i = 0; i < 3 * s_BinCount; ++i) {
+				const Bin& partial = partialBins[batch * 3 * s_BinCount + i];
+				bins[i / s_BinCount][i % s_BinCount].Bounds.Grow(partial.Bounds);
+				bins[i / s_BinCount][i % s_BinCount].Count += partial.Count;
+			}
+		}
+	}
+	else
+		fillBins(0, node.Count, bins);
+
+	//SAH cost relative to the parent area, traversal step costs as much as one object test
+	float bestCost = FLT_MAX;
+	int bestAxis = -1;
+	unsigned int bestSplit = 0;
+	for (int axis = 0; axis < 3; ++axis) {
+		if (binScale[axis] == 0.0f)
+			continue;
+
+		float rightArea[s_BinCount];
+		unsigned int rightCount[s_BinCount];
+		AABB right = AABB::Empty();
+		unsigned int count = 0;
+		for (unsigned int i = s_BinCount - 1; i > 0; --i) {
+			right.Grow(bins[axis][i].Bounds);
+			count += bins[axis][i].Count;
+			rightArea[i] = right.GetSurfaceArea();
+			rightCount[i] = count;
+		}
+
+		AABB left = AABB::Empty();
+		count = 0;
+		for (unsigned int i = 1; i < s_BinCount; ++i) {
+			left.Grow(bins[axis][i - 1].Bounds);
+			count += bins[axis][i - 1].Count;
+			float cost = left.GetSurfaceArea() * count + rightArea[i] * rightCount[i];
+			if (count > 0 && rightCount[i] > 0 && cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = i;
+			}
+		}
+	}
+
+	float parentArea = bounds.GetSurfaceArea();
+	bestCost = parentArea > 0.0f ? 1.0f + bestCost / parentArea : FLT_MAX;
+
+	unsigned int middle;
+	if (bestAxis < 0) {
+		//All centers in the same spot, splitting by position can't help
+		if (node.Count <= s_MaxLeafSize) {
+			makeLeaf();
+			return;
+		}
+		middle = node.Count / 2;
+	}
+	else {
+		if (bestCost >= (float)node.Count && node.Count <= s_MaxLeafSize) {
+			makeLeaf();
+			return;
+		}
+		unsigned int* split = std::partition(objects, objects + node.Count, [&](unsigned int object) {
+			return binIndex(centers[object], bestAxis) < bestSplit;
+		});
+		middle = (unsigned int)(split - objects);
+	}
+
+	unsigned int left = AllocateNodes();
+	node.Left = left;
+
+	Node& leftNode = m_Nodes[left];
+	Node& rightNode = m_Nodes[left + 1];
+	leftNode.Parent = rightNode.Parent = nodeIndex;
+	leftNode.Dirty = rightNode.Dirty = false;
+	leftNode.First = node.First;
+	leftNode.Count = middle;
+	rightNode.First = node.First + middle;
+	rightNode.Count = node.Count - middle;
+
+	if (parallel && node.Count > s_ParallelThreshold) {
+		JobSystem::Get().ParallelFor(2, 1, [&](size_t begin, size_t) {
+			BuildNode(left + (unsigned int)begin, centers, depth + 1, parallel);
+		});
+	}
+	else {
+		BuildNode(left, centers, depth + 1, parallel);
+		BuildNode(left + 1, centers, depth + 1, parallel);
+	}
+}
+
+
+void Bvh::SetObjectBounds(unsigned int object, const AABB& bounds) {
+
+	m_Bounds[object] = bounds;
+
+	Node& leaf = m_Nodes[m_ObjectLeaf[object]];
+	if (!leaf.Dirty) {
+		leaf.Dirty = true;
+		m_DirtyLeaves.push_back(m_ObjectLeaf[object]);
+	}
+}
+
+
+void Bvh::Refit() {
+
+	if (m_DirtyLeaves.empty())
+		return;
+
+	//Mark the ancestors, stopping at the first one another leaf already marked
+	std::vector<unsigned int> dirty(m_DirtyLeaves);
+	for (unsigned int leaf : m_DirtyLeaves) {
+		for (unsigned int parent = m_Nodes[leaf].Parent; parent != s_NoParent && !m_Nodes[parent].Dirty; parent = m_Nodes[parent].Parent) {
+			m_Nodes[parent].Dirty = true;
+			dirty.push_back(parent);
+		}
+	}
+	m_DirtyLeaves.clear();
+
+	//Children always come after their parent in m_Nodes, so descending order updates bottom up
+	//When most of the tree moved a sweep over all nodes is cheaper than sorting the list
+	if (dirty.size() > m_Nodes.size() / 8) {
+		dirty.clear();
+		for (unsigned int index = (unsigned int)m_Nodes.size(); index-- > 0;) {
+			if (m_Nodes[index].Dirty)
+				dirty.push_back(index);
+		}
+	}
+	else
+		std::sort(dirty.begin(), dirty.end(), std::greater<unsigned int>());
+
+	for (unsigned int index : dirty) {
+		Node& node = m_Nodes[index];
+		node.Bounds = AABB::Empty();
+		if (node.Left == 0) {
+			for (unsigned int i = node.First; i < node.First + node.Count; ++i)
+				node.Bounds.Grow(m_Bounds[m_Objects[i]]);
+		}
+		else {
+			node.Bounds.Grow(m_Nodes[node.Left].Bounds);
+			node.Bounds.Grow(m_Nodes[node.Left + 1].Bounds);
+		}
+		node.Dirty = false;
+	}
+}
+
+
+void Bvh::AddSubtree(const Node& node, std::vector<unsigned int>& results) const {
+	results.insert(results.end(), m_Objects.begin() + node.First, m_Objects.begin() + node.First + node.Count);
+}
+
+
+void Bvh::QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& visible) const {
+
+	visible.clear();
+	if (m_Bounds.empty())
+		return;
+
+	//Every entry carries the planes its parent still intersected, the others can't cull anything below
+	struct Entry {
+		unsigned int Node;
+		unsigned int PlaneMask;
+	};
+	Entry stack[s_MaxDepth];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = { 0, 0x3F };
+
+	while (stackSize > 0) {
+		Entry entry = stack[--stackSize];
+		const Node& node = m_Nodes[entry.Node];
+
+		unsigned int mask = 0;
+		bool outside = false;
+		for (unsigned int p = 0; p < 6 && !outside; ++p) {
+			if (!(entry.PlaneMask & (1 << p)))
+				continue;
+			int side = ClassifyBox(frustum.Planes[p], node.Bounds);
+			outside = side == 0;
+			mask |= (side == 1) << p;
+		}
+
+		if (outside)
+			continue;
+		if (mask == 0) {
+			AddSubtree(node, visible);
+			continue;
+		}
+
+		if (node.Left == 0) {
+			for (unsigned int i = node.First; i < node.First + node.Count; ++i) {
+				bool inside = true;
+				for (unsigned int p = 0; p < 6 && inside; ++p)
+					inside = !(mask & (1 << p)) || ClassifyBox(frustum.Planes[p], m_Bounds[m_Objects[i]]) != 0;
+				if (inside)
+					visible.push_back(m_Objects[i]);
+			}
+		}
+		else {
+			stack[stackSize++] = { node.Left + 1, mask };
+			stack[stackSize++] = { node.Left, mask };
+		}
+	}
+}
+
+
+bool Bvh::Raycast(const Ray& ray, RayHit& hit, float maxDistance) const {
+
+	if (m_Bounds.empty())
+		return false;
+
+	glm::vec3 inverseDirection = 1.0f / ray.Direction;
+	float closest = maxDistance;
+	unsigned int closestObject = s_NoParent;
+
+	unsigned int stack[s_MaxDepth];
+	unsigned int stackSize = 0;
+	if (IntersectRay(m_Nodes[0].Bounds, ray.Origin, inverseDirection, closest) >= 0.0f)
+		stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const Node& node = m_Nodes[stack[--stackSize]];
+
+		if (node.Left == 0) {
+			for (unsigned int i = node.First; i < node.First + node.Count; ++i) {
+				float distance = IntersectRay(m_Bounds[m_Objects[i]], ray.Origin, inverseDirection, closest);
+				if (distance >= 0.0f && distance < closest) {
+					closest = distance;
+					closestObject = m_Objects[i];
+				}
+			}
+			continue;
+		}
+
+		//Visit the nearer child first so the farther one is more likely to be rejected by closest
+		float leftDistance = IntersectRay(m_Nodes[node.Left].Bounds, ray.Origin, inverseDirection, closest);
+		float rightDistance = IntersectRay(m_Nodes[node.Left + 1].Bounds, ray.Origin, inverseDirection, closest);
+		unsigned int first = node.Left, second = node.Left + 1;
+		if (rightDistance >= 0.0f && (leftDistance < 0.0f || rightDistance < leftDistance)) {
+			std::swap(first, second);
+			std::swap(leftDistance, rightDistance);
+		}
+
+		if (rightDistance >= 0.0f)
+			stack[stackSize++] = second;
+		if (leftDistance >= 0.0f)
+			stack[stackSize++] = first;
+	}
+
+	if (closestObject == s_NoParent)
+		return false;
+
+	hit.Object = closestObject;
+	hit.Distance = closest;
+	return true;
+}
+
+
+void Bvh::QueryRegion(const AABB& region, std::vector<unsigned int>& results) const {
+
+	results.clear();
+	if (m_Bounds.empty())
+		return;
+
+	unsigned int stack[s_MaxDepth];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const Node& node = m_Nodes[stack[--stackSize]];
+		if (!region.Overlaps(node.Bounds))
+			continue;
+
+		bool contained = glm::all(glm::lessThanEqual(region.Min, node.Bounds.Min)) && glm::all(glm::greaterThanEqual(region.Max, node.Bounds.Max));
+		if (contained) {
+			AddSubtree(node, results);
+			continue;
+		}
+
+		if (node.Left == 0) {
+			for (unsigned int i = node.First; i < node.First + node.Count; ++i) {
+				if (region.Overlaps(m_Bounds[m_Objects[i]]))
+					results.push_back(m_Objects[i]);
+			}
+		}
+		else {
+			stack[stackSize++] = node.Left + 1;
+			stack[stackSize++] = node.Left;
+		}
+	}
+}
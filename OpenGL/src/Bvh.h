@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Culling.h"
+
+
+struct AABB {
+	glm::vec3 Min, Max;
+
+	//Empty box that any Grow() replaces
+	static AABB Empty();
+
+	void Grow(const glm::vec3& point);
+	void Grow(const AABB& other);
+
+	inline glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+	inline glm::vec3 GetExtent() const { return (Max - Min) * 0.5f; }
+	float GetSurfaceArea() const;
+	bool Overlaps(const AABB& other) const;
+};
+
+
+struct Ray {
+	glm::vec3 Origin;
+	glm::vec3 Direction;
+
+	//Ray through a pixel, mouse in window coordinates (origin top left) like glfwGetCursorPos/ImGui report it
+	static Ray FromScreen(const glm::vec2& mouse, const glm::vec2& viewportSize, const glm::mat4& viewProjection);
+};
+
+
+struct RayHit {
+	unsigned int Object;
+	float Distance;
+};
+
+
+//Bounding volume hierarchy over object AABBs, built with binned SAH
+//Objects are referred to by their index in the bounds array passed to Build()
+class Bvh {
+public:
+	Bvh();
+
+	//parallel builds the upper subtrees on the JobSystem
+	void Build(const AABB* bounds, size_t count, bool parallel = true);
+
+	//Incremental refit for moving objects, the tree topology stays the same
+	//Only the ancestors of objects changed since the last Refit() are recomputed
+	void SetObjectBounds(unsigned int object, const AABB& bounds);
+	void Refit();
+
+	//Objects whose bounds intersect the frustum, subtrees fully inside are added without further tests
+	void QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& visible) const;
+	//Closest object whose bounds the ray hits, returns false if there is none closer than maxDistance
+	bool Raycast(const Ray& ray, RayHit& hit, float maxDistance = 1e30f) const;
+	//Objects whose bounds overlap the region
+	void QueryRegion(const AABB& region, std::vector<unsigned int>& results) const;
+
+	inline size_t GetObjectCount() const { return m_Bounds.size(); }
+	inline size_t GetNodeCount() const { return m_NodeCount; }
+	inline const AABB& GetBounds() const { return m_Nodes[0].Bounds; }
+
+private:
+	//Inner nodes have their children at Left and Left + 1, leaves have Left = 0
+	//Every node covers the objects m_Objects[First, First + Count)
+	struct Node {
+		AABB Bounds;
+		unsigned int Left;
+		unsigned int Parent;
+		unsigned int First;
+		unsigned int Count;
+		bool Dirty;
+	};
+
+	void BuildNode(unsigned int node, const glm::vec3* centers, unsigned int depth, bool parallel);
+	unsigned int AllocateNodes();
+	void AddSubtree(const Node& node, std::vector<unsigned int>& results) const;
+
+private:
+	std::vector<Node> m_Nodes;
+	std::vector<AABB> m_Bounds;
+	std::vector<unsigned int> m_Objects;
+	std::vector<unsigned int> m_ObjectLeaf;
+	std::vector<unsigned int> m_DirtyLeaves;
+	std::atomic<unsigned int> m_NodeCount;
+};
@@ -0,0 +1,165 @@
+#include "Camera.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+
+Camera::Camera()
+	: m_Position(0.0f), m_Rotation(1.0f, 0.0f, 0.0f, 0.0f), m_ViewDirty(true), m_ProjectionDirty(true),
+	  m_View(1.0f), m_InverseView(1.0f), m_Projection(1.0f), m_ViewProjection(1.0f), m_InverseViewProjection(1.0f),
+	  m_Frustum(), m_Version(0)
+{
+}
+
+
+void Camera::SetPosition(const glm::vec3& position) {
+	if (position == m_Position)
+		return;
+	m_Position = position;
+	m_ViewDirty = true;
+}
+
+
+void Camera::SetRotation(const glm::quat& rotation) {
+	if (rotation == m_Rotation)
+		return;
+	m_Rotation = rotation;
+	m_ViewDirty = true;
+}
+
+
+void Camera::Update() const {
+
+	if (!m_ViewDirty && !m_ProjectionDirty)
+		return;
+
+	if (m_ViewDirty) {
+		//The camera transform is translate * rotate, the view matrix is its inverse
+		glm::mat4 rotation = glm::mat4_cast(m_Rotation);
+		m_InverseView = glm::translate(glm::mat4(1.0f), m_Position) * rotation;
+		m_View = glm::transpose(rotation) * glm::translate(glm::mat4(1.0f), -m_Position);
+	}
+	if (m_ProjectionDirty)
+		m_Projection = CalculateProjection();
+
+	m_ViewProjection = m_Projection * m_View;
+	m_InverseViewProjection = glm::inverse(m_ViewProjection);
+	m_Frustum = Frustum::FromMatrix(m_ViewProjection);
+
+	m_ViewDirty = false;
+	m_ProjectionDirty = false;
+	m_Version++;
+}
+
+
+const glm::mat4& Camera::GetView() const {
+	Update();
+	return m_View;
+}
+
+
+const glm::mat4& Camera::GetInverseView() const {
+	Update();
+	return m_InverseView;
+}
+
+
+const glm::mat4& Camera::GetProjection() const {
+	Update();
+	return m_Projection;
+}
+
+
+const glm::mat4& Camera::GetViewProjection() const {
+	Update();
+	return m_ViewProjection;
+}
+
+
+const glm::mat4& Camera::GetInverseViewProjection() const {
+	Update();
+	return m_InverseViewProjection;
+}
+
+
+const Frustum& Camera::GetFrustum() const {
+	Update();
+	return m_Frustum;
+}
+
+
+unsigned int Camera::GetVersion() const {
+	Update();
+	return m_Version;
+}
+
+
+OrthographicCamera::OrthographicCamera(float width, float height, float nearPlane, float farPlane)
+	: m_Width(width), m_Height(height), m_Near(nearPlane), m_Far(farPlane), m_Zoom(1.0f)
+{
+}
+
+
+void OrthographicCamera::SetViewportSize(float width, float height) {
+	if (width <= 0.0f || height <= 0.0f || (width == m_Width && height == m_Height))
+		return;
+	m_Width = width;
+	m_Height = height;
+	InvalidateProjection();
+}
+
+
+void OrthographicCamera::SetZoom(float zoom) {
+	if (zoom == m_Zoom)
+		return;
+	m_Zoom = zoom;
+	InvalidateProjection();
+}
+
+
+glm::mat4 OrthographicCamera::CalculateProjection() const {
+	return glm::ortho(0.0f, m_Width / m_Zoom, 0.0f, m_Height / m_Zoom, m_Near, m_Far);
+}
+
+
+PerspectiveCamera::PerspectiveCamera(float fieldOfView, float aspectRatio, float nearPlane, float farPlane)
+	: m_FieldOfView(fieldOfView), m_AspectRatio(aspectRatio), m_Near(nearPlane), m_Far(farPlane)
+{
+}
+
+
+void PerspectiveCamera::SetViewportSize(float width, float height) {
+	//Minimized windows report 0 x 0
+	if (width <= 0.0f || height <= 0.0f || width / height == m_AspectRatio)
+		return;
+	m_AspectRatio = width / height;
+	InvalidateProjection();
+}
+
+
+void PerspectiveCamera::SetFieldOfView(float fieldOfView) {
+	if (fieldOfView == m_FieldOfView)
+		return;
+	m_FieldOfView = fieldOfView;
+	InvalidateProjection();
+}
+
+
+void PerspectiveCamera::SetClipPlanes(float nearPlane, float farPlane) {
+	if (nearPlane == m_Near && farPlane == m_Far)
+		return;
+	m_Near = nearPlane;
+	m_Far = farPlane;
+	InvalidateProjection();
+}
+
+
+void PerspectiveCamera::LookAt(const glm::vec3& target, const glm::vec3& up) {
+	//lookAt builds the view matrix, its rotation part is the inverse of the camera rotation
+	glm::mat4 view = glm::lookAt(GetPosition(), target, up);
+	SetRotation(glm::conjugate(glm::quat_cast(glm::mat3(view))));
+}
+
+
+glm::mat4 PerspectiveCamera::CalculateProjection() const {
+	return glm::perspective(glm::radians(m_FieldOfView), m_AspectRatio, m_Near, m_Far);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "Culling.h"
+
+
+//Base class of the cameras: caches view, projection, view-projection, their inverses and the frustum planes,
+//and only recomputes them on the first Get after a setter changed something
+class Camera {
+public:
+	Camera();
+	virtual ~Camera() {}
+
+	void SetPosition(const glm::vec3& position);
+	void SetRotation(const glm::quat& rotation);
+	inline const glm::vec3& GetPosition() const { return m_Position; }
+	inline const glm::quat& GetRotation() const { return m_Rotation; }
+
+	//Call when the window/framebuffer is resized, the projection follows the new size
+	virtual void SetViewportSize(float width, float height) = 0;
+
+	const glm::mat4& GetView() const;
+	const glm::mat4& GetInverseView() const;
+	const glm::mat4& GetProjection() const;
+	const glm::mat4& GetViewProjection() const;
+	const glm::mat4& GetInverseViewProjection() const;
+	const Frustum& GetFrustum() const;
+
+	//Goes up every time the matrices change, compare with a stored value to skip work while the camera stands still
+	unsigned int GetVersion() const;
+
+protected:
+	virtual glm::mat4 CalculateProjection() const = 0;
+	inline void InvalidateProjection() { m_ProjectionDirty = true; }
+
+private:
+	void Update() const;
+
+private:
+	glm::vec3 m_Position;
+	glm::quat m_Rotation;
+
+	mutable bool m_ViewDirty;
+	mutable bool m_ProjectionDirty;
+	mutable glm::mat4 m_View, m_InverseView;
+	mutable glm::mat4 m_Projection;
+	mutable glm::mat4 m_ViewProjection, m_InverseViewProjection;
+	mutable Frustum m_Frustum;
+	mutable unsigned int m_Version;
+};
+
+
+//Pixel space by default: (0, 0) is the bottom left and (width, height) the top right corner of the window
+class OrthographicCamera : public Camera {
+public:
+	OrthographicCamera(float width, float height, float nearPlane = -1.0f, float farPlane = 1.0f);
+
+	void SetViewportSize(float width, float height) override;
+	//Values above 1 show less of the world, keeps the bottom left corner in place
+	void SetZoom(float zoom);
+
+	inline float GetWidth() const { return m_Width; }
+	inline float GetHeight() const { return m_Height; }
+	inline float GetZoom() const { return m_Zoom; }
+
+protected:
+	glm::mat4 CalculateProjection() const override;
+
+private:
+	float m_Width, m_Height;
+	float m_Near, m_Far;
+	float m_Zoom;
+};
+
+
+class PerspectiveCamera : public Camera {
+public:
+	//fieldOfView is vertical, in degrees
+	PerspectiveCamera(float fieldOfView, float aspectRatio, float nearPlane, float farPlane);
+
+	void SetViewportSize(float width, float height) override;
+	void SetFieldOfView(float fieldOfView);
+	void SetClipPlanes(float nearPlane, float farPlane);
+
+	//Rotates the camera to face target from its current position
+	void LookAt(const glm::vec3& target, const glm::vec3& up = glm::vec3(0.0f, 1.0f, 0.0f));
+
+	inline float GetFieldOfView() const { return m_FieldOfView; }
+	inline float GetAspectRatio() const { return m_AspectRatio; }
+	inline float GetNearPlane() const { return m_Near; }
+	inline float GetFarPlane() const { return m_Far; }
+
+protected:
+	glm::mat4 CalculateProjection() const override;
+
+private:
+	float m_FieldOfView;
+	float m_AspectRatio;
+	float m_Near, m_Far;
+};
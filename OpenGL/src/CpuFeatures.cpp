@@ -0,0 +1,57 @@
+#include "CpuFeatures.h"
+
+#ifdef CPU_X86
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+#include <cstdint>
+
+
+const CpuFeatures::Flags& CpuFeatures::GetFlags() {
+
+	static const Flags flags = []() {
+		Flags result = { false, false };
+#ifdef CPU_X86
+		unsigned int ecx = 0;
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		ecx = (unsigned int)info[2];
+	#else
+		unsigned int eax, ebx, edx;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			return result;
+	#endif
+
+		//AVX needs the instructions and an OS that enabled the XMM and YMM state (XCR0 bits 1 and 2)
+		bool osxsave = (ecx >> 27) & 1;
+		if (!osxsave || !((ecx >> 28) & 1))
+			return result;
+	#ifdef _MSC_VER
+		uint64_t xcr0 = _xgetbv(0);
+	#else
+		unsigned int xcr0Low, xcr0High;
+		__asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+		uint64_t xcr0 = ((uint64_t)xcr0High << 32) | xcr0Low;
+	#endif
+		result.AVX = (xcr0 & 6) == 6;
+		result.F16C = result.AVX && ((ecx >> 29) & 1);
+#endif
+		return result;
+	}();
+	return flags;
+}
+
+
+bool CpuFeatures::HasAVX() {
+	return GetFlags().AVX;
+}
+
+
+bool CpuFeatures::HasF16C() {
+	return GetFlags().F16C;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define CPU_X86
+#endif
+
+//Compiles a single function for an instruction set the build doesn't assume, e.g. CPU_TARGET("avx")
+//The function may only run when CpuFeatures reports the set. MSVC accepts every intrinsic without /arch, so it needs nothing.
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define CPU_TARGET(isa)
+#else
+	#define CPU_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+
+//Instruction set extensions of the CPU the program runs on, queried once with cpuid
+class CpuFeatures {
+public:
+	//Also checks that the OS saves the AVX registers
+	static bool HasAVX();
+	//16 bit float conversions, implies AVX
+	static bool HasF16C();
+
+private:
+	struct Flags {
+		bool AVX;
+		bool F16C;
+	};
+
+	static const Flags& GetFlags();
+};
@@ -0,0 +1,272 @@
+#include "Culling.h"
+
+#include "CpuFeatures.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection) {
+
+	//glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+	const glm::mat4& m = viewProjection;
+	glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+	glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+	glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+	glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	Frustum frustum;
+	frustum.Planes[0] = row3 + row0;
+	frustum.Planes[1] = row3 - row0;
+	frustum.Planes[2] = row3 + row1;
+	frustum.Planes[3] = row3 - row1;
+	frustum.Planes[4] = row3 + row2;
+	frustum.Planes[5] = row3 - row2;
+
+	for (glm::vec4& plane : frustum.Planes)
+		plane /= glm::length(glm::vec3(plane));
+
+	return frustum;
+}
+
+
+unsigned int BoundingVolumes::AddBox(const glm::vec3& min, const glm::vec3& max) {
+	unsigned int index = (unsigned int)GetCount();
+	m_CenterX.push_back(0.0f); m_CenterY.push_back(0.0f); m_CenterZ.push_back(0.0f);
+	m_ExtentX.push_back(0.0f); m_ExtentY.push_back(0.0f); m_ExtentZ.push_back(0.0f);
+	m_Radius.push_back(0.0f);
+	SetBox(index, min, max);
+	return index;
+}
+
+
+unsigned int BoundingVolumes::AddSphere(const glm::vec3& center, float radius) {
+	unsigned int index = (unsigned int)GetCount();
+	m_CenterX.push_back(0.0f); m_CenterY.push_back(0.0f); m_CenterZ.push_back(0.0f);
+	m_ExtentX.push_back(0.0f); m_ExtentY.push_back(0.0f); m_ExtentZ.push_back(0.0f);
+	m_Radius.push_back(0.0f);
+	SetSphere(index, center, radius);
+	return index;
+}
+
+
+void BoundingVolumes::SetBox(unsigned int index, const glm::vec3& min, const glm::vec3& max) {
+	glm::vec3 center = (min + max) * 0.5f;
+	glm::vec3 extent = (max - min) * 0.5f;
+	m_CenterX[index] = center.x; m_CenterY[index] = center.y; m_CenterZ[index] = center.z;
+	m_ExtentX[index] = extent.x; m_ExtentY[index] = extent.y; m_ExtentZ[index] = extent.z;
+	m_Radius[index] = 0.0f;
+}
+
+
+void BoundingVolumes::SetSphere(unsigned int index, const glm::vec3& center, float radius) {
+	m_CenterX[index] = center.x; m_CenterY[index] = center.y; m_CenterZ[index] = center.z;
+	m_ExtentX[index] = 0.0f; m_ExtentY[index] = 0.0f; m_ExtentZ[index] = 0.0f;
+	m_Radius[index] = radius;
+}
+
+
+void BoundingVolumes::Clear() {
+	m_CenterX.clear(); m_CenterY.clear(); m_CenterZ.clear();
+	m_ExtentX.clear(); m_ExtentY.clear(); m_ExtentZ.clear();
+	m_Radius.clear();
+}
+
+
+void BoundingVolumes::Reserve(size_t count) {
+	m_CenterX.reserve(count); m_CenterY.reserve(count); m_CenterZ.reserve(count);
+	m_ExtentX.reserve(count); m_ExtentY.reserve(count); m_ExtentZ.reserve(count);
+	m_Radius.reserve(count);
+}
+
+
+//Kernels take the arrays directly and write visible indices without branching, so they may write
+//up to their lane count past the last visible entry
+struct CullingInput {
+	const float* CenterX; const float* CenterY; const float* CenterZ;
+	const float* ExtentX; const float* ExtentY; const float* ExtentZ;
+	const float* Radius;
+};
+
+
+static size_t CullScalar(const Frustum& frustum, const CullingInput& in, size_t begin, size_t end, unsigned int* visible) {
+
+	size_t count = 0;
+	for (size_t i = begin; i < end; ++i) {
+		bool inside = true;
+		for (const glm::vec4& plane : frustum.Planes) {
+			float distance = plane.x * in.CenterX[i] + plane.y * in.CenterY[i] + plane.z * in.CenterZ[i] + plane.w;
+			float radius = std::fabs(plane.x) * in.ExtentX[i] + std::fabs(plane.y) * in.ExtentY[i] + std::fabs(plane.z) * in.ExtentZ[i] + in.Radius[i];
+			inside &= distance + radius >= 0.0f;
+		}
+
+		visible[count] = (unsigned int)i;
+		count += inside;
+	}
+	return count;
+}
+
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+static size_t CullSSE(const Frustum& frustum, const CullingInput& in, size_t begin, size_t end, unsigned int* visible) {
+
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	for (int p = 0; p < 6; ++p) {
+		planeX[p] = _mm_set1_ps(frustum.Planes[p].x);
+		planeY[p] = _mm_set1_ps(frustum.Planes[p].y);
+		planeZ[p] = _mm_set1_ps(frustum.Planes[p].z);
+		planeW[p] = _mm_set1_ps(frustum.Planes[p].w);
+		absX[p] = _mm_and_ps(planeX[p], signMask);
+		absY[p] = _mm_and_ps(planeY[p], signMask);
+		absZ[p] = _mm_and_ps(planeZ[p], signMask);
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	size_t count = 0;
+	size_t i = begin;
+
+	for (; i + 4 <= end; i += 4) {
+		__m128 cx = _mm_loadu_ps(in.CenterX + i), cy = _mm_loadu_ps(in.CenterY + i), cz = _mm_loadu_ps(in.CenterZ + i);
+		__m128 ex = _mm_loadu_ps(in.ExtentX + i), ey = _mm_loadu_ps(in.ExtentY + i), ez = _mm_loadu_ps(in.ExtentZ + i);
+		__m128 r = _mm_loadu_ps(in.Radius + i);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < 6; ++p) {
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)), _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)), _mm_add_ps(_mm_mul_ps(absZ[p], ez), r));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; ++lane) {
+			visible[count] = (unsigned int)(i + lane);
+			count += (mask >> lane) & 1;
+		}
+	}
+
+	return count + CullScalar(frustum, in, i, end, visible + count);
+}
+
+#endif
+
+
+#ifdef CPU_X86
+
+//Compiled for AVX on its own, the build doesn't assume it. Only called when CpuFeatures reports AVX.
+CPU_TARGET("avx")
+static size_t CullAVX(const Frustum& frustum, const CullingInput& in, size_t begin, size_t end, unsigned int* visible) {
+
+	__m256 planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+	for (int p = 0; p < 6; ++p) {
+		planeX[p] = _mm256_set1_ps(frustum.Planes[p].x);
+		planeY[p] = _mm256_set1_ps(frustum.Planes[p].y);
+		planeZ[p] = _mm256_set1_ps(frustum.Planes[p].z);
+		planeW[p] = _mm256_set1_ps(frustum.Planes[p].w);
+		absX[p] = _mm256_set1_ps(std::fabs(frustum.Planes[p].x));
+		absY[p] = _mm256_set1_ps(std::fabs(frustum.Planes[p].y));
+		absZ[p] = _mm256_set1_ps(std::fabs(frustum.Planes[p].z));
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+	size_t count = 0;
+	size_t i = begin;
+
+	for (; i + 8 <= end; i += 8) {
+		__m256 cx = _mm256_loadu_ps(in.CenterX + i), cy = _mm256_loadu_ps(in.CenterY + i), cz = _mm256_loadu_ps(in.CenterZ + i);
+		__m256 ex = _mm256_loadu_ps(in.ExtentX + i), ey = _mm256_loadu_ps(in.ExtentY + i), ez = _mm256_loadu_ps(in.ExtentZ + i);
+		__m256 r = _mm256_loadu_ps(in.Radius + i);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int p = 0; p < 6; ++p) {
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], cx), _mm256_mul_ps(planeY[p], cy)), _mm256_add_ps(_mm256_mul_ps(planeZ[p], cz), planeW[p]));
+			__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absX[p], ex), _mm256_mul_ps(absY[p], ey)), _mm256_add_ps(_mm256_mul_ps(absZ[p], ez), r));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(inside);
+		for (int lane = 0; lane < 8; ++lane) {
+			visible[count] = (unsigned int)(i + lane);
+			count += (mask >> lane) & 1;
+		}
+	}
+
+	return count + CullScalar(frustum, in, i, end, visible + count);
+}
+
+#endif
+
+
+bool FrustumCuller::IsSupported(CullingKernel kernel) {
+	switch (kernel) {
+	case CullingKernel::Scalar:	return true;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	case CullingKernel::SSE:	return true;
+#endif
+#ifdef CPU_X86
+	case CullingKernel::AVX:	return CpuFeatures::HasAVX();
+#endif
+	default:					return false;
+	}
+}
+
+
+size_t FrustumCuller::CullRange(const Frustum& frustum, const BoundingVolumes& volumes, size_t begin, size_t end,
+	unsigned int* visible, CullingKernel kernel) {
+
+	CullingInput in = {
+		volumes.m_CenterX.data(), volumes.m_CenterY.data(), volumes.m_CenterZ.data(),
+		volumes.m_ExtentX.data(), volumes.m_ExtentY.data(), volumes.m_ExtentZ.data(),
+		volumes.m_Radius.data()
+	};
+
+#ifdef CPU_X86
+	if (kernel == CullingKernel::AVX && CpuFeatures::HasAVX())
+		return CullAVX(frustum, in, begin, end, visible);
+#endif
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	if (kernel != CullingKernel::Scalar)
+		return CullSSE(frustum, in, begin, end, visible);
+#endif
+	return CullScalar(frustum, in, begin, end, visible);
+}
+
+
+//Room for the lanes the branchless compaction writes past the end
+static const size_t s_CullingSlack = 8;
+
+
+void FrustumCuller::Cull(const Frustum& frustum, const BoundingVolumes& volumes, std::vector<unsigned int>& visible, CullingKernel kernel) {
+
+	size_t count = volumes.GetCount();
+	visible.resize(count + s_CullingSlack);
+	visible.resize(CullRange(frustum, volumes, 0, count, visible.data(), kernel));
+}
+
+
+void FrustumCuller::CullParallel(const Frustum& frustum, const BoundingVolumes& volumes, std::vector<unsigned int>& visible, CullingKernel kernel) {
+
+	const size_t batchSize = 16384;
+	size_t count = volumes.GetCount();
+	size_t batches = (count + batchSize - 1) / batchSize;
+
+	//Every batch writes into its own slice of the output, the slices get packed together afterwards
+	visible.resize(count + batches * s_CullingSlack);
+	std::vector<size_t> visibleCounts(batches);
+
+	JobSystem::Get().ParallelFor(count, batchSize, [&](size_t begin, size_t end) {
+		size_t batch = begin / batchSize;
+		visibleCounts[batch] = CullRange(frustum, volumes, begin, end, visible.data() + begin + batch * s_CullingSlack, kernel);
+	});
+
+	size_t written = 0;
+	for (size_t batch = 0; batch < batches; ++batch) {
+		const unsigned int* source = visible.data() + batch * (batchSize + s_CullingSlack);
+		memmove(visible.data() + written, source, visibleCounts[batch] * sizeof(unsigned int));
+		written += visibleCounts[batch];
+	}
+	visible.resize(written);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+
+//Six planes (left, right, bottom, top, near, far) as (normal, distance), normals point inside
+struct Frustum {
+	glm::vec4 Planes[6];
+
+	//Gribb/Hartmann extraction from projection * view (OpenGL clip space, -w <= z <= w)
+	static Frustum FromMatrix(const glm::mat4& viewProjection);
+};
+
+
+//Bounding volumes stored as structure of arrays, so the culling kernels can test 4/8 objects per instruction
+//Boxes and spheres share the arrays: a box has radius 0, a sphere has zero extents
+class BoundingVolumes {
+public:
+	unsigned int AddBox(const glm::vec3& min, const glm::vec3& max);
+	unsigned int AddSphere(const glm::vec3& center, float radius);
+
+	void SetBox(unsigned int index, const glm::vec3& min, const glm::vec3& max);
+	void SetSphere(unsigned int index, const glm::vec3& center, float radius);
+
+	void Clear();
+	void Reserve(size_t count);
+
+	inline size_t GetCount() const { return m_CenterX.size(); }
+
+private:
+	friend class FrustumCuller;
+
+	std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+	std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+	std::vector<float> m_Radius;
+};
+
+
+enum class CullingKernel {
+	Scalar, SSE, AVX
+};
+
+
+class FrustumCuller {
+public:
+	//Writes the indices of all volumes that intersect the frustum into visible, in ascending order
+	static void Cull(const Frustum& frustum, const BoundingVolumes& volumes, std::vector<unsigned int>& visible,
+		CullingKernel kernel = CullingKernel::AVX);
+
+	//Same, split into batches across the JobSystem
+	static void CullParallel(const Frustum& frustum, const BoundingVolumes& volumes, std::vector<unsigned int>& visible,
+		CullingKernel kernel = CullingKernel::AVX);
+
+	//AVX is picked at runtime and falls back to SSE on CPUs without it, SSE falls back to scalar when glm didn't enable it
+	static bool IsSupported(CullingKernel kernel);
+
+private:
+	static size_t CullRange(const Frustum& frustum, const BoundingVolumes& volumes, size_t begin, size_t end,
+		unsigned int* visible, CullingKernel kernel);
+};
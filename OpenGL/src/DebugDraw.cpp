@@ -0,0 +1,394 @@
+#include "DebugDraw.h"
+
+#include "Font.h"
+#include "FramePacer.h"
+#include "TextRenderer.h"
+#include "VertexBufferLayout.h"
+
+#include "glm/gtc/constants.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+static void PackColor(const glm::vec4& color, unsigned char* packed)
+{
+	for (int i = 0; i < 4; ++i)
+		packed[i] = (unsigned char)(glm::clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+
+DebugDraw::DebugDraw()
+	: m_Time(0.0), m_LastRender(std::chrono::steady_clock::now()), m_Rendered(false), m_LineCount(0), m_TriangleCount(0),
+	  m_UploadSize(0), m_DrawCalls(0)
+{
+	for (Stream& stream : m_Streams)
+		stream.Count = 0;
+}
+
+
+DebugDraw::~DebugDraw()
+{
+
+}
+
+
+DebugDraw& DebugDraw::Get() {
+	static DebugDraw s_Instance;
+	return s_Instance;
+}
+
+
+DebugDraw::DebugVertex* DebugDraw::Append(StreamIndex index, size_t count, float lifetime)
+{
+	Stream& stream = m_Streams[index];
+
+	if (lifetime <= 0.0f) {
+		if (stream.Count + count > stream.Vertices.size())
+			stream.Vertices.resize(std::max(stream.Count + count, stream.Vertices.size() * 2));
+		DebugVertex* vertices = &stream.Vertices[stream.Count];
+		stream.Count += count;
+		return vertices;
+	}
+
+	//Shapes added in the same frame with the same lifetime share one range
+	double expiresAt = m_Time + lifetime;
+	if (!stream.Ranges.empty() && stream.Ranges.back().ExpiresAt == expiresAt)
+		stream.Ranges.back().Count += count;
+	else
+		stream.Ranges.push_back({ count, expiresAt });
+
+	size_t offset = stream.Persistent.size();
+	stream.Persistent.resize(offset + count);
+	return &stream.Persistent[offset];
+}
+
+
+void DebugDraw::Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, float lifetime, bool depthTest)
+{
+	DebugVertex* vertices = Append(GetLineStream(depthTest), 2, lifetime);
+	vertices[0].Position = from;
+	vertices[1].Position = to;
+	PackColor(color, vertices[0].Color);
+	memcpy(vertices[1].Color, vertices[0].Color, 4);
+}
+
+
+void DebugDraw::Lines(const glm::vec3* points, size_t count, const glm::vec4& color, float lifetime, bool depthTest)
+{
+	count &= ~(size_t)1;
+	if (count == 0)
+		return;
+
+	unsigned char packed[4];
+	PackColor(color, packed);
+
+	DebugVertex* vertices = Append(GetLineStream(depthTest), count, lifetime);
+	for (size_t i = 0; i < count; ++i) {
+		vertices[i].Position = points[i];
+		memcpy(vertices[i].Color, packed, 4);
+	}
+}
+
+
+void DebugDraw::Box(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color, float lifetime, bool depthTest)
+{
+	//Corner i has bit 0 = x, bit 1 = y, bit 2 = z of max
+	glm::vec3 corners[8];
+	for (int i = 0; i < 8; ++i)
+		corners[i] = glm::vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+
+	static const int s_Edges[24] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 2, 1, 3, 4, 6, 5, 7, 0, 4, 1, 5, 2, 6, 3, 7 };
+	glm::vec3 points[24];
+	for (int i = 0; i < 24; ++i)
+		points[i] = corners[s_Edges[i]];
+	Lines(points, 24, color, lifetime, depthTest);
+}
+
+
+void DebugDraw::Circle(const glm::vec3& center, const glm::vec3& normal, float radius, const glm::vec4& color, float lifetime,
+	bool depthTest, int segments)
+{
+	segments = std::max(segments, 3);
+
+	//Two axes spanning the plane of the circle
+	glm::vec3 n = glm::normalize(normal);
+	glm::vec3 u = glm::normalize(glm::cross(n, std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f))) * radius;
+	glm::vec3 v = glm::cross(n, u);
+
+	unsigned char packed[4];
+	PackColor(color, packed);
+
+	DebugVertex* vertices = Append(GetLineStream(depthTest), (size_t)segments * 2, lifetime);
+	glm::vec3 previous = center + u;
+	for (int i = 1; i <= segments; ++i) {
+		float angle = glm::two_pi<float>() * i / segments;
+		glm::vec3 point = center + u * std::cos(angle) + v * std::sin(angle);
+		vertices[0].Position = previous;
+		vertices[1].Position = point;
+		memcpy(vertices[0].Color, packed, 4);
+		memcpy(vertices[1].Color, packed, 4);
+		vertices += 2;
+		previous = point;
+	}
+}
+
+
+void DebugDraw::Sphere(const glm::vec3& center, float radius, const glm::vec4& color, float lifetime, bool depthTest)
+{
+	Circle(center, glm::vec3(1.0f, 0.0f, 0.0f), radius, color, lifetime, depthTest);
+	Circle(center, glm::vec3(0.0f, 1.0f, 0.0f), radius, color, lifetime, depthTest);
+	Circle(center, glm::vec3(0.0f, 0.0f, 1.0f), radius, color, lifetime, depthTest);
+}
+
+
+void DebugDraw::Frustum(const glm::mat4& inverseViewProjection, const glm::vec4& color, float lifetime, bool depthTest)
+{
+	//Same corner order as Box, from the clip space cube
+	glm::vec3 corners[8];
+	for (int i = 0; i < 8; ++i) {
+		glm::vec4 corner = inverseViewProjection * glm::vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f, 1.0f);
+		corners[i] = glm::vec3(corner) / corner.w;
+	}
+
+	static const int s_Edges[24] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 2, 1, 3, 4, 6, 5, 7, 0, 4, 1, 5, 2, 6, 3, 7 };
+	glm::vec3 points[24];
+	for (int i = 0; i < 24; ++i)
+		points[i] = corners[s_Edges[i]];
+	Lines(points, 24, color, lifetime, depthTest);
+}
+
+
+void DebugDraw::Axes(const glm::mat4& transform, float size, float lifetime, bool depthTest)
+{
+	glm::vec3 origin(transform[3]);
+	for (int axis = 0; axis < 3; ++axis) {
+		glm::vec4 color(0.0f, 0.0f, 0.0f, 1.0f);
+		color[axis] = 1.0f;
+		Line(origin, origin + glm::vec3(transform[axis]) * size, color, lifetime, depthTest);
+	}
+}
+
+
+void DebugDraw::Cross(const glm::vec3& position, float size, const glm::vec4& color, float lifetime, bool depthTest)
+{
+	float half = size * 0.5f;
+	glm::vec3 points[6] = {
+		position - glm::vec3(half, 0.0f, 0.0f), position + glm::vec3(half, 0.0f, 0.0f),
+		position - glm::vec3(0.0f, half, 0.0f), position + glm::vec3(0.0f, half, 0.0f),
+		position - glm::vec3(0.0f, 0.0f, half), position + glm::vec3(0.0f, 0.0f, half)
+	};
+	Lines(points, 6, color, lifetime, depthTest);
+}
+
+
+void DebugDraw::Triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec4& color, float lifetime, bool depthTest)
+{
+	DebugVertex* vertices = Append(depthTest ? TrianglesDepth : TrianglesOverlay, 3, lifetime);
+	vertices[0].Position = a;
+	vertices[1].Position = b;
+	vertices[2].Position = c;
+	PackColor(color, vertices[0].Color);
+	memcpy(vertices[1].Color, vertices[0].Color, 4);
+	memcpy(vertices[2].Color, vertices[0].Color, 4);
+}
+
+
+void DebugDraw::Text(const glm::vec3& position, const std::string& text, const glm::vec4& color, float size, float lifetime)
+{
+	m_Text.push_back({ position, text, color, size, lifetime > 0.0f ? m_Time + lifetime : 0.0 });
+}
+
+
+void DebugDraw::RemoveExpired()
+{
+	for (Stream& stream : m_Streams) {
+		//Compacts the ranges that are still alive to the front, they stay in the order they were added
+		size_t read = 0, write = 0;
+		size_t ranges = 0;
+		for (const PersistentRange& range : stream.Ranges) {
+			if (range.ExpiresAt > m_Time) {
+				if (read != write)
+					std::copy(stream.Persistent.begin() + read, stream.Persistent.begin() + read + range.Count, stream.Persistent.begin() + write);
+				write += range.Count;
+				stream.Ranges[ranges++] = range;
+			}
+			read += range.Count;
+		}
+		stream.Persistent.resize(write);
+		stream.Ranges.resize(ranges);
+	}
+
+	m_Text.erase(std::remove_if(m_Text.begin(), m_Text.end(), [this](const TextMarker& marker) {
+		return marker.ExpiresAt > 0.0 && marker.ExpiresAt <= m_Time;
+	}), m_Text.end());
+}
+
+
+void DebugDraw::Render(const glm::mat4& viewProjection)
+{
+	static constexpr auto s_DebugVertexLayout = MakeVertexLayout<DebugVertex>(
+		VERTEX_ATTRIB(DebugVertex, Position),
+		VERTEX_ATTRIB(DebugVertex, Color)
+	);
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	m_Time += std::chrono::duration<double>(now - m_LastRender).count();
+	m_LastRender = now;
+	m_Rendered = true;
+
+	if (!m_VAO) {
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/Debug.shader");
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(nullptr, 0, true);
+		m_VAO->AddBuffer(*m_VBO, s_DebugVertexLayout);
+	}
+
+	size_t first[StreamCount], total = 0;
+	for (int i = 0; i < StreamCount; ++i) {
+		first[i] = total;
+		total += m_Streams[i].Count + m_Streams[i].Persistent.size();
+	}
+	m_LineCount = (first[TrianglesDepth] - first[LinesDepth]) / 2;
+	m_TriangleCount = (total - first[TrianglesDepth]) / 3;
+	m_UploadSize = total * sizeof(DebugVertex);
+	m_DrawCalls = 0;
+
+	if (total > 0) {
+		//Fresh storage every frame, so the upload never waits for last frame's draws
+		m_VBO->Bind();
+		GLCall(glBufferData(GL_ARRAY_BUFFER, m_UploadSize, nullptr, GL_STREAM_DRAW));
+		for (int i = 0; i < StreamCount; ++i) {
+			const Stream& stream = m_Streams[i];
+			size_t offset = first[i] * sizeof(DebugVertex);
+			if (stream.Count)
+				m_VBO->SetData(stream.Vertices.data(), (unsigned int)(stream.Count * sizeof(DebugVertex)), (unsigned int)offset);
+			if (!stream.Persistent.empty())
+				m_VBO->SetData(stream.Persistent.data(), (unsigned int)(stream.Persistent.size() * sizeof(DebugVertex)),
+					(unsigned int)(offset + stream.Count * sizeof(DebugVertex)));
+		}
+
+		GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+		GLint depthFunc;
+		GLCall(glGetIntegerv(GL_DEPTH_FUNC, &depthFunc));
+		//Lines lying on a surface would fight with it under GL_LESS
+		GLCall(glDepthFunc(GL_LEQUAL));
+
+		m_Shader->Bind();
+		m_Shader->SetUniformMat4f("u_MVP", viewProjection);
+		m_VAO->Bind();
+
+		//Depth tested shapes first, the overlay is drawn over them, triangles before lines so the outlines stay visible
+		static const StreamIndex s_Order[StreamCount] = { TrianglesDepth, LinesDepth, TrianglesOverlay, LinesOverlay };
+		for (StreamIndex index : s_Order) {
+			size_t count = m_Streams[index].Count + m_Streams[index].Persistent.size();
+			if (count == 0)
+				continue;
+
+			if (index == TrianglesDepth || index == LinesDepth) {
+				GLCall(glEnable(GL_DEPTH_TEST));
+			}
+			else {
+				GLCall(glDisable(GL_DEPTH_TEST));
+			}
+			GLenum mode = index == LinesDepth || index == LinesOverlay ? GL_LINES : GL_TRIANGLES;
+			GLCall(glDrawArrays(mode, (GLint)first[index], (GLsizei)count));
+			++m_DrawCalls;
+		}
+
+		GLCall(glDepthFunc(depthFunc));
+		if (depthTest) {
+			GLCall(glEnable(GL_DEPTH_TEST));
+		}
+		else {
+			GLCall(glDisable(GL_DEPTH_TEST));
+		}
+	}
+
+	for (Stream& stream : m_Streams)
+		stream.Count = 0;
+
+	if (!m_Text.empty())
+		RenderText(viewProjection);
+
+	//Afterwards, so a persistent shape is drawn at least once even if its lifetime is shorter than a frame
+	RemoveExpired();
+}
+
+
+void DebugDraw::RenderText(const glm::mat4& viewProjection)
+{
+	if (!m_TextRenderer) {
+		m_Font = std::make_unique<Font>();
+		m_TextRenderer = std::make_unique<TextRenderer>(*m_Font);
+	}
+
+	GLint viewport[4];
+	GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+	glm::vec2 size((float)viewport[2], (float)viewport[3]);
+
+	GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+	GLCall(glDisable(GL_DEPTH_TEST));
+
+	m_TextRenderer->Begin(glm::ortho(0.0f, size.x, 0.0f, size.y));
+	for (const TextMarker& marker : m_Text) {
+		//Points behind the camera or outside of the screen are skipped
+		glm::vec4 clip = viewProjection * glm::vec4(marker.Position, 1.0f);
+		if (clip.w <= 0.0f || std::abs(clip.x) > clip.w || std::abs(clip.y) > clip.w)
+			continue;
+
+		glm::vec2 screen = (glm::vec2(clip) / clip.w * 0.5f + 0.5f) * size;
+		m_TextRenderer->DrawString(marker.Text, glm::round(screen), marker.Size, marker.Color);
+	}
+	m_TextRenderer->End();
+	m_DrawCalls += m_TextRenderer->GetDrawCalls();
+
+	if (depthTest) {
+		GLCall(glEnable(GL_DEPTH_TEST));
+	}
+
+	//One frame markers are done
+	m_Text.erase(std::remove_if(m_Text.begin(), m_Text.end(), [](const TextMarker& marker) { return marker.ExpiresAt == 0.0; }), m_Text.end());
+}
+
+
+void DebugDraw::EndFrame()
+{
+	if (!m_Rendered) {
+		for (Stream& stream : m_Streams)
+			stream.Count = 0;
+		m_Text.erase(std::remove_if(m_Text.begin(), m_Text.end(), [](const TextMarker& marker) { return marker.ExpiresAt == 0.0; }), m_Text.end());
+	}
+	m_Rendered = false;
+
+	bool persistent = !m_Text.empty();
+	for (const Stream& stream : m_Streams)
+		persistent |= !stream.Ranges.empty();
+	//In idle mode nothing would be drawn until they expired
+	if (persistent)
+		FramePacer::Get().RequestFrames(1);
+}
+
+
+void DebugDraw::Clear()
+{
+	for (Stream& stream : m_Streams) {
+		stream.Count = 0;
+		stream.Persistent.clear();
+		stream.Ranges.clear();
+	}
+	m_Text.clear();
+}
+
+
+void DebugDraw::Shutdown()
+{
+	Clear();
+	m_TextRenderer.reset();
+	m_Font.reset();
+	m_VAO.reset();
+	m_VBO.reset();
+	m_Shader.Reset();
+}
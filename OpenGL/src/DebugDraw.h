@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Renderer.h"
+#include "AssetManager.h"
+#include "VertexBuffer.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+class Font;
+class TextRenderer;
+
+
+//Immediate mode debug geometry: call the shape functions anywhere during the frame and Render() once with the camera
+//Shapes are appended to CPU vertex streams, one per primitive type with and without depth testing. Render() uploads all
+//streams in one buffer and draws every non-empty stream with a single glDrawArrays, so a million lines cost one upload
+//and one draw call. A lifetime above 0 keeps a shape for that many seconds, otherwise it is drawn for one frame.
+class DebugDraw {
+public:
+	static DebugDraw& Get();
+
+	DebugDraw(const DebugDraw&) = delete;
+	DebugDraw& operator=(const DebugDraw&) = delete;
+
+	void Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, float lifetime = 0.0f, bool depthTest = true);
+	//count points, every two of them form a segment
+	void Lines(const glm::vec3* points, size_t count, const glm::vec4& color, float lifetime = 0.0f, bool depthTest = true);
+	void Box(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color, float lifetime = 0.0f, bool depthTest = true);
+	void Circle(const glm::vec3& center, const glm::vec3& normal, float radius, const glm::vec4& color, float lifetime = 0.0f,
+		bool depthTest = true, int segments = 32);
+	//Three circles around the axes
+	void Sphere(const glm::vec3& center, float radius, const glm::vec4& color, float lifetime = 0.0f, bool depthTest = true);
+	//Edges of the volume a camera sees, pass its inverse view-projection
+	void Frustum(const glm::mat4& inverseViewProjection, const glm::vec4& color, float lifetime = 0.0f, bool depthTest = true);
+	//Red, green and blue lines along the x, y and z axis of the transform
+	void Axes(const glm::mat4& transform, float size, float lifetime = 0.0f, bool depthTest = true);
+	//Three crossing lines marking a point
+	void Cross(const glm::vec3& position, float size, const glm::vec4& color, float lifetime = 0.0f, bool depthTest = true);
+	void Triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec4& color, float lifetime = 0.0f,
+		bool depthTest = true);
+	//Text at the screen position of a point, size in pixels, always on top
+	void Text(const glm::vec3& position, const std::string& text, const glm::vec4& color = glm::vec4(1.0f), float size = 16.0f,
+		float lifetime = 0.0f);
+
+	//Draws everything added since the last call and the persistent shapes that are still alive
+	void Render(const glm::mat4& viewProjection);
+	//Drops the one frame shapes nobody rendered, call once per frame. Keeps the frames coming while persistent shapes are alive.
+	void EndFrame();
+	//Removes all shapes, e.g. when another test starts
+	void Clear();
+	//Releases the GL objects, has to run while the GL context still exists
+	void Shutdown();
+
+	//Of the last Render
+	inline size_t GetLineCount() const { return m_LineCount; }
+	inline size_t GetTriangleCount() const { return m_TriangleCount; }
+	inline size_t GetUploadSize() const { return m_UploadSize; }
+	inline unsigned int GetDrawCalls() const { return m_DrawCalls; }
+
+private:
+	struct DebugVertex {
+		glm::vec3 Position;
+		unsigned char Color[4];
+	};
+
+	//Consecutive persistent vertices that expire together
+	struct PersistentRange {
+		size_t Count;
+		double ExpiresAt;
+	};
+
+	struct Stream {
+		std::vector<DebugVertex> Vertices;		//Only grows, Count are in use, so a frame doesn't pay for initializing them
+		size_t Count;
+		std::vector<DebugVertex> Persistent;
+		std::vector<PersistentRange> Ranges;
+	};
+
+	struct TextMarker {
+		glm::vec3 Position;
+		std::string Text;
+		glm::vec4 Color;
+		float Size;
+		double ExpiresAt;	//0 for one frame
+	};
+
+	enum StreamIndex {
+		LinesDepth, LinesOverlay, TrianglesDepth, TrianglesOverlay, StreamCount
+	};
+
+	DebugDraw();
+	~DebugDraw();
+
+	//Space for count vertices in the frame or persistent part of a stream, the caller writes them
+	DebugVertex* Append(StreamIndex stream, size_t count, float lifetime);
+	inline static StreamIndex GetLineStream(bool depthTest) { return depthTest ? LinesDepth : LinesOverlay; }
+	void RemoveExpired();
+	void RenderText(const glm::mat4& viewProjection);
+
+private:
+	Stream m_Streams[StreamCount];
+	std::vector<TextMarker> m_Text;
+
+	//Seconds since the first Render, advanced by the wall clock in every Render
+	double m_Time;
+	std::chrono::steady_clock::time_point m_LastRender;
+	bool m_Rendered;
+
+	AssetRef<Shader> m_Shader;
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VBO;
+	std::unique_ptr<Font> m_Font;
+	std::unique_ptr<TextRenderer> m_TextRenderer;
+
+	size_t m_LineCount, m_TriangleCount;
+	size_t m_UploadSize;
+	unsigned int m_DrawCalls;
+};
@@ -0,0 +1,208 @@
+#include "Ecs.h"
+
+#include "Renderer.h"
+
+#include <iostream>
+#include <new>
+
+
+static std::vector<ComponentInfo>& GetComponentInfos() {
+	static std::vector<ComponentInfo> s_Infos;
+	return s_Infos;
+}
+
+
+uint32_t ComponentRegistry::Register(size_t size, size_t alignment) {
+
+	std::vector<ComponentInfo>& infos = GetComponentInfos();
+	//Any id handed out past the limit would alias the column and signature bit of another type
+	if (infos.size() >= MaxTypes)
+		std::cout << "[ECS] More than " << MaxTypes << " component types registered" << std::endl;
+	ASSERT(infos.size() < MaxTypes);
+
+	infos.push_back({ size, alignment });
+	return (uint32_t)infos.size() - 1;
+}
+
+
+const ComponentInfo& ComponentRegistry::GetInfo(uint32_t id) {
+	return GetComponentInfos()[id];
+}
+
+
+Archetype::Archetype(uint64_t mask)
+	: m_Mask(mask), m_Capacity(0)
+{
+	m_Offsets.fill(0);
+
+	size_t rowSize = sizeof(Entity);
+	for (uint32_t id = 0; id < ComponentRegistry::MaxTypes; ++id) {
+		if (mask & (1ull << id)) {
+			m_ComponentIds.push_back(id);
+			rowSize += ComponentRegistry::GetInfo(id).Size;
+		}
+	}
+
+	//Entity array first, then one array per component, each starting on its own cache line
+	size_t padding = ChunkAlignment * (m_ComponentIds.size() + 1);
+	m_Capacity = (uint32_t)((ChunkSize - padding) / rowSize);
+
+	size_t offset = m_Capacity * sizeof(Entity);
+	for (uint32_t id : m_ComponentIds) {
+		offset = (offset + ChunkAlignment - 1) & ~(ChunkAlignment - 1);
+		m_Offsets[id] = (uint32_t)offset;
+		offset += m_Capacity * ComponentRegistry::GetInfo(id).Size;
+	}
+}
+
+
+Archetype::~Archetype() {
+	for (Chunk& chunk : m_Chunks)
+		::operator delete(chunk.Data, std::align_val_t(ChunkAlignment));
+}
+
+
+std::pair<uint32_t, uint32_t> Archetype::AllocateRow(Entity entity) {
+
+	if (m_Chunks.empty() || m_Chunks.back().Count == m_Capacity)
+		m_Chunks.push_back({ (uint8_t*)::operator new(ChunkSize, std::align_val_t(ChunkAlignment)), 0 });
+
+	uint32_t chunk = (uint32_t)m_Chunks.size() - 1;
+	uint32_t row = m_Chunks[chunk].Count++;
+	GetEntities(chunk)[row] = entity;
+	return { chunk, row };
+}
+
+
+Entity Archetype::RemoveRow(uint32_t chunk, uint32_t row) {
+
+	//Only the last chunk is ever partially filled
+	uint32_t lastChunk = (uint32_t)m_Chunks.size() - 1;
+	uint32_t lastRow = m_Chunks[lastChunk].Count - 1;
+
+	Entity moved = s_NullEntity;
+	if (chunk != lastChunk || row != lastRow) {
+		moved = GetEntities(lastChunk)[lastRow];
+		GetEntities(chunk)[row] = moved;
+		for (uint32_t id : m_ComponentIds)
+			memcpy(GetComponent(id, chunk, row), GetComponent(id, lastChunk, lastRow), ComponentRegistry::GetInfo(id).Size);
+	}
+
+	if (--m_Chunks[lastChunk].Count == 0) {
+		::operator delete(m_Chunks[lastChunk].Data, std::align_val_t(ChunkAlignment));
+		m_Chunks.pop_back();
+	}
+	return moved;
+}
+
+
+World::World()
+	: m_EntityCount(0)
+{
+}
+
+
+World::~World() {
+}
+
+
+Archetype& World::GetArchetype(uint64_t mask) {
+
+	auto it = m_ArchetypeLookup.find(mask);
+	if (it != m_ArchetypeLookup.end())
+		return *it->second;
+
+	m_Archetypes.push_back(std::make_unique<Archetype>(mask));
+	m_ArchetypeLookup[mask] = m_Archetypes.back().get();
+	return *m_Archetypes.back();
+}
+
+
+Entity World::AllocateEntity() {
+
+	m_EntityCount++;
+	if (!m_FreeIndices.empty()) {
+		uint32_t index = m_FreeIndices.back();
+		m_FreeIndices.pop_back();
+		return { index, m_Records[index].Generation };
+	}
+
+	m_Records.push_back({ nullptr, 0, 0, 0 });
+	return { (uint32_t)m_Records.size() - 1, 0 };
+}
+
+
+void World::RemoveFromArchetype(const Record& record) {
+	Entity moved = record.Owner->RemoveRow(record.Chunk, record.Row);
+	if (moved != s_NullEntity) {
+		m_Records[moved.Index].Chunk = record.Chunk;
+		m_Records[moved.Index].Row = record.Row;
+	}
+}
+
+
+bool World::IsAlive(Entity entity) const {
+	return entity.Index < m_Records.size() && m_Records[entity.Index].Owner && m_Records[entity.Index].Generation == entity.Generation;
+}
+
+
+void World::Destroy(Entity entity) {
+
+	if (!IsAlive(entity)) {
+		std::cout << "[ECS] Destroying entity " << entity.Index << " which is already dead" << std::endl;
+		return;
+	}
+
+	Record& record = m_Records[entity.Index];
+	RemoveFromArchetype(record);
+	record.Owner = nullptr;
+	record.Generation++;
+	m_FreeIndices.push_back(entity.Index);
+	m_EntityCount--;
+}
+
+
+void World::Clear() {
+	m_Archetypes.clear();
+	m_ArchetypeLookup.clear();
+
+	//The records stay so the generations keep counting, handles from before the Clear must not match new entities
+	m_FreeIndices.clear();
+	for (size_t i = m_Records.size(); i-- > 0;) {
+		m_Records[i].Owner = nullptr;
+		m_Records[i].Generation++;
+		m_FreeIndices.push_back((uint32_t)i);
+	}
+	m_EntityCount = 0;
+}
+
+
+bool World::CheckAlive(Entity entity, const char* action) const {
+	if (IsAlive(entity))
+		return true;
+	std::cout << "[ECS] " << action << " entity " << entity.Index << " which is dead" << std::endl;
+	return false;
+}
+
+
+const World::Record& World::MoveEntity(Entity entity, uint64_t mask) {
+
+	Record& record = m_Records[entity.Index];
+	if (record.Owner->GetMask() == mask)
+		return record;
+
+	Archetype& target = GetArchetype(mask);
+	std::pair<uint32_t, uint32_t> location = target.AllocateRow(entity);
+
+	//Components both archetypes have are copied over, added ones are left for the caller to fill
+	for (uint32_t id : target.GetComponentIds()) {
+		if (record.Owner->GetMask() & (1ull << id))
+			memcpy(target.GetComponent(id, location.first, location.second), record.Owner->GetComponent(id, record.Chunk, record.Row), ComponentRegistry::GetInfo(id).Size);
+	}
+
+	RemoveFromArchetype(record);
+	record.Owner = &target;
+	record.Chunk = location.first;
+	record.Row = location.second;
+	return record;
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "JobSystem.h"
+
+
+//Archetype based entity component system
+//Entities with the same set of components share an Archetype, which stores every component in its own
+//contiguous array inside fixed size, cache line aligned chunks, so queries walk memory linearly
+
+
+struct Entity {
+	uint32_t Index;
+	uint32_t Generation;
+
+	inline bool operator==(const Entity& other) const { return Index == other.Index && Generation == other.Generation; }
+	inline bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+static const Entity s_NullEntity = { 0xFFFFFFFF, 0 };
+
+
+struct ComponentInfo {
+	size_t Size;
+	size_t Alignment;
+};
+
+//Hands out a bit per component type, registering more than MaxTypes of them is a fatal error
+class ComponentRegistry {
+public:
+	static const uint32_t MaxTypes = 64;
+
+	//Components are moved between chunks with memcpy, so they have to be plain data
+	template<typename T>
+	static uint32_t GetId() {
+		static_assert(std::is_trivially_copyable<T>::value, "Components have to be trivially copyable");
+		static const uint32_t s_Id = Register(sizeof(T), alignof(T));
+		return s_Id;
+	}
+
+	static const ComponentInfo& GetInfo(uint32_t id);
+
+private:
+	static uint32_t Register(size_t size, size_t alignment);
+};
+
+
+class Archetype {
+public:
+	static const size_t ChunkSize = 16 * 1024;
+	static const size_t ChunkAlignment = 64;
+
+	Archetype(uint64_t mask);
+	~Archetype();
+
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	inline uint64_t GetMask() const { return m_Mask; }
+	inline const std::vector<uint32_t>& GetComponentIds() const { return m_ComponentIds; }
+	inline size_t GetChunkCount() const { return m_Chunks.size(); }
+	inline size_t GetChunkEntityCount(size_t chunk) const { return m_Chunks[chunk].Count; }
+	inline uint32_t GetCapacity() const { return m_Capacity; }
+
+	inline Entity* GetEntities(size_t chunk) { return (Entity*)m_Chunks[chunk].Data; }
+	inline void* GetComponents(uint32_t id, size_t chunk) { return m_Chunks[chunk].Data + m_Offsets[id]; }
+	template<typename T>
+	inline T* GetComponents(size_t chunk) { return (T*)GetComponents(ComponentRegistry::GetId<T>(), chunk); }
+
+	inline void* GetComponent(uint32_t id, uint32_t chunk, uint32_t row) {
+		return m_Chunks[chunk].Data + m_Offsets[id] + row * ComponentRegistry::GetInfo(id).Size;
+	}
+
+	//Appends an entity with uninitialized components, returns its chunk and row
+	std::pair<uint32_t, uint32_t> AllocateRow(Entity entity);
+	//Fills the hole with the last entity of the archetype and returns it, or s_NullEntity if the removed one was last
+	Entity RemoveRow(uint32_t chunk, uint32_t row);
+
+private:
+	struct Chunk {
+		uint8_t* Data;
+		uint32_t Count;
+	};
+
+	uint64_t m_Mask;
+	std::vector<uint32_t> m_ComponentIds;
+	std::array<uint32_t, ComponentRegistry::MaxTypes> m_Offsets;
+	uint32_t m_Capacity;
+	std::vector<Chunk> m_Chunks;
+};
+
+
+class World {
+public:
+	World();
+	~World();
+
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	template<typename... Ts>
+	Entity Create(const Ts&... components) {
+		Archetype& archetype = GetArchetype(GetMask<Ts...>());
+		Entity entity = AllocateEntity();
+		Record& record = m_Records[entity.Index];
+		record.Owner = &archetype;
+		std::tie(record.Chunk, record.Row) = archetype.AllocateRow(entity);
+		(memcpy(archetype.GetComponent(ComponentRegistry::GetId<Ts>(), record.Chunk, record.Row), &components, sizeof(Ts)), ...);
+		return entity;
+	}
+
+	void Destroy(Entity entity);
+	bool IsAlive(Entity entity) const;
+	void Clear();
+
+	//nullptr if the entity doesn't have the component or is dead, pointers are invalidated by Create/Destroy/Add/Remove
+	template<typename T>
+	T* Get(Entity entity) {
+		if (!IsAlive(entity))
+			return nullptr;
+		const Record& record = m_Records[entity.Index];
+		uint32_t id = ComponentRegistry::GetId<T>();
+		if (!(record.Owner->GetMask() & (1ull << id)))
+			return nullptr;
+		return (T*)record.Owner->GetComponent(id, record.Chunk, record.Row);
+	}
+
+	template<typename T>
+	bool Has(Entity entity) const { return IsAlive(entity) && (m_Records[entity.Index].Owner->GetMask() & GetMask<T>()) != 0; }
+
+	//Adding and removing components moves the entity to another archetype, dead entities are reported and ignored
+	template<typename T>
+	void Add(Entity entity, const T& component) {
+		if (!CheckAlive(entity, "Adding a component to"))
+			return;
+		const Record& record = MoveEntity(entity, m_Records[entity.Index].Owner->GetMask() | GetMask<T>());
+		memcpy(record.Owner->GetComponent(ComponentRegistry::GetId<T>(), record.Chunk, record.Row), &component, sizeof(T));
+	}
+
+	template<typename T>
+	void Remove(Entity entity) {
+		if (!CheckAlive(entity, "Removing a component from"))
+			return;
+		MoveEntity(entity, m_Records[entity.Index].Owner->GetMask() & ~GetMask<T>());
+	}
+
+	//func(size_t count, Ts*... components) once per chunk of every archetype that has all of Ts
+	template<typename... Ts, typename Func>
+	void EachChunk(Func&& func) {
+		uint64_t mask = GetMask<Ts...>();
+		for (const std::unique_ptr<Archetype>& archetype : m_Archetypes) {
+			if ((archetype->GetMask() & mask) != mask)
+				continue;
+			for (size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+				func(archetype->GetChunkEntityCount(chunk), archetype->template GetComponents<Ts>(chunk)...);
+		}
+	}
+
+	//func(Ts&... components) for every entity that has all of Ts
+	template<typename... Ts, typename Func>
+	void Each(Func&& func) {
+		EachChunk<Ts...>([&func](size_t count, Ts*... components) {
+			for (size_t i = 0; i < count; ++i)
+				func(components[i]...);
+		});
+	}
+
+	//Same as Each, chunks are spread across the JobSystem so func must not touch shared state
+	template<typename... Ts, typename Func>
+	void ParallelEach(Func&& func) {
+		uint64_t mask = GetMask<Ts...>();
+		std::vector<std::pair<Archetype*, size_t>> chunks;
+		for (const std::unique_ptr<Archetype>& archetype : m_Archetypes) {
+			if ((archetype->GetMask() & mask) != mask)
+				continue;
+			for (size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+				chunks.emplace_back(archetype.get(), chunk);
+		}
+
+		JobSystem::Get().ParallelFor(chunks.size(), 8, [&](size_t begin, size_t end) {
+			for (size_t c = begin; c < end; ++c) {
+				Archetype* archetype = chunks[c].first;
+				size_t chunk = chunks[c].second;
+				size_t count = archetype->GetChunkEntityCount(chunk);
+				std::tuple<Ts*...> components(archetype->template GetComponents<Ts>(chunk)...);
+				for (size_t i = 0; i < count; ++i)
+					func(std::get<Ts*>(components)[i]...);
+			}
+		});
+	}
+
+	inline size_t GetEntityCount() const { return m_EntityCount; }
+	inline size_t GetArchetypeCount() const { return m_Archetypes.size(); }
+
+private:
+	struct Record {
+		Archetype* Owner;
+		uint32_t Chunk;
+		uint32_t Row;
+		uint32_t Generation;
+	};
+
+	template<typename... Ts>
+	static uint64_t GetMask() {
+		return (0ull | ... | (1ull << ComponentRegistry::GetId<Ts>()));
+	}
+
+	Archetype& GetArchetype(uint64_t mask);
+	Entity AllocateEntity();
+	void RemoveFromArchetype(const Record& record);
+	const Record& MoveEntity(Entity entity, uint64_t mask);
+	//Prints what was attempted on a dead entity
+	bool CheckAlive(Entity entity, const char* action) const;
+
+private:
+	std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+	std::unordered_map<uint64_t, Archetype*> m_ArchetypeLookup;
+	std::vector<Record> m_Records;
+	std::vector<uint32_t> m_FreeIndices;
+	size_t m_EntityCount;
+};
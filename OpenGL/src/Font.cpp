@@ -0,0 +1,340 @@
+#include "Font.h"
+
+//ImGui compiles its own copy of stb_truetype with STBTT_STATIC, its functions are local to imgui_draw.cpp so this one doesn't clash with it
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imgui/stb_truetype.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+
+//Value of the distance field on the outline, inside is above
+static const unsigned char s_OnEdgeValue = 128;
+
+
+//Returns the next codepoint and advances text, broken sequences become U+FFFD
+static uint32_t DecodeUtf8(const unsigned char*& text, const unsigned char* end)
+{
+	uint32_t c = *text++;
+	if (c < 0x80)
+		return c;
+
+	int length = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+	if (length == 0 || end - text < length)
+		return 0xFFFD;
+
+	c &= 0x3F >> length;
+	for (int i = 0; i < length; ++i) {
+		if ((*text & 0xC0) != 0x80)
+			return 0xFFFD;
+		c = (c << 6) | (*text++ & 0x3F);
+	}
+	return c;
+}
+
+
+Font::Font(int atlasSize)
+	: m_Info(std::make_unique<stbtt_fontinfo>()), m_Loaded(false)
+{
+	ImFontAtlas* fonts = ImGui::GetIO().Fonts;
+	if (fonts->ConfigData.Size > 0 && fonts->ConfigData[0].FontData) {
+		const unsigned char* data = (const unsigned char*)fonts->ConfigData[0].FontData;
+		m_FontData.assign(data, data + fonts->ConfigData[0].FontDataSize);
+	}
+	else {
+		std::cout << "[Font] ImGui has no font data\n";
+	}
+	Init(atlasSize);
+}
+
+
+Font::Font(const std::string& path, int atlasSize)
+	: m_Info(std::make_unique<stbtt_fontinfo>()), m_Loaded(false)
+{
+	std::ifstream stream(path, std::ios::binary | std::ios::ate);
+	if (stream) {
+		m_FontData.resize((size_t)stream.tellg());
+		stream.seekg(0);
+		stream.read((char*)m_FontData.data(), (std::streamsize)m_FontData.size());
+	}
+	if (!stream) {
+		std::cout << "[Font] Failed to read " << path << '\n';
+		m_FontData.clear();
+	}
+	Init(atlasSize);
+}
+
+
+Font::Font(const unsigned char* data, size_t size, int atlasSize)
+	: m_FontData(data, data + size), m_Info(std::make_unique<stbtt_fontinfo>()), m_Loaded(false)
+{
+	Init(atlasSize);
+}
+
+
+Font::~Font()
+{
+	GLCall(glDeleteTextures(1, &m_AtlasID));
+}
+
+
+void Font::Init(int atlasSize)
+{
+	m_Scale = 0.0f;
+	m_Ascent = m_Descent = m_LineGap = 0.0f;
+	m_AtlasSize = atlasSize;
+	m_AtlasPixels.assign((size_t)atlasSize * atlasSize, 0);
+	m_DirtyMinY = 0;
+	m_DirtyMaxY = 0;
+	m_ShelfTop = 0;
+	m_EvictionAllowed = true;
+	ResetStats();
+
+	int offset = m_FontData.empty() ? -1 : stbtt_GetFontOffsetForIndex(m_FontData.data(), 0);
+	if (offset >= 0 && stbtt_InitFont(m_Info.get(), m_FontData.data(), offset)) {
+		m_Loaded = true;
+		m_Scale = stbtt_ScaleForMappingEmToPixels(m_Info.get(), (float)GlyphSize);
+
+		int ascent, descent, lineGap;
+		stbtt_GetFontVMetrics(m_Info.get(), &ascent, &descent, &lineGap);
+		m_Ascent = ascent * m_Scale / GlyphSize;
+		m_Descent = descent * m_Scale / GlyphSize;
+		m_LineGap = lineGap * m_Scale / GlyphSize;
+	}
+	else if (!m_FontData.empty()) {
+		std::cout << "[Font] Unsupported font file\n";
+	}
+
+	GLCall(glGenTextures(1, &m_AtlasID));
+	GLCall(glBindTexture(GL_TEXTURE_2D, m_AtlasID));
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_AtlasSize, m_AtlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, m_AtlasPixels.data()));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+
+const Glyph& Font::GetGlyph(uint32_t codepoint)
+{
+	++m_GlyphLookups;
+
+	auto it = m_Glyphs.find(codepoint);
+	if (it != m_Glyphs.end())
+		return it->second;
+
+	//Codepoints the font doesn't have all map to its missing glyph, which only needs to be in the atlas once
+	int index = m_Loaded ? stbtt_FindGlyphIndex(m_Info.get(), (int)codepoint) : 0;
+	auto rasterized = m_GlyphsByIndex.find(index);
+	if (rasterized != m_GlyphsByIndex.end())
+		return m_Glyphs.emplace(codepoint, rasterized->second).first->second;
+
+	++m_GlyphMisses;
+	Glyph glyph;
+	if (!Rasterize(index, glyph)) {
+		//Didn't fit and evicting wasn't allowed, not cached so it gets another chance next time
+		m_DroppedGlyph = glyph;
+		return m_DroppedGlyph;
+	}
+	//Rasterize may have cleared the maps, so the glyph is only inserted afterwards
+	m_GlyphsByIndex.emplace(index, glyph);
+	return m_Glyphs.emplace(codepoint, glyph).first->second;
+}
+
+
+bool Font::Rasterize(int index, Glyph& glyph)
+{
+	glyph = {};
+	if (!m_Loaded)
+		return true;
+
+	int advance, leftSideBearing;
+	stbtt_GetGlyphHMetrics(m_Info.get(), index, &advance, &leftSideBearing);
+	glyph.Advance = advance * m_Scale / GlyphSize;
+	glyph.Index = index;
+
+	//The falloff reaches 0 at GlyphPadding pixels outside of the outline
+	int width, height, offsetX, offsetY;
+	unsigned char* sdf = stbtt_GetGlyphSDF(m_Info.get(), m_Scale, index, GlyphPadding, s_OnEdgeValue, (float)s_OnEdgeValue / GlyphPadding,
+		&width, &height, &offsetX, &offsetY);
+	if (!sdf)
+		return true;	//Nothing to draw, e.g. a space
+
+	//One pixel of gap, so linear filtering never reads the neighbouring glyph
+	int x, y;
+	if (!Pack(width + 1, height + 1, x, y)) {
+		if (m_EvictionAllowed)
+			Evict();
+		if (!m_EvictionAllowed || !Pack(width + 1, height + 1, x, y)) {
+			stbtt_FreeSDF(sdf, nullptr);
+			return false;
+		}
+	}
+
+	for (int row = 0; row < height; ++row)
+		memcpy(&m_AtlasPixels[(size_t)(y + row) * m_AtlasSize + x], sdf + (size_t)row * width, width);
+	stbtt_FreeSDF(sdf, nullptr);
+
+	if (m_DirtyMinY >= m_DirtyMaxY) {
+		m_DirtyMinY = y;
+		m_DirtyMaxY = y + height;
+	}
+	else {
+		m_DirtyMinY = std::min(m_DirtyMinY, y);
+		m_DirtyMaxY = std::max(m_DirtyMaxY, y + height);
+	}
+
+	//The bitmap goes down from the top left corner, the quad is y up, so Min samples the bottom row of the bitmap
+	glyph.Min = glm::vec2((float)offsetX, (float)-(offsetY + height)) / (float)GlyphSize;
+	glyph.Max = glm::vec2((float)(offsetX + width), (float)-offsetY) / (float)GlyphSize;
+
+	float toTexRect = 65535.0f / m_AtlasSize;
+	glyph.TexRect[0] = (unsigned short)(x * toTexRect + 0.5f);
+	glyph.TexRect[1] = (unsigned short)((y + height) * toTexRect + 0.5f);
+	glyph.TexRect[2] = (unsigned short)((x + width) * toTexRect + 0.5f);
+	glyph.TexRect[3] = (unsigned short)(y * toTexRect + 0.5f);
+	glyph.Visible = true;
+	return true;
+}
+
+
+bool Font::Pack(int width, int height, int& x, int& y)
+{
+	if (width > m_AtlasSize || height > m_AtlasSize)
+		return false;
+
+	//Lowest shelf the glyph fits into
+	Shelf* best = nullptr;
+	for (Shelf& shelf : m_Shelves) {
+		if (shelf.Height >= height && m_AtlasSize - shelf.Width >= width && (!best || shelf.Height < best->Height))
+			best = &shelf;
+	}
+
+	//A new shelf when the best one would waste more than a quarter of its height, heights are rounded up to 4 pixels
+	//so glyphs of similar size share shelves
+	int shelfHeight = (height + 3) & ~3;
+	if ((!best || best->Height > height + height / 4) && m_ShelfTop + shelfHeight <= m_AtlasSize) {
+		m_Shelves.push_back({ m_ShelfTop, shelfHeight, 0 });
+		m_ShelfTop += shelfHeight;
+		best = &m_Shelves.back();
+	}
+
+	if (!best)
+		return false;
+
+	x = best->Width;
+	y = best->Y;
+	best->Width += width;
+	return true;
+}
+
+
+void Font::Evict()
+{
+	if (m_OnEviction)
+		m_OnEviction();
+	ClearAtlas();
+	++m_AtlasResets;
+}
+
+
+const ShapedRun& Font::Shape(const std::string& text)
+{
+	++m_RunLookups;
+
+	auto it = m_Runs.find(text);
+	if (it != m_Runs.end())
+		return it->second;
+
+	++m_RunMisses;
+	if (m_Runs.size() >= MaxCachedRuns)
+		m_Runs.clear();
+
+	ShapedRun run;
+	const unsigned char* begin = (const unsigned char*)text.data();
+	const unsigned char* end = begin + text.size();
+
+	//If the atlas gets cleared halfway through, the glyphs before have stale coordinates, so the run is shaped again.
+	//The second pass can't evict, a run that doesn't fit into an empty atlas loses the glyphs that don't fit.
+	unsigned int resets = m_AtlasResets;
+	for (int pass = 0; pass < 2; ++pass) {
+		run.Glyphs.clear();
+		run.Size = glm::vec2(0.0f, GetLineHeight());
+		m_EvictionAllowed = pass == 0;
+
+		glm::vec2 pen(0.0f);
+		int previous = -1;
+		for (const unsigned char* c = begin; c != end;) {
+			uint32_t codepoint = DecodeUtf8(c, end);
+			if (codepoint == '\n') {
+				run.Size.x = std::max(run.Size.x, pen.x);
+				run.Size.y += GetLineHeight();
+				pen = glm::vec2(0.0f, pen.y - GetLineHeight());
+				previous = -1;
+				continue;
+			}
+
+			const Glyph& glyph = GetGlyph(codepoint);
+			if (previous >= 0)
+				pen.x += stbtt_GetGlyphKernAdvance(m_Info.get(), previous, glyph.Index) * m_Scale / GlyphSize;
+			previous = glyph.Index;
+
+			if (glyph.Visible) {
+				ShapedGlyph shaped = { pen + glyph.Min, pen + glyph.Max, { glyph.TexRect[0], glyph.TexRect[1], glyph.TexRect[2], glyph.TexRect[3] } };
+				run.Glyphs.push_back(shaped);
+			}
+			pen.x += glyph.Advance;
+		}
+		run.Size.x = std::max(run.Size.x, pen.x);
+
+		if (m_AtlasResets == resets)
+			break;
+		resets = m_AtlasResets;
+	}
+	m_EvictionAllowed = true;
+
+	return m_Runs.emplace(text, std::move(run)).first->second;
+}
+
+
+void Font::BindAtlas(unsigned int slot)
+{
+	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+	GLCall(glBindTexture(GL_TEXTURE_2D, m_AtlasID));
+
+	if (m_DirtyMinY < m_DirtyMaxY) {
+		//Whole rows, so the source needs no row length and the upload is one contiguous block
+		GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+		GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_DirtyMinY, m_AtlasSize, m_DirtyMaxY - m_DirtyMinY, GL_RED, GL_UNSIGNED_BYTE,
+			&m_AtlasPixels[(size_t)m_DirtyMinY * m_AtlasSize]));
+		GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+		m_DirtyMinY = m_DirtyMaxY = 0;
+	}
+}
+
+
+void Font::ClearAtlas()
+{
+	m_Glyphs.clear();
+	m_GlyphsByIndex.clear();
+	m_Runs.clear();
+	m_Shelves.clear();
+	m_ShelfTop = 0;
+
+	//Cleared as well, otherwise old glyphs would show up in the gaps between the new ones
+	std::fill(m_AtlasPixels.begin(), m_AtlasPixels.end(), (unsigned char)0);
+	m_DirtyMinY = 0;
+	m_DirtyMaxY = m_AtlasSize;
+}
+
+
+void Font::ResetStats()
+{
+	m_GlyphLookups = m_GlyphMisses = 0;
+	m_RunLookups = m_RunMisses = 0;
+	m_AtlasResets = 0;
+}
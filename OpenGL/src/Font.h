@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+struct stbtt_fontinfo;
+
+
+//One glyph of the atlas, the quad is relative to the pen position on the baseline, in ems with y up
+struct Glyph {
+	glm::vec2 Min, Max;
+	unsigned short TexRect[4];	//Normalized atlas coordinates at the Min and Max corner
+	float Advance;
+	int Index;		//Glyph index in the font, for kerning
+	bool Visible;	//False for spaces and glyphs that didn't fit into the atlas
+};
+
+struct ShapedGlyph {
+	glm::vec2 Min, Max;		//Relative to the start of the run, in ems
+	unsigned short TexRect[4];
+};
+
+//A laid out string: kerning, advances and line breaks are already applied, invisible glyphs are left out
+struct ShapedRun {
+	std::vector<ShapedGlyph> Glyphs;
+	glm::vec2 Size;			//Width of the longest line and height of all lines, in ems
+};
+
+
+//TrueType font rendered from a signed distance field atlas
+//Glyphs are rasterized once at a fixed size with stbtt_GetGlyphSDF the first time they are used and packed into an R8
+//atlas with a shelf packer. The distance field stays sharp when it is scaled, so one atlas serves every text size.
+//Shaped runs are cached by their string, so static text costs one hash lookup per frame instead of a decode + kerning pass.
+//When the atlas is full it is cleared and refilled with the glyphs that are still used, which is counted as a reset.
+class Font {
+public:
+	//Uses the font embedded in ImGui (ProggyClean), needs an ImGui context with the default font added
+	Font(int atlasSize = 1024);
+	Font(const std::string& path, int atlasSize = 1024);
+	//The data is copied, so the caller may free it
+	Font(const unsigned char* data, size_t size, int atlasSize = 1024);
+	~Font();
+
+	Font(const Font&) = delete;
+	Font& operator=(const Font&) = delete;
+
+	inline bool IsLoaded() const { return m_Loaded; }
+
+	//Rasterizes the glyph on a miss, codepoints the font doesn't have get its missing glyph box
+	const Glyph& GetGlyph(uint32_t codepoint);
+	//text is UTF-8, '\n' starts a new line, the run stays valid until the next Shape call
+	const ShapedRun& Shape(const std::string& text);
+
+	//Uploads the glyphs rasterized since the last call and binds the atlas
+	void BindAtlas(unsigned int slot = 0);
+	//Drops all glyphs and runs, the atlas refills on demand
+	void ClearAtlas();
+
+	//Called right before the atlas is cleared because it is full, so text batched with the old glyphs can still be drawn
+	inline void SetEvictionCallback(const std::function<void()>& callback) { m_OnEviction = callback; }
+
+	//Vertical metrics in ems, the line height is ascent - descent + line gap
+	inline float GetAscent() const { return m_Ascent; }
+	inline float GetDescent() const { return m_Descent; }
+	inline float GetLineHeight() const { return m_Ascent - m_Descent + m_LineGap; }
+
+	inline int GetAtlasSize() const { return m_AtlasSize; }
+	inline unsigned int GetAtlasID() const { return m_AtlasID; }
+	//Fraction of the atlas rows taken by shelves
+	inline float GetAtlasUsage() const { return (float)m_ShelfTop / m_AtlasSize; }
+	//Glyphs in the atlas
+	inline size_t GetGlyphCount() const { return m_GlyphsByIndex.size(); }
+	inline size_t GetRunCount() const { return m_Runs.size(); }
+
+	//A miss is a glyph that had to be rasterized into the atlas
+	inline uint64_t GetGlyphLookups() const { return m_GlyphLookups; }
+	inline uint64_t GetGlyphMisses() const { return m_GlyphMisses; }
+	inline uint64_t GetRunLookups() const { return m_RunLookups; }
+	inline uint64_t GetRunMisses() const { return m_RunMisses; }
+	inline unsigned int GetAtlasResets() const { return m_AtlasResets; }
+	void ResetStats();
+
+	//Size of one em in the atlas and the distance field falloff on each side of the outline, in atlas pixels
+	static const int GlyphSize = 40;
+	static const int GlyphPadding = 5;
+	//Runs kept before the run cache is dropped, protects against text that changes every frame
+	static const size_t MaxCachedRuns = 16384;
+
+private:
+	struct Shelf {
+		int Y, Height, Width;	//Width = used part of the row
+	};
+
+	void Init(int atlasSize);
+	//False if the glyph has no space in the atlas
+	bool Rasterize(int index, Glyph& glyph);
+	void Evict();
+	//Finds space for a width x height rectangle, false if the atlas is full
+	bool Pack(int width, int height, int& x, int& y);
+
+private:
+	std::vector<unsigned char> m_FontData;
+	std::unique_ptr<stbtt_fontinfo> m_Info;
+	bool m_Loaded;
+	float m_Scale;		//Font units to atlas pixels
+	float m_Ascent, m_Descent, m_LineGap;
+
+	unsigned int m_AtlasID;
+	int m_AtlasSize;
+	std::vector<unsigned char> m_AtlasPixels;	//CPU copy, glyphs are written here and uploaded in BindAtlas
+	int m_DirtyMinY, m_DirtyMaxY;				//Rows that changed since the last upload, empty if min >= max
+	std::vector<Shelf> m_Shelves;
+	int m_ShelfTop;
+
+	std::unordered_map<uint32_t, Glyph> m_Glyphs;			//By codepoint
+	std::unordered_map<int, Glyph> m_GlyphsByIndex;			//By glyph index, what is actually in the atlas
+	Glyph m_DroppedGlyph;
+	std::unordered_map<std::string, ShapedRun> m_Runs;
+	std::function<void()> m_OnEviction;
+	bool m_EvictionAllowed;
+
+	uint64_t m_GlyphLookups, m_GlyphMisses;
+	uint64_t m_RunLookups, m_RunMisses;
+	unsigned int m_AtlasResets;
+};
@@ -0,0 +1,339 @@
+#include "FrameCapture.h"
+
+#include "ImageEncoder.h"
+#include "Timer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+
+FrameCapture::FrameCapture(unsigned int ringSize)
+	: m_Slots(ringSize < 1 ? 1 : ringSize), m_Next(0), m_Capturing(false), m_Format(CaptureFormat::PNG), m_FrameRate(60),
+	  m_VideoWidth(0), m_VideoHeight(0), m_FramesCaptured(0), m_Stalls(0), m_LastOverheadMs(0.0f), m_TotalOverheadMs(0.0),
+	  m_WriterRunning(false), m_WriterBusy(false), m_FramesWritten(0), m_TotalWriteMs(0.0)
+{
+	for (Slot& slot : m_Slots) {
+		GLCall(glGenBuffers(1, &slot.Buffer));
+		slot.Fence = nullptr;
+		slot.Capacity = 0;
+		slot.Width = slot.Height = 0;
+		slot.Index = 0;
+	}
+}
+
+
+FrameCapture::~FrameCapture() {
+
+	Stop();
+
+	for (Slot& slot : m_Slots) {
+		GLCall(glDeleteBuffers(1, &slot.Buffer));
+	}
+}
+
+
+bool FrameCapture::Start(const std::string& path, CaptureFormat format, int frameRate) {
+
+	Stop();
+
+	std::error_code error;
+	if (format == CaptureFormat::PNG) {
+		std::filesystem::create_directories(path, error);
+	}
+	else {
+		std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, error);
+
+		m_Video.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_Video) {
+			std::cout << "[FrameCapture] Failed to create " << path << '\n';
+			return false;
+		}
+	}
+
+	m_Format = format;
+	m_Path = path;
+	m_FrameRate = frameRate;
+	m_VideoWidth = m_VideoHeight = 0;
+	m_FramesCaptured = 0;
+	m_Stalls = 0;
+	m_LastOverheadMs = 0.0f;
+	m_TotalOverheadMs = 0.0;
+	m_FramesWritten = 0;
+	m_TotalWriteMs = 0.0;
+
+	m_WriterRunning = true;
+	m_Writer = std::thread(&FrameCapture::WriterLoop, this);
+	m_Capturing = true;
+	return true;
+}
+
+
+void FrameCapture::Stop() {
+
+	if (!m_Capturing)
+		return;
+
+	Collect(true);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_WriterRunning = false;
+	}
+	m_FrameQueued.notify_all();
+	m_Writer.join();
+
+	if (m_Video.is_open())
+		m_Video.close();
+	m_Capturing = false;
+}
+
+
+void FrameCapture::CaptureFrame(int width, int height) {
+
+	if (!m_Capturing || width <= 0 || height <= 0)
+		return;
+
+	auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+		m_LastOverheadMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		m_TotalOverheadMs += m_LastOverheadMs;
+	};
+	Timer timer(measure);
+
+	Collect(false);
+
+	//The ring is full when the oldest readback still isn't done, only then the GPU is waited for
+	Slot& slot = m_Slots[m_Next];
+	if (slot.Fence) {
+		++m_Stalls;
+		ReadSlot(slot, true);
+	}
+
+	size_t size = (size_t)width * height * 4;
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer));
+	if (slot.Capacity < size) {
+		GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+		slot.Capacity = size;
+	}
+
+	//With a pack buffer bound this only queues the copy, RGBA rows are always 4 byte aligned
+	GLCall(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	GLCall(slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+	slot.Width = width;
+	slot.Height = height;
+	slot.Index = m_FramesCaptured++;
+	m_Next = (m_Next + 1) % (unsigned int)m_Slots.size();
+}
+
+
+void FrameCapture::Collect(bool wait) {
+
+	//m_Next is the oldest slot, frames have to reach the writer in order
+	unsigned int count = (unsigned int)m_Slots.size();
+	for (unsigned int i = 0; i < count; ++i) {
+		Slot& slot = m_Slots[(m_Next + i) % count];
+		if (slot.Fence && !ReadSlot(slot, wait))
+			break;
+	}
+}
+
+
+bool FrameCapture::ReadSlot(Slot& slot, bool wait) {
+
+	GLenum status;
+	if (wait) {
+		do {
+			GLCall(status = glClientWaitSync(slot.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+		} while (status == GL_TIMEOUT_EXPIRED);
+	}
+	else {
+		GLCall(status = glClientWaitSync(slot.Fence, 0, 0));
+		if (status == GL_TIMEOUT_EXPIRED)
+			return false;
+	}
+
+	GLCall(glDeleteSync(slot.Fence));
+	slot.Fence = nullptr;
+
+	if (status == GL_WAIT_FAILED) {
+		std::cout << "[FrameCapture] Waiting for frame " << slot.Index << " failed, it is skipped\n";
+		return true;
+	}
+
+	Frame frame;
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		if (m_Queue.size() >= MaxQueuedFrames) {
+			++m_Stalls;
+			m_FrameWritten.wait(lock, [this] { return m_Queue.size() < MaxQueuedFrames; });
+		}
+		if (!m_FreeFrames.empty()) {
+			frame = std::move(m_FreeFrames.back());
+			m_FreeFrames.pop_back();
+		}
+	}
+
+	size_t size = (size_t)slot.Width * slot.Height * 4;
+	frame.Pixels.resize(size);
+	frame.Width = slot.Width;
+	frame.Height = slot.Height;
+	frame.Index = slot.Index;
+
+	const void* pixels;
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer));
+	GLCall(pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+	if (pixels)
+		memcpy(frame.Pixels.data(), pixels, size);
+	GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+	if (!pixels)
+		return true;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Queue.push_back(std::move(frame));
+	}
+	m_FrameQueued.notify_one();
+	return true;
+}
+
+
+unsigned int FrameCapture::GetFramesWritten() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_FramesWritten;
+}
+
+
+unsigned int FrameCapture::GetFramesQueued() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return (unsigned int)m_Queue.size() + (m_WriterBusy ? 1 : 0);
+}
+
+
+float FrameCapture::GetAverageWriteMs() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_FramesWritten ? (float)(m_TotalWriteMs / m_FramesWritten) : 0.0f;
+}
+
+
+void FrameCapture::WriterLoop() {
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true) {
+		m_FrameQueued.wait(lock, [this] { return !m_Queue.empty() || !m_WriterRunning; });
+		//Stop() only ends the thread once everything queued is written
+		if (m_Queue.empty())
+			break;
+
+		Frame frame = std::move(m_Queue.front());
+		m_Queue.pop_front();
+		m_WriterBusy = true;
+		lock.unlock();
+
+		float ms = 0.0f;
+		{
+			auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+				ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+			};
+			Timer timer(measure);
+			WriteFrame(frame);
+		}
+
+		lock.lock();
+		m_WriterBusy = false;
+		++m_FramesWritten;
+		m_TotalWriteMs += ms;
+		m_FreeFrames.push_back(std::move(frame));
+		m_FrameWritten.notify_all();
+	}
+}
+
+
+void FrameCapture::WriteFrame(Frame& frame) {
+
+	if (m_Format == CaptureFormat::Y4M) {
+		WriteY4M(frame);
+		return;
+	}
+
+	//The framebuffer alpha is whatever blending left behind, so it is dropped
+	size_t pixelCount = (size_t)frame.Width * frame.Height;
+	m_Planes.resize(pixelCount * 3);
+	for (size_t i = 0; i < pixelCount; ++i) {
+		m_Planes[i * 3 + 0] = frame.Pixels[i * 4 + 0];
+		m_Planes[i * 3 + 1] = frame.Pixels[i * 4 + 1];
+		m_Planes[i * 3 + 2] = frame.Pixels[i * 4 + 2];
+	}
+
+	char name[32];
+	snprintf(name, sizeof(name), "/frame_%05u.png", frame.Index);
+	if (EncodePng(m_Planes.data(), frame.Width, frame.Height, 3, m_Encoded, true)) {
+		std::ofstream stream(m_Path + name, std::ios::binary);
+		stream.write((const char*)m_Encoded.data(), (std::streamsize)m_Encoded.size());
+		if (!stream)
+			std::cout << "[FrameCapture] Failed to write " << m_Path << name << '\n';
+	}
+}
+
+
+//BT.601 limited range, every chroma sample is the average of a 2x2 block (centered siting, C420jpeg)
+void FrameCapture::WriteY4M(const Frame& frame) {
+
+	//The stream header is written with the first frame, a video can't change its size
+	if (m_VideoWidth == 0) {
+		m_VideoWidth = frame.Width;
+		m_VideoHeight = frame.Height;
+		m_Video << "YUV4MPEG2 W" << m_VideoWidth << " H" << m_VideoHeight << " F" << m_FrameRate << ":1 Ip A1:1 C420jpeg\n";
+	}
+	else if (frame.Width != m_VideoWidth || frame.Height != m_VideoHeight) {
+		std::cout << "[FrameCapture] Frame " << frame.Index << " is " << frame.Width << "x" << frame.Height << ", the video is "
+			<< m_VideoWidth << "x" << m_VideoHeight << ", it is skipped\n";
+		return;
+	}
+
+	int width = frame.Width, height = frame.Height;
+	int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+	size_t lumaSize = (size_t)width * height;
+	size_t chromaSize = (size_t)chromaWidth * chromaHeight;
+	m_Planes.resize(lumaSize + chromaSize * 2);
+	unsigned char* lumaPlane = m_Planes.data();
+	unsigned char* uPlane = lumaPlane + lumaSize;
+	unsigned char* vPlane = uPlane + chromaSize;
+
+	//Video rows go top to bottom, the framebuffer is bottom up
+	auto pixel = [&frame, width, height](int x, int y) { return &frame.Pixels[((size_t)(height - 1 - y) * width + x) * 4]; };
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const unsigned char* p = pixel(x, y);
+			lumaPlane[(size_t)y * width + x] = (unsigned char)(16 + ((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8));
+		}
+	}
+
+	for (int y = 0; y < chromaHeight; ++y) {
+		for (int x = 0; x < chromaWidth; ++x) {
+			int r = 0, g = 0, b = 0, count = 0;
+			for (int dy = 0; dy < 2 && y * 2 + dy < height; ++dy) {
+				for (int dx = 0; dx < 2 && x * 2 + dx < width; ++dx) {
+					const unsigned char* p = pixel(x * 2 + dx, y * 2 + dy);
+					r += p[0]; g += p[1]; b += p[2];
+					++count;
+				}
+			}
+			r /= count; g /= count; b /= count;
+			uPlane[(size_t)y * chromaWidth + x] = (unsigned char)(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+			vPlane[(size_t)y * chromaWidth + x] = (unsigned char)(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+		}
+	}
+
+	m_Video << "FRAME\n";
+	m_Video.write((const char*)m_Planes.data(), (std::streamsize)m_Planes.size());
+	if (!m_Video)
+		std::cout << "[FrameCapture] Failed to write frame " << frame.Index << " to " << m_Path << '\n';
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+enum class CaptureFormat {
+	PNG,	//Numbered frame_00000.png files in a directory
+	Y4M		//One raw YUV 4:2:0 video file, plays in ffplay/mpv and converts with ffmpeg -i capture.y4m
+};
+
+
+//Captures the rendered frames without stalling on glReadPixels
+//Every frame is read into the next pixel pack buffer of a ring, followed by a fence. The buffer is only mapped once its
+//fence signaled a few frames later, so the copy happens while the GPU works on the next frames. Mapped frames are
+//copied out and handed to a writer thread that does the encoding and file IO.
+//Only needs GL 3.2 (sync objects), so it works on software renderers and hidden (offscreen) windows as well.
+class FrameCapture {
+public:
+	//ringSize = frames the readback may lag behind, more hide more latency but cost a frame of memory each
+	FrameCapture(unsigned int ringSize = 3);
+	~FrameCapture();
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+
+	//path is the directory for PNGs or the .y4m file, frameRate is only stored in the Y4M header
+	bool Start(const std::string& path, CaptureFormat format, int frameRate = 60);
+	//Waits for the frames still in flight and for the writer to finish them
+	void Stop();
+
+	//Call after rendering and before swapping, reads the current read framebuffer (the back buffer by default)
+	void CaptureFrame(int width, int height);
+
+	inline bool IsCapturing() const { return m_Capturing; }
+	inline CaptureFormat GetFormat() const { return m_Format; }
+	inline const std::string& GetPath() const { return m_Path; }
+
+	inline unsigned int GetFramesCaptured() const { return m_FramesCaptured; }
+	unsigned int GetFramesWritten();
+	unsigned int GetFramesQueued();
+	//Times CaptureFrame had to wait, because the oldest readback wasn't done or the writer fell behind
+	inline unsigned int GetStalls() const { return m_Stalls; }
+	//CPU time of CaptureFrame: the last frame and the average since Start
+	inline float GetLastOverheadMs() const { return m_LastOverheadMs; }
+	inline float GetAverageOverheadMs() const { return m_FramesCaptured ? (float)(m_TotalOverheadMs / m_FramesCaptured) : 0.0f; }
+	//Time the writer thread spends per frame on encoding and writing
+	float GetAverageWriteMs();
+
+	//Frames the writer may lag behind before CaptureFrame blocks, so a slow disk can't use up all memory
+	static const unsigned int MaxQueuedFrames = 8;
+
+private:
+	struct Slot {
+		unsigned int Buffer;
+		GLsync Fence;
+		size_t Capacity;
+		int Width, Height;
+		unsigned int Index;
+	};
+
+	struct Frame {
+		std::vector<unsigned char> Pixels;	//RGBA, bottom row first
+		int Width, Height;
+		unsigned int Index;
+	};
+
+	//Maps a finished slot and queues its frame, with wait the fence is waited for, otherwise false is returned if it isn't signaled
+	bool ReadSlot(Slot& slot, bool wait);
+	//Reads all finished slots from the oldest on
+	void Collect(bool wait);
+
+	void WriterLoop();
+	void WriteFrame(Frame& frame);
+	void WriteY4M(const Frame& frame);
+
+private:
+	std::vector<Slot> m_Slots;
+	unsigned int m_Next;
+
+	bool m_Capturing;
+	CaptureFormat m_Format;
+	std::string m_Path;
+	int m_FrameRate;
+	std::ofstream m_Video;
+	int m_VideoWidth, m_VideoHeight;
+	std::vector<unsigned char> m_Planes;
+	std::vector<unsigned char> m_Encoded;
+
+	unsigned int m_FramesCaptured;
+	unsigned int m_Stalls;
+	float m_LastOverheadMs;
+	double m_TotalOverheadMs;
+
+	//Shared with the writer thread
+	std::thread m_Writer;
+	std::mutex m_Mutex;
+	std::condition_variable m_FrameQueued;
+	std::condition_variable m_FrameWritten;
+	std::deque<Frame> m_Queue;
+	std::vector<Frame> m_FreeFrames;
+	bool m_WriterRunning;
+	bool m_WriterBusy;
+	unsigned int m_FramesWritten;
+	double m_TotalWriteMs;
+};
@@ -0,0 +1,114 @@
+#include "FramePacer.h"
+
+#include <GLFW/glfw3.h>
+
+
+//Callbacks that were installed before Attach, every event is passed on to them
+static GLFWcursorposfun s_CursorPosCallback;
+static GLFWmousebuttonfun s_MouseButtonCallback;
+static GLFWscrollfun s_ScrollCallback;
+static GLFWkeyfun s_KeyCallback;
+static GLFWcharfun s_CharCallback;
+static GLFWframebuffersizefun s_FramebufferSizeCallback;
+static GLFWwindowfocusfun s_WindowFocusCallback;
+static GLFWwindowrefreshfun s_WindowRefreshCallback;
+
+
+FramePacer::FramePacer()
+	: m_IdleMode(false), m_IdleTimeout(1.0), m_FramesRemaining(FramesAfterInput), m_FramesRendered(0), m_IdleTime(0.0)
+{
+
+}
+
+
+FramePacer& FramePacer::Get() {
+	static FramePacer s_Instance;
+	return s_Instance;
+}
+
+
+//Runs on the main thread inside glfwPollEvents/glfwWaitEventsTimeout, so there is nothing to wake up
+void FramePacer::OnEvent() {
+	Get().Schedule(FramesAfterInput);
+}
+
+
+void FramePacer::Attach(GLFWwindow* window) {
+
+	s_CursorPosCallback = glfwSetCursorPosCallback(window, [](GLFWwindow* window, double x, double y) {
+		if (s_CursorPosCallback)
+			s_CursorPosCallback(window, x, y);
+		OnEvent();
+	});
+	s_MouseButtonCallback = glfwSetMouseButtonCallback(window, [](GLFWwindow* window, int button, int action, int mods) {
+		if (s_MouseButtonCallback)
+			s_MouseButtonCallback(window, button, action, mods);
+		OnEvent();
+	});
+	s_ScrollCallback = glfwSetScrollCallback(window, [](GLFWwindow* window, double x, double y) {
+		if (s_ScrollCallback)
+			s_ScrollCallback(window, x, y);
+		OnEvent();
+	});
+	s_KeyCallback = glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int scancode, int action, int mods) {
+		if (s_KeyCallback)
+			s_KeyCallback(window, key, scancode, action, mods);
+		OnEvent();
+	});
+	s_CharCallback = glfwSetCharCallback(window, [](GLFWwindow* window, unsigned int c) {
+		if (s_CharCallback)
+			s_CharCallback(window, c);
+		OnEvent();
+	});
+	s_FramebufferSizeCallback = glfwSetFramebufferSizeCallback(window, [](GLFWwindow* window, int width, int height) {
+		if (s_FramebufferSizeCallback)
+			s_FramebufferSizeCallback(window, width, height);
+		OnEvent();
+	});
+	s_WindowFocusCallback = glfwSetWindowFocusCallback(window, [](GLFWwindow* window, int focused) {
+		if (s_WindowFocusCallback)
+			s_WindowFocusCallback(window, focused);
+		OnEvent();
+	});
+	s_WindowRefreshCallback = glfwSetWindowRefreshCallback(window, [](GLFWwindow* window) {
+		if (s_WindowRefreshCallback)
+			s_WindowRefreshCallback(window);
+		OnEvent();
+	});
+}
+
+
+void FramePacer::Schedule(unsigned int count) {
+	unsigned int remaining = m_FramesRemaining.load();
+	while (remaining < count && !m_FramesRemaining.compare_exchange_weak(remaining, count)) {}
+}
+
+
+void FramePacer::RequestFrames(unsigned int count) {
+
+	Schedule(count);
+
+	//Wakes glfwWaitEventsTimeout when this comes from another thread
+	glfwPostEmptyEvent();
+}
+
+
+void FramePacer::EndFrame(bool animating) {
+
+	++m_FramesRendered;
+	unsigned int remaining = m_FramesRemaining.load();
+	while (remaining > 0 && !m_FramesRemaining.compare_exchange_weak(remaining, remaining - 1)) {}
+
+	if (!m_IdleMode || animating || m_FramesRemaining.load() > 0) {
+		glfwPollEvents();
+		return;
+	}
+
+	double start = glfwGetTime();
+	glfwWaitEventsTimeout(m_IdleTimeout);
+	m_IdleTime += glfwGetTime() - start;
+
+	//Woken by the timeout or an event without callback, the next frame is rendered anyway
+	if (m_FramesRemaining.load() == 0)
+		m_FramesRemaining = 1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+
+struct GLFWwindow;
+
+
+//On-demand rendering for the main loop: in idle mode it sleeps in glfwWaitEventsTimeout instead of redrawing the same frame
+//The next frame is rendered when input arrives, the current test animates or frames were requested
+class FramePacer {
+public:
+	static FramePacer& Get();
+
+	//Chains the input and window callbacks of the window, so install ImGui's callbacks first
+	void Attach(GLFWwindow* window);
+
+	//Renders at least count more frames, for animations that end on their own or results that arrive over a few frames
+	//Can be called from any thread, a sleeping main loop is woken up
+	void RequestFrames(unsigned int count);
+
+	//Call once per frame instead of glfwPollEvents, animating is true while something changes every frame on its own
+	void EndFrame(bool animating);
+
+	void SetIdleMode(bool enabled) { m_IdleMode = enabled; }
+	//Longest sleep, one frame is rendered after it even without events so timers and background work stay current
+	void SetIdleTimeout(double seconds) { m_IdleTimeout = seconds; }
+
+	inline bool IsIdleMode() const { return m_IdleMode; }
+	inline double GetIdleTimeout() const { return m_IdleTimeout; }
+	inline unsigned int GetFramesRendered() const { return m_FramesRendered; }
+	//Seconds spent waiting for events
+	inline double GetIdleTime() const { return m_IdleTime; }
+
+	//ImGui needs a few frames after input until hover states and layout changes settled
+	static const unsigned int FramesAfterInput = 3;
+
+private:
+	FramePacer();
+
+	static void OnEvent();
+	//Raises the remaining frames to at least count
+	void Schedule(unsigned int count);
+
+private:
+	bool m_IdleMode;
+	double m_IdleTimeout;
+	std::atomic<unsigned int> m_FramesRemaining;
+	unsigned int m_FramesRendered;
+	double m_IdleTime;
+};
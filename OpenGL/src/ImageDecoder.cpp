@@ -0,0 +1,383 @@
+#include "ImageDecoder.h"
+
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+#include "glm/glm.hpp"
+#include "stb_image/stb_image.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	#include <emmintrin.h>
+#endif
+#if GLM_ARCH & GLM_ARCH_SSSE3_BIT
+	#include <tmmintrin.h>
+#endif
+
+
+static const unsigned char s_PngSignature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+enum PngColorType {
+	PngGray = 0, PngRGB = 2, PngPalette = 3, PngGrayAlpha = 4, PngRGBA = 6
+};
+
+struct PngHeader {
+	int Width, Height;
+	int Channels;
+	int ColorType;
+};
+
+
+static inline uint32_t ReadBigEndian32(const unsigned char* p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+
+//Collects the IDAT chunks and the palette, returns false for anything the fast path doesn't handle:
+//other bit depths, interlacing, and tRNS color keys on gray/RGB images
+static bool ParsePng(const unsigned char* data, size_t size, PngHeader& header, std::vector<unsigned char>& compressed, uint32_t palette[256])
+{
+	if (size < 8 + 25 || memcmp(data, s_PngSignature, 8) != 0)
+		return false;
+
+	const unsigned char* ihdr = data + 8;
+	if (ReadBigEndian32(ihdr) != 13 || memcmp(ihdr + 4, "IHDR", 4) != 0)
+		return false;
+
+	header.Width = (int)ReadBigEndian32(ihdr + 8);
+	header.Height = (int)ReadBigEndian32(ihdr + 12);
+	int bitDepth = ihdr[16];
+	header.ColorType = ihdr[17];
+	int interlace = ihdr[20];
+
+	switch (header.ColorType) {
+		case PngGray:		header.Channels = 1; break;
+		case PngRGB:		header.Channels = 3; break;
+		case PngPalette:	header.Channels = 1; break;
+		case PngGrayAlpha:	header.Channels = 2; break;
+		case PngRGBA:		header.Channels = 4; break;
+		default:			return false;
+	}
+
+	if (bitDepth != 8 || interlace != 0 || ihdr[18] != 0 || ihdr[19] != 0 || header.Width <= 0 || header.Height <= 0 ||
+		(size_t)header.Width * header.Height > (1u << 28))
+		return false;
+
+	for (int i = 0; i < 256; ++i)
+		palette[i] = 0xFF000000;
+
+	compressed.clear();
+	size_t offset = 8;
+	while (offset + 12 <= size) {
+		uint32_t length = ReadBigEndian32(data + offset);
+		const unsigned char* type = data + offset + 4;
+		const unsigned char* chunk = data + offset + 8;
+		if (offset + 12 + (size_t)length > size)
+			return false;
+
+		if (memcmp(type, "IDAT", 4) == 0)
+			compressed.insert(compressed.end(), chunk, chunk + length);
+		else if (memcmp(type, "PLTE", 4) == 0) {
+			for (uint32_t i = 0; i < length / 3 && i < 256; ++i)
+				palette[i] = chunk[i * 3] | (chunk[i * 3 + 1] << 8) | (chunk[i * 3 + 2] << 16) | 0xFF000000u;
+		}
+		else if (memcmp(type, "tRNS", 4) == 0) {
+			if (header.ColorType != PngPalette)
+				return false;
+			for (uint32_t i = 0; i < length && i < 256; ++i)
+				palette[i] = (palette[i] & 0x00FFFFFF) | ((uint32_t)chunk[i] << 24);
+		}
+		else if (memcmp(type, "IEND", 4) == 0)
+			break;
+
+		offset += 12 + (size_t)length;
+	}
+
+	return !compressed.empty();
+}
+
+
+static inline int PaethPredictor(int a, int b, int c)
+{
+	int p = a + b - c;
+	int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+	if (pa <= pb && pa <= pc)
+		return a;
+	return pb <= pc ? b : c;
+}
+
+
+static void UnfilterRowScalar(int filter, unsigned char* row, const unsigned char* prior, size_t length, int bpp, size_t begin)
+{
+	switch (filter) {
+		case 1:
+			for (size_t i = begin; i < length; ++i)
+				row[i] = (unsigned char)(row[i] + (i >= (size_t)bpp ? row[i - bpp] : 0));
+			break;
+		case 2:
+			for (size_t i = begin; i < length; ++i)
+				row[i] = (unsigned char)(row[i] + prior[i]);
+			break;
+		case 3:
+			for (size_t i = begin; i < length; ++i)
+				row[i] = (unsigned char)(row[i] + (((i >= (size_t)bpp ? row[i - bpp] : 0) + prior[i]) >> 1));
+			break;
+		case 4:
+			for (size_t i = begin; i < length; ++i) {
+				int a = i >= (size_t)bpp ? row[i - bpp] : 0;
+				int c = i >= (size_t)bpp ? prior[i - bpp] : 0;
+				row[i] = (unsigned char)(row[i] + PaethPredictor(a, prior[i], c));
+			}
+			break;
+	}
+}
+
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+static inline __m128i LoadPixel(const unsigned char* p, int bpp)
+{
+	int32_t value = 0;
+	memcpy(&value, p, bpp);
+	return _mm_cvtsi32_si128(value);
+}
+
+static inline void StorePixel(unsigned char* p, __m128i pixel, int bpp)
+{
+	int32_t value = _mm_cvtsi128_si32(pixel);
+	memcpy(p, &value, bpp);
+}
+
+//Up is independent per byte and runs 16 at a time, Sub/Avg/Paeth depend on the pixel to the left,
+//so they process one 3 or 4 byte pixel per step in a register (same approach as libpng's SSE2 filters)
+//The last pixel of a 3 byte row is done in the scalar tail, so no load reads past the row
+static size_t UnfilterRowSSE(int filter, unsigned char* row, const unsigned char* prior, size_t length, int bpp)
+{
+	size_t i = 0;
+
+	if (filter == 2) {
+		for (; i + 16 <= length; i += 16) {
+			__m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(prior + i));
+			_mm_storeu_si128((__m128i*)(row + i), _mm_add_epi8(x, b));
+		}
+		return i;
+	}
+
+	if (bpp != 3 && bpp != 4)
+		return 0;
+
+	size_t end = length >= 4 ? length - 4 + 1 : 0;
+	__m128i a = _mm_setzero_si128();
+
+	if (filter == 1) {
+		for (; i + bpp <= length && i < end; i += bpp) {
+			a = _mm_add_epi8(LoadPixel(row + i, 4), a);
+			StorePixel(row + i, a, bpp);
+		}
+	}
+	else if (filter == 3) {
+		const __m128i one = _mm_set1_epi8(1);
+		for (; i + bpp <= length && i < end; i += bpp) {
+			__m128i b = LoadPixel(prior + i, 4);
+			//_mm_avg_epu8 rounds up, the filter rounds down
+			__m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+			a = _mm_add_epi8(LoadPixel(row + i, 4), average);
+			StorePixel(row + i, a, bpp);
+		}
+	}
+	else if (filter == 4) {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i c = zero;
+		for (; i + bpp <= length && i < end; i += bpp) {
+			__m128i b = _mm_unpacklo_epi8(LoadPixel(prior + i, 4), zero);
+			__m128i a16 = _mm_unpacklo_epi8(a, zero);
+
+			//pa = |b - c|, pb = |a - c|, pc = |a + b - 2c|
+			__m128i pa = _mm_sub_epi16(b, c);
+			__m128i pb = _mm_sub_epi16(a16, c);
+			__m128i pc = _mm_add_epi16(pa, pb);
+			pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+			pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+			pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+			__m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+			__m128i isC = _mm_cmpeq_epi16(smallest, pc);
+			__m128i nearest = _mm_or_si128(_mm_and_si128(isC, c), _mm_andnot_si128(isC, b));
+			__m128i isB = _mm_cmpeq_epi16(smallest, pb);
+			nearest = _mm_or_si128(_mm_and_si128(isB, b), _mm_andnot_si128(isB, nearest));
+			__m128i isA = _mm_cmpeq_epi16(smallest, pa);
+			nearest = _mm_or_si128(_mm_and_si128(isA, a16), _mm_andnot_si128(isA, nearest));
+
+			a = _mm_add_epi8(LoadPixel(row + i, 4), _mm_packus_epi16(nearest, nearest));
+			StorePixel(row + i, a, bpp);
+			c = b;
+		}
+	}
+
+	return i;
+}
+
+#endif
+
+
+static void UnfilterRow(int filter, unsigned char* row, const unsigned char* prior, size_t length, int bpp)
+{
+	size_t done = 0;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	done = UnfilterRowSSE(filter, row, prior, length, bpp);
+#endif
+	UnfilterRowScalar(filter, row, prior, length, bpp, done);
+}
+
+
+//Converts one unfiltered row to RGBA8
+static void ExpandRow(const unsigned char* src, unsigned char* dst, int width, const PngHeader& header, const uint32_t palette[256])
+{
+	int x = 0;
+
+	switch (header.ColorType) {
+		case PngRGBA:
+			memcpy(dst, src, (size_t)width * 4);
+			return;
+
+		case PngRGB:
+#if GLM_ARCH & GLM_ARCH_SSSE3_BIT
+		{
+			//4 pixels per step, the 16 byte load must not read past the 12 bytes of the last full step
+			const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+			const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+			for (; x + 6 <= width; x += 4) {
+				__m128i rgb = _mm_loadu_si128((const __m128i*)(src + x * 3));
+				_mm_storeu_si128((__m128i*)(dst + x * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+			}
+		}
+#endif
+			for (; x < width; ++x) {
+				dst[x * 4 + 0] = src[x * 3 + 0];
+				dst[x * 4 + 1] = src[x * 3 + 1];
+				dst[x * 4 + 2] = src[x * 3 + 2];
+				dst[x * 4 + 3] = 255;
+			}
+			return;
+
+		case PngGray:
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+		{
+			const __m128i opaque = _mm_set1_epi8((char)0xFF);
+			for (; x + 16 <= width; x += 16) {
+				__m128i gray = _mm_loadu_si128((const __m128i*)(src + x));
+				__m128i gg0 = _mm_unpacklo_epi8(gray, gray), gg1 = _mm_unpackhi_epi8(gray, gray);
+				__m128i ga0 = _mm_unpacklo_epi8(gray, opaque), ga1 = _mm_unpackhi_epi8(gray, opaque);
+				_mm_storeu_si128((__m128i*)(dst + x * 4), _mm_unpacklo_epi16(gg0, ga0));
+				_mm_storeu_si128((__m128i*)(dst + x * 4 + 16), _mm_unpackhi_epi16(gg0, ga0));
+				_mm_storeu_si128((__m128i*)(dst + x * 4 + 32), _mm_unpacklo_epi16(gg1, ga1));
+				_mm_storeu_si128((__m128i*)(dst + x * 4 + 48), _mm_unpackhi_epi16(gg1, ga1));
+			}
+		}
+#endif
+			for (; x < width; ++x) {
+				dst[x * 4 + 0] = dst[x * 4 + 1] = dst[x * 4 + 2] = src[x];
+				dst[x * 4 + 3] = 255;
+			}
+			return;
+
+		case PngGrayAlpha:
+			for (; x < width; ++x) {
+				dst[x * 4 + 0] = dst[x * 4 + 1] = dst[x * 4 + 2] = src[x * 2];
+				dst[x * 4 + 3] = src[x * 2 + 1];
+			}
+			return;
+
+		case PngPalette:
+			for (; x < width; ++x)
+				memcpy(dst + x * 4, &palette[src[x]], 4);
+			return;
+	}
+}
+
+
+bool GetImageInfo(const unsigned char* data, size_t size, ImageInfo& info)
+{
+	return stbi_info_from_memory(data, (int)size, &info.Width, &info.Height, &info.Channels) != 0;
+}
+
+
+bool DecodeImageStb(const unsigned char* data, size_t size, unsigned char* dst, bool flipVertically)
+{
+	//The thread local flag, so batch decodes don't race with each other or the global flag other loaders set
+	stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+
+	int width, height, channels;
+	unsigned char* pixels = stbi_load_from_memory(data, (int)size, &width, &height, &channels, 4);
+	if (!pixels) {
+		std::cout << "[ImageDecoder] Failed to decode image: " << stbi_failure_reason() << '\n';
+		return false;
+	}
+
+	memcpy(dst, pixels, (size_t)width * height * 4);
+	stbi_image_free(pixels);
+	return true;
+}
+
+
+bool DecodeImage(const unsigned char* data, size_t size, unsigned char* dst, bool flipVertically)
+{
+	//Reused across calls, so batch decodes don't allocate per image
+	thread_local std::vector<unsigned char> compressed, filtered, zeroRow;
+
+	PngHeader header;
+	uint32_t palette[256];
+	if (!ParsePng(data, size, header, compressed, palette))
+		return DecodeImageStb(data, size, dst, flipVertically);
+
+	size_t stride = (size_t)header.Width * header.Channels;
+	size_t filteredSize = (stride + 1) * header.Height;
+	filtered.resize(filteredSize);
+	zeroRow.assign(stride, 0);
+
+	int decoded = stbi_zlib_decode_buffer((char*)filtered.data(), (int)filteredSize, (const char*)compressed.data(), (int)compressed.size());
+	if (decoded != (int)filteredSize)
+		return DecodeImageStb(data, size, dst, flipVertically);
+
+	const unsigned char* prior = zeroRow.data();
+	for (int y = 0; y < header.Height; ++y) {
+		unsigned char* row = filtered.data() + y * (stride + 1);
+		int filter = row[0];
+		if (filter > 4) {
+			std::cout << "[ImageDecoder] Invalid PNG filter type " << filter << '\n';
+			return false;
+		}
+
+		UnfilterRow(filter, row + 1, prior, stride, header.Channels);
+
+		int dstY = flipVertically ? header.Height - 1 - y : y;
+		ExpandRow(row + 1, dst + (size_t)dstY * header.Width * 4, header.Width, header, palette);
+		prior = row + 1;
+	}
+
+	return true;
+}
+
+
+void DecodeImages(std::vector<ImageDecodeRequest>& requests, bool flipVertically)
+{
+	JobSystem::Get().ParallelFor(requests.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			ImageDecodeRequest& request = requests[i];
+			request.Success = false;
+
+			MappedFile file(request.Path);
+			if (!file.IsOpen() || !GetImageInfo(file.GetData(), file.GetSize(), request.Info))
+				continue;
+
+			request.Pixels.resize((size_t)request.Info.Width * request.Info.Height * 4);
+			request.Success = DecodeImage(file.GetData(), file.GetSize(), request.Pixels.data(), flipVertically);
+		}
+	});
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+//RGBA8 image decoding that writes straight into caller memory (e.g. a mapped pixel unpack buffer)
+//8 bit non-interlaced PNGs go through a fast path: stb_image's inflate, then SIMD filter reversal fused with the expansion
+//to RGBA and the vertical flip, one row at a time. Every other format and PNG variant falls back to stb_image.
+
+
+struct ImageInfo {
+	int Width, Height;
+	int Channels;		//Channels stored in the file, the decoded image always has 4
+};
+
+//Reads only the header
+bool GetImageInfo(const unsigned char* data, size_t size, ImageInfo& info);
+
+//dst has to hold width * height * 4 bytes, with flipVertically the first row in memory is the bottom of the image (OpenGL)
+bool DecodeImage(const unsigned char* data, size_t size, unsigned char* dst, bool flipVertically = true);
+
+//Plain stb_image (stbi_load_from_memory with 4 components + copy), used as fallback and benchmark baseline
+bool DecodeImageStb(const unsigned char* data, size_t size, unsigned char* dst, bool flipVertically = true);
+
+
+struct ImageDecodeRequest {
+	std::string Path;
+	ImageInfo Info;
+	std::vector<unsigned char> Pixels;
+	bool Success;
+};
+
+//Decodes every request on the JobSystem, one file per job
+void DecodeImages(std::vector<ImageDecodeRequest>& requests, bool flipVertically = true);
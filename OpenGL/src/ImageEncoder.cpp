@@ -0,0 +1,330 @@
+#include "ImageEncoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+
+static const unsigned char s_PngSignature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+static const int s_MinMatch = 4;
+static const int s_MaxMatch = 258;
+static const size_t s_WindowSize = 32768;
+static const int s_HashBits = 15;
+
+static const uint16_t s_LengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t s_LengthExtraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t s_DistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+											 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t s_DistanceExtraBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+
+static uint32_t ReverseBits(uint32_t value, int count)
+{
+	uint32_t result = 0;
+	for (int i = 0; i < count; ++i, value >>= 1)
+		result = (result << 1) | (value & 1);
+	return result;
+}
+
+
+//Fixed Huffman codes (RFC 1951 3.2.6), bit reversed because deflate streams are filled from the least significant bit
+//Lengths and distances map straight to their symbol, distances above 256 are looked up in steps of 128 like zlib does
+struct DeflateTables {
+	uint16_t LiteralCode[288];
+	uint8_t LiteralBits[288];
+	uint16_t DistanceCode[30];
+
+	uint16_t LengthSymbol[s_MaxMatch + 1];
+	uint8_t DistanceSymbol[512];
+
+	DeflateTables()
+	{
+		for (int symbol = 0; symbol < 288; ++symbol) {
+			uint32_t code;
+			int bits;
+			if (symbol < 144)		{ code = 0x30 + symbol; bits = 8; }
+			else if (symbol < 256)	{ code = 0x190 + symbol - 144; bits = 9; }
+			else if (symbol < 280)	{ code = symbol - 256; bits = 7; }
+			else					{ code = 0xC0 + symbol - 280; bits = 8; }
+			LiteralCode[symbol] = (uint16_t)ReverseBits(code, bits);
+			LiteralBits[symbol] = (uint8_t)bits;
+		}
+
+		for (int code = 0; code < 30; ++code)
+			DistanceCode[code] = (uint16_t)ReverseBits(code, 5);
+
+		//Code 27 would cover 258 as well, code 28 overwrites it
+		for (int code = 0; code < 29; ++code) {
+			for (int length = s_LengthBase[code]; length < s_LengthBase[code] + (1 << s_LengthExtraBits[code]) && length <= s_MaxMatch; ++length)
+				LengthSymbol[length] = (uint16_t)code;
+		}
+
+		for (int code = 0; code < 30; ++code) {
+			for (int distance = s_DistanceBase[code]; distance < s_DistanceBase[code] + (1 << s_DistanceExtraBits[code]); ++distance) {
+				int index = distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7);
+				DistanceSymbol[index] = (uint8_t)code;
+			}
+		}
+	}
+};
+
+
+class BitWriter {
+public:
+	BitWriter(std::vector<unsigned char>& out)
+		: m_Out(out), m_Bits(0), m_Count(0) {}
+
+	inline void Write(uint32_t value, int count)
+	{
+		m_Bits |= (uint64_t)value << m_Count;
+		m_Count += count;
+		while (m_Count >= 8) {
+			m_Out.push_back((unsigned char)m_Bits);
+			m_Bits >>= 8;
+			m_Count -= 8;
+		}
+	}
+
+	inline void Flush()
+	{
+		if (m_Count > 0)
+			m_Out.push_back((unsigned char)m_Bits);
+		m_Bits = 0;
+		m_Count = 0;
+	}
+
+private:
+	std::vector<unsigned char>& m_Out;
+	uint64_t m_Bits;
+	int m_Count;
+};
+
+
+static inline uint32_t HashBytes(const unsigned char* p)
+{
+	uint32_t value;
+	memcpy(&value, p, 4);
+	return (value * 2654435761u) >> (32 - s_HashBits);
+}
+
+
+//One final block with fixed codes, every position only remembers the last one with the same 4 byte hash
+static void Deflate(const unsigned char* data, size_t size, std::vector<unsigned char>& out)
+{
+	static const DeflateTables s_Tables;
+	const DeflateTables& t = s_Tables;
+
+	BitWriter writer(out);
+	writer.Write(1, 1);		//BFINAL
+	writer.Write(1, 2);		//BTYPE = fixed Huffman codes
+
+	std::vector<int32_t> head((size_t)1 << s_HashBits, -1);
+
+	size_t i = 0;
+	while (i + s_MinMatch <= size) {
+		uint32_t hash = HashBytes(data + i);
+		int32_t candidate = head[hash];
+		head[hash] = (int32_t)i;
+
+		if (candidate < 0 || i - candidate > s_WindowSize || memcmp(data + candidate, data + i, s_MinMatch) != 0) {
+			writer.Write(t.LiteralCode[data[i]], t.LiteralBits[data[i]]);
+			++i;
+			continue;
+		}
+
+		size_t maxLength = std::min((size_t)s_MaxMatch, size - i);
+		size_t length = s_MinMatch;
+		while (length < maxLength && data[candidate + length] == data[i + length])
+			++length;
+
+		int lengthCode = t.LengthSymbol[length];
+		writer.Write(t.LiteralCode[257 + lengthCode], t.LiteralBits[257 + lengthCode]);
+		writer.Write((uint32_t)(length - s_LengthBase[lengthCode]), s_LengthExtraBits[lengthCode]);
+
+		size_t distance = i - candidate;
+		int distanceCode = t.DistanceSymbol[distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7)];
+		writer.Write(t.DistanceCode[distanceCode], 5);
+		writer.Write((uint32_t)(distance - s_DistanceBase[distanceCode]), s_DistanceExtraBits[distanceCode]);
+
+		//The positions inside the match are hashed too, so later matches can start there
+		size_t end = i + length;
+		for (++i; i < end && i + s_MinMatch <= size; ++i)
+			head[HashBytes(data + i)] = (int32_t)i;
+		i = end;
+	}
+
+	for (; i < size; ++i)
+		writer.Write(t.LiteralCode[data[i]], t.LiteralBits[data[i]]);
+
+	writer.Write(t.LiteralCode[256], t.LiteralBits[256]);
+	writer.Flush();
+}
+
+
+static uint32_t Adler32(const unsigned char* data, size_t size)
+{
+	uint32_t a = 1, b = 0;
+	while (size > 0) {
+		//5552 bytes is the most that can be summed before b overflows
+		size_t block = std::min(size, (size_t)5552);
+		for (size_t i = 0; i < block; ++i) {
+			a += data[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+		data += block;
+		size -= block;
+	}
+	return (b << 16) | a;
+}
+
+
+static uint32_t Crc32(const unsigned char* data, size_t size, uint32_t crc = 0)
+{
+	static uint32_t s_Table[256];
+	static bool s_Initialized = [] {
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t value = i;
+			for (int bit = 0; bit < 8; ++bit)
+				value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+			s_Table[i] = value;
+		}
+		return true;
+	}();
+	(void)s_Initialized;
+
+	crc = ~crc;
+	for (size_t i = 0; i < size; ++i)
+		crc = s_Table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+
+static void AppendBigEndian32(std::vector<unsigned char>& out, uint32_t value)
+{
+	out.push_back((unsigned char)(value >> 24));
+	out.push_back((unsigned char)(value >> 16));
+	out.push_back((unsigned char)(value >> 8));
+	out.push_back((unsigned char)value);
+}
+
+
+//Length, type and data, the CRC covers type and data
+static void AppendChunk(std::vector<unsigned char>& png, const char* type, const unsigned char* data, size_t size)
+{
+	AppendBigEndian32(png, (uint32_t)size);
+	size_t start = png.size();
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), data, data + size);
+	AppendBigEndian32(png, Crc32(png.data() + start, size + 4));
+}
+
+
+static inline unsigned char Paeth(int a, int b, int c)
+{
+	int p = a + b - c;
+	int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+	if (pa <= pb && pa <= pc)
+		return (unsigned char)a;
+	return (unsigned char)(pb <= pc ? b : c);
+}
+
+
+//Writes the filter type byte and the filtered row to dst, prior is null for the first row
+static void FilterRow(const unsigned char* row, const unsigned char* prior, size_t rowSize, int bpp, unsigned char* dst, unsigned char* scratch)
+{
+	unsigned char* candidates[5];
+	for (int filter = 0; filter < 5; ++filter)
+		candidates[filter] = scratch + filter * rowSize;
+
+	for (size_t i = 0; i < rowSize; ++i) {
+		int a = i >= (size_t)bpp ? row[i - bpp] : 0;
+		int b = prior ? prior[i] : 0;
+		int c = prior && i >= (size_t)bpp ? prior[i - bpp] : 0;
+		candidates[0][i] = row[i];
+		candidates[1][i] = (unsigned char)(row[i] - a);
+		candidates[2][i] = (unsigned char)(row[i] - b);
+		candidates[3][i] = (unsigned char)(row[i] - ((a + b) >> 1));
+		candidates[4][i] = (unsigned char)(row[i] - Paeth(a, b, c));
+	}
+
+	//Minimum sum of absolute differences, with the bytes taken as signed
+	int best = 0;
+	uint64_t bestSum = UINT64_MAX;
+	for (int filter = 0; filter < 5; ++filter) {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < rowSize; ++i)
+			sum += (uint64_t)abs((int)(signed char)candidates[filter][i]);
+		if (sum < bestSum) {
+			bestSum = sum;
+			best = filter;
+		}
+	}
+
+	dst[0] = (unsigned char)best;
+	memcpy(dst + 1, candidates[best], rowSize);
+}
+
+
+bool EncodePng(const unsigned char* pixels, int width, int height, int channels, std::vector<unsigned char>& png, bool flipVertically)
+{
+	if (width <= 0 || height <= 0 || (channels != 3 && channels != 4)) {
+		std::cout << "[ImageEncoder] Only RGB and RGBA images can be encoded\n";
+		return false;
+	}
+
+	size_t rowSize = (size_t)width * channels;
+	std::vector<unsigned char> filtered((rowSize + 1) * height);
+	std::vector<unsigned char> scratch(rowSize * 5);
+
+	const unsigned char* prior = nullptr;
+	for (int y = 0; y < height; ++y) {
+		const unsigned char* row = pixels + (size_t)(flipVertically ? height - 1 - y : y) * rowSize;
+		FilterRow(row, prior, rowSize, channels, filtered.data() + (size_t)y * (rowSize + 1), scratch.data());
+		prior = row;
+	}
+
+	//zlib stream: header (deflate, 32K window, no dictionary), raw deflate data, Adler-32 of the filtered rows
+	std::vector<unsigned char> compressed = { 0x78, 0x01 };
+	compressed.reserve(filtered.size() / 2);
+	Deflate(filtered.data(), filtered.size(), compressed);
+	AppendBigEndian32(compressed, Adler32(filtered.data(), filtered.size()));
+
+	unsigned char header[13];
+	header[0] = (unsigned char)(width >> 24); header[1] = (unsigned char)(width >> 16); header[2] = (unsigned char)(width >> 8); header[3] = (unsigned char)width;
+	header[4] = (unsigned char)(height >> 24); header[5] = (unsigned char)(height >> 16); header[6] = (unsigned char)(height >> 8); header[7] = (unsigned char)height;
+	header[8] = 8;								//Bit depth
+	header[9] = channels == 4 ? 6 : 2;			//Color type RGBA/RGB
+	header[10] = 0;								//Compression
+	header[11] = 0;								//Filter method
+	header[12] = 0;								//No interlacing
+
+	png.clear();
+	png.reserve(compressed.size() + 64);
+	png.insert(png.end(), s_PngSignature, s_PngSignature + 8);
+	AppendChunk(png, "IHDR", header, sizeof(header));
+	AppendChunk(png, "IDAT", compressed.data(), compressed.size());
+	AppendChunk(png, "IEND", nullptr, 0);
+	return true;
+}
+
+
+bool WritePng(const std::string& path, const unsigned char* pixels, int width, int height, int channels, bool flipVertically)
+{
+	std::vector<unsigned char> png;
+	if (!EncodePng(pixels, width, height, channels, png, flipVertically))
+		return false;
+
+	std::ofstream stream(path, std::ios::binary);
+	stream.write((const char*)png.data(), (std::streamsize)png.size());
+	if (!stream) {
+		std::cout << "[ImageEncoder] Failed to write " << path << '\n';
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+//PNG writer for screenshots and frame captures, counterpart of the ImageDecoder
+//Every row gets the filter with the smallest sum of absolute differences (like libpng), then a single pass deflate with
+//fixed Huffman codes and greedy hash matching compresses the image. Files are larger than with zlib, but it is a lot faster.
+
+
+//pixels has channels (3 = RGB, 4 = RGBA) bytes per pixel and no row padding
+//With flipVertically the first row in memory is the bottom of the image, the way glReadPixels returns it
+bool EncodePng(const unsigned char* pixels, int width, int height, int channels, std::vector<unsigned char>& png, bool flipVertically = false);
+
+bool WritePng(const std::string& path, const unsigned char* pixels, int width, int height, int channels, bool flipVertically = false);
@@ -1,31 +1,88 @@
 #include "IndexBuffer.h"
 
 #include "Renderer.h"
+#include "VertexPacking.h"
 
+#include <vector>
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
-    :m_Count(count)
+
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, bool primitiveRestart)
+    :m_RendererID(0), m_Count(count), m_Type(GL_UNSIGNED_INT), m_PrimitiveRestart(primitiveRestart)
 {
 
     ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
-    GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), data, GL_STATIC_DRAW));
+    //Never narrows to 8 bit, a lot of hardware converts byte indices on the CPU
+    //0xFFFF is reserved as restart index when primitive restart is used
+    unsigned int maxIndex = FindMaxIndex(data, count, primitiveRestart ? 0xFFFFFFFF : 0);
+    unsigned int limit = primitiveRestart ? 0xFFFF : 0x10000;
+
+    if (maxIndex < limit) {
+        std::vector<unsigned short> narrowed(count);
+        NarrowIndices(data, narrowed.data(), count);
+        Upload(narrowed.data(), count, GL_UNSIGNED_SHORT);
+    }
+    else
+        Upload(data, count, GL_UNSIGNED_INT);
 
 }
 
 
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int count, bool primitiveRestart)
+    :m_RendererID(0), m_Count(count), m_Type(GL_UNSIGNED_SHORT), m_PrimitiveRestart(primitiveRestart)
+{
+    Upload(data, count, GL_UNSIGNED_SHORT);
+}
+
+
+IndexBuffer::IndexBuffer(const unsigned char* data, unsigned int count, bool primitiveRestart)
+    :m_RendererID(0), m_Count(count), m_Type(GL_UNSIGNED_BYTE), m_PrimitiveRestart(primitiveRestart)
+{
+    Upload(data, count, GL_UNSIGNED_BYTE);
+}
+
+
 IndexBuffer::~IndexBuffer() {
     GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
 
+void IndexBuffer::Upload(const void* data, unsigned int count, unsigned int type) {
+
+    m_Type = type;
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * GetSizeOfType(type), data, GL_STATIC_DRAW));
+
+}
+
+
 void IndexBuffer::Bind() const {
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
 }
 
 
 void IndexBuffer::Unbind() const {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+}
+
+
+unsigned int IndexBuffer::GetRestartIndex() const {
+    switch (m_Type) {
+    case GL_UNSIGNED_BYTE:  return 0xFF;
+    case GL_UNSIGNED_SHORT: return 0xFFFF;
+    default:                return 0xFFFFFFFF;
+    }
+}
+
+
+unsigned int IndexBuffer::GetSizeOfType(unsigned int type) {
+    switch (type) {
+    case GL_UNSIGNED_BYTE:  return 1;
+    case GL_UNSIGNED_SHORT: return 2;
+    case GL_UNSIGNED_INT:   return 4;
+    }
+    ASSERT(false);
+    return 0;
 }
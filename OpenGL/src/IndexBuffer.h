@@ -5,14 +5,26 @@ class IndexBuffer {
 private:
 	unsigned int m_RendererID;
 	unsigned int m_Count;
+	unsigned int m_Type;	//GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	bool m_PrimitiveRestart;
 public:
-	IndexBuffer(const unsigned int* data, unsigned int count); //size = bytes, count = amount of elements
+	//32 bit indices are narrowed to 16 bit automatically if every index fits
+	//With primitiveRestart the maximum value of the index type (0xFFFFFFFF for 32 bit input) restarts the primitive
+	IndexBuffer(const unsigned int* data, unsigned int count, bool primitiveRestart = false); //size = bytes, count = amount of elements
+	IndexBuffer(const unsigned short* data, unsigned int count, bool primitiveRestart = false);
+	IndexBuffer(const unsigned char* data, unsigned int count, bool primitiveRestart = false);
 	~IndexBuffer();
 
 	void Bind() const;
 	void Unbind() const;
 
 	inline unsigned int GetCount() const { return m_Count; }
-};
+	inline unsigned int GetType() const { return m_Type; }
+	inline bool HasPrimitiveRestart() const { return m_PrimitiveRestart; }
+	unsigned int GetRestartIndex() const;
 
+	static unsigned int GetSizeOfType(unsigned int type);
 
+private:
+	void Upload(const void* data, unsigned int count, unsigned int type);
+};
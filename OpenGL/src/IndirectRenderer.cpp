@@ -0,0 +1,245 @@
+#include "IndirectRenderer.h"
+
+#include "VertexBufferLayout.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+
+
+unsigned int MeshPool::AddMesh(const MeshVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+
+	glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+	for (size_t i = 0; i < vertexCount; ++i) {
+		min = glm::min(min, vertices[i].Position);
+		max = glm::max(max, vertices[i].Position);
+	}
+
+	//An empty mesh gets a zero sphere at the origin
+	glm::vec3 center = vertexCount > 0 ? (min + max) * 0.5f : glm::vec3(0.0f);
+	float radius = 0.0f;
+	for (size_t i = 0; i < vertexCount; ++i)
+		radius = std::max(radius, glm::length(vertices[i].Position - center));
+
+	Mesh mesh;
+	mesh.IndexCount = (unsigned int)indexCount;
+	mesh.FirstIndex = (unsigned int)m_Indices.size();
+	mesh.BaseVertex = (int)m_Vertices.size();
+	mesh.BoundingSphere = glm::vec4(center, radius);
+	m_Meshes.push_back(mesh);
+
+	m_Vertices.insert(m_Vertices.end(), vertices, vertices + vertexCount);
+	m_Indices.insert(m_Indices.end(), indices, indices + indexCount);
+	return (unsigned int)m_Meshes.size() - 1;
+}
+
+
+void MeshPool::Upload() {
+	m_VBO = std::make_unique<VertexBuffer>(m_Vertices.data(), (unsigned int)(m_Vertices.size() * sizeof(MeshVertex)));
+	//Indices are relative to their mesh, so the pool usually still fits into 16 bit
+	m_IBO = std::make_unique<IndexBuffer>(m_Indices.data(), (unsigned int)m_Indices.size());
+}
+
+
+bool IndirectRenderer::IsSupported() {
+	return GLEW_VERSION_4_2 || (GLEW_ARB_draw_indirect && GLEW_ARB_base_instance);
+}
+
+
+bool IndirectRenderer::IsGpuCullingSupported() {
+	return GLEW_VERSION_4_3 || (GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_multi_draw_indirect);
+}
+
+
+IndirectRenderer::IndirectRenderer(const MeshPool& pool, unsigned int maxObjects)
+	: m_Pool(pool), m_MaxObjects(maxObjects), m_ObjectsDirty(false),
+	  m_MeshBuffer(0), m_CommandBuffer(0), m_ParameterBuffer(0), m_DrawCount(0), m_DrawCalls(0)
+{
+	m_ObjectBuffer = std::make_unique<VertexBuffer>(nullptr, maxObjects * (unsigned int)sizeof(GpuObject), true);
+
+	//Mesh attributes at 0-2, the model matrix as 4 vec4 columns at 3-6 advancing once per instance
+	VertexBufferElement modelColumns[4];
+	for (unsigned int column = 0; column < 4; ++column)
+		modelColumns[column] = { GL_FLOAT, 4, GL_FALSE, column * (unsigned int)sizeof(glm::vec4), GL_FALSE };
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_VAO->AddBuffer(pool.GetVertexBuffer(), s_MeshVertexLayout);
+	m_VAO->AddBuffer(*m_ObjectBuffer, VertexBufferLayout(modelColumns, 4, sizeof(GpuObject)), 3, 1);
+	pool.GetIndexBuffer().Bind();
+	m_VAO->Unbind();
+
+	GLCall(glGenBuffers(1, &m_CommandBuffer));
+	GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer));
+	GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, maxObjects * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW));
+
+	if (!IsGpuCullingSupported())
+		return;
+
+	//Same layout as the Mesh struct in CullIndirect.shader
+	struct GpuMesh {
+		uint32_t IndexCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t Padding;
+	};
+	std::vector<GpuMesh> meshes(pool.GetMeshCount());
+	for (unsigned int i = 0; i < meshes.size(); ++i) {
+		const MeshPool::Mesh& mesh = pool.GetMesh(i);
+		meshes[i] = { mesh.IndexCount, mesh.FirstIndex, mesh.BaseVertex, 0 };
+	}
+
+	GLCall(glGenBuffers(1, &m_MeshBuffer));
+	GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_MeshBuffer));
+	GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, meshes.size() * sizeof(GpuMesh), meshes.data(), GL_STATIC_DRAW));
+
+	//With ARB_indirect_parameters the shader appends visible commands and the draw count stays on the GPU,
+	//otherwise every object keeps its slot and culled ones get an instance count of 0
+	if (GLEW_ARB_indirect_parameters) {
+		GLCall(glGenBuffers(1, &m_ParameterBuffer));
+		GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_ParameterBuffer));
+		GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW));
+	}
+
+	m_CullShader = AssetManager::Get().Load<Shader>("res/shader/CullIndirect.shader");
+}
+
+
+IndirectRenderer::~IndirectRenderer() {
+	GLCall(glDeleteBuffers(1, &m_CommandBuffer));
+	if (m_MeshBuffer) {
+		GLCall(glDeleteBuffers(1, &m_MeshBuffer));
+	}
+	if (m_ParameterBuffer) {
+		GLCall(glDeleteBuffers(1, &m_ParameterBuffer));
+	}
+}
+
+
+unsigned int IndirectRenderer::AddObject(unsigned int mesh, const glm::mat4& model) {
+
+	if (m_Objects.size() >= m_MaxObjects) {
+		std::cout << "[IndirectRenderer] More than " << m_MaxObjects << " objects added" << std::endl;
+		return InvalidObject;
+	}
+
+	GpuObject object = {};
+	object.Mesh = mesh;
+	m_Objects.push_back(object);
+	m_Volumes.AddSphere(glm::vec3(0.0f), 0.0f);
+
+	unsigned int index = (unsigned int)m_Objects.size() - 1;
+	SetTransform(index, model);
+	return index;
+}
+
+
+void IndirectRenderer::SetTransform(unsigned int object, const glm::mat4& model) {
+
+	GpuObject& gpuObject = m_Objects[object];
+	gpuObject.Model = model;
+
+	//Sphere in world space, scaled by the largest axis so non uniform scale stays conservative
+	const glm::vec4& sphere = m_Pool.GetMesh(gpuObject.Mesh).BoundingSphere;
+	float scale = std::max(std::max(glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1]))), glm::length(glm::vec3(model[2])));
+	glm::vec3 center(model * glm::vec4(glm::vec3(sphere), 1.0f));
+	gpuObject.BoundingSphere = glm::vec4(center, sphere.w * scale);
+
+	m_Volumes.SetSphere(object, center, sphere.w * scale);
+	m_ObjectsDirty = true;
+}
+
+
+void IndirectRenderer::UploadObjects() {
+	if (!m_ObjectsDirty)
+		return;
+	m_ObjectBuffer->SetData(m_Objects.data(), (unsigned int)(m_Objects.size() * sizeof(GpuObject)));
+	m_ObjectsDirty = false;
+}
+
+
+void IndirectRenderer::CullGpu(const Frustum& frustum) {
+
+	unsigned int count = (unsigned int)m_Objects.size();
+
+	if (m_ParameterBuffer) {
+		uint32_t zero = 0;
+		GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_ParameterBuffer));
+		GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero));
+		GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_ParameterBuffer));
+	}
+
+	m_CullShader->Bind();
+	m_CullShader->SetUniform4fv("u_Planes", 6, frustum.Planes);
+	m_CullShader->SetUniform1ui("u_ObjectCount", count);
+	m_CullShader->SetUniform1i("u_Compact", m_ParameterBuffer != 0);
+
+	GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ObjectBuffer->GetRendererID()));
+	GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_MeshBuffer));
+	GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_CommandBuffer));
+
+	GLCall(glDispatchCompute((count + 63) / 64, 1, 1));
+	//The draw reads the commands (and the count) written by the shader
+	GLCall(glMemoryBarrier(GL_COMMAND_BARRIER_BIT));
+
+	m_DrawCount = count;
+}
+
+
+void IndirectRenderer::CullCpu(const Frustum& frustum) {
+
+	FrustumCuller::Cull(frustum, m_Volumes, m_Visible);
+
+	m_Commands.resize(m_Visible.size());
+	for (size_t i = 0; i < m_Visible.size(); ++i) {
+		unsigned int object = m_Visible[i];
+		const MeshPool::Mesh& mesh = m_Pool.GetMesh(m_Objects[object].Mesh);
+		m_Commands[i] = { mesh.IndexCount, 1, mesh.FirstIndex, mesh.BaseVertex, object };
+	}
+
+	GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer));
+	GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_Commands.size() * sizeof(DrawElementsIndirectCommand), m_Commands.data()));
+
+	m_DrawCount = (unsigned int)m_Commands.size();
+}
+
+
+void IndirectRenderer::Draw(const Frustum& frustum, const Shader& shader, IndirectCulling culling) {
+
+	m_DrawCalls = 0;
+	if (m_Objects.empty())
+		return;
+
+	UploadObjects();
+
+	bool gpu = culling == IndirectCulling::Gpu && m_CullShader;
+	if (gpu)
+		CullGpu(frustum);
+	else
+		CullCpu(frustum);
+
+	if (m_DrawCount == 0)
+		return;
+
+	shader.Bind();
+	m_VAO->Bind();
+	GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer));
+	unsigned int type = m_Pool.GetIndexBuffer().GetType();
+
+	if (gpu && m_ParameterBuffer) {
+		GLCall(glBindBuffer(GL_PARAMETER_BUFFER_ARB, m_ParameterBuffer));
+		GLCall(glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, type, nullptr, 0, m_DrawCount, 0));
+		m_DrawCalls = 1;
+	}
+	else if (GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect) {
+		GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, type, nullptr, m_DrawCount, 0));
+		m_DrawCalls = 1;
+	}
+	else {
+		for (unsigned int i = 0; i < m_DrawCount; ++i) {
+			GLCall(glDrawElementsIndirect(GL_TRIANGLES, type, (const void*)(i * sizeof(DrawElementsIndirectCommand))));
+		}
+		m_DrawCalls = m_DrawCount;
+	}
+
+	m_VAO->Unbind();
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Renderer.h"
+#include "AssetManager.h"
+#include "Culling.h"
+#include "MeshConverter.h"
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+//Layout glDrawElementsIndirect/glMultiDrawElementsIndirect read from GL_DRAW_INDIRECT_BUFFER
+struct DrawElementsIndirectCommand {
+	uint32_t Count;
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	int32_t BaseVertex;
+	uint32_t BaseInstance;
+};
+
+
+//Every mesh lives in one shared vertex and index buffer, so one VertexArray can draw all of them
+//Indices stay relative to the mesh, the draw commands add BaseVertex
+class MeshPool {
+public:
+	struct Mesh {
+		unsigned int IndexCount;
+		unsigned int FirstIndex;
+		int BaseVertex;
+		glm::vec4 BoundingSphere;	//Center and radius in model space
+	};
+
+	unsigned int AddMesh(const MeshVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+	//Creates the GPU buffers, meshes added afterwards need another Upload()
+	void Upload();
+
+	inline const Mesh& GetMesh(unsigned int mesh) const { return m_Meshes[mesh]; }
+	inline size_t GetMeshCount() const { return m_Meshes.size(); }
+	inline const VertexBuffer& GetVertexBuffer() const { return *m_VBO; }
+	inline const IndexBuffer& GetIndexBuffer() const { return *m_IBO; }
+
+private:
+	std::vector<MeshVertex> m_Vertices;
+	std::vector<unsigned int> m_Indices;
+	std::vector<Mesh> m_Meshes;
+
+	std::unique_ptr<VertexBuffer> m_VBO;
+	std::unique_ptr<IndexBuffer> m_IBO;
+};
+
+
+enum class IndirectCulling {
+	Gpu,	//Compute shader culls and writes the draw commands, nothing goes back to the CPU
+	Cpu		//FrustumCuller on the CPU, commands uploaded every frame
+};
+
+
+//Draws any amount of objects from a MeshPool with one glMultiDrawElementsIndirect call
+//Per object data sits in a buffer that is both the SSBO the culling shader reads and an instanced vertex
+//attribute (the model matrix) selected by the BaseInstance of each command
+//Shaders read the mesh attributes at locations 0-2 (MeshVertex) and the model matrix at locations 3-6
+class IndirectRenderer {
+public:
+	//Returned by AddObject once maxObjects objects were added
+	static const unsigned int InvalidObject = 0xFFFFFFFF;
+
+	IndirectRenderer(const MeshPool& pool, unsigned int maxObjects);
+	~IndirectRenderer();
+
+	unsigned int AddObject(unsigned int mesh, const glm::mat4& model);
+	void SetTransform(unsigned int object, const glm::mat4& model);
+	inline size_t GetObjectCount() const { return m_Objects.size(); }
+
+	void Draw(const Frustum& frustum, const Shader& shader, IndirectCulling culling);
+
+	//Visible objects of the last CPU culled Draw, the GPU path doesn't read its count back
+	inline size_t GetVisibleCount() const { return m_Visible.size(); }
+	//GL draw calls issued by the last Draw, one per command without ARB_multi_draw_indirect
+	inline unsigned int GetDrawCalls() const { return m_DrawCalls; }
+
+	//Indirect draws with BaseInstance (GL 4.2 + ARB_draw_indirect) are needed for either path
+	static bool IsSupported();
+	//Compute shaders and SSBOs (GL 4.3)
+	static bool IsGpuCullingSupported();
+
+private:
+	//std430 layout of the Object struct in CullIndirect.shader
+	struct GpuObject {
+		glm::mat4 Model;
+		glm::vec4 BoundingSphere;	//World space
+		uint32_t Mesh;
+		uint32_t Padding[3];
+	};
+
+	void UploadObjects();
+	void CullGpu(const Frustum& frustum);
+	void CullCpu(const Frustum& frustum);
+
+private:
+	const MeshPool& m_Pool;
+	unsigned int m_MaxObjects;
+
+	std::vector<GpuObject> m_Objects;
+	BoundingVolumes m_Volumes;
+	bool m_ObjectsDirty;
+
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_ObjectBuffer;
+	unsigned int m_MeshBuffer;
+	unsigned int m_CommandBuffer;
+	unsigned int m_ParameterBuffer;
+	unsigned int m_DrawCount;
+	unsigned int m_DrawCalls;
+	AssetRef<Shader> m_CullShader;
+
+	std::vector<unsigned int> m_Visible;
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+};
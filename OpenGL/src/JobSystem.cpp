@@ -0,0 +1,119 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+
+JobSystem::JobSystem(unsigned int threadCount)
+	: m_Pending(0), m_Running(true)
+{
+	if (threadCount == 0) {
+		unsigned int hardware = std::thread::hardware_concurrency();
+		threadCount = hardware > 1 ? hardware - 1 : 1;
+	}
+
+	m_Workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; ++i)
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this);
+}
+
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Running = false;
+	}
+	m_JobAvailable.notify_all();
+
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+
+JobSystem& JobSystem::Get() {
+	static JobSystem s_Instance;
+	return s_Instance;
+}
+
+
+void JobSystem::Submit(std::function<void()> job) {
+	m_Pending++;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Queue.push_back(std::move(job));
+	}
+	m_JobAvailable.notify_one();
+}
+
+
+bool JobSystem::RunOne() {
+
+	std::function<void()> job;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Queue.empty())
+			return false;
+		job = std::move(m_Queue.front());
+		m_Queue.pop_front();
+	}
+
+	job();
+
+	if (--m_Pending == 0) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_JobsDone.notify_all();
+	}
+	return true;
+}
+
+
+void JobSystem::WorkerLoop() {
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_JobAvailable.wait(lock, [this] { return !m_Queue.empty() || !m_Running; });
+			if (!m_Running && m_Queue.empty())
+				return;
+		}
+		RunOne();
+	}
+}
+
+
+void JobSystem::Wait() {
+
+	//Help out until the queue is drained, then wait for jobs still running on the workers
+	while (RunOne())
+		;
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_JobsDone.wait(lock, [this] { return m_Pending == 0; });
+}
+
+
+void JobSystem::ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)>& func) {
+
+	if (count == 0)
+		return;
+
+	batchSize = std::max<size_t>(batchSize, 1);
+	if (count <= batchSize) {
+		func(0, count);
+		return;
+	}
+
+	std::atomic<size_t> remaining((count + batchSize - 1) / batchSize);
+	for (size_t begin = 0; begin < count; begin += batchSize) {
+		size_t end = std::min(begin + batchSize, count);
+		Submit([&func, &remaining, begin, end] {
+			func(begin, end);
+			remaining--;
+		});
+	}
+
+	//Only waits for its own batches, so ParallelFor can be nested inside jobs without deadlocking
+	while (remaining > 0) {
+		if (!RunOne())
+			std::this_thread::yield();
+	}
+}
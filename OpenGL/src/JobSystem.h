@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//Fixed pool of worker threads with a shared FIFO queue
+//Wait() lets the calling thread work on the queue as well instead of just blocking
+class JobSystem {
+public:
+	//threadCount = 0 uses one worker per hardware thread except the calling one
+	JobSystem(unsigned int threadCount = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	void Submit(std::function<void()> job);
+	//Blocks until every submitted job has finished
+	void Wait();
+
+	//Splits [0, count) into batches of batchSize and runs func(begin, end) on each, returns when all are done
+	void ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)>& func);
+
+	//Amount of threads that execute jobs, including the one calling Wait()
+	inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size() + 1; }
+
+	//Shared instance used by the engine systems
+	static JobSystem& Get();
+
+private:
+	bool RunOne();
+	void WorkerLoop();
+
+private:
+	std::vector<std::thread> m_Workers;
+	std::deque<std::function<void()>> m_Queue;
+	std::mutex m_Mutex;
+	std::condition_variable m_JobAvailable;
+	std::condition_variable m_JobsDone;
+	std::atomic<size_t> m_Pending;
+	bool m_Running;
+};
@@ -0,0 +1,84 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+	: m_Data(nullptr), m_Size(0), m_File(INVALID_HANDLE_VALUE), m_Mapping(nullptr)
+{
+	m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE) {
+		std::cout << "[MappedFile] Failed to open " << path << '\n';
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_File, &size) || size.QuadPart == 0)
+		return;
+
+	m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_Mapping) {
+		std::cout << "[MappedFile] Failed to map " << path << '\n';
+		return;
+	}
+
+	m_Data = (const unsigned char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+	m_Size = m_Data ? (size_t)size.QuadPart : 0;
+}
+
+
+MappedFile::~MappedFile() {
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+	if (m_Mapping)
+		CloseHandle(m_Mapping);
+	if (m_File != INVALID_HANDLE_VALUE)
+		CloseHandle(m_File);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+	: m_Data(nullptr), m_Size(0)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		std::cout << "[MappedFile] Failed to open " << path << '\n';
+		return;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			m_Data = (const unsigned char*)data;
+			m_Size = (size_t)info.st_size;
+		}
+		else
+			std::cout << "[MappedFile] Failed to map " << path << '\n';
+	}
+
+	//The mapping stays valid after the descriptor is closed
+	close(fd);
+}
+
+
+MappedFile::~MappedFile() {
+	if (m_Data)
+		munmap((void*)m_Data, m_Size);
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "MeshConverter.h"
+
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+static const char* SkipSpaces(const char* p) {
+	while (*p == ' ' || *p == '\t')
+		++p;
+	return p;
+}
+
+
+//OBJ indices are 1 based, negative ones count back from the end of the list
+static int ResolveObjIndex(long index, size_t count) {
+	if (index > 0)
+		return (int)index - 1;
+	if (index < 0)
+		return (int)count + (int)index;
+	return -1;
+}
+
+
+bool LoadObj(const std::string& path, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices) {
+
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream) {
+		std::cout << "[OBJ] Failed to open " << path << '\n';
+		return false;
+	}
+
+	std::stringstream ss;
+	ss << stream.rdbuf();
+	std::string text = ss.str();
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> texCoords;
+	std::vector<glm::vec3> normals;
+
+	//Every face corner becomes its own vertex first, identical ones get welded afterwards
+	std::vector<MeshVertex> corners;
+	std::vector<MeshVertex> polygon;
+
+	const char* p = text.c_str();
+	while (*p) {
+		p = SkipSpaces(p);
+
+		if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+			glm::vec3 v;
+			char* end;
+			v.x = strtof(p + 2, &end);
+			v.y = strtof(end, &end);
+			v.z = strtof(end, &end);
+			positions.push_back(v);
+			p = end;
+		}
+		else if (p[0] == 'v' && p[1] == 't') {
+			glm::vec2 vt;
+			char* end;
+			vt.x = strtof(p + 2, &end);
+			vt.y = strtof(end, &end);
+			texCoords.push_back(vt);
+			p = end;
+		}
+		else if (p[0] == 'v' && p[1] == 'n') {
+			glm::vec3 vn;
+			char* end;
+			vn.x = strtof(p + 2, &end);
+			vn.y = strtof(end, &end);
+			vn.z = strtof(end, &end);
+			normals.push_back(vn);
+			p = end;
+		}
+		else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+			polygon.clear();
+			p = SkipSpaces(p + 1);
+
+			while (*p && *p != '\n' && *p != '\r') {
+				MeshVertex vertex = {};
+				char* end;
+
+				int v = ResolveObjIndex(strtol(p, &end, 10), positions.size());
+				int vt = -1, vn = -1;
+				if (*end == '/') {
+					if (end[1] != '/')
+						vt = ResolveObjIndex(strtol(end + 1, &end, 10), texCoords.size());
+					else
+						++end;
+					if (*end == '/')
+						vn = ResolveObjIndex(strtol(end + 1, &end, 10), normals.size());
+				}
+
+				if (end == p || v < 0 || v >= (int)positions.size()) {
+					std::cout << "[OBJ] Invalid face in " << path << '\n';
+					return false;
+				}
+
+				vertex.Position = positions[v];
+				if (vt >= 0 && vt < (int)texCoords.size())
+					vertex.TexCoord = texCoords[vt];
+				if (vn >= 0 && vn < (int)normals.size())
+					vertex.Normal = normals[vn];
+				polygon.push_back(vertex);
+
+				p = SkipSpaces(end);
+			}
+
+			for (size_t i = 2; i < polygon.size(); ++i) {
+				corners.push_back(polygon[0]);
+				corners.push_back(polygon[i - 1]);
+				corners.push_back(polygon[i]);
+			}
+		}
+
+		//Skip the rest of the line (comments, groups, materials, ...)
+		while (*p && *p != '\n')
+			++p;
+		if (*p)
+			++p;
+	}
+
+	std::vector<unsigned int> remap;
+	size_t unique = GenerateVertexRemap(remap, corners.data(), corners.size(), sizeof(MeshVertex));
+
+	vertices.resize(unique);
+	RemapVertices(vertices.data(), corners.data(), corners.size(), sizeof(MeshVertex), remap);
+
+	indices.resize(corners.size());
+	for (size_t i = 0; i < corners.size(); ++i)
+		indices[i] = remap[i];
+
+	return true;
+}
+
+
+bool ConvertObjToMesh(const std::string& objPath, const std::string& meshPath) {
+
+	std::vector<MeshVertex> vertices;
+	std::vector<unsigned int> indices;
+	if (!LoadObj(objPath, vertices, indices))
+		return false;
+
+	OptimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+
+	std::vector<MeshVertex> fetched(vertices.size());
+	size_t vertexCount = OptimizeVertexFetch(fetched.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(MeshVertex));
+
+	return MeshFile::Write(meshPath, s_MeshVertexLayout, fetched.data(), (unsigned int)vertexCount, indices.data(), (unsigned int)indices.size());
+}
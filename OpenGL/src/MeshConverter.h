@@ -0,0 +1,27 @@
+#pragma once
+
+#include "VertexBufferLayout.h"
+
+#include <string>
+#include <vector>
+
+
+//Vertex format of meshes imported from OBJ, position and texture coordinate match Basic.shader's attribute locations
+struct MeshVertex {
+	glm::vec3 Position;
+	glm::vec2 TexCoord;
+	glm::vec3 Normal;
+};
+
+static constexpr auto s_MeshVertexLayout = MakeVertexLayout<MeshVertex>(
+	VERTEX_ATTRIB(MeshVertex, Position),
+	VERTEX_ATTRIB(MeshVertex, TexCoord),
+	VERTEX_ATTRIB(MeshVertex, Normal)
+);
+
+
+//Parses a Wavefront OBJ (v/vt/vn/f, polygons are triangulated as fans) into an indexed triangle list
+bool LoadObj(const std::string& path, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices);
+
+//Imports an OBJ, optimizes it for the vertex cache and fetch order, and writes it as a MeshFile
+bool ConvertObjToMesh(const std::string& objPath, const std::string& meshPath);
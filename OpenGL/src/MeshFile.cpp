@@ -0,0 +1,129 @@
+#include "MeshFile.h"
+
+#include "VertexPacking.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+MeshFile::MeshFile(const std::string& path)
+	: m_File(path), m_Header(nullptr), m_Elements(nullptr)
+{
+	if (!m_File.IsOpen())
+		return;
+
+	size_t size = m_File.GetSize();
+	const MeshFileHeader* header = (const MeshFileHeader*)m_File.GetData();
+
+	if (size < sizeof(MeshFileHeader) || memcmp(header->Magic, "MESH", 4) != 0 || header->Version != MeshFileVersion ||
+		(header->IndexType != GL_UNSIGNED_SHORT && header->IndexType != GL_UNSIGNED_INT)) {
+		std::cout << "[MeshFile] " << path << " is not a mesh file or has the wrong version\n";
+		return;
+	}
+
+	if (sizeof(MeshFileHeader) + header->ElementCount * sizeof(MeshFileElement) > size ||
+		header->VertexDataOffset + header->VertexDataSize > size ||
+		header->IndexDataOffset + header->IndexDataSize > size ||
+		header->VertexDataSize != (uint64_t)header->VertexCount * header->VertexStride ||
+		header->IndexDataSize != (uint64_t)header->IndexCount * IndexBuffer::GetSizeOfType(header->IndexType)) {
+		std::cout << "[MeshFile] " << path << " is truncated or corrupt\n";
+		return;
+	}
+
+	m_Header = header;
+	m_Elements = (const MeshFileElement*)(m_File.GetData() + sizeof(MeshFileHeader));
+}
+
+
+VertexBufferLayout MeshFile::GetLayout() const {
+
+	std::vector<VertexBufferElement> elements(m_Header->ElementCount);
+	for (unsigned int i = 0; i < m_Header->ElementCount; ++i) {
+		const MeshFileElement& e = m_Elements[i];
+		elements[i] = { e.Type, e.Count, e.Normalized, e.Offset, e.Integer };
+	}
+
+	return VertexBufferLayout(elements.data(), (unsigned int)elements.size(), m_Header->VertexStride);
+}
+
+
+std::unique_ptr<VertexBuffer> MeshFile::CreateVertexBuffer() const {
+	return std::make_unique<VertexBuffer>(GetVertexData(), (unsigned int)m_Header->VertexDataSize);
+}
+
+
+std::unique_ptr<IndexBuffer> MeshFile::CreateIndexBuffer() const {
+	if (m_Header->IndexType == GL_UNSIGNED_SHORT)
+		return std::make_unique<IndexBuffer>((const unsigned short*)GetIndexData(), m_Header->IndexCount);
+	return std::make_unique<IndexBuffer>((const unsigned int*)GetIndexData(), m_Header->IndexCount);
+}
+
+
+static void WritePadding(std::ofstream& stream, uint64_t& position) {
+	static const char zeros[MeshFileAlignment] = {};
+	uint64_t padding = (MeshFileAlignment - position % MeshFileAlignment) % MeshFileAlignment;
+	stream.write(zeros, (std::streamsize)padding);
+	position += padding;
+}
+
+
+bool MeshFile::Write(const std::string& path, const VertexBufferElement* elements, unsigned int elementCount, unsigned int stride,
+	const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount) {
+
+	std::vector<uint16_t> narrowed;
+	bool narrow = FindMaxIndex(indices, indexCount) < 0x10000;
+	if (narrow) {
+		narrowed.resize(indexCount);
+		NarrowIndices(indices, narrowed.data(), indexCount);
+	}
+
+	MeshFileHeader header = {};
+	memcpy(header.Magic, "MESH", 4);
+	header.Version = MeshFileVersion;
+	header.ElementCount = elementCount;
+	header.VertexStride = stride;
+	header.VertexCount = vertexCount;
+	header.IndexCount = indexCount;
+	header.IndexType = narrow ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	header.VertexDataSize = (uint64_t)vertexCount * stride;
+	header.IndexDataSize = (uint64_t)indexCount * (narrow ? 2 : 4);
+
+	auto align = [](uint64_t position) { return (position + MeshFileAlignment - 1) / MeshFileAlignment * MeshFileAlignment; };
+	header.VertexDataOffset = align(sizeof(MeshFileHeader) + elementCount * sizeof(MeshFileElement));
+	header.IndexDataOffset = align(header.VertexDataOffset + header.VertexDataSize);
+
+	std::ofstream stream(path, std::ios::binary);
+	if (!stream) {
+		std::cout << "[MeshFile] Failed to create " << path << '\n';
+		return false;
+	}
+
+	uint64_t position = 0;
+	stream.write((const char*)&header, sizeof(header));
+	position += sizeof(header);
+
+	for (unsigned int i = 0; i < elementCount; ++i) {
+		MeshFileElement element = {};
+		element.Type = elements[i].type;
+		element.Count = elements[i].count;
+		element.Offset = elements[i].offset;
+		element.Normalized = elements[i].normalized;
+		element.Integer = elements[i].integer;
+		stream.write((const char*)&element, sizeof(element));
+		position += sizeof(element);
+	}
+
+	WritePadding(stream, position);
+	stream.write((const char*)vertices, (std::streamsize)header.VertexDataSize);
+	position += header.VertexDataSize;
+
+	WritePadding(stream, position);
+	if (narrow)
+		stream.write((const char*)narrowed.data(), (std::streamsize)header.IndexDataSize);
+	else
+		stream.write((const char*)indices, (std::streamsize)header.IndexDataSize);
+
+	return (bool)stream;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "VertexBufferLayout.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+//Binary mesh format, everything little endian:
+//	MeshFileHeader | MeshFileElement[ElementCount] | padding | vertex data | padding | index data
+//The vertex and index blobs are aligned to MeshFileAlignment so they can be handed to the GL straight from the mapping
+struct MeshFileHeader {
+	char Magic[4];				//"MESH"
+	uint32_t Version;
+	uint32_t ElementCount;
+	uint32_t VertexStride;
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	uint32_t IndexType;			//GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	uint32_t Reserved;
+	uint64_t VertexDataOffset;
+	uint64_t VertexDataSize;
+	uint64_t IndexDataOffset;
+	uint64_t IndexDataSize;
+};
+
+//Mirrors VertexBufferElement with fixed size members
+struct MeshFileElement {
+	uint32_t Type;
+	uint32_t Count;
+	uint32_t Offset;
+	uint8_t Normalized;
+	uint8_t Integer;
+	uint16_t Reserved;
+};
+
+static const uint32_t MeshFileVersion = 1;
+static const uint64_t MeshFileAlignment = 64;
+
+
+class MeshFile {
+public:
+	MeshFile(const std::string& path);
+
+	inline bool IsValid() const { return m_Header != nullptr; }
+
+	inline unsigned int GetVertexCount() const { return m_Header->VertexCount; }
+	inline unsigned int GetIndexCount() const { return m_Header->IndexCount; }
+	inline unsigned int GetIndexType() const { return m_Header->IndexType; }
+	inline const void* GetVertexData() const { return m_File.GetData() + m_Header->VertexDataOffset; }
+	inline const void* GetIndexData() const { return m_File.GetData() + m_Header->IndexDataOffset; }
+	VertexBufferLayout GetLayout() const;
+
+	//Upload straight from the mapped file, without an intermediate copy
+	std::unique_ptr<VertexBuffer> CreateVertexBuffer() const;
+	std::unique_ptr<IndexBuffer> CreateIndexBuffer() const;
+
+	//Indices are narrowed to 16 bit if possible
+	static bool Write(const std::string& path, const VertexBufferElement* elements, unsigned int elementCount, unsigned int stride,
+		const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+
+	static bool Write(const std::string& path, const VertexBufferLayout& layout,
+		const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount) {
+		return Write(path, layout.GetElements().data(), (unsigned int)layout.GetElements().size(), layout.GetStride(), vertices, vertexCount, indices, indexCount);
+	}
+
+	template<unsigned int N>
+	static bool Write(const std::string& path, const StaticVertexBufferLayout<N>& layout,
+		const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount) {
+		return Write(path, layout.Elements, N, layout.Stride, vertices, vertexCount, indices, indexCount);
+	}
+
+private:
+	MappedFile m_File;
+	const MeshFileHeader* m_Header;
+	const MeshFileElement* m_Elements;
+};
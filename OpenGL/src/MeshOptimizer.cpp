@@ -0,0 +1,540 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "glm/glm.hpp"
+
+
+//Vertex -> triangle adjacency in CSR form
+struct TriangleAdjacency {
+	std::vector<unsigned int> Counts;
+	std::vector<unsigned int> Offsets;
+	std::vector<unsigned int> Triangles;
+
+	TriangleAdjacency(const unsigned int* indices, size_t indexCount, size_t vertexCount)
+		: Counts(vertexCount, 0), Offsets(vertexCount, 0), Triangles(indexCount)
+	{
+		for (size_t i = 0; i < indexCount; ++i)
+			Counts[indices[i]]++;
+
+		unsigned int offset = 0;
+		for (size_t v = 0; v < vertexCount; ++v) {
+			Offsets[v] = offset;
+			offset += Counts[v];
+		}
+
+		std::vector<unsigned int> fill(Offsets);
+		for (size_t i = 0; i < indexCount; ++i)
+			Triangles[fill[indices[i]]++] = (unsigned int)(i / 3);
+	}
+};
+
+
+static uint32_t HashVertex(const unsigned char* data, size_t size) {
+
+	//MurmurHash2 style mixing over 4 byte words, bytewise for the tail
+	const uint32_t m = 0x5BD1E995;
+	uint32_t h = (uint32_t)size;
+
+	size_t i = 0;
+	for (; i + 4 <= size; i += 4) {
+		uint32_t k;
+		memcpy(&k, data + i, sizeof(k));
+		k *= m;
+		k ^= k >> 24;
+		k *= m;
+		h = (h * m) ^ k;
+	}
+	for (; i < size; ++i)
+		h = (h ^ data[i]) * m;
+
+	h ^= h >> 13;
+	h *= m;
+	h ^= h >> 15;
+	return h;
+}
+
+
+size_t GenerateVertexRemap(std::vector<unsigned int>& remap, const void* vertices, size_t vertexCount, size_t vertexSize) {
+
+	const unsigned char* data = (const unsigned char*)vertices;
+	const unsigned int empty = ~0u;
+
+	size_t capacity = 1;
+	while (capacity < vertexCount * 2)
+		capacity *= 2;
+
+	//Open addressing with linear probing, stores the original index of the first vertex with that content
+	std::vector<unsigned int> table(capacity, empty);
+	remap.assign(vertexCount, 0);
+
+	size_t unique = 0;
+	for (size_t v = 0; v < vertexCount; ++v) {
+
+		const unsigned char* vertex = data + v * vertexSize;
+		size_t slot = HashVertex(vertex, vertexSize) & (capacity - 1);
+
+		while (table[slot] != empty && memcmp(data + (size_t)table[slot] * vertexSize, vertex, vertexSize) != 0)
+			slot = (slot + 1) & (capacity - 1);
+
+		if (table[slot] == empty) {
+			table[slot] = (unsigned int)v;
+			remap[v] = (unsigned int)unique++;
+		}
+		else
+			remap[v] = remap[table[slot]];
+	}
+
+	return unique;
+}
+
+
+void RemapVertices(void* dst, const void* vertices, size_t vertexCount, size_t vertexSize, const std::vector<unsigned int>& remap) {
+	for (size_t v = 0; v < vertexCount; ++v)
+		memcpy((unsigned char*)dst + (size_t)remap[v] * vertexSize, (const unsigned char*)vertices + v * vertexSize, vertexSize);
+}
+
+
+void RemapIndices(unsigned int* dst, const unsigned int* indices, size_t indexCount, const std::vector<unsigned int>& remap) {
+	for (size_t i = 0; i < indexCount; ++i)
+		dst[i] = remap[indices[i]];
+}
+
+
+//Forsyth scoring, see https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+static const int s_ForsythCacheSize = 32;
+
+static float ForsythVertexScore(int cachePosition, unsigned int remainingTriangles) {
+
+	if (remainingTriangles == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0) {
+		//The last triangle's vertices get a fixed score so the next triangle doesn't just reuse the same edge
+		if (cachePosition < 3)
+			score = 0.75f;
+		else
+			score = std::pow(1.0f - (cachePosition - 3) / (float)(s_ForsythCacheSize - 3), 1.5f);
+	}
+
+	//Favour vertices with few triangles left so they don't end up as lonely leftovers
+	return score + 2.0f / std::sqrt((float)remainingTriangles);
+}
+
+
+void OptimizeVertexCache(unsigned int* dst, const unsigned int* indices, size_t indexCount, size_t vertexCount) {
+
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	//Work on a copy so dst may alias indices
+	std::vector<unsigned int> input(indices, indices + indexCount);
+	TriangleAdjacency adjacency(input.data(), indexCount, vertexCount);
+
+	std::vector<unsigned int> remaining(adjacency.Counts);
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+		vertexScore[v] = ForsythVertexScore(-1, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	for (size_t t = 0; t < triangleCount; ++t)
+		triangleScore[t] = vertexScore[input[t * 3]] + vertexScore[input[t * 3 + 1]] + vertexScore[input[t * 3 + 2]];
+
+	std::vector<bool> emitted(triangleCount, false);
+
+	unsigned int cache[s_ForsythCacheSize + 3];
+	unsigned int newCache[s_ForsythCacheSize + 3];
+	int cacheCount = 0;
+
+	size_t cursor = 0;
+	int best = -1;
+	size_t written = 0;
+
+	while (written < indexCount) {
+
+		//Nothing adjacent to the cache left, continue with the next triangle in input order
+		if (best < 0) {
+			while (emitted[cursor])
+				cursor++;
+			best = (int)cursor;
+		}
+
+		const unsigned int* tri = &input[(size_t)best * 3];
+		dst[written++] = tri[0];
+		dst[written++] = tri[1];
+		dst[written++] = tri[2];
+		emitted[best] = true;
+
+		//Remove the triangle from its vertices' adjacency lists
+		for (int k = 0; k < 3; ++k) {
+			unsigned int v = tri[k];
+			unsigned int* list = &adjacency.Triangles[adjacency.Offsets[v]];
+			for (unsigned int i = 0; i < remaining[v]; ++i) {
+				if (list[i] == (unsigned int)best) {
+					list[i] = list[remaining[v] - 1];
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		//Move the triangle's vertices to the front of the LRU cache
+		int newCount = 0;
+		newCache[newCount++] = tri[0];
+		newCache[newCount++] = tri[1];
+		newCache[newCount++] = tri[2];
+		for (int i = 0; i < cacheCount; ++i) {
+			unsigned int v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache[newCount++] = v;
+		}
+
+		//Everything past the cache size got evicted
+		for (int i = s_ForsythCacheSize; i < newCount; ++i) {
+			unsigned int v = newCache[i];
+			cachePosition[v] = -1;
+			float score = ForsythVertexScore(-1, remaining[v]);
+			float delta = score - vertexScore[v];
+			vertexScore[v] = score;
+
+			const unsigned int* list = &adjacency.Triangles[adjacency.Offsets[v]];
+			for (unsigned int j = 0; j < remaining[v]; ++j)
+				triangleScore[list[j]] += delta;
+		}
+
+		cacheCount = std::min(newCount, s_ForsythCacheSize);
+		memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+
+		//Rescore everything in the cache and find the best triangle touching it
+		for (int i = 0; i < cacheCount; ++i) {
+			unsigned int v = cache[i];
+			cachePosition[v] = i;
+			float score = ForsythVertexScore(i, remaining[v]);
+			float delta = score - vertexScore[v];
+			vertexScore[v] = score;
+
+			const unsigned int* list = &adjacency.Triangles[adjacency.Offsets[v]];
+			for (unsigned int j = 0; j < remaining[v]; ++j)
+				triangleScore[list[j]] += delta;
+		}
+
+		best = -1;
+		float bestScore = 0.0f;
+		for (int i = 0; i < cacheCount; ++i) {
+			unsigned int v = cache[i];
+			const unsigned int* list = &adjacency.Triangles[adjacency.Offsets[v]];
+			for (unsigned int j = 0; j < remaining[v]; ++j) {
+				if (triangleScore[list[j]] > bestScore) {
+					bestScore = triangleScore[list[j]];
+					best = (int)list[j];
+				}
+			}
+		}
+	}
+}
+
+
+static int TipsifySkipDeadEnd(const std::vector<unsigned int>& remaining, std::vector<unsigned int>& deadEnds, size_t& cursor, size_t vertexCount) {
+
+	while (!deadEnds.empty()) {
+		unsigned int v = deadEnds.back();
+		deadEnds.pop_back();
+		if (remaining[v] > 0)
+			return (int)v;
+	}
+
+	while (cursor < vertexCount) {
+		if (remaining[cursor] > 0)
+			return (int)cursor;
+		cursor++;
+	}
+
+	return -1;
+}
+
+
+void OptimizeVertexCacheTipsify(unsigned int* dst, const unsigned int* indices, size_t indexCount, size_t vertexCount,
+	unsigned int cacheSize, std::vector<unsigned int>* clusters) {
+
+	if (clusters)
+		clusters->clear();
+	if (indexCount < 3)
+		return;
+
+	std::vector<unsigned int> input(indices, indices + indexCount);
+	TriangleAdjacency adjacency(input.data(), indexCount, vertexCount);
+
+	std::vector<unsigned int> remaining(adjacency.Counts);
+	std::vector<unsigned int> timestamp(vertexCount, 0);
+	std::vector<bool> emitted(indexCount / 3, false);
+	std::vector<unsigned int> deadEnds;
+	std::vector<unsigned int> candidates;
+
+	unsigned int time = cacheSize + 1;
+	size_t cursor = 0;
+	size_t written = 0;
+
+	int fanning = TipsifySkipDeadEnd(remaining, deadEnds, cursor, vertexCount);
+	if (clusters)
+		clusters->push_back(0);
+
+	while (fanning >= 0) {
+
+		candidates.clear();
+
+		//Emit all remaining triangles around the fanning vertex
+		const unsigned int* list = &adjacency.Triangles[adjacency.Offsets[fanning]];
+		for (unsigned int i = 0; i < adjacency.Counts[fanning]; ++i) {
+			unsigned int t = list[i];
+			if (emitted[t])
+				continue;
+
+			for (int k = 0; k < 3; ++k) {
+				unsigned int v = input[t * 3 + k];
+				dst[written++] = v;
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				remaining[v]--;
+
+				if (time - timestamp[v] > cacheSize)
+					timestamp[v] = time++;
+			}
+			emitted[t] = true;
+		}
+
+		//Next fanning vertex: the one that is still in the cache after its remaining triangles are emitted, and oldest
+		int next = -1;
+		int bestPriority = -1;
+		for (unsigned int v : candidates) {
+			if (remaining[v] == 0)
+				continue;
+
+			int priority = 0;
+			if (time - timestamp[v] + 2 * remaining[v] <= cacheSize)
+				priority = (int)(time - timestamp[v]);
+
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				next = (int)v;
+			}
+		}
+
+		if (next < 0) {
+			next = TipsifySkipDeadEnd(remaining, deadEnds, cursor, vertexCount);
+			if (clusters && next >= 0 && written < indexCount)
+				clusters->push_back((unsigned int)(written / 3));
+		}
+
+		fanning = next;
+	}
+}
+
+
+//FIFO cache simulation, returns true if the vertex had to be transformed
+struct FifoCache {
+	std::vector<unsigned int> Timestamps;
+	unsigned int Time;
+	unsigned int Size;
+
+	FifoCache(size_t vertexCount, unsigned int size)
+		: Timestamps(vertexCount, 0), Time(size + 1), Size(size) {}
+
+	bool Access(unsigned int v) {
+		if (Time - Timestamps[v] > Size) {
+			Timestamps[v] = Time++;
+			return true;
+		}
+		return false;
+	}
+
+	//Makes every entry stale without touching the timestamps
+	void Reset() {
+		Time += Size + 1;
+	}
+};
+
+
+VertexCacheStatistics AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize) {
+
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> used(vertexCount, false);
+
+	unsigned int transformed = 0;
+	size_t unique = 0;
+	for (size_t i = 0; i < indexCount; ++i) {
+		transformed += cache.Access(indices[i]);
+		if (!used[indices[i]]) {
+			used[indices[i]] = true;
+			unique++;
+		}
+	}
+
+	VertexCacheStatistics stats;
+	stats.VerticesTransformed = transformed;
+	stats.ACMR = indexCount >= 3 ? transformed / (float)(indexCount / 3) : 0.0f;
+	stats.ATVR = unique > 0 ? transformed / (float)unique : 0.0f;
+	return stats;
+}
+
+
+
+VertexFetchStatistics AnalyzeVertexFetch(const unsigned int* indices, size_t indexCount, size_t vertexCount, size_t vertexSize,
+	unsigned int cacheSize, unsigned int cacheLines, unsigned int lineSize) {
+
+	FifoCache vertexCache(vertexCount, cacheSize);
+	FifoCache lineCache((vertexCount * vertexSize + lineSize - 1) / lineSize, cacheLines);
+	std::vector<bool> used(vertexCount, false);
+
+	size_t fetched = 0;
+	size_t unique = 0;
+	for (size_t i = 0; i < indexCount; ++i) {
+		unsigned int v = indices[i];
+		if (!used[v]) {
+			used[v] = true;
+			unique++;
+		}
+		if (!vertexCache.Access(v))
+			continue;
+
+		//A vertex can straddle two lines
+		size_t first = (size_t)v * vertexSize / lineSize;
+		size_t last = ((size_t)v * vertexSize + vertexSize - 1) / lineSize;
+		for (size_t line = first; line <= last; ++line)
+			fetched += lineCache.Access((unsigned int)line) ? lineSize : 0;
+	}
+
+	VertexFetchStatistics stats;
+	stats.BytesFetched = fetched;
+	stats.Overfetch = unique > 0 ? fetched / (float)(unique * vertexSize) : 0.0f;
+	return stats;
+}
+
+void OptimizeOverdraw(unsigned int* dst, const unsigned int* indices, size_t indexCount,
+	const float* positions, size_t vertexCount, size_t positionStride, float threshold) {
+
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	std::vector<unsigned int> input(indices, indices + indexCount);
+
+	//Hard boundaries: triangles where all three vertices miss the cache, the cache order is free to change there
+	std::vector<unsigned int> clusters;
+	{
+		FifoCache hardCache(vertexCount, 16);
+		for (size_t t = 0; t < triangleCount; ++t) {
+			unsigned int misses = hardCache.Access(input[t * 3]) + hardCache.Access(input[t * 3 + 1]) + hardCache.Access(input[t * 3 + 2]);
+			if (misses == 3 || t == 0)
+				clusters.push_back((unsigned int)t);
+		}
+	}
+
+	//Soft boundaries: split a hard cluster wherever its running ACMR is within threshold of the whole cluster's ACMR
+	std::vector<unsigned int> softClusters;
+	FifoCache cache(vertexCount, 16);
+	for (size_t c = 0; c < clusters.size(); ++c) {
+		size_t begin = clusters[c];
+		size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+		cache.Reset();
+		unsigned int clusterMisses = 0;
+		for (size_t t = begin; t < end; ++t)
+			for (int k = 0; k < 3; ++k)
+				clusterMisses += cache.Access(input[t * 3 + k]);
+		float clusterACMR = clusterMisses / (float)(end - begin);
+
+		cache.Reset();
+		unsigned int misses = 0;
+		size_t start = begin;
+		softClusters.push_back((unsigned int)begin);
+		for (size_t t = begin; t < end; ++t) {
+			for (int k = 0; k < 3; ++k)
+				misses += cache.Access(input[t * 3 + k]);
+
+			float runningACMR = misses / (float)(t - start + 1);
+			if (t + 1 < end && runningACMR <= clusterACMR * threshold) {
+				softClusters.push_back((unsigned int)(t + 1));
+				start = t + 1;
+				misses = 0;
+				cache.Reset();
+			}
+		}
+	}
+
+	auto position = [&](unsigned int v) {
+		const float* p = (const float*)((const unsigned char*)positions + (size_t)v * positionStride);
+		return glm::vec3(p[0], p[1], p[2]);
+	};
+
+	//Mesh centroid over all referenced vertices
+	glm::vec3 meshCentroid(0.0f);
+	for (size_t i = 0; i < indexCount; ++i)
+		meshCentroid += position(input[i]);
+	meshCentroid /= (float)indexCount;
+
+	//Clusters whose area weighted normal points away from the mesh center are likely in front, draw them first
+	size_t clusterCount = softClusters.size();
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t c = 0; c < clusterCount; ++c) {
+		size_t begin = softClusters[c];
+		size_t end = c + 1 < clusterCount ? softClusters[c + 1] : triangleCount;
+
+		glm::vec3 centroid(0.0f);
+		glm::vec3 normal(0.0f);
+		float area = 0.0f;
+		for (size_t t = begin; t < end; ++t) {
+			glm::vec3 a = position(input[t * 3]);
+			glm::vec3 b = position(input[t * 3 + 1]);
+			glm::vec3 c3 = position(input[t * 3 + 2]);
+			glm::vec3 n = glm::cross(b - a, c3 - a);
+			float triangleArea = glm::length(n);
+
+			centroid += (a + b + c3) * (triangleArea / 3.0f);
+			normal += n;
+			area += triangleArea;
+		}
+
+		float normalLength = glm::length(normal);
+		centroid = area > 0.0f ? centroid / area : centroid;
+		normal = normalLength > 0.0f ? normal / normalLength : normal;
+		sortKeys[c] = glm::dot(centroid - meshCentroid, normal);
+	}
+
+	std::vector<unsigned int> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; ++c)
+		order[c] = (unsigned int)c;
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](unsigned int a, unsigned int b) { return sortKeys[a] > sortKeys[b]; });
+
+	size_t written = 0;
+	for (unsigned int c : order) {
+		size_t begin = softClusters[c];
+		size_t end = c + 1 < clusterCount ? softClusters[c + 1] : triangleCount;
+		memcpy(dst + written, &input[begin * 3], (end - begin) * 3 * sizeof(unsigned int));
+		written += (end - begin) * 3;
+	}
+}
+
+
+size_t OptimizeVertexFetch(void* dst, unsigned int* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexSize) {
+
+	const unsigned int unused = ~0u;
+	std::vector<unsigned int> remap(vertexCount, unused);
+
+	size_t next = 0;
+	for (size_t i = 0; i < indexCount; ++i) {
+		unsigned int v = indices[i];
+		if (remap[v] == unused) {
+			remap[v] = (unsigned int)next++;
+			memcpy((unsigned char*)dst + remap[v] * vertexSize, (const unsigned char*)vertices + (size_t)v * vertexSize, vertexSize);
+		}
+		indices[i] = remap[v];
+	}
+
+	return next;
+}
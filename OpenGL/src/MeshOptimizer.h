@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+//CPU side mesh preprocessing, run at load time or offline before creating the VertexBuffer/IndexBuffer
+//All functions work on indexed triangle lists with 32 bit indices
+
+
+//Welds bit-identical vertices, remap[oldIndex] = newIndex
+//Returns the amount of unique vertices, apply with RemapVertices/RemapIndices
+size_t GenerateVertexRemap(std::vector<unsigned int>& remap, const void* vertices, size_t vertexCount, size_t vertexSize);
+void RemapVertices(void* dst, const void* vertices, size_t vertexCount, size_t vertexSize, const std::vector<unsigned int>& remap);
+void RemapIndices(unsigned int* dst, const unsigned int* indices, size_t indexCount, const std::vector<unsigned int>& remap);
+
+
+//Reorders triangles for post-transform vertex cache reuse (Tom Forsyth's linear speed algorithm)
+void OptimizeVertexCache(unsigned int* dst, const unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+//Tipsify (Sander et al. 2007): faster than Forsyth and tuned for a FIFO cache of cacheSize entries
+//clusters, if not null, receives the first triangle of every cluster that starts after a dead end
+void OptimizeVertexCacheTipsify(unsigned int* dst, const unsigned int* indices, size_t indexCount, size_t vertexCount,
+	unsigned int cacheSize = 16, std::vector<unsigned int>* clusters = nullptr);
+
+//Sorts clusters of a cache optimized index buffer so outward facing ones are drawn first, to reduce overdraw
+//positions points at the x of the first vertex, positionStride is the vertex size in bytes
+//threshold > 1 allows the vertex cache efficiency to get worse by that factor in exchange for smaller clusters
+void OptimizeOverdraw(unsigned int* dst, const unsigned int* indices, size_t indexCount,
+	const float* positions, size_t vertexCount, size_t positionStride, float threshold = 1.05f);
+
+//Reorders vertices in the order the index buffer first uses them and rewrites the indices in place
+//Returns the amount of referenced vertices, unreferenced ones are dropped
+size_t OptimizeVertexFetch(void* dst, unsigned int* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexSize);
+
+
+struct VertexCacheStatistics {
+	unsigned int VerticesTransformed;
+	float ACMR;	//Average cache miss ratio: transformed vertices per triangle, 0.5 is the best case for a regular grid
+	float ATVR;	//Average transformed vertex ratio: transformed vertices per unique vertex, 1.0 is optimal
+};
+
+//Simulates a FIFO post-transform cache of cacheSize entries
+VertexCacheStatistics AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16);
+
+
+struct VertexFetchStatistics {
+	size_t BytesFetched;
+	float Overfetch;	//Fetched bytes per byte of referenced vertex data, 1.0 is optimal
+};
+
+//Simulates the memory reads behind the post-transform cache: every vertex that misses a FIFO cache of cacheSize entries
+//is read through a FIFO cache of cacheLines lines of lineSize bytes
+VertexFetchStatistics AnalyzeVertexFetch(const unsigned int* indices, size_t indexCount, size_t vertexCount, size_t vertexSize,
+	unsigned int cacheSize = 16, unsigned int cacheLines = 64, unsigned int lineSize = 64);
@@ -0,0 +1,179 @@
+#include "PostProcess.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+
+PostProcess::PostProcess()
+	: m_BlurTapCount(0), m_BlurRadius(0), m_BlurTapsSigma(-1.0f)
+{
+	m_Settings.Bloom = true;
+	m_Settings.BloomThreshold = 1.0f;
+	m_Settings.BloomKnee = 0.5f;
+	m_Settings.BloomIntensity = 0.6f;
+	m_Settings.BloomLevels = 6;
+	m_Settings.BloomRadius = 1.0f;
+	m_Settings.Blur = false;
+	m_Settings.BlurSigma = 4.0f;
+	m_Settings.BlurDownscale = 2;
+	m_Settings.BlurAmount = 1.0f;
+	m_Settings.Exposure = 1.0f;
+	m_Settings.Tonemapper = 1;
+
+	m_DownsampleShader = AssetManager::Get().Load<Shader>("res/shader/BloomDownsample.shader");
+	m_UpsampleShader = AssetManager::Get().Load<Shader>("res/shader/BloomUpsample.shader");
+	m_BlurShader = AssetManager::Get().Load<Shader>("res/shader/Blur.shader");
+	m_TonemapShader = AssetManager::Get().Load<Shader>("res/shader/Tonemap.shader");
+}
+
+
+int PostProcess::ComputeBlurTaps(float sigma, glm::vec4* taps, int& radius)
+{
+	sigma = std::max(sigma, 0.1f);
+	radius = std::min((int)std::ceil(sigma * 3.0f), (int)MaxBlurRadius);
+
+	float weights[MaxBlurRadius + 2] = {};
+	float sum = 0.0f;
+	for (int i = 0; i <= radius; ++i) {
+		weights[i] = std::exp(-(float)(i * i) / (2.0f * sigma * sigma));
+		sum += i == 0 ? weights[i] : weights[i] * 2.0f;
+	}
+	for (int i = 0; i <= radius; ++i)
+		weights[i] /= sum;
+
+	//Texels i and i + 1 become one fetch between them at the offset where the bilinear weights match theirs
+	int count = 0;
+	taps[count++] = glm::vec4(0.0f, weights[0], 0.0f, 0.0f);
+	for (int i = 1; i <= radius; i += 2) {
+		float weight = weights[i] + weights[i + 1];
+		float offset = (i * weights[i] + (i + 1) * weights[i + 1]) / weight;
+		taps[count++] = glm::vec4(offset, weight, 0.0f, 0.0f);
+	}
+	return count;
+}
+
+
+RenderResource PostProcess::AddPasses(RenderGraph& graph, RenderResource hdrColor, RenderResource output)
+{
+	const PostProcessSettings settings = m_Settings;
+	const RenderTextureDesc input = graph.GetTextureDesc(hdrColor);
+	RenderResource bloom = InvalidRenderResource, blur = InvalidRenderResource;
+
+	//Box filtered halving, the first bloom level also applies the threshold
+	auto addDownsample = [&](const std::string& name, RenderResource source, int width, int height, bool prefilter) {
+		RenderResource target;
+		graph.AddPass(name, [&](RenderPassBuilder& builder) {
+			builder.Read(source);
+			target = builder.CreateTexture(name, { width, height, GL_R11F_G11F_B10F });
+		}, [this, source, prefilter, settings](RenderPassContext& context) {
+			const RenderTextureDesc& desc = context.GetTextureDesc(source);
+			m_DownsampleShader->Bind();
+			m_DownsampleShader->SetUniform1i("u_Source", 0);
+			m_DownsampleShader->SetUniform2f("u_TexelSize", 1.0f / desc.Width, 1.0f / desc.Height);
+			m_DownsampleShader->SetUniform2f("u_Threshold", settings.BloomThreshold, settings.BloomKnee);
+			m_DownsampleShader->SetUniform1i("u_Prefilter", prefilter ? 1 : 0);
+			context.BindTexture(source, 0);
+			context.DrawFullscreenTriangle();
+		});
+		return target;
+	};
+
+	if (settings.Bloom) {
+		RenderResource levels[MaxBloomLevels];
+		int levelCount = 0;
+		int width = std::max(input.Width / 2, 1), height = std::max(input.Height / 2, 1);
+		levels[levelCount++] = addDownsample("Bloom Threshold", hdrColor, width, height, true);
+		while (levelCount < std::min(settings.BloomLevels, (int)MaxBloomLevels) && width > 2 && height > 2) {
+			width /= 2;
+			height /= 2;
+			levels[levelCount] = addDownsample("Bloom Down " + std::to_string(levelCount), levels[levelCount - 1], width, height, false);
+			++levelCount;
+		}
+
+		//Each level gets the tent filtered level below it added
+		bloom = levels[levelCount - 1];
+		for (int level = levelCount - 2; level >= 0; --level) {
+			RenderResource source = bloom, base = levels[level];
+			std::string name = "Bloom Up " + std::to_string(level);
+			graph.AddPass(name, [&](RenderPassBuilder& builder) {
+				builder.Read(source);
+				builder.Read(base);
+				bloom = builder.CreateTexture(name, graph.GetTextureDesc(base));
+			}, [this, source, base, settings](RenderPassContext& context) {
+				const RenderTextureDesc& desc = context.GetTextureDesc(source);
+				m_UpsampleShader->Bind();
+				m_UpsampleShader->SetUniform1i("u_Source", 0);
+				m_UpsampleShader->SetUniform1i("u_Base", 1);
+				m_UpsampleShader->SetUniform2f("u_TexelSize", 1.0f / desc.Width, 1.0f / desc.Height);
+				m_UpsampleShader->SetUniform1f("u_Radius", settings.BloomRadius);
+				context.BindTexture(source, 0);
+				context.BindTexture(base, 1);
+				context.DrawFullscreenTriangle();
+			});
+		}
+	}
+
+	if (settings.Blur) {
+		if (settings.BlurSigma != m_BlurTapsSigma) {
+			m_BlurTapCount = ComputeBlurTaps(settings.BlurSigma, m_BlurTaps, m_BlurRadius);
+			m_BlurTapsSigma = settings.BlurSigma;
+		}
+
+		RenderResource source = hdrColor;
+		int width = input.Width, height = input.Height;
+		for (int downscale = 1; downscale < settings.BlurDownscale; downscale *= 2) {
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+			source = addDownsample("Blur Downsample " + std::to_string(downscale * 2), source, width, height, false);
+		}
+
+		auto addBlur = [&](const std::string& name, RenderResource from, bool horizontal) {
+			RenderResource target;
+			graph.AddPass(name, [&](RenderPassBuilder& builder) {
+				builder.Read(from);
+				target = builder.CreateTexture(name, { width, height, GL_R11F_G11F_B10F });
+			}, [this, from, horizontal](RenderPassContext& context) {
+				const RenderTextureDesc& desc = context.GetTextureDesc(from);
+				m_BlurShader->Bind();
+				m_BlurShader->SetUniform1i("u_Source", 0);
+				m_BlurShader->SetUniform2f("u_Direction", horizontal ? 1.0f / desc.Width : 0.0f, horizontal ? 0.0f : 1.0f / desc.Height);
+				m_BlurShader->SetUniform4fv("u_Taps", m_BlurTapCount, m_BlurTaps);
+				m_BlurShader->SetUniform1i("u_TapCount", m_BlurTapCount);
+				context.BindTexture(from, 0);
+				context.DrawFullscreenTriangle();
+			});
+			return target;
+		};
+		blur = addBlur("Blur Vertical", addBlur("Blur Horizontal", source, true), false);
+	}
+
+	graph.AddPass("Tonemap", [&](RenderPassBuilder& builder) {
+		builder.Read(hdrColor);
+		if (bloom != InvalidRenderResource)
+			builder.Read(bloom);
+		if (blur != InvalidRenderResource)
+			builder.Read(blur);
+		if (output != InvalidRenderResource)
+			builder.Write(output);
+		else
+			output = builder.CreateTexture("Tonemapped", { input.Width, input.Height, GL_RGBA8 });
+	}, [this, hdrColor, bloom, blur, settings](RenderPassContext& context) {
+		GLCall(glDisable(GL_DEPTH_TEST));
+		m_TonemapShader->Bind();
+		m_TonemapShader->SetUniform1i("u_Scene", 0);
+		m_TonemapShader->SetUniform1i("u_Bloom", 1);
+		m_TonemapShader->SetUniform1i("u_Blur", 2);
+		//Disabled stages sample the scene with a weight of 0
+		m_TonemapShader->SetUniform1f("u_BloomIntensity", bloom != InvalidRenderResource ? settings.BloomIntensity : 0.0f);
+		m_TonemapShader->SetUniform1f("u_BlurAmount", blur != InvalidRenderResource ? settings.BlurAmount : 0.0f);
+		m_TonemapShader->SetUniform1f("u_Exposure", settings.Exposure);
+		m_TonemapShader->SetUniform1i("u_Tonemapper", settings.Tonemapper);
+		context.BindTexture(hdrColor, 0);
+		context.BindTexture(bloom != InvalidRenderResource ? bloom : hdrColor, 1);
+		context.BindTexture(blur != InvalidRenderResource ? blur : hdrColor, 2);
+		context.DrawFullscreenTriangle();
+		GLCall(glActiveTexture(GL_TEXTURE0));
+	});
+	return output;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "AssetManager.h"
+#include "RenderGraph.h"
+
+#include "glm/glm.hpp"
+
+
+struct PostProcessSettings {
+	bool Bloom;
+	float BloomThreshold;		//HDR brightness where bloom starts
+	float BloomKnee;			//Width of the soft transition around the threshold
+	float BloomIntensity;
+	int BloomLevels;			//Size halvings from the half resolution threshold pass down, including it
+	float BloomRadius;			//Upsample tent radius in source texels
+
+	bool Blur;
+	float BlurSigma;			//Standard deviation in texels at the blur resolution
+	int BlurDownscale;			//1, 2 or 4, the blur runs at 1 / BlurDownscale of the input size
+	float BlurAmount;			//0 = sharp image, 1 = blurred image
+
+	float Exposure;
+	int Tonemapper;				//0 = Reinhard, 1 = ACES
+};
+
+
+//Post-processing stack added to a RenderGraph as fullscreen triangle passes
+//Bloom thresholds into a half resolution target, halves it down a chain of levels with a 4-tap box filter and walks the
+//chain back up with a 9-tap tent filter, adding each level on the way. Every full resolution texel is only read once, the
+//wide glow comes from the small levels. The blur is a separable Gaussian at a reduced resolution whose weights are
+//combined in pairs, so the bilinear filter reads two texels per fetch. Tonemapping combines everything into the output.
+class PostProcess {
+public:
+	PostProcess();
+
+	//Adds the passes that turn the HDR color into the tonemapped output, which may be an imported backbuffer
+	//Without an output the tonemap pass creates an RGBA8 texture of the input size. Returns the output.
+	RenderResource AddPasses(RenderGraph& graph, RenderResource hdrColor, RenderResource output = InvalidRenderResource);
+
+	inline PostProcessSettings& GetSettings() { return m_Settings; }
+
+	//Texture fetches per pixel of one blur direction, with and without the paired taps
+	inline int GetBlurFetches() const { return m_BlurTapCount * 2 - 1; }
+	inline int GetBlurNaiveFetches() const { return m_BlurRadius * 2 + 1; }
+
+	//Gaussian weights out to 3 sigma combined into bilinear taps, taps[0] is the center, x = offset in texels, y = weight
+	//Returns the number of taps, radius receives the number of texels covered on each side
+	static int ComputeBlurTaps(float sigma, glm::vec4* taps, int& radius);
+
+	static const int MaxBlurRadius = 32;
+	static const int MaxBlurTaps = MaxBlurRadius / 2 + 1;
+	static const int MaxBloomLevels = 8;
+
+private:
+	PostProcessSettings m_Settings;
+
+	AssetRef<Shader> m_DownsampleShader;
+	AssetRef<Shader> m_UpsampleShader;
+	AssetRef<Shader> m_BlurShader;
+	AssetRef<Shader> m_TonemapShader;
+
+	//Recomputed when the sigma changes
+	glm::vec4 m_BlurTaps[MaxBlurTaps];
+	int m_BlurTapCount;
+	int m_BlurRadius;
+	float m_BlurTapsSigma;
+};
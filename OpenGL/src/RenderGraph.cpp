@@ -0,0 +1,663 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <queue>
+
+
+static bool IsDepthFormat(unsigned int format)
+{
+	return format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F ||
+		format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+
+static bool HasStencil(unsigned int format)
+{
+	return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+
+static const char* GetFormatName(unsigned int format)
+{
+	switch (format) {
+	case GL_R8:					return "R8";
+	case GL_RG8:				return "RG8";
+	case GL_RGBA8:				return "RGBA8";
+	case GL_SRGB8_ALPHA8:		return "SRGB8_A8";
+	case GL_R16F:				return "R16F";
+	case GL_RG16F:				return "RG16F";
+	case GL_RGBA16F:			return "RGBA16F";
+	case GL_R32F:				return "R32F";
+	case GL_RG32F:				return "RG32F";
+	case GL_RGBA32F:			return "RGBA32F";
+	case GL_R11F_G11F_B10F:		return "R11G11B10F";
+	case GL_RGB10_A2:			return "RGB10_A2";
+	case GL_DEPTH_COMPONENT16:	return "D16";
+	case GL_DEPTH_COMPONENT24:	return "D24";
+	case GL_DEPTH_COMPONENT32F:	return "D32F";
+	case GL_DEPTH24_STENCIL8:	return "D24S8";
+	case GL_DEPTH32F_STENCIL8:	return "D32FS8";
+	}
+	return "?";
+}
+
+
+size_t RenderGraph::GetTextureSize(const RenderTextureDesc& desc)
+{
+	size_t bytesPerPixel = 4;
+	switch (desc.Format) {
+	case GL_R8:											bytesPerPixel = 1; break;
+	case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16:	bytesPerPixel = 2; break;
+	case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8:	bytesPerPixel = 8; break;
+	case GL_RGBA32F:									bytesPerPixel = 16; break;
+	}
+	return (size_t)desc.Width * desc.Height * bytesPerPixel;
+}
+
+
+RenderResource RenderPassBuilder::CreateTexture(const std::string& name, const RenderTextureDesc& desc)
+{
+	RenderResource resource = m_Graph.AddResource(name, RenderGraph::ResourceType::Texture, desc, RenderGraph::GetTextureSize(desc), m_Pass);
+	return Write(resource);
+}
+
+
+RenderResource RenderPassBuilder::CreateBuffer(const std::string& name, size_t size)
+{
+	RenderResource resource = m_Graph.AddResource(name, RenderGraph::ResourceType::Buffer, { 0, 0, 0 }, size, m_Pass);
+	return Write(resource);
+}
+
+
+RenderResource RenderPassBuilder::Read(RenderResource resource)
+{
+	RenderGraph::Pass& pass = m_Graph.m_Passes[m_Pass];
+	if (std::find(pass.Reads.begin(), pass.Reads.end(), resource) == pass.Reads.end()) {
+		pass.Reads.push_back(resource);
+		m_Graph.m_Resources[resource].Readers.push_back(m_Pass);
+	}
+	return resource;
+}
+
+
+RenderResource RenderPassBuilder::Write(RenderResource resource)
+{
+	RenderGraph::Pass& pass = m_Graph.m_Passes[m_Pass];
+	if (std::find(pass.Writes.begin(), pass.Writes.end(), resource) == pass.Writes.end()) {
+		pass.Writes.push_back(resource);
+		m_Graph.m_Resources[resource].Writers.push_back(m_Pass);
+	}
+	return resource;
+}
+
+
+void RenderPassBuilder::SetSideEffect()
+{
+	m_Graph.m_Passes[m_Pass].SideEffect = true;
+}
+
+
+unsigned int RenderPassContext::GetTexture(RenderResource resource) const
+{
+	const RenderGraph::Resource& entry = m_Graph.m_Resources[resource];
+	if (entry.Imported)
+		return entry.ImportedID;
+	return entry.Physical >= 0 ? m_Graph.m_Pool[entry.Physical].RendererID : 0;
+}
+
+
+unsigned int RenderPassContext::GetBuffer(RenderResource resource) const
+{
+	return GetTexture(resource);
+}
+
+
+const RenderTextureDesc& RenderPassContext::GetTextureDesc(RenderResource resource) const
+{
+	return m_Graph.m_Resources[resource].Desc;
+}
+
+
+void RenderPassContext::BindTexture(RenderResource resource, unsigned int slot) const
+{
+	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+	GLCall(glBindTexture(GL_TEXTURE_2D, GetTexture(resource)));
+}
+
+
+void RenderPassContext::DrawFullscreenTriangle() const
+{
+	GLCall(glBindVertexArray(m_Graph.m_EmptyVAO));
+	GLCall(glDrawArrays(GL_TRIANGLES, 0, 3));
+}
+
+
+RenderGraph::RenderGraph()
+	: m_Compiled(false), m_Aliasing(true), m_Framebuffer(0), m_EmptyVAO(0), m_Frame(0), m_CulledPasses(0), m_TransientMemory(0),
+	  m_AliasedMemory(0), m_Profiling(false)
+{
+	for (TimerFrame& timers : m_Timers)
+		timers.Used = 0;
+
+	GLCall(glGenFramebuffers(1, &m_Framebuffer));
+	GLCall(glGenVertexArrays(1, &m_EmptyVAO));
+}
+
+
+RenderGraph::~RenderGraph()
+{
+	for (PhysicalResource& physical : m_Pool)
+		DestroyPhysical(physical);
+	for (TimerFrame& timers : m_Timers) {
+		if (!timers.Queries.empty()) {
+			GLCall(glDeleteQueries((GLsizei)timers.Queries.size(), timers.Queries.data()));
+		}
+	}
+	GLCall(glDeleteFramebuffers(1, &m_Framebuffer));
+	GLCall(glDeleteVertexArrays(1, &m_EmptyVAO));
+}
+
+
+void RenderGraph::Reset()
+{
+	m_Passes.clear();
+	m_Resources.clear();
+	m_Order.clear();
+	m_Compiled = false;
+	++m_Frame;
+}
+
+
+RenderResource RenderGraph::AddResource(const std::string& name, ResourceType type, const RenderTextureDesc& desc, size_t size, unsigned int creator)
+{
+	Resource resource;
+	resource.Name = name;
+	resource.Type = type;
+	resource.Desc = desc;
+	resource.Size = size;
+	resource.Imported = false;
+	resource.ImportedID = 0;
+	resource.Creator = creator;
+	resource.RefCount = 0;
+	resource.FirstUse = resource.LastUse = -1;
+	resource.Physical = -1;
+	m_Resources.push_back(resource);
+	return (RenderResource)(m_Resources.size() - 1);
+}
+
+
+RenderResource RenderGraph::ImportTexture(const std::string& name, unsigned int texture, const RenderTextureDesc& desc)
+{
+	RenderResource resource = AddResource(name, ResourceType::Texture, desc, GetTextureSize(desc), 0);
+	m_Resources[resource].Imported = true;
+	m_Resources[resource].ImportedID = texture;
+	return resource;
+}
+
+
+void RenderGraph::AddPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute)
+{
+	m_Passes.push_back({ name, execute, {}, {}, false, 0, false });
+	m_Compiled = false;
+
+	RenderPassBuilder builder(*this, (unsigned int)(m_Passes.size() - 1));
+	setup(builder);
+}
+
+
+bool RenderGraph::Compile()
+{
+	m_Order.clear();
+	m_Compiled = false;
+
+	//Every read of a transient resource needs a writer, imported ones already hold data
+	for (const Resource& resource : m_Resources) {
+		if (!resource.Imported && resource.Writers.empty() && !resource.Readers.empty()) {
+			std::cout << "[RenderGraph] Pass " << m_Passes[resource.Readers.front()].Name << " reads " << resource.Name << " which nothing writes" << std::endl;
+			return false;
+		}
+	}
+
+	//Topological sort (Kahn) along the data flow: the writers of a resource run one after another, the creator first and
+	//the others in the order they were added, and every pass that only reads it runs after the last writer
+	//Ready passes run in the order they were added, so independent passes keep a deterministic order
+	std::vector<std::vector<unsigned int>> edges(m_Passes.size());
+	std::vector<unsigned int> incoming(m_Passes.size(), 0);
+	auto addEdge = [&](unsigned int from, unsigned int to) {
+		if (from == to || std::find(edges[from].begin(), edges[from].end(), to) != edges[from].end())
+			return;
+		edges[from].push_back(to);
+		++incoming[to];
+	};
+	std::vector<unsigned int> writers;
+	for (const Resource& resource : m_Resources) {
+		if (resource.Writers.empty())
+			continue;
+
+		writers = resource.Writers;
+		std::sort(writers.begin(), writers.end());
+		if (!resource.Imported) {
+			auto creator = std::find(writers.begin(), writers.end(), resource.Creator);
+			if (creator != writers.end())
+				std::rotate(writers.begin(), creator, creator + 1);
+		}
+		for (size_t i = 1; i < writers.size(); ++i)
+			addEdge(writers[i - 1], writers[i]);
+
+		for (unsigned int reader : resource.Readers) {
+			if (std::find(writers.begin(), writers.end(), reader) == writers.end())
+				addEdge(writers.back(), reader);
+		}
+	}
+
+	std::priority_queue<unsigned int, std::vector<unsigned int>, std::greater<unsigned int>> ready;
+	for (unsigned int pass = 0; pass < m_Passes.size(); ++pass) {
+		if (incoming[pass] == 0)
+			ready.push(pass);
+	}
+	while (!ready.empty()) {
+		unsigned int pass = ready.top();
+		ready.pop();
+		m_Order.push_back(pass);
+		for (unsigned int next : edges[pass]) {
+			if (--incoming[next] == 0)
+				ready.push(next);
+		}
+	}
+
+	//Passes left over wait on each other, e.g. two passes that each read what the other one writes
+	if (m_Order.size() != m_Passes.size()) {
+		for (unsigned int pass = 0; pass < m_Passes.size(); ++pass) {
+			if (incoming[pass] > 0)
+				std::cout << "[RenderGraph] Pass " << m_Passes[pass].Name << " is part of or waits on a dependency cycle" << std::endl;
+		}
+		m_Order.clear();
+		return false;
+	}
+
+	//Culling: a pass stays if something reads one of its outputs, unread resources release their writers and the
+	//inputs of culled writers may become unread in turn
+	std::vector<RenderResource> unreferenced;
+	for (RenderResource resource = 0; resource < m_Resources.size(); ++resource) {
+		Resource& entry = m_Resources[resource];
+		entry.RefCount = (unsigned int)entry.Readers.size() + (entry.Imported ? 1 : 0);
+		entry.FirstUse = entry.LastUse = -1;
+		entry.Physical = -1;
+		if (entry.RefCount == 0)
+			unreferenced.push_back(resource);
+	}
+
+	auto cull = [&](Pass& pass) {
+		pass.Culled = true;
+		for (RenderResource read : pass.Reads) {
+			if (--m_Resources[read].RefCount == 0)
+				unreferenced.push_back(read);
+		}
+	};
+
+	for (Pass& pass : m_Passes) {
+		pass.RefCount = (unsigned int)pass.Writes.size();
+		pass.Culled = false;
+	}
+	for (Pass& pass : m_Passes) {
+		if (pass.RefCount == 0 && !pass.SideEffect)
+			cull(pass);
+	}
+	while (!unreferenced.empty()) {
+		Resource& resource = m_Resources[unreferenced.back()];
+		unreferenced.pop_back();
+		for (unsigned int writer : resource.Writers) {
+			Pass& pass = m_Passes[writer];
+			if (!pass.Culled && --pass.RefCount == 0 && !pass.SideEffect)
+				cull(pass);
+		}
+	}
+
+	//Lifetimes as positions in the execution order
+	m_CulledPasses = 0;
+	for (int position = 0; position < (int)m_Order.size(); ++position) {
+		const Pass& pass = m_Passes[m_Order[position]];
+		if (pass.Culled) {
+			++m_CulledPasses;
+			continue;
+		}
+		for (const std::vector<RenderResource>* resources : { &pass.Reads, &pass.Writes }) {
+			for (RenderResource resource : *resources) {
+				Resource& entry = m_Resources[resource];
+				if (entry.FirstUse < 0)
+					entry.FirstUse = position;
+				entry.LastUse = position;
+			}
+		}
+	}
+
+	//Physical resources, handed out at the first use and free again after the last
+	for (PhysicalResource& physical : m_Pool)
+		physical.FreeAfter = -1;
+	m_TransientMemory = 0;
+	m_AliasedMemory = 0;
+	for (int position = 0; position < (int)m_Order.size(); ++position) {
+		const Pass& pass = m_Passes[m_Order[position]];
+		if (pass.Culled)
+			continue;
+		for (const std::vector<RenderResource>* resources : { &pass.Reads, &pass.Writes }) {
+			for (RenderResource resource : *resources) {
+				Resource& entry = m_Resources[resource];
+				if (entry.Imported || entry.FirstUse != position || entry.Physical >= 0)
+					continue;
+				entry.Physical = Acquire(entry, position);
+				m_TransientMemory += entry.Size;
+			}
+		}
+	}
+
+	//Trims what the graph hasn't needed for a while, e.g. the render targets of an old window size
+	for (PhysicalResource& physical : m_Pool) {
+		if (physical.RendererID && m_Frame - physical.LastUsedFrame > UnusedLifetime)
+			DestroyPhysical(physical);
+	}
+
+	m_Compiled = true;
+	return true;
+}
+
+
+int RenderGraph::Acquire(const Resource& resource, int position)
+{
+	//Free physical resource of the same kind, for buffers the smallest one that is large enough without wasting half of it
+	int best = -1, empty = -1;
+	for (int i = 0; i < (int)m_Pool.size(); ++i) {
+		const PhysicalResource& physical = m_Pool[i];
+		if (!physical.RendererID) {
+			empty = i;
+			continue;
+		}
+		if (physical.Type != resource.Type || physical.FreeAfter >= position)
+			continue;
+
+		if (resource.Type == ResourceType::Texture) {
+			if (physical.Desc == resource.Desc) {
+				best = i;
+				break;
+			}
+		}
+		else if (physical.Size >= resource.Size && physical.Size <= resource.Size * 2 && (best < 0 || physical.Size < m_Pool[best].Size)) {
+			best = i;
+		}
+	}
+
+	if (best < 0) {
+		PhysicalResource physical = { resource.Type, resource.Desc, resource.Size, 0, -1, 0 };
+		CreatePhysical(physical);
+		if (empty >= 0) {
+			m_Pool[empty] = physical;
+			best = empty;
+		}
+		else {
+			m_Pool.push_back(physical);
+			best = (int)m_Pool.size() - 1;
+		}
+	}
+
+	PhysicalResource& physical = m_Pool[best];
+	//Counted once per frame, however many resources end up in it
+	if (physical.FreeAfter < 0)
+		m_AliasedMemory += physical.Size;
+	physical.FreeAfter = m_Aliasing ? resource.LastUse : INT_MAX;
+	physical.LastUsedFrame = m_Frame;
+	return best;
+}
+
+
+void RenderGraph::CreatePhysical(PhysicalResource& physical)
+{
+	if (physical.Type == ResourceType::Buffer) {
+		GLCall(glGenBuffers(1, &physical.RendererID));
+		GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, physical.RendererID));
+		GLCall(glBufferData(GL_COPY_WRITE_BUFFER, physical.Size, nullptr, GL_DYNAMIC_COPY));
+		GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+		return;
+	}
+
+	const RenderTextureDesc& desc = physical.Desc;
+	GLCall(glGenTextures(1, &physical.RendererID));
+	GLCall(glBindTexture(GL_TEXTURE_2D, physical.RendererID));
+
+	if (GLEW_VERSION_4_2 || GLEW_ARB_texture_storage) {
+		GLCall(glTexStorage2D(GL_TEXTURE_2D, 1, desc.Format, desc.Width, desc.Height));
+	}
+	else {
+		//No data is uploaded, the format and type only have to be a valid combination for the internal format
+		unsigned int format = HasStencil(desc.Format) ? GL_DEPTH_STENCIL : IsDepthFormat(desc.Format) ? GL_DEPTH_COMPONENT : GL_RGBA;
+		unsigned int type = HasStencil(desc.Format) ? GL_UNSIGNED_INT_24_8 : IsDepthFormat(desc.Format) ? GL_FLOAT : GL_UNSIGNED_BYTE;
+		if (desc.Format == GL_DEPTH32F_STENCIL8)
+			type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+		GLCall(glTexImage2D(GL_TEXTURE_2D, 0, desc.Format, desc.Width, desc.Height, 0, format, type, nullptr));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+	}
+
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+
+void RenderGraph::DestroyPhysical(PhysicalResource& physical)
+{
+	if (!physical.RendererID)
+		return;
+
+	if (physical.Type == ResourceType::Buffer) {
+		GLCall(glDeleteBuffers(1, &physical.RendererID));
+	}
+	else {
+		GLCall(glDeleteTextures(1, &physical.RendererID));
+	}
+	physical.RendererID = 0;
+}
+
+
+size_t RenderGraph::GetPoolMemory() const
+{
+	size_t size = 0;
+	for (const PhysicalResource& physical : m_Pool) {
+		if (physical.RendererID)
+			size += physical.Size;
+	}
+	return size;
+}
+
+
+void RenderGraph::BindFramebuffer(const Pass& pass)
+{
+	RenderPassContext context(*this);
+
+	std::vector<RenderResource> colors;
+	RenderResource depth = InvalidRenderResource;
+	bool defaultFramebuffer = false;
+	for (RenderResource resource : pass.Writes) {
+		const Resource& entry = m_Resources[resource];
+		if (entry.Type != ResourceType::Texture)
+			continue;
+		if (entry.Imported && entry.ImportedID == 0)
+			defaultFramebuffer = true;
+		else if (IsDepthFormat(entry.Desc.Format))
+			depth = resource;
+		else
+			colors.push_back(resource);
+	}
+
+	//Passes that only write buffers keep whatever is bound
+	if (!defaultFramebuffer && colors.empty() && depth == InvalidRenderResource)
+		return;
+
+	const RenderTextureDesc* size = nullptr;
+	if (defaultFramebuffer) {
+		GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+		for (RenderResource resource : pass.Writes) {
+			if (m_Resources[resource].Imported && m_Resources[resource].ImportedID == 0)
+				size = &m_Resources[resource].Desc;
+		}
+	}
+	else {
+		GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer));
+
+		//Attachments of the previous pass that aren't overwritten are detached
+		GLint maxColors = 0;
+		GLCall(glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &maxColors));
+		std::vector<unsigned int> drawBuffers;
+		for (int i = 0; i < maxColors && i < 8; ++i) {
+			unsigned int texture = i < (int)colors.size() ? context.GetTexture(colors[i]) : 0;
+			GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, texture, 0));
+			if (texture)
+				drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + i);
+		}
+
+		unsigned int depthTexture = depth != InvalidRenderResource ? context.GetTexture(depth) : 0;
+		bool stencil = depth != InvalidRenderResource && HasStencil(m_Resources[depth].Desc.Format);
+		GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0, 0));
+		GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0));
+
+		if (drawBuffers.empty()) {
+			GLCall(glDrawBuffer(GL_NONE));
+		}
+		else {
+			GLCall(glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data()));
+		}
+
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		if (status != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "[RenderGraph] Framebuffer of pass " << pass.Name << " is incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+
+		size = &m_Resources[colors.empty() ? depth : colors.front()].Desc;
+	}
+
+	if (size) {
+		GLCall(glViewport(0, 0, size->Width, size->Height));
+	}
+}
+
+
+void RenderGraph::Execute()
+{
+	if (!m_Compiled && !Compile())
+		return;
+
+	GLint viewport[4];
+	GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+
+	TimerFrame& timers = m_Timers[m_Frame % TimerLatency];
+	CollectTimers(timers);
+
+	RenderPassContext context(*this);
+	for (unsigned int index : m_Order) {
+		Pass& pass = m_Passes[index];
+		if (pass.Culled)
+			continue;
+		BindFramebuffer(pass);
+
+		if (m_Profiling) {
+			if (timers.Used == timers.Queries.size()) {
+				timers.Queries.push_back(0);
+				GLCall(glGenQueries(1, &timers.Queries.back()));
+			}
+			if (timers.Names.size() <= timers.Used)
+				timers.Names.resize(timers.Used + 1);
+			timers.Names[timers.Used] = pass.Name;
+			GLCall(glBeginQuery(GL_TIME_ELAPSED, timers.Queries[timers.Used]));
+			pass.Execute(context);
+			GLCall(glEndQuery(GL_TIME_ELAPSED));
+			++timers.Used;
+		}
+		else {
+			pass.Execute(context);
+		}
+	}
+
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+	GLCall(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+}
+
+
+void RenderGraph::CollectTimers(TimerFrame& timers)
+{
+	if (timers.Used > 0) {
+		//Queries finish in order, if the last one is ready all of them are. Otherwise the GPU is more than
+		//TimerLatency frames behind and the frame is skipped rather than waited for.
+		GLuint available = 0;
+		GLCall(glGetQueryObjectuiv(timers.Queries[timers.Used - 1], GL_QUERY_RESULT_AVAILABLE, &available));
+		if (available) {
+			m_PassTimes.resize(timers.Used);
+			for (size_t i = 0; i < timers.Used; ++i) {
+				GLuint64 ns = 0;
+				GLCall(glGetQueryObjectui64v(timers.Queries[i], GL_QUERY_RESULT, &ns));
+				m_PassTimes[i].Name = timers.Names[i];
+				m_PassTimes[i].Ms = ns / 1000000.0f;
+			}
+		}
+	}
+	else if (!m_Profiling) {
+		m_PassTimes.clear();
+	}
+	timers.Used = 0;
+}
+
+
+std::string RenderGraph::Dump() const
+{
+	std::string dump;
+	char line[256];
+
+	auto names = [this](const std::vector<RenderResource>& resources) {
+		std::string list;
+		for (RenderResource resource : resources)
+			list += (list.empty() ? "" : ", ") + m_Resources[resource].Name;
+		return list.empty() ? std::string("-") : list;
+	};
+
+	snprintf(line, sizeof(line), "%zu passes, %zu culled, %zu resources\n\n", m_Passes.size(), m_CulledPasses, m_Resources.size());
+	dump += line;
+
+	int position = 0;
+	for (unsigned int index : m_Order) {
+		const Pass& pass = m_Passes[index];
+		if (pass.Culled)
+			snprintf(line, sizeof(line), "  -  %-16s culled\n", pass.Name.c_str());
+		else
+			snprintf(line, sizeof(line), "%3d  %-16s\n", position, pass.Name.c_str());
+		dump += line;
+		dump += "       reads  " + names(pass.Reads) + "\n";
+		dump += "       writes " + names(pass.Writes) + "\n";
+		++position;
+	}
+
+	dump += "\n";
+	for (const Resource& resource : m_Resources) {
+		char description[64];
+		if (resource.Type == ResourceType::Texture)
+			snprintf(description, sizeof(description), "%dx%d %s", resource.Desc.Width, resource.Desc.Height, GetFormatName(resource.Desc.Format));
+		else
+			snprintf(description, sizeof(description), "buffer");
+
+		if (resource.Imported)
+			snprintf(line, sizeof(line), "%-16s %-22s imported\n", resource.Name.c_str(), description);
+		else if (resource.FirstUse < 0)
+			snprintf(line, sizeof(line), "%-16s %-22s %7.2f MB  unused\n", resource.Name.c_str(), description, resource.Size / (1024.0 * 1024.0));
+		else
+			snprintf(line, sizeof(line), "%-16s %-22s %7.2f MB  passes %d-%d  -> #%d\n", resource.Name.c_str(), description,
+				resource.Size / (1024.0 * 1024.0), resource.FirstUse, resource.LastUse, resource.Physical);
+		dump += line;
+	}
+
+	snprintf(line, sizeof(line), "\nTransient %.2f MB, placed in %.2f MB (%.2f MB saved by aliasing), pool %.2f MB\n",
+		m_TransientMemory / (1024.0 * 1024.0), m_AliasedMemory / (1024.0 * 1024.0),
+		(m_TransientMemory - std::min(m_AliasedMemory, m_TransientMemory)) / (1024.0 * 1024.0), GetPoolMemory() / (1024.0 * 1024.0));
+	dump += line;
+	return dump;
+}
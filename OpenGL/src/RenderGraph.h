@@ -0,0 +1,218 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+//Size and internal format of a render target, e.g. { 1920, 1080, GL_RGBA16F } or { 1920, 1080, GL_DEPTH_COMPONENT24 }
+struct RenderTextureDesc {
+	int Width, Height;
+	unsigned int Format;
+
+	bool operator==(const RenderTextureDesc& other) const { return Width == other.Width && Height == other.Height && Format == other.Format; }
+};
+
+//Handle of a texture or buffer in the graph, only valid for the frame it was created in
+typedef unsigned int RenderResource;
+static const RenderResource InvalidRenderResource = 0xFFFFFFFF;
+
+class RenderGraph;
+
+//GPU time of a pass, measured with a timer query
+struct RenderPassTime {
+	std::string Name;
+	float Ms;
+};
+
+
+//Passed to the setup function of a pass to declare what the pass reads and writes
+class RenderPassBuilder {
+public:
+	//A transient texture or buffer that lives from this pass to its last reader
+	RenderResource CreateTexture(const std::string& name, const RenderTextureDesc& desc);
+	RenderResource CreateBuffer(const std::string& name, size_t size);
+
+	RenderResource Read(RenderResource resource);
+	//Textures written by a pass are attached to its framebuffer, colors in the order of the Write calls
+	RenderResource Write(RenderResource resource);
+
+	//The pass is never culled, e.g. because it reads results back to the CPU
+	void SetSideEffect();
+
+private:
+	friend class RenderGraph;
+	RenderPassBuilder(RenderGraph& graph, unsigned int pass) : m_Graph(graph), m_Pass(pass) {}
+
+	RenderGraph& m_Graph;
+	unsigned int m_Pass;
+};
+
+
+//Passed to the execute function, the framebuffer with the written textures is already bound
+class RenderPassContext {
+public:
+	unsigned int GetTexture(RenderResource resource) const;
+	unsigned int GetBuffer(RenderResource resource) const;
+	const RenderTextureDesc& GetTextureDesc(RenderResource resource) const;
+
+	//Binds a read texture to a texture unit
+	void BindTexture(RenderResource resource, unsigned int slot) const;
+	//One triangle covering the viewport, the vertex shader builds it from gl_VertexID (see Fullscreen.shader)
+	void DrawFullscreenTriangle() const;
+
+private:
+	friend class RenderGraph;
+	RenderPassContext(const RenderGraph& graph) : m_Graph(graph) {}
+
+	const RenderGraph& m_Graph;
+};
+
+
+//Frame graph: passes declare the textures and buffers they read and write, then the graph decides what runs and where
+//the data lives. Rebuild it every frame with Reset(), AddPass() ..., Compile() and Execute().
+//Compile orders the passes by their data flow, so they can be added in any order: writers of a resource run before its
+//readers, several writers of one resource run in the order they were added (its creator first). It culls passes whose
+//results nobody reads (imported resources and side effects count as read) and computes the first and last pass that
+//uses every transient resource. It then places them in pooled GL textures and buffers, a physical resource returns to
+//the pool after the last pass that uses it, so transient resources whose lifetimes don't overlap share memory.
+//The pool lives across frames, nothing is allocated in a steady state.
+class RenderGraph {
+public:
+	typedef std::function<void(RenderPassBuilder&)> SetupFunction;
+	typedef std::function<void(RenderPassContext&)> ExecuteFunction;
+
+	RenderGraph();
+	~RenderGraph();
+
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+
+	//Starts a new frame, handles of the last frame become invalid
+	void Reset();
+
+	//Textures that live outside of the graph, texture 0 is the default framebuffer
+	RenderResource ImportTexture(const std::string& name, unsigned int texture, const RenderTextureDesc& desc);
+
+	//setup runs right away, execute during Execute() if the pass wasn't culled
+	void AddPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute);
+
+	//Size and format of a texture created or imported this frame
+	inline const RenderTextureDesc& GetTextureDesc(RenderResource resource) const { return m_Resources[resource].Desc; }
+
+	//Returns false if a pass reads a resource nobody writes or the passes depend on each other in a cycle,
+	//the graph can't be executed then
+	bool Compile();
+	void Execute();
+
+	//Passes in execution order with their resources, lifetimes, physical slots and the memory saved by aliasing
+	std::string Dump() const;
+
+	//Without aliasing every transient resource gets its own physical one, to compare the memory
+	inline void SetAliasing(bool enabled) { m_Aliasing = enabled; }
+	inline bool IsAliasing() const { return m_Aliasing; }
+
+	//Wraps every executed pass in a GL_TIME_ELAPSED query. The results are read TimerLatency frames later so the CPU
+	//never waits for the GPU, GetPassTimes() returns the passes of the newest frame that has finished.
+	inline void SetProfiling(bool enabled) { m_Profiling = enabled; }
+	inline bool IsProfiling() const { return m_Profiling; }
+	inline const std::vector<RenderPassTime>& GetPassTimes() const { return m_PassTimes; }
+
+	inline size_t GetPassCount() const { return m_Passes.size(); }
+	inline size_t GetCulledPassCount() const { return m_CulledPasses; }
+	//Bytes of the transient resources of the last compiled frame, as if each had its own memory
+	inline size_t GetTransientMemory() const { return m_TransientMemory; }
+	//Bytes of the physical resources they were placed in
+	inline size_t GetAliasedMemory() const { return m_AliasedMemory; }
+	//Everything the pool holds, including resources unused this frame
+	size_t GetPoolMemory() const;
+
+	//Physical resources unused for this many frames are deleted
+	static const unsigned int UnusedLifetime = 30;
+	static const unsigned int TimerLatency = 3;
+
+	static size_t GetTextureSize(const RenderTextureDesc& desc);
+
+private:
+	friend class RenderPassBuilder;
+	friend class RenderPassContext;
+
+	enum class ResourceType {
+		Texture, Buffer
+	};
+
+	struct Resource {
+		std::string Name;
+		ResourceType Type;
+		RenderTextureDesc Desc;
+		size_t Size;						//Bytes, for buffers also the requested size
+		bool Imported;
+		unsigned int ImportedID;
+		unsigned int Creator;				//Pass that created it, for transient resources
+		std::vector<unsigned int> Writers;
+		std::vector<unsigned int> Readers;
+
+		//Filled by Compile
+		unsigned int RefCount;
+		int FirstUse, LastUse;				//Positions in m_Order, -1 if unused
+		int Physical;						//Index in m_Pool, -1 if none
+	};
+
+	struct Pass {
+		std::string Name;
+		ExecuteFunction Execute;
+		std::vector<RenderResource> Reads;
+		std::vector<RenderResource> Writes;
+		bool SideEffect;
+
+		unsigned int RefCount;
+		bool Culled;
+	};
+
+	//A GL texture or buffer of the pool
+	struct PhysicalResource {
+		ResourceType Type;
+		RenderTextureDesc Desc;
+		size_t Size;
+		unsigned int RendererID;
+		int FreeAfter;						//Position in m_Order after which it is free again this frame, -1 = free
+		uint64_t LastUsedFrame;
+	};
+
+	//Queries issued in one frame, reused TimerLatency frames later
+	struct TimerFrame {
+		std::vector<unsigned int> Queries;
+		std::vector<std::string> Names;
+		size_t Used;
+	};
+
+	RenderResource AddResource(const std::string& name, ResourceType type, const RenderTextureDesc& desc, size_t size, unsigned int creator);
+	int Acquire(const Resource& resource, int position);
+	void CreatePhysical(PhysicalResource& physical);
+	void DestroyPhysical(PhysicalResource& physical);
+	void BindFramebuffer(const Pass& pass);
+	//Reads the timers of the frame whose queries are about to be reused
+	void CollectTimers(TimerFrame& timers);
+
+private:
+	std::vector<Pass> m_Passes;
+	std::vector<Resource> m_Resources;
+	std::vector<unsigned int> m_Order;		//Passes in execution order, culled ones included
+	std::vector<PhysicalResource> m_Pool;
+	bool m_Compiled;
+	bool m_Aliasing;
+
+	unsigned int m_Framebuffer;
+	unsigned int m_EmptyVAO;				//Attributeless draws still need a bound VertexArray in the core profile
+	uint64_t m_Frame;
+
+	size_t m_CulledPasses;
+	size_t m_TransientMemory, m_AliasedMemory;
+
+	bool m_Profiling;
+	TimerFrame m_Timers[TimerLatency];
+	std::vector<RenderPassTime> m_PassTimes;
+};
@@ -31,12 +31,21 @@ void Renderer::SetClearColor(float v1, float v2, float v3, float v4) const
 }
 
 
-void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const {
+void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int mode) const {
 
     shader.Bind();
     va.Bind();
     ib.Bind();
 
-    GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr)); //Count (6) = amount of indices to draw //Buffer is already bound, because of that: nullptr
+    if (ib.HasPrimitiveRestart()) {
+        GLCall(glEnable(GL_PRIMITIVE_RESTART));
+        GLCall(glPrimitiveRestartIndex(ib.GetRestartIndex()));
+    }
+
+    GLCall(glDrawElements(mode, ib.GetCount(), ib.GetType(), nullptr)); //Count (6) = amount of indices to draw //Buffer is already bound, because of that: nullptr
+
+    if (ib.HasPrimitiveRestart()) {
+        GLCall(glDisable(GL_PRIMITIVE_RESTART));
+    }
 
 }
@@ -7,7 +7,13 @@
 #include "Shader.h"
 
 
-#define ASSERT(x)   if(!(x)) __debugbreak();
+#ifdef _MSC_VER
+    #define DEBUG_BREAK() __debugbreak()
+#else
+    #define DEBUG_BREAK() __builtin_trap()
+#endif
+
+#define ASSERT(x)   if(!(x)) DEBUG_BREAK();
 #define GLCall(x)   GLClearError();\
                     x;\
                     ASSERT(GLLogCall(#x, __FILE__, __LINE__))
@@ -23,6 +29,7 @@ class Renderer {
 public:
     void Clear() const;
     void SetClearColor(float v1 = 0.0f, float v2 = 0.0f, float v3 = 0.0f, float v4 = 0.0f) const;
-    void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+    //Primitive restart needs a strip or loop mode to be useful, e.g. GL_TRIANGLE_STRIP
+    void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int mode = GL_TRIANGLES) const;
 
 };
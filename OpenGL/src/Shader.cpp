@@ -9,7 +9,10 @@ Shader::Shader(const std::string& filepath)
 	:m_FilePath(filepath), m_RendererID(0)
 {
 	ShaderProgramSource source = ParseShader(filepath);
-	m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+	if (!source.ComputeSource.empty())
+		m_RendererID = CreateComputeShader(source.ComputeSource);
+	else
+		m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
 }
 
 
@@ -21,12 +24,12 @@ Shader::~Shader() {
 ShaderProgramSource Shader::ParseShader(const std::string& filepath) {
 
 	enum class ShaderType {
-		None = -1, VertexShader = 0, FragmentShader = 1
+		None = -1, VertexShader = 0, FragmentShader = 1, ComputeShader = 2
 	};
 
 	std::fstream stream(filepath.c_str());
 
-	std::stringstream ss[2];
+	std::stringstream ss[3];
 	std::string line;
 	ShaderType type = ShaderType::None;
 	while (getline(stream, line)) {
@@ -37,12 +40,15 @@ ShaderProgramSource Shader::ParseShader(const std::string& filepath) {
 			else if (line.find("fragment") != std::string::npos) {
 				type = ShaderType::FragmentShader;
 			}
+			else if (line.find("compute") != std::string::npos) {
+				type = ShaderType::ComputeShader;
+			}
 		}
-		else
+		else if (type != ShaderType::None)
 			ss[(int)type] << line << '\n';
 	}
 
-	return { ss[0].str(), ss[1].str() };
+	return { ss[0].str(), ss[1].str(), ss[2].str() };
 
 }
 
@@ -66,7 +72,7 @@ unsigned int Shader::CompileShader(unsigned int type, const char* source) {
 		//Fills the message with the actual error message
 		GLCall(glGetShaderInfoLog(id, length, &length, message));
 
-		std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex " : "fragment ") << "shader!\n";
+		std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex " : type == GL_FRAGMENT_SHADER ? "fragment " : "compute ") << "shader!\n";
 		std::cout << message << "\n";
 		GLCall(glDeleteShader(id));
 		return 0;
@@ -100,6 +106,25 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
 }
 
 
+unsigned int Shader::CreateComputeShader(const std::string& computeShader) {
+
+	unsigned int program = glCreateProgram();
+	unsigned int cs = CompileShader(GL_COMPUTE_SHADER, computeShader.c_str());
+
+	GLCall(glAttachShader(program, cs));
+	GLCall(glLinkProgram(program));
+	GLCall(glDetachShader(program, cs));
+	GLCall(glDeleteShader(cs));
+
+	int result;
+	GLCall(glGetProgramiv(program, GL_LINK_STATUS, &result));
+	if (result == GL_FALSE)
+		std::cout << "Failed to link compute shader " << m_FilePath << "!\n";
+
+	return program;
+}
+
+
 void Shader::Bind() const {
 	GLCall(glUseProgram(m_RendererID));
 }
@@ -115,16 +140,31 @@ void Shader::SetUniform1i(const std::string& name, int value) {
 }
 
 
+void Shader::SetUniform1ui(const std::string& name, unsigned int value) {
+	GLCall(glUniform1ui(GetUniformLocation(name), value));
+}
+
+
 void Shader::SetUniform1f(const std::string& name, float value) {
 	GLCall(glUniform1f(GetUniformLocation(name), value));
 }
 
 
+void Shader::SetUniform2f(const std::string& name, float v1, float v2) {
+	GLCall(glUniform2f(GetUniformLocation(name), v1, v2));
+}
+
+
 void Shader::SetUniform4f(const std::string& name, float v1, float v2, float v3, float v4) {
 	GLCall(glUniform4f(GetUniformLocation(name), v1, v2, v3, v4))
 }
 
 
+void Shader::SetUniform4fv(const std::string& name, unsigned int count, const glm::vec4* values) {
+	GLCall(glUniform4fv(GetUniformLocation(name), count, &values[0].x));
+}
+
+
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix) {
 	GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
@@ -9,17 +9,19 @@
 struct ShaderProgramSource {
 	std::string VertexSource;
 	std::string FragmentSource;
+	std::string ComputeSource;
 };
 
 
 class Shader
 {
 private:
-	const std::string& m_FilePath;
+	std::string m_FilePath;
 	unsigned int m_RendererID;
 	//std::unordered_map<std::string, int> m_UniformLocationCache;
 	std::unordered_map<std::string, int> m_UniformLocationCache;
 public:
+	//A file with a "#shader compute" section becomes a compute program, otherwise vertex + fragment
 	Shader(const std::string& filepath);
 	~Shader();
 
@@ -28,14 +30,18 @@ public:
 
 	//Set uniforms
 	void SetUniform1f(const std::string& name, float value);
+	void SetUniform2f(const std::string& name, float v1, float v2);
 	void SetUniform4f(const std::string& name, float v1, float v2, float v3, float v4);
 	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
 	void SetUniform1i(const std::string& name, int value);
+	void SetUniform1ui(const std::string& name, unsigned int value);
+	void SetUniform4fv(const std::string& name, unsigned int count, const glm::vec4* values);
 private:
 
 	ShaderProgramSource ParseShader(const std::string& filepath);
 	unsigned int CompileShader(unsigned int type, const char* source);
 	unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+	unsigned int CreateComputeShader(const std::string& computeShader);
 	int GetUniformLocation(const std::string& name);
 };
 
@@ -0,0 +1,93 @@
+#include "TextRenderer.h"
+
+#include "VertexBufferLayout.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+TextRenderer::TextRenderer(Font& font, unsigned int maxGlyphs)
+	: m_Font(font), m_MaxGlyphs(maxGlyphs), m_ViewProjection(1.0f), m_GlyphsDrawn(0), m_DrawCalls(0)
+{
+	static constexpr auto s_GlyphLayout = MakeVertexLayout<GlyphInstance>(
+		VERTEX_ATTRIB(GlyphInstance, Rect),
+		VERTEX_ATTRIB(GlyphInstance, TexRect),
+		VERTEX_ATTRIB(GlyphInstance, Color)
+	);
+
+	m_Instances.reserve(m_MaxGlyphs);
+
+	m_Shader = AssetManager::Get().Load<Shader>("res/shader/Text.shader");
+	m_Shader->Bind();
+	m_Shader->SetUniform1i("u_Atlas", 0);
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_VBO = std::make_unique<VertexBuffer>(nullptr, m_MaxGlyphs * (unsigned int)sizeof(GlyphInstance), true);
+	m_VAO->AddBuffer(*m_VBO, s_GlyphLayout, 0, 1);
+
+	//Glyphs batched before the atlas is cleared have to be drawn while their coordinates are still valid
+	m_Font.SetEvictionCallback([this]() { Flush(); });
+}
+
+
+TextRenderer::~TextRenderer()
+{
+	m_Font.SetEvictionCallback(nullptr);
+}
+
+
+void TextRenderer::Begin(const glm::mat4& viewProjection)
+{
+	m_ViewProjection = viewProjection;
+	m_GlyphsDrawn = 0;
+	m_DrawCalls = 0;
+}
+
+
+void TextRenderer::DrawString(const std::string& text, const glm::vec2& position, float size, const glm::vec4& color)
+{
+	const ShapedRun& run = m_Font.Shape(text);
+
+	GlyphInstance instance;
+	instance.Color[0] = (unsigned char)(glm::clamp(color.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+	instance.Color[1] = (unsigned char)(glm::clamp(color.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+	instance.Color[2] = (unsigned char)(glm::clamp(color.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+	instance.Color[3] = (unsigned char)(glm::clamp(color.a, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+	for (const ShapedGlyph& glyph : run.Glyphs) {
+		if (m_Instances.size() == m_MaxGlyphs)
+			Flush();
+
+		instance.Rect = glm::vec4(position + glyph.Min * size, position + glyph.Max * size);
+		memcpy(instance.TexRect, glyph.TexRect, sizeof(instance.TexRect));
+		m_Instances.push_back(instance);
+	}
+}
+
+
+void TextRenderer::End()
+{
+	Flush();
+}
+
+
+void TextRenderer::Flush()
+{
+	if (m_Instances.empty())
+		return;
+
+	//Orphaning the buffer gives the driver fresh storage, so the upload doesn't wait for the previous batch to be drawn
+	m_VBO->Bind();
+	GLCall(glBufferData(GL_ARRAY_BUFFER, m_MaxGlyphs * sizeof(GlyphInstance), nullptr, GL_DYNAMIC_DRAW));
+	m_VBO->SetData(m_Instances.data(), (unsigned int)(m_Instances.size() * sizeof(GlyphInstance)));
+
+	m_Font.BindAtlas(0);
+	m_Shader->Bind();
+	m_Shader->SetUniformMat4f("u_MVP", m_ViewProjection);
+	m_VAO->Bind();
+	GLCall(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)m_Instances.size()));
+
+	m_GlyphsDrawn += (unsigned int)m_Instances.size();
+	++m_DrawCalls;
+	m_Instances.clear();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Font.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "AssetManager.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+
+//Batches text of one Font into instanced quads, 4 vertices per glyph generated from gl_VertexID (see Text.shader)
+//A glyph is a single 28 byte instance, so hundreds of thousands of glyphs per frame stay a few MB of vertex data.
+//The batch is drawn when it is full, when the font atlas has to be cleared and in End().
+class TextRenderer {
+public:
+	TextRenderer(Font& font, unsigned int maxGlyphs = 65536);
+	~TextRenderer();
+
+	TextRenderer(const TextRenderer&) = delete;
+	TextRenderer& operator=(const TextRenderer&) = delete;
+
+	void Begin(const glm::mat4& viewProjection);
+	//position is the start of the baseline of the first line, size is the em size in world units (pixels for a 2D camera)
+	void DrawString(const std::string& text, const glm::vec2& position, float size, const glm::vec4& color = glm::vec4(1.0f));
+	void End();
+
+	//Counted since Begin
+	inline unsigned int GetGlyphsDrawn() const { return m_GlyphsDrawn; }
+	inline unsigned int GetDrawCalls() const { return m_DrawCalls; }
+
+private:
+	struct GlyphInstance {
+		glm::vec4 Rect;					//Min and max corner
+		unsigned short TexRect[4];
+		unsigned char Color[4];
+	};
+
+	void Flush();
+
+private:
+	Font& m_Font;
+	unsigned int m_MaxGlyphs;
+	glm::mat4 m_ViewProjection;
+
+	std::vector<GlyphInstance> m_Instances;
+	AssetRef<Shader> m_Shader;
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VBO;
+
+	unsigned int m_GlyphsDrawn;
+	unsigned int m_DrawCalls;
+};
@@ -1,15 +1,19 @@
 #include "Texture.h"
 
+#include "ImageDecoder.h"
+#include "MappedFile.h"
+#include "TextureCache.h"
 #include "stb_image/stb_image.h"
 
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
 Texture::Texture(const std::string& path)
-	: m_RendererID(0) , m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0) 
+	: m_RendererID(0) , m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0),
+	  m_Format(TextureFormat::RGBA8), m_MemorySize(0)
 {
 
-	stbi_set_flip_vertically_on_load(1); //Flips the image
-	//Loads the image
-	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
-
 	GLCall(glGenTextures(1, &m_RendererID));
 	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
 	
@@ -18,11 +22,24 @@ Texture::Texture(const std::string& path)
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 
+	//Pre-compressed textures skip decoding entirely, other images are decoded at most once per change of the file
+	bool loaded = IsContainerFile(path) ? LoadTextureFile(path) : LoadCachedImage(path) || LoadImageFile(path);
+	if (loaded) {
+		GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+		return;
+	}
+
+	stbi_set_flip_vertically_on_load(1); //Flips the image
+	//Loads the image
+	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+
 	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
 	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
 
-	if (m_LocalBuffer)
+	if (m_LocalBuffer) {
+		m_MemorySize = (size_t)m_Width * m_Height * 4;
 		stbi_image_free(m_LocalBuffer);
+	}
 
 }
 
@@ -32,6 +49,110 @@ Texture::~Texture() {
 }
 
 
+bool Texture::IsContainerFile(const std::string& path) {
+
+	size_t dot = path.find_last_of('.');
+	if (dot == std::string::npos)
+		return false;
+
+	std::string extension = path.substr(dot + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	return extension == "dds" || extension == "ktx" || extension == "ktx2";
+}
+
+
+bool Texture::LoadTextureFile(const std::string& path) {
+
+	TextureFile file(path);
+	if (!file.IsValid())
+		return false;
+
+	if (!IsTextureFormatSupported(file.GetFormat())) {
+		std::cout << "[Texture] " << GetTextureFormatName(file.GetFormat()) << " isn't supported by this OpenGL context: " << path << '\n';
+		return false;
+	}
+
+	m_Format = file.GetFormat();
+	m_Width = file.GetWidth();
+	m_Height = file.GetHeight();
+	m_BPP = 4;
+
+	UploadLevels(&file.GetLevel(0), file.GetLevelCount());
+	return true;
+}
+
+
+bool Texture::LoadCachedImage(const std::string& path) {
+
+	std::unique_ptr<CachedImage> image = TextureCache::Get().Open(path);
+	if (!image)
+		return false;
+
+	m_Format = TextureFormat::RGBA8;
+	m_Width = image->GetWidth();
+	m_Height = image->GetHeight();
+	m_BPP = image->GetChannels();
+
+	//Uploaded straight from the mapping, pages that are still in the OS cache don't even touch the disk
+	UploadLevels(image->GetLevels(), image->GetLevelCount());
+	return true;
+}
+
+
+void Texture::UploadLevels(const TextureFile::Level* levels, int levelCount) {
+
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1));
+	if (levelCount > 1) {
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+	}
+
+	unsigned int internalFormat = GetTextureFormatGL(m_Format);
+	for (int i = 0; i < levelCount; ++i) {
+		const TextureFile::Level& level = levels[i];
+		if (m_Format == TextureFormat::RGBA8) {
+			GLCall(glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level.Width, level.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.Data));
+		}
+		else {
+			GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.Width, level.Height, 0, (GLsizei)level.Size, level.Data));
+		}
+		m_MemorySize += level.Size;
+	}
+}
+
+
+bool Texture::LoadImageFile(const std::string& path) {
+
+	MappedFile file(path);
+	ImageInfo info;
+	if (!file.IsOpen() || !GetImageInfo(file.GetData(), file.GetSize(), info))
+		return false;
+
+	//The decoder writes into the mapped buffer, so the pixels are never copied on the CPU side
+	size_t size = (size_t)info.Width * info.Height * 4;
+	unsigned int buffer;
+	GLCall(glGenBuffers(1, &buffer));
+	GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer));
+	GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+	void* pixels;
+	GLCall(pixels = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	bool decoded = pixels && DecodeImage(file.GetData(), file.GetSize(), (unsigned char*)pixels);
+	GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+	if (decoded) {
+		m_Width = info.Width;
+		m_Height = info.Height;
+		m_BPP = info.Channels;
+		m_MemorySize = size;
+		GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	}
+
+	GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	GLCall(glDeleteBuffers(1, &buffer));
+	return decoded;
+}
+
+
 void Texture::Bind(unsigned int slot) const {
 	
 	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
@@ -43,4 +164,3 @@ void Texture::Bind(unsigned int slot) const {
 void Texture::Unbind() const {
 	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
 }
-
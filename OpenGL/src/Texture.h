@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Renderer.h"
+#include "TextureFile.h"
 
 class Texture
 {
@@ -9,8 +10,14 @@ private:
 	std::string m_FilePath;
 	unsigned char* m_LocalBuffer;
 	int m_Width, m_Height, m_BPP;
+	TextureFormat m_Format;
+	size_t m_MemorySize;
 
 public:
+	//.dds, .ktx and .ktx2 files are uploaded as stored (including their mip chain)
+	//Other images come from the TextureCache when it is enabled, otherwise they are decoded by the ImageDecoder straight
+	//into a pixel unpack buffer, stb_image is the fallback
+	//Compressed blocks can't be flipped on load, so those files have to store the bottom row first like ConvertImageToDDS does
 	Texture(const std::string& path);
 	~Texture();
 
@@ -19,6 +26,16 @@ public:
 
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
+	inline TextureFormat GetFormat() const { return m_Format; }
+	//Bytes of all uploaded levels
+	inline size_t GetMemorySize() const { return m_MemorySize; }
 
-};
+	static bool IsContainerFile(const std::string& path);
+
+private:
+	bool LoadTextureFile(const std::string& path);
+	bool LoadImageFile(const std::string& path);
+	bool LoadCachedImage(const std::string& path);
+	void UploadLevels(const TextureFile::Level* levels, int levelCount);
 
+};
@@ -0,0 +1,135 @@
+#include "TextureArray.h"
+
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+
+//Bilinear resampling of RGBA8 pixels, only used when an image doesn't match the array size
+static void ResampleRGBA(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight)
+{
+	float scaleX = (float)srcWidth / dstWidth;
+	float scaleY = (float)srcHeight / dstHeight;
+
+	for (int y = 0; y < dstHeight; ++y) {
+		float sy = std::max((y + 0.5f) * scaleY - 0.5f, 0.0f);
+		int y0 = std::min((int)sy, srcHeight - 1), y1 = std::min(y0 + 1, srcHeight - 1);
+		float fy = sy - y0;
+
+		for (int x = 0; x < dstWidth; ++x) {
+			float sx = std::max((x + 0.5f) * scaleX - 0.5f, 0.0f);
+			int x0 = std::min((int)sx, srcWidth - 1), x1 = std::min(x0 + 1, srcWidth - 1);
+			float fx = sx - x0;
+
+			const unsigned char* p00 = src + (y0 * srcWidth + x0) * 4;
+			const unsigned char* p10 = src + (y0 * srcWidth + x1) * 4;
+			const unsigned char* p01 = src + (y1 * srcWidth + x0) * 4;
+			const unsigned char* p11 = src + (y1 * srcWidth + x1) * 4;
+			unsigned char* out = dst + (y * dstWidth + x) * 4;
+
+			for (int c = 0; c < 4; ++c) {
+				float top = p00[c] + (p10[c] - p00[c]) * fx;
+				float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+				out[c] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+			}
+		}
+	}
+}
+
+
+TextureArray::TextureArray(int width, int height, int layers, int mipLevels)
+	: m_RendererID(0), m_Width(width), m_Height(height), m_Layers(layers), m_MipLevels(mipLevels)
+{
+	if (m_MipLevels <= 0) {
+		m_MipLevels = 1;
+		for (int size = std::max(width, height); size > 1; size >>= 1)
+			++m_MipLevels;
+	}
+
+	GLCall(glGenTextures(1, &m_RendererID));
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID));
+
+	//Immutable storage lets the driver allocate every level and layer once and skip completeness checks
+	if (GLEW_VERSION_4_2 || GLEW_ARB_texture_storage) {
+		GLCall(glTexStorage3D(GL_TEXTURE_2D_ARRAY, m_MipLevels, GL_RGBA8, m_Width, m_Height, m_Layers));
+	}
+	else {
+		for (int level = 0; level < m_MipLevels; ++level) {
+			GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(m_Width >> level, 1), std::max(m_Height >> level, 1),
+				m_Layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+		}
+	}
+
+	GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0));
+	GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_MipLevels - 1));
+	GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, m_MipLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+}
+
+
+TextureArray::~TextureArray() {
+	GLCall(glDeleteTextures(1, &m_RendererID));
+}
+
+
+void TextureArray::SetLayer(int layer, const void* data) {
+
+	if (layer < 0 || layer >= m_Layers) {
+		std::cout << "[TextureArray] Layer " << layer << " is out of range (" << m_Layers << " layers)" << std::endl;
+		return;
+	}
+
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID));
+	GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+	GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_Width, m_Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data));
+	GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+}
+
+
+bool TextureArray::LoadLayer(int layer, const std::string& path) {
+
+	int width, height, bpp;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+	if (!pixels) {
+		std::cout << "[TextureArray] Failed to load " << path << std::endl;
+		return false;
+	}
+
+	if (width == m_Width && height == m_Height) {
+		SetLayer(layer, pixels);
+	}
+	else {
+		std::vector<unsigned char> resampled((size_t)m_Width * m_Height * 4);
+		ResampleRGBA(pixels, width, height, resampled.data(), m_Width, m_Height);
+		SetLayer(layer, resampled.data());
+	}
+
+	stbi_image_free(pixels);
+	return true;
+}
+
+
+void TextureArray::GenerateMipmaps() {
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID));
+	GLCall(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+}
+
+
+void TextureArray::Bind(unsigned int slot) const {
+	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID));
+}
+
+
+void TextureArray::Unbind() const {
+	GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include <string>
+
+
+//GL_TEXTURE_2D_ARRAY of equally sized RGBA8 layers, so many images can be sampled in one draw call
+//through a single texture unit, shaders pick the image with the layer coordinate (see TextureArray.shader)
+class TextureArray
+{
+private:
+	unsigned int m_RendererID;
+	int m_Width, m_Height, m_Layers, m_MipLevels;
+
+public:
+	//mipLevels = 0 allocates the full chain down to 1x1
+	TextureArray(int width, int height, int layers, int mipLevels = 0);
+	~TextureArray();
+
+	//Uploads width * height RGBA8 pixels into mip 0 of a layer
+	void SetLayer(int layer, const void* data);
+	//Loads an image into a layer, images of a different size are resampled to the array size
+	bool LoadLayer(int layer, const std::string& path);
+
+	//Fills the mip chain of all layers from mip 0, call once after the layers have been uploaded
+	void GenerateMipmaps();
+
+	void Bind(unsigned int slot = 0) const;
+	void Unbind() const;
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline int GetLayerCount() const { return m_Layers; }
+	inline int GetMipLevels() const { return m_MipLevels; }
+};
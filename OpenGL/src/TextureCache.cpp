@@ -0,0 +1,279 @@
+#include "TextureCache.h"
+
+#include "ImageDecoder.h"
+#include "TextureConverter.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+
+static const uint32_t s_CacheMagic = 0x48435854;	//"TXCH"
+static const uint32_t s_CacheVersion = 1;
+static const char* s_CacheExtension = ".texcache";
+
+enum CacheFlags : uint32_t {
+	CacheFlipped = 1, CacheMipmaps = 2
+};
+
+//The levels follow the header without padding, largest first, 4 bytes per pixel
+struct CacheHeader {
+	uint32_t Magic, Version;
+	uint64_t SourceSize;
+	int64_t SourceTime;
+	uint64_t SourceHash;
+	uint32_t Width, Height, Channels, LevelCount, Flags;
+	uint32_t Reserved[3];
+};
+
+static_assert(sizeof(CacheHeader) == 64, "CacheHeader has to match the file layout");
+
+
+//MurmurHash64A, 8 byte words with a bytewise tail
+static uint64_t Hash(const unsigned char* data, size_t size, uint64_t seed)
+{
+	const uint64_t m = 0xc6a4a7935bd1e995ull;
+	const int r = 47;
+
+	uint64_t hash = seed ^ (size * m);
+
+	const unsigned char* end = data + (size & ~(size_t)7);
+	for (; data != end; data += 8) {
+		uint64_t k;
+		memcpy(&k, data, 8);
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		hash ^= k;
+		hash *= m;
+	}
+
+	size_t tail = size & 7;
+	if (tail) {
+		for (size_t i = 0; i < tail; ++i)
+			hash ^= (uint64_t)data[i] << (8 * i);
+		hash *= m;
+	}
+
+	hash ^= hash >> r;
+	hash *= m;
+	hash ^= hash >> r;
+	return hash;
+}
+
+
+CachedImage::CachedImage(const std::string& path)
+	: m_File(path), m_SourceSize(0), m_SourceTime(0), m_SourceHash(0), m_Flags(0), m_Channels(0), m_LevelCount(0)
+{
+	if (!m_File.IsOpen() || m_File.GetSize() < sizeof(CacheHeader))
+		return;
+
+	CacheHeader header;
+	memcpy(&header, m_File.GetData(), sizeof(header));
+	if (header.Magic != s_CacheMagic || header.Version != s_CacheVersion || header.Width == 0 || header.Height == 0 ||
+		header.LevelCount == 0 || header.LevelCount > (uint32_t)TextureFile::MaxLevels)
+		return;
+
+	int width = (int)header.Width;
+	int height = (int)header.Height;
+	size_t offset = sizeof(CacheHeader);
+	for (uint32_t level = 0; level < header.LevelCount; ++level) {
+		size_t size = (size_t)width * height * 4;
+		if (size > m_File.GetSize() - offset) {
+			std::cout << "[TextureCache] Truncated entry " << path << '\n';
+			m_LevelCount = 0;
+			return;
+		}
+
+		m_Levels[m_LevelCount++] = { width, height, m_File.GetData() + offset, size };
+		offset += size;
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+
+	m_SourceSize = header.SourceSize;
+	m_SourceTime = header.SourceTime;
+	m_SourceHash = header.SourceHash;
+	m_Flags = header.Flags;
+	m_Channels = (int)header.Channels;
+}
+
+
+TextureCache::TextureCache()
+	: m_Enabled(true), m_GenerateMipmaps(false), m_Directory("res/generated/cache"), m_Hits(0), m_Misses(0)
+{
+
+}
+
+
+TextureCache& TextureCache::Get() {
+	static TextureCache s_Instance;
+	return s_Instance;
+}
+
+
+std::unique_ptr<CachedImage> TextureCache::Open(const std::string& sourcePath) {
+
+	if (!m_Enabled)
+		return nullptr;
+
+	std::error_code error;
+	uint64_t size = std::filesystem::file_size(sourcePath, error);
+	if (error)
+		return nullptr;
+	int64_t time = (int64_t)std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count();
+	if (error)
+		return nullptr;
+
+	uint32_t flags = (uint32_t)CacheFlipped | (m_GenerateMipmaps ? (uint32_t)CacheMipmaps : 0u);
+	std::string entryPath = GetEntryPath(sourcePath, flags);
+
+	if (std::filesystem::exists(entryPath, error)) {
+		std::unique_ptr<CachedImage> entry = std::make_unique<CachedImage>(entryPath);
+		if (entry->IsValid() && entry->m_Flags == flags && entry->m_SourceSize == size) {
+			if (entry->m_SourceTime == time) {
+				++m_Hits;
+				return entry;
+			}
+
+			//Only the time changed: compare the content and store the new time if it is still the same
+			uint64_t entryHash = entry->m_SourceHash;
+			entry.reset();
+
+			MappedFile source(sourcePath);
+			if (source.IsOpen() && Hash(source.GetData(), source.GetSize(), 0) == entryHash) {
+				std::fstream stream(entryPath, std::ios::binary | std::ios::in | std::ios::out);
+				stream.seekp(offsetof(CacheHeader, SourceTime));
+				stream.write((const char*)&time, sizeof(time));
+				stream.close();
+
+				entry = std::make_unique<CachedImage>(entryPath);
+				if (entry->IsValid()) {
+					++m_Hits;
+					return entry;
+				}
+			}
+		}
+	}
+
+	++m_Misses;
+	if (!WriteEntry(sourcePath, entryPath, size, time, flags))
+		return nullptr;
+
+	std::unique_ptr<CachedImage> entry = std::make_unique<CachedImage>(entryPath);
+	if (!entry->IsValid())
+		return nullptr;
+	return entry;
+}
+
+
+bool TextureCache::WriteEntry(const std::string& sourcePath, const std::string& entryPath, uint64_t size, int64_t time, uint32_t flags) {
+
+	MappedFile source(sourcePath);
+	ImageInfo info;
+	if (!source.IsOpen() || !GetImageInfo(source.GetData(), source.GetSize(), info))
+		return false;
+
+	//Level sizes first, so the whole chain fits in one allocation
+	TextureFile::Level levels[TextureFile::MaxLevels];
+	int levelCount = 0;
+	size_t totalSize = 0;
+	int width = info.Width, height = info.Height;
+	while (levelCount < TextureFile::MaxLevels) {
+		levels[levelCount++] = { width, height, nullptr, (size_t)width * height * 4 };
+		totalSize += (size_t)width * height * 4;
+		if (!(flags & CacheMipmaps) || (width == 1 && height == 1))
+			break;
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+
+	std::vector<unsigned char> pixels(totalSize);
+	size_t offset = 0;
+	for (int level = 0; level < levelCount; ++level) {
+		levels[level].Data = pixels.data() + offset;
+		offset += levels[level].Size;
+	}
+
+	if (!DecodeImage(source.GetData(), source.GetSize(), pixels.data(), (flags & CacheFlipped) != 0))
+		return false;
+	for (int level = 1; level < levelCount; ++level)
+		DownsampleRGBA(levels[level - 1].Data, levels[level - 1].Width, levels[level - 1].Height, (unsigned char*)levels[level].Data);
+
+	CacheHeader header = {};
+	header.Magic = s_CacheMagic;
+	header.Version = s_CacheVersion;
+	header.SourceSize = size;
+	header.SourceTime = time;
+	header.SourceHash = Hash(source.GetData(), source.GetSize(), 0);
+	header.Width = (uint32_t)info.Width;
+	header.Height = (uint32_t)info.Height;
+	header.Channels = (uint32_t)info.Channels;
+	header.LevelCount = (uint32_t)levelCount;
+	header.Flags = flags;
+
+	std::error_code error;
+	std::filesystem::create_directories(m_Directory, error);
+
+	//Written under a temporary name and renamed, so an interrupted write never leaves a valid looking entry behind
+	std::string temporaryPath = entryPath + ".tmp";
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary);
+		stream.write((const char*)&header, sizeof(header));
+		stream.write((const char*)pixels.data(), (std::streamsize)pixels.size());
+		if (!stream) {
+			std::cout << "[TextureCache] Failed to write " << temporaryPath << '\n';
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, entryPath, error);
+	if (error) {
+		std::cout << "[TextureCache] Failed to rename " << temporaryPath << ": " << error.message() << '\n';
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+
+std::string TextureCache::GetEntryPath(const std::string& sourcePath, uint32_t flags) const {
+
+	std::error_code error;
+	std::string key = std::filesystem::absolute(sourcePath, error).lexically_normal().generic_string();
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)Hash((const unsigned char*)key.data(), key.size(), flags));
+	return m_Directory + '/' + name + s_CacheExtension;
+}
+
+
+void TextureCache::Clear() {
+
+	std::error_code error;
+	for (const auto& file : std::filesystem::directory_iterator(m_Directory, error)) {
+		if (file.path().extension() == s_CacheExtension)
+			std::filesystem::remove(file.path(), error);
+	}
+}
+
+
+size_t TextureCache::GetDiskSize() const {
+
+	size_t size = 0;
+	std::error_code error;
+	for (const auto& file : std::filesystem::directory_iterator(m_Directory, error)) {
+		if (file.path().extension() != s_CacheExtension)
+			continue;
+		uintmax_t fileSize = file.file_size(error);
+		if (!error)
+			size += (size_t)fileSize;
+	}
+	return size;
+}
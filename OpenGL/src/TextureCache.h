@@ -0,0 +1,77 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "TextureFile.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+//Read only view of a cache entry, the level data points straight into the mapping
+class CachedImage {
+public:
+	CachedImage(const std::string& path);
+
+	inline bool IsValid() const { return m_LevelCount > 0; }
+
+	inline int GetWidth() const { return m_Levels[0].Width; }
+	inline int GetHeight() const { return m_Levels[0].Height; }
+	inline int GetChannels() const { return m_Channels; }
+	inline int GetLevelCount() const { return m_LevelCount; }
+	inline const TextureFile::Level* GetLevels() const { return m_Levels; }
+
+private:
+	friend class TextureCache;
+
+	MappedFile m_File;
+	uint64_t m_SourceSize;
+	int64_t m_SourceTime;
+	uint64_t m_SourceHash;
+	uint32_t m_Flags;
+	int m_Channels;
+	int m_LevelCount;
+	TextureFile::Level m_Levels[TextureFile::MaxLevels];
+};
+
+
+//Disk cache of decoded images, so a warm start maps the RGBA8 texels and uploads them without decoding again
+//Entries are stored flipped like Texture expects, optionally with the full mip chain, and named by a hash of the
+//source path and those options. An entry is used while the source file's size and modification time match.
+//When only the time changed the hash of the source content decides, so touched but unchanged files stay cached.
+class TextureCache {
+public:
+	static TextureCache& Get();
+
+	//Maps the entry of an image file, decoding the source and writing the entry first when it is missing or stale
+	//Returns nullptr when the cache is disabled or the source can't be decoded
+	std::unique_ptr<CachedImage> Open(const std::string& sourcePath);
+
+	//Deletes all entries in the directory
+	void Clear();
+
+	void SetEnabled(bool enabled) { m_Enabled = enabled; }
+	void SetDirectory(const std::string& directory) { m_Directory = directory; }
+	//Only affects entries created afterwards, mipmapped entries are stored separately
+	void SetGenerateMipmaps(bool mipmaps) { m_GenerateMipmaps = mipmaps; }
+
+	inline bool IsEnabled() const { return m_Enabled; }
+	inline const std::string& GetDirectory() const { return m_Directory; }
+	inline bool GetGenerateMipmaps() const { return m_GenerateMipmaps; }
+	inline unsigned int GetHits() const { return m_Hits; }
+	inline unsigned int GetMisses() const { return m_Misses; }
+	//Bytes of all entries on disk
+	size_t GetDiskSize() const;
+
+private:
+	TextureCache();
+
+	std::string GetEntryPath(const std::string& sourcePath, uint32_t flags) const;
+	bool WriteEntry(const std::string& sourcePath, const std::string& entryPath, uint64_t size, int64_t time, uint32_t flags);
+
+private:
+	bool m_Enabled;
+	bool m_GenerateMipmaps;
+	std::string m_Directory;
+	unsigned int m_Hits, m_Misses;
+};
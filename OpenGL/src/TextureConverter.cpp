@@ -0,0 +1,445 @@
+#include "TextureConverter.h"
+
+#include "JobSystem.h"
+
+#include "glm/glm.hpp"
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	#include <emmintrin.h>
+#endif
+
+
+//Copies a 4x4 block of pixels, clamping at the right and bottom edge
+static void LoadBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY, unsigned char block[64])
+{
+	for (int y = 0; y < 4; ++y) {
+		int sy = std::min(blockY * 4 + y, height - 1);
+		for (int x = 0; x < 4; ++x) {
+			int sx = std::min(blockX * 4 + x, width - 1);
+			memcpy(&block[(y * 4 + x) * 4], &rgba[((size_t)sy * width + sx) * 4], 4);
+		}
+	}
+}
+
+
+static inline uint16_t To565(const unsigned char color[4])
+{
+	return (uint16_t)(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3));
+}
+
+static inline void From565(uint16_t color, unsigned char out[4])
+{
+	unsigned char r = (unsigned char)((color >> 11) & 31), g = (unsigned char)((color >> 5) & 63), b = (unsigned char)(color & 31);
+	out[0] = (unsigned char)((r << 3) | (r >> 2));
+	out[1] = (unsigned char)((g << 2) | (g >> 4));
+	out[2] = (unsigned char)((b << 3) | (b >> 2));
+	out[3] = 255;
+}
+
+
+//Insets the bounding box by 1/16 of its size, which moves the endpoints closer to where most colors are
+//Returns false if both endpoints quantize to the same 565 color, every index is 0 then
+static bool SelectEndpoints(const unsigned char minColor[4], const unsigned char maxColor[4], uint16_t& color0, uint16_t& color1, unsigned char palette[4][4])
+{
+	unsigned char low[4], high[4];
+	for (int c = 0; c < 3; ++c) {
+		int inset = (maxColor[c] - minColor[c]) >> 4;
+		low[c] = (unsigned char)(minColor[c] + inset);
+		high[c] = (unsigned char)(maxColor[c] - inset);
+	}
+
+	//Every channel of high is >= low, so color0 >= color1 and the block is in 4 color mode
+	color0 = To565(high);
+	color1 = To565(low);
+	if (color0 == color1)
+		return false;
+
+	From565(color0, palette[0]);
+	From565(color1, palette[1]);
+	for (int c = 0; c < 3; ++c) {
+		palette[2][c] = (unsigned char)((2 * palette[0][c] + palette[1][c]) / 3);
+		palette[3][c] = (unsigned char)((palette[0][c] + 2 * palette[1][c]) / 3);
+	}
+	return true;
+}
+
+
+static inline void WriteColorBlock(unsigned char* dst, uint16_t color0, uint16_t color1, uint32_t indices)
+{
+	memcpy(dst, &color0, 2);
+	memcpy(dst + 2, &color1, 2);
+	memcpy(dst + 4, &indices, 4);
+}
+
+
+static void CompressColorBlockScalar(const unsigned char block[64], unsigned char* dst)
+{
+	unsigned char minColor[4] = { 255, 255, 255, 255 }, maxColor[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < 3; ++c) {
+			minColor[c] = std::min(minColor[c], block[i * 4 + c]);
+			maxColor[c] = std::max(maxColor[c], block[i * 4 + c]);
+		}
+	}
+
+	uint16_t color0, color1;
+	unsigned char palette[4][4];
+	if (!SelectEndpoints(minColor, maxColor, color0, color1, palette)) {
+		WriteColorBlock(dst, color0, color1, 0);
+		return;
+	}
+
+	uint32_t indices = 0;
+	for (int i = 0; i < 16; ++i) {
+		const unsigned char* pixel = &block[i * 4];
+		int best = 0, bestDistance = 0x7FFFFFFF;
+		for (int k = 0; k < 4; ++k) {
+			int dr = pixel[0] - palette[k][0], dg = pixel[1] - palette[k][1], db = pixel[2] - palette[k][2];
+			int distance = dr * dr + dg * dg + db * db;
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				best = k;
+			}
+		}
+		indices |= (uint32_t)best << (i * 2);
+	}
+
+	WriteColorBlock(dst, color0, color1, indices);
+}
+
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+//Spreads the low 16 bits so bit i ends up at bit 2 * i
+static inline uint32_t SpreadBits(uint32_t x)
+{
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+	return x;
+}
+
+static void CompressColorBlockSSE(const unsigned char block[64], unsigned char* dst)
+{
+	__m128i rows[4];
+	for (int i = 0; i < 4; ++i)
+		rows[i] = _mm_loadu_si128((const __m128i*)(block + i * 16));
+
+	//Bounding box: min/max over the rows, then across the 4 pixels of a register
+	__m128i minColor = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]), _mm_min_epu8(rows[2], rows[3]));
+	__m128i maxColor = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]), _mm_max_epu8(rows[2], rows[3]));
+	minColor = _mm_min_epu8(minColor, _mm_shuffle_epi32(minColor, _MM_SHUFFLE(1, 0, 3, 2)));
+	maxColor = _mm_max_epu8(maxColor, _mm_shuffle_epi32(maxColor, _MM_SHUFFLE(1, 0, 3, 2)));
+	minColor = _mm_min_epu8(minColor, _mm_shuffle_epi32(minColor, _MM_SHUFFLE(2, 3, 0, 1)));
+	maxColor = _mm_max_epu8(maxColor, _mm_shuffle_epi32(maxColor, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	uint32_t minBits = (uint32_t)_mm_cvtsi128_si32(minColor), maxBits = (uint32_t)_mm_cvtsi128_si32(maxColor);
+	unsigned char minBytes[4], maxBytes[4];
+	memcpy(minBytes, &minBits, 4);
+	memcpy(maxBytes, &maxBits, 4);
+
+	uint16_t color0, color1;
+	unsigned char palette[4][4];
+	if (!SelectEndpoints(minBytes, maxBytes, color0, color1, palette)) {
+		WriteColorBlock(dst, color0, color1, 0);
+		return;
+	}
+
+	//Pixels as 16 bit (r, g) and (b, 0) pairs in every 32 bit lane, so _mm_madd_epi16 gives dr*dr + dg*dg and db*db
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	__m128i paletteRG[4], paletteB[4];
+	for (int k = 0; k < 4; ++k) {
+		paletteRG[k] = _mm_set1_epi32(palette[k][0] | (palette[k][1] << 16));
+		paletteB[k] = _mm_set1_epi32(palette[k][2]);
+	}
+
+	__m128i indices[4];
+	for (int i = 0; i < 4; ++i) {
+		__m128i rg = _mm_or_si128(_mm_and_si128(rows[i], byteMask), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(rows[i], 8), byteMask), 16));
+		__m128i b = _mm_and_si128(_mm_srli_epi32(rows[i], 16), byteMask);
+
+		__m128i best = _mm_setzero_si128(), bestDistance = _mm_setzero_si128();
+		for (int k = 0; k < 4; ++k) {
+			__m128i drg = _mm_sub_epi16(rg, paletteRG[k]);
+			__m128i db = _mm_sub_epi16(b, paletteB[k]);
+			__m128i distance = _mm_add_epi32(_mm_madd_epi16(drg, drg), _mm_madd_epi16(db, db));
+
+			if (k == 0) {
+				bestDistance = distance;
+				continue;
+			}
+
+			//Strictly smaller, so ties keep the lower index like the scalar version
+			__m128i closer = _mm_cmplt_epi32(distance, bestDistance);
+			bestDistance = _mm_or_si128(_mm_and_si128(closer, distance), _mm_andnot_si128(closer, bestDistance));
+			best = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)), _mm_andnot_si128(closer, best));
+		}
+		indices[i] = best;
+	}
+
+	//16 indices of 0-3 as bytes, movemask collects bit 0 and bit 1 of each, then the two masks are interleaved
+	__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(indices[0], indices[1]), _mm_packs_epi32(indices[2], indices[3]));
+	uint32_t bit0 = (uint32_t)_mm_movemask_epi8(_mm_slli_epi16(bytes, 7));
+	uint32_t bit1 = (uint32_t)_mm_movemask_epi8(_mm_slli_epi16(bytes, 6));
+
+	WriteColorBlock(dst, color0, color1, SpreadBits(bit0) | (SpreadBits(bit1) << 1));
+}
+
+#endif
+
+
+//Alpha block of BC3 (same layout as BC4): two 8 bit endpoints and 3 bit indices into 8 interpolated values
+//Shared by both paths, the color block dominates the encoding time
+static void CompressAlphaBlock(const unsigned char block[64], unsigned char* dst)
+{
+	int minAlpha = 255, maxAlpha = 0;
+	for (int i = 0; i < 16; ++i) {
+		minAlpha = std::min(minAlpha, (int)block[i * 4 + 3]);
+		maxAlpha = std::max(maxAlpha, (int)block[i * 4 + 3]);
+	}
+
+	dst[0] = (unsigned char)maxAlpha;
+	dst[1] = (unsigned char)minAlpha;
+
+	uint64_t indices = 0;
+	int range = maxAlpha - minAlpha;
+	if (range > 0) {
+		for (int i = 0; i < 16; ++i) {
+			//Position 0 is alpha0, 7 is alpha1, 1-6 are the interpolated values which use indices 2-7
+			int position = ((maxAlpha - block[i * 4 + 3]) * 14 + range) / (2 * range);
+			uint64_t index = position == 0 ? 0 : position == 7 ? 1 : (uint64_t)position + 1;
+			indices |= index << (i * 3);
+		}
+	}
+
+	for (int i = 0; i < 6; ++i)
+		dst[2 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+
+template<bool HasAlpha, typename ColorFunc>
+static void CompressBlocks(const unsigned char* rgba, int width, int height, unsigned char* dst, ColorFunc compressColor)
+{
+	int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	unsigned char block[64];
+
+	for (int by = 0; by < blocksY; ++by) {
+		for (int bx = 0; bx < blocksX; ++bx) {
+			LoadBlock(rgba, width, height, bx, by, block);
+			if (HasAlpha) {
+				CompressAlphaBlock(block, dst);
+				dst += 8;
+			}
+			compressColor(block, dst);
+			dst += 8;
+		}
+	}
+}
+
+
+void CompressBC1Scalar(const unsigned char* rgba, int width, int height, unsigned char* dst)
+{
+	CompressBlocks<false>(rgba, width, height, dst, CompressColorBlockScalar);
+}
+
+
+void CompressBC3Scalar(const unsigned char* rgba, int width, int height, unsigned char* dst)
+{
+	CompressBlocks<true>(rgba, width, height, dst, CompressColorBlockScalar);
+}
+
+
+void CompressBC1(const unsigned char* rgba, int width, int height, unsigned char* dst)
+{
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	CompressBlocks<false>(rgba, width, height, dst, CompressColorBlockSSE);
+#else
+	CompressBC1Scalar(rgba, width, height, dst);
+#endif
+}
+
+
+void CompressBC3(const unsigned char* rgba, int width, int height, unsigned char* dst)
+{
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	CompressBlocks<true>(rgba, width, height, dst, CompressColorBlockSSE);
+#else
+	CompressBC3Scalar(rgba, width, height, dst);
+#endif
+}
+
+
+//BC3 color blocks are always in 4 color mode, BC1 switches to 3 colors + transparent when color0 <= color1
+static void DecompressColorBlock(const unsigned char* src, bool alwaysFourColors, unsigned char block[64])
+{
+	uint16_t color0, color1;
+	uint32_t indices;
+	memcpy(&color0, src, 2);
+	memcpy(&color1, src + 2, 2);
+	memcpy(&indices, src + 4, 4);
+
+	bool fourColors = alwaysFourColors || color0 > color1;
+	unsigned char palette[4][4];
+	From565(color0, palette[0]);
+	From565(color1, palette[1]);
+	for (int c = 0; c < 3; ++c) {
+		if (fourColors) {
+			palette[2][c] = (unsigned char)((2 * palette[0][c] + palette[1][c]) / 3);
+			palette[3][c] = (unsigned char)((palette[0][c] + 2 * palette[1][c]) / 3);
+		}
+		else {
+			palette[2][c] = (unsigned char)((palette[0][c] + palette[1][c]) / 2);
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = fourColors ? 255 : 0;
+
+	for (int i = 0; i < 16; ++i)
+		memcpy(&block[i * 4], palette[(indices >> (i * 2)) & 3], 4);
+}
+
+
+static void DecompressAlphaBlock(const unsigned char* src, unsigned char block[64])
+{
+	int alpha0 = src[0], alpha1 = src[1];
+	unsigned char values[8] = { (unsigned char)alpha0, (unsigned char)alpha1 };
+	for (int i = 2; i < 8; ++i) {
+		if (alpha0 > alpha1)
+			values[i] = (unsigned char)(((8 - i) * alpha0 + (i - 1) * alpha1) / 7);
+		else
+			values[i] = i < 6 ? (unsigned char)(((6 - i) * alpha0 + (i - 1) * alpha1) / 5) : (unsigned char)(i == 6 ? 0 : 255);
+	}
+
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; ++i)
+		indices |= (uint64_t)src[2 + i] << (i * 8);
+	for (int i = 0; i < 16; ++i)
+		block[i * 4 + 3] = values[(indices >> (i * 3)) & 7];
+}
+
+
+template<bool HasAlpha>
+static void DecompressBlocks(const unsigned char* src, int width, int height, unsigned char* dst)
+{
+	int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	unsigned char block[64];
+
+	for (int by = 0; by < blocksY; ++by) {
+		for (int bx = 0; bx < blocksX; ++bx) {
+			DecompressColorBlock(src + (HasAlpha ? 8 : 0), HasAlpha, block);
+			if (HasAlpha)
+				DecompressAlphaBlock(src, block);
+			src += HasAlpha ? 16 : 8;
+
+			//Edge blocks only store the pixels that exist
+			for (int y = 0; y < 4 && by * 4 + y < height; ++y) {
+				for (int x = 0; x < 4 && bx * 4 + x < width; ++x)
+					memcpy(&dst[((size_t)(by * 4 + y) * width + bx * 4 + x) * 4], &block[(y * 4 + x) * 4], 4);
+			}
+		}
+	}
+}
+
+
+void DecompressBC1(const unsigned char* blocks, int width, int height, unsigned char* dst)
+{
+	DecompressBlocks<false>(blocks, width, height, dst);
+}
+
+
+void DecompressBC3(const unsigned char* blocks, int width, int height, unsigned char* dst)
+{
+	DecompressBlocks<true>(blocks, width, height, dst);
+}
+
+
+void DownsampleRGBA(const unsigned char* src, int width, int height, unsigned char* dst)
+{
+	int dstWidth = std::max(width / 2, 1), dstHeight = std::max(height / 2, 1);
+
+	for (int y = 0; y < dstHeight; ++y) {
+		int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+		for (int x = 0; x < dstWidth; ++x) {
+			int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+			for (int c = 0; c < 4; ++c) {
+				int sum = src[((size_t)y0 * width + x0) * 4 + c] + src[((size_t)y0 * width + x1) * 4 + c] +
+					src[((size_t)y1 * width + x0) * 4 + c] + src[((size_t)y1 * width + x1) * 4 + c];
+				dst[((size_t)y * dstWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+
+bool ConvertImageToDDS(const std::string& imagePath, const std::string& ddsPath, TextureFormat format, bool mipmaps)
+{
+	if (format != TextureFormat::RGBA8 && format != TextureFormat::BC1 && format != TextureFormat::BC3) {
+		std::cout << "[TextureConverter] Can't encode " << GetTextureFormatName(format) << '\n';
+		return false;
+	}
+
+	int width, height, bpp;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* pixels = stbi_load(imagePath.c_str(), &width, &height, &bpp, 4);
+	if (!pixels) {
+		std::cout << "[TextureConverter] Failed to load " << imagePath << '\n';
+		return false;
+	}
+
+	//Mip chain in RGBA8, level 0 is the loaded image
+	std::vector<std::vector<unsigned char>> images(1, std::vector<unsigned char>(pixels, pixels + (size_t)width * height * 4));
+	stbi_image_free(pixels);
+
+	std::vector<TextureFile::Level> levels(1, TextureFile::Level{ width, height, nullptr, 0 });
+	while (mipmaps && (int)levels.size() < TextureFile::MaxLevels && (levels.back().Width > 1 || levels.back().Height > 1)) {
+		const TextureFile::Level& previous = levels.back();
+		TextureFile::Level level = { std::max(previous.Width / 2, 1), std::max(previous.Height / 2, 1), nullptr, 0 };
+		images.emplace_back((size_t)level.Width * level.Height * 4);
+		DownsampleRGBA(images[images.size() - 2].data(), previous.Width, previous.Height, images.back().data());
+		levels.push_back(level);
+	}
+
+	if (format == TextureFormat::RGBA8) {
+		for (size_t i = 0; i < levels.size(); ++i) {
+			levels[i].Data = images[i].data();
+			levels[i].Size = images[i].size();
+		}
+		return TextureFile::WriteDDS(ddsPath, format, levels.data(), (int)levels.size());
+	}
+
+	//Every level is cut into bands of block rows that are compressed in parallel
+	std::vector<std::vector<unsigned char>> compressed(levels.size());
+	size_t blockSize = format == TextureFormat::BC1 ? 8 : 16;
+
+	for (size_t i = 0; i < levels.size(); ++i) {
+		int levelWidth = levels[i].Width, levelHeight = levels[i].Height;
+		compressed[i].resize(GetTextureLevelSize(format, levelWidth, levelHeight));
+
+		const unsigned char* src = images[i].data();
+		unsigned char* dst = compressed[i].data();
+		size_t blockRowSize = (size_t)((levelWidth + 3) / 4) * blockSize;
+
+		JobSystem::Get().ParallelFor((size_t)(levelHeight + 3) / 4, 16, [&](size_t begin, size_t end) {
+			const unsigned char* bandSrc = src + begin * 4 * levelWidth * 4;
+			int bandHeight = std::min((int)(end * 4), levelHeight) - (int)(begin * 4);
+			if (format == TextureFormat::BC1)
+				CompressBC1(bandSrc, levelWidth, bandHeight, dst + begin * blockRowSize);
+			else
+				CompressBC3(bandSrc, levelWidth, bandHeight, dst + begin * blockRowSize);
+		});
+
+		levels[i].Data = compressed[i].data();
+		levels[i].Size = compressed[i].size();
+	}
+
+	return TextureFile::WriteDDS(ddsPath, format, levels.data(), (int)levels.size());
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "TextureFile.h"
+
+#include <string>
+
+
+//BC1 (opaque, 4 color mode) and BC3 encoders for RGBA8 images, run offline or at load time before writing a TextureFile
+//Endpoints are the inset bounding box of the block colors (van Waveren, "Real-Time DXT Compression"),
+//every pixel then picks the palette entry with the smallest squared RGB distance
+//Sizes don't need to be multiples of 4, edge blocks repeat the last row/column
+//dst receives GetTextureLevelSize(format, width, height) bytes
+void CompressBC1(const unsigned char* rgba, int width, int height, unsigned char* dst);
+void CompressBC3(const unsigned char* rgba, int width, int height, unsigned char* dst);
+
+//Plain scalar versions, produce the same blocks as the SSE2 ones and serve as benchmark baseline
+void CompressBC1Scalar(const unsigned char* rgba, int width, int height, unsigned char* dst);
+void CompressBC3Scalar(const unsigned char* rgba, int width, int height, unsigned char* dst);
+
+//Decoders for the blocks written above, dst receives width * height RGBA8 pixels
+//Used to measure the encoding error, BC1 blocks in 3 color mode decode index 3 as transparent black
+void DecompressBC1(const unsigned char* blocks, int width, int height, unsigned char* dst);
+void DecompressBC3(const unsigned char* blocks, int width, int height, unsigned char* dst);
+
+//Halves an RGBA8 image with a 2x2 box filter, dst is max(width / 2, 1) * max(height / 2, 1) pixels
+void DownsampleRGBA(const unsigned char* src, int width, int height, unsigned char* dst);
+
+//Loads an image with stb_image, builds the mip chain, compresses all levels on the JobSystem and writes a DDS
+//format can be RGBA8, BC1 or BC3
+bool ConvertImageToDDS(const std::string& imagePath, const std::string& ddsPath, TextureFormat format, bool mipmaps = true);
@@ -0,0 +1,399 @@
+#include "TextureFile.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+
+unsigned int GetTextureFormatGL(TextureFormat format) {
+	switch (format) {
+		case TextureFormat::RGBA8:		return GL_RGBA8;
+		case TextureFormat::BC1:		return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case TextureFormat::BC3:		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case TextureFormat::BC4:		return GL_COMPRESSED_RED_RGTC1;
+		case TextureFormat::BC5:		return GL_COMPRESSED_RG_RGTC2;
+		case TextureFormat::BC7:		return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		case TextureFormat::ETC2_RGB:	return GL_COMPRESSED_RGB8_ETC2;
+		case TextureFormat::ETC2_RGBA:	return GL_COMPRESSED_RGBA8_ETC2_EAC;
+	}
+	return 0;
+}
+
+
+const char* GetTextureFormatName(TextureFormat format) {
+	switch (format) {
+		case TextureFormat::RGBA8:		return "RGBA8";
+		case TextureFormat::BC1:		return "BC1";
+		case TextureFormat::BC3:		return "BC3";
+		case TextureFormat::BC4:		return "BC4";
+		case TextureFormat::BC5:		return "BC5";
+		case TextureFormat::BC7:		return "BC7";
+		case TextureFormat::ETC2_RGB:	return "ETC2 RGB";
+		case TextureFormat::ETC2_RGBA:	return "ETC2 RGBA";
+	}
+	return "Unknown";
+}
+
+
+size_t GetTextureLevelSize(TextureFormat format, int width, int height) {
+	size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+	switch (format) {
+		case TextureFormat::RGBA8:		return (size_t)width * height * 4;
+		case TextureFormat::BC1:
+		case TextureFormat::BC4:
+		case TextureFormat::ETC2_RGB:	return blocks * 8;
+		default:						return blocks * 16;
+	}
+}
+
+
+bool IsTextureFormatSupported(TextureFormat format) {
+	switch (format) {
+		case TextureFormat::RGBA8:		return true;
+		case TextureFormat::BC1:
+		case TextureFormat::BC3:		return GLEW_EXT_texture_compression_s3tc != 0;
+		case TextureFormat::BC4:
+		case TextureFormat::BC5:		return GLEW_VERSION_3_0 || GLEW_ARB_texture_compression_rgtc;
+		case TextureFormat::BC7:		return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+		case TextureFormat::ETC2_RGB:
+		case TextureFormat::ETC2_RGBA:	return GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility;
+	}
+	return false;
+}
+
+
+//DDS (DirectDraw Surface): "DDS " followed by DDS_HEADER and, if the FourCC is "DX10", DDS_HEADER_DXT10
+struct DDSPixelFormat {
+	uint32_t Size, Flags, FourCC, RGBBitCount;
+	uint32_t RBitMask, GBitMask, BBitMask, ABitMask;
+};
+
+struct DDSHeader {
+	uint32_t Size, Flags, Height, Width, PitchOrLinearSize, Depth, MipMapCount;
+	uint32_t Reserved1[11];
+	DDSPixelFormat PixelFormat;
+	uint32_t Caps, Caps2, Caps3, Caps4, Reserved2;
+};
+
+struct DDSHeaderDXT10 {
+	uint32_t DxgiFormat, ResourceDimension, MiscFlag, ArraySize, MiscFlags2;
+};
+
+static constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+	return (uint32_t)(unsigned char)a | ((uint32_t)(unsigned char)b << 8) | ((uint32_t)(unsigned char)c << 16) | ((uint32_t)(unsigned char)d << 24);
+}
+
+static const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PITCH = 0x8, DDSD_PIXELFORMAT = 0x1000, DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+static const uint32_t DDPF_FOURCC = 0x4, DDPF_RGB = 0x40, DDPF_ALPHAPIXELS = 0x1;
+static const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+static const uint32_t DDSCAPS2_CUBEMAP = 0x200, DDSCAPS2_VOLUME = 0x200000;
+
+
+//KTX 1: identifier, then 13 little endian uint32, key/value data and for every level its size followed by the data
+static const unsigned char s_KTXIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+struct KTXHeader {
+	uint32_t Endianness, GLType, GLTypeSize, GLFormat, GLInternalFormat, GLBaseInternalFormat;
+	uint32_t PixelWidth, PixelHeight, PixelDepth, ArrayElements, Faces, MipmapLevels, KeyValueBytes;
+};
+
+
+//KTX 2: identifier, header, index and a level index with absolute offsets, levels are stored smallest first
+static const unsigned char s_KTX2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+struct KTX2Header {
+	uint32_t VkFormat, TypeSize, PixelWidth, PixelHeight, PixelDepth, LayerCount, FaceCount, LevelCount, SupercompressionScheme;
+	uint32_t DfdByteOffset, DfdByteLength, KvdByteOffset, KvdByteLength;
+	uint32_t SgdByteOffset[2], SgdByteLength[2];	//uint64 in the file, split so the struct has no padding
+};
+
+struct KTX2Level {
+	uint64_t ByteOffset, ByteLength, UncompressedByteLength;
+};
+
+static_assert(sizeof(DDSHeader) == 124 && sizeof(KTXHeader) == 52 && sizeof(KTX2Header) == 68, "Container headers must match the file layout");
+
+
+static bool FormatFromDXGI(uint32_t dxgiFormat, TextureFormat& format) {
+	switch (dxgiFormat) {
+		case 28: format = TextureFormat::RGBA8; return true;	//DXGI_FORMAT_R8G8B8A8_UNORM
+		case 71: format = TextureFormat::BC1; return true;
+		case 77: format = TextureFormat::BC3; return true;
+		case 80: format = TextureFormat::BC4; return true;
+		case 83: format = TextureFormat::BC5; return true;
+		case 98: format = TextureFormat::BC7; return true;
+	}
+	return false;
+}
+
+static bool FormatFromGL(uint32_t internalFormat, TextureFormat& format) {
+	switch (internalFormat) {
+		case GL_RGBA8:								format = TextureFormat::RGBA8; return true;
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:		format = TextureFormat::BC1; return true;
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:		format = TextureFormat::BC3; return true;
+		case GL_COMPRESSED_RED_RGTC1:				format = TextureFormat::BC4; return true;
+		case GL_COMPRESSED_RG_RGTC2:				format = TextureFormat::BC5; return true;
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:			format = TextureFormat::BC7; return true;
+		case GL_COMPRESSED_RGB8_ETC2:				format = TextureFormat::ETC2_RGB; return true;
+		case GL_COMPRESSED_RGBA8_ETC2_EAC:			format = TextureFormat::ETC2_RGBA; return true;
+	}
+	return false;
+}
+
+static bool FormatFromVulkan(uint32_t vkFormat, TextureFormat& format) {
+	switch (vkFormat) {
+		case 37:	format = TextureFormat::RGBA8; return true;		//VK_FORMAT_R8G8B8A8_UNORM
+		case 131:
+		case 133:	format = TextureFormat::BC1; return true;
+		case 137:	format = TextureFormat::BC3; return true;
+		case 139:	format = TextureFormat::BC4; return true;
+		case 141:	format = TextureFormat::BC5; return true;
+		case 145:	format = TextureFormat::BC7; return true;
+		case 147:	format = TextureFormat::ETC2_RGB; return true;
+		case 151:	format = TextureFormat::ETC2_RGBA; return true;
+	}
+	return false;
+}
+
+
+TextureFile::TextureFile(const std::string& path)
+	: m_File(path), m_Format(TextureFormat::RGBA8), m_LevelCount(0), m_Levels()
+{
+	if (!m_File.IsOpen())
+		return;
+
+	const unsigned char* data = m_File.GetData();
+	size_t size = m_File.GetSize();
+
+	bool valid = false;
+	if (size >= 4 && memcmp(data, "DDS ", 4) == 0)
+		valid = ParseDDS(path);
+	else if (size >= sizeof(s_KTXIdentifier) && memcmp(data, s_KTXIdentifier, sizeof(s_KTXIdentifier)) == 0)
+		valid = ParseKTX(path);
+	else if (size >= sizeof(s_KTX2Identifier) && memcmp(data, s_KTX2Identifier, sizeof(s_KTX2Identifier)) == 0)
+		valid = ParseKTX2(path);
+	else
+		std::cout << "[TextureFile] " << path << " is not a DDS, KTX or KTX2 file\n";
+
+	if (!valid)
+		m_LevelCount = 0;
+}
+
+
+bool TextureFile::AddLevel(const std::string& path, uint64_t offset, uint64_t size, int width, int height) {
+
+	if (m_LevelCount == MaxLevels || width <= 0 || height <= 0)
+		return false;
+
+	//Offsets come straight from the file, offset + size could wrap around
+	if (offset > m_File.GetSize() || size > m_File.GetSize() - offset || size != GetTextureLevelSize(m_Format, width, height)) {
+		std::cout << "[TextureFile] " << path << " is truncated or corrupt\n";
+		return false;
+	}
+
+	m_Levels[m_LevelCount++] = { width, height, m_File.GetData() + offset, (size_t)size };
+	return true;
+}
+
+
+bool TextureFile::ParseDDS(const std::string& path) {
+
+	DDSHeader header;
+	if (m_File.GetSize() < 4 + sizeof(header))
+		return false;
+	memcpy(&header, m_File.GetData() + 4, sizeof(header));
+
+	if (header.Size != sizeof(DDSHeader) || (header.Caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))) {
+		std::cout << "[TextureFile] " << path << ": only 2D DDS textures are supported\n";
+		return false;
+	}
+
+	size_t offset = 4 + sizeof(DDSHeader);
+	bool supported = false;
+	const DDSPixelFormat& pf = header.PixelFormat;
+
+	if (pf.Flags & DDPF_FOURCC) {
+		switch (pf.FourCC) {
+			case MakeFourCC('D', 'X', 'T', '1'): m_Format = TextureFormat::BC1; supported = true; break;
+			case MakeFourCC('D', 'X', 'T', '5'): m_Format = TextureFormat::BC3; supported = true; break;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'): m_Format = TextureFormat::BC4; supported = true; break;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'): m_Format = TextureFormat::BC5; supported = true; break;
+			case MakeFourCC('D', 'X', '1', '0'): {
+				DDSHeaderDXT10 dx10;
+				if (m_File.GetSize() < offset + sizeof(dx10))
+					return false;
+				memcpy(&dx10, m_File.GetData() + offset, sizeof(dx10));
+				offset += sizeof(dx10);
+				supported = dx10.ArraySize <= 1 && FormatFromDXGI(dx10.DxgiFormat, m_Format);
+				break;
+			}
+		}
+	}
+	else if ((pf.Flags & DDPF_RGB) && pf.RGBBitCount == 32 && pf.RBitMask == 0xFF && pf.GBitMask == 0xFF00 && pf.BBitMask == 0xFF0000) {
+		m_Format = TextureFormat::RGBA8;
+		supported = true;
+	}
+
+	if (!supported) {
+		std::cout << "[TextureFile] " << path << " uses an unsupported DDS pixel format\n";
+		return false;
+	}
+
+	int levelCount = (header.Flags & DDSD_MIPMAPCOUNT) ? std::max((int)header.MipMapCount, 1) : 1;
+	int width = (int)header.Width, height = (int)header.Height;
+
+	for (int level = 0; level < levelCount; ++level) {
+		size_t levelSize = GetTextureLevelSize(m_Format, width, height);
+		if (!AddLevel(path, offset, levelSize, width, height))
+			return false;
+		offset += levelSize;
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+	return true;
+}
+
+
+bool TextureFile::ParseKTX(const std::string& path) {
+
+	KTXHeader header;
+	size_t offset = sizeof(s_KTXIdentifier);
+	if (m_File.GetSize() < offset + sizeof(header))
+		return false;
+	memcpy(&header, m_File.GetData() + offset, sizeof(header));
+	offset += sizeof(header) + header.KeyValueBytes;
+
+	if (header.Endianness != 0x04030201) {
+		std::cout << "[TextureFile] " << path << ": big endian KTX files are not supported\n";
+		return false;
+	}
+
+	if (header.PixelDepth > 1 || header.ArrayElements > 1 || header.Faces > 1 || !FormatFromGL(header.GLInternalFormat, m_Format)) {
+		std::cout << "[TextureFile] " << path << ": only single 2D KTX textures in a supported format can be loaded\n";
+		return false;
+	}
+
+	int levelCount = std::max((int)header.MipmapLevels, 1);
+	int width = (int)header.PixelWidth, height = (int)std::max(header.PixelHeight, 1u);
+
+	for (int level = 0; level < levelCount; ++level) {
+		uint32_t imageSize;
+		if (offset > m_File.GetSize() || sizeof(imageSize) > m_File.GetSize() - offset)
+			return false;
+		memcpy(&imageSize, m_File.GetData() + offset, sizeof(imageSize));
+		offset += sizeof(imageSize);
+
+		if (!AddLevel(path, offset, imageSize, width, height))
+			return false;
+
+		//Levels are padded to 4 bytes
+		offset += (imageSize + 3) & ~3u;
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+	return true;
+}
+
+
+bool TextureFile::ParseKTX2(const std::string& path) {
+
+	KTX2Header header;
+	size_t offset = sizeof(s_KTX2Identifier);
+	if (m_File.GetSize() < offset + sizeof(header))
+		return false;
+	memcpy(&header, m_File.GetData() + offset, sizeof(header));
+	offset += sizeof(header);
+
+	if (header.SupercompressionScheme != 0) {
+		std::cout << "[TextureFile] " << path << ": KTX2 supercompression (BasisLZ, Zstandard) is not supported\n";
+		return false;
+	}
+
+	if (header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount > 1 || !FormatFromVulkan(header.VkFormat, m_Format)) {
+		std::cout << "[TextureFile] " << path << ": only single 2D KTX2 textures in a supported format can be loaded\n";
+		return false;
+	}
+
+	int levelCount = std::max((int)header.LevelCount, 1);
+	if (offset + levelCount * sizeof(KTX2Level) > m_File.GetSize())
+		return false;
+
+	int width = (int)header.PixelWidth, height = (int)std::max(header.PixelHeight, 1u);
+
+	for (int level = 0; level < levelCount; ++level) {
+		KTX2Level entry;
+		memcpy(&entry, m_File.GetData() + offset + level * sizeof(KTX2Level), sizeof(entry));
+
+		if (!AddLevel(path, entry.ByteOffset, entry.ByteLength, width, height))
+			return false;
+
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+	return true;
+}
+
+
+bool TextureFile::WriteDDS(const std::string& path, TextureFormat format, const Level* levels, int levelCount) {
+
+	DDSHeader header = {};
+	header.Size = sizeof(DDSHeader);
+	header.Flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header.Width = (uint32_t)levels[0].Width;
+	header.Height = (uint32_t)levels[0].Height;
+	header.PitchOrLinearSize = (uint32_t)levels[0].Size;
+	header.MipMapCount = (uint32_t)levelCount;
+	header.Caps = DDSCAPS_TEXTURE | (levelCount > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+	DDSPixelFormat& pf = header.PixelFormat;
+	pf.Size = sizeof(DDSPixelFormat);
+
+	DDSHeaderDXT10 dx10 = {};
+	bool writeDX10 = false;
+
+	switch (format) {
+		case TextureFormat::RGBA8:
+			pf.Flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+			pf.RGBBitCount = 32;
+			pf.RBitMask = 0xFF; pf.GBitMask = 0xFF00; pf.BBitMask = 0xFF0000; pf.ABitMask = 0xFF000000;
+			header.Flags = (header.Flags & ~DDSD_LINEARSIZE) | DDSD_PITCH;
+			header.PitchOrLinearSize = (uint32_t)levels[0].Width * 4;
+			break;
+		case TextureFormat::BC1: pf.Flags = DDPF_FOURCC; pf.FourCC = MakeFourCC('D', 'X', 'T', '1'); break;
+		case TextureFormat::BC3: pf.Flags = DDPF_FOURCC; pf.FourCC = MakeFourCC('D', 'X', 'T', '5'); break;
+		case TextureFormat::BC4: pf.Flags = DDPF_FOURCC; pf.FourCC = MakeFourCC('B', 'C', '4', 'U'); break;
+		case TextureFormat::BC5: pf.Flags = DDPF_FOURCC; pf.FourCC = MakeFourCC('B', 'C', '5', 'U'); break;
+		case TextureFormat::BC7:
+			pf.Flags = DDPF_FOURCC;
+			pf.FourCC = MakeFourCC('D', 'X', '1', '0');
+			dx10.DxgiFormat = 98;
+			dx10.ResourceDimension = 3;	//D3D10_RESOURCE_DIMENSION_TEXTURE2D
+			dx10.ArraySize = 1;
+			writeDX10 = true;
+			break;
+		default:
+			std::cout << "[TextureFile] " << GetTextureFormatName(format) << " can't be stored in a DDS, use KTX\n";
+			return false;
+	}
+
+	std::ofstream stream(path, std::ios::binary);
+	if (!stream) {
+		std::cout << "[TextureFile] Failed to create " << path << '\n';
+		return false;
+	}
+
+	stream.write("DDS ", 4);
+	stream.write((const char*)&header, sizeof(header));
+	if (writeDX10)
+		stream.write((const char*)&dx10, sizeof(dx10));
+	for (int level = 0; level < levelCount; ++level)
+		stream.write((const char*)levels[level].Data, (std::streamsize)levels[level].Size);
+
+	return (bool)stream;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+//Formats that can be uploaded as they are stored, everything except RGBA8 uses 4x4 pixel blocks
+enum class TextureFormat {
+	RGBA8,
+	BC1,		//RGB + 1 bit alpha, 8 bytes per block
+	BC3,		//RGB + interpolated alpha, 16 bytes per block
+	BC4,		//Single channel, 8 bytes per block
+	BC5,		//Two channels (normal maps), 16 bytes per block
+	BC7,		//High quality RGBA, 16 bytes per block
+	ETC2_RGB,	//8 bytes per block, mainly for GLES class hardware
+	ETC2_RGBA	//16 bytes per block
+};
+
+//GL internal format for glCompressedTexImage2D (glTexImage2D for RGBA8)
+unsigned int GetTextureFormatGL(TextureFormat format);
+const char* GetTextureFormatName(TextureFormat format);
+//Bytes of one mip level, block formats round the size up to whole blocks
+size_t GetTextureLevelSize(TextureFormat format, int width, int height);
+//Checks the GL version and extensions, needs a current context
+bool IsTextureFormatSupported(TextureFormat format);
+
+
+//Read only view of a DDS, KTX or KTX2 file (detected by magic), the level data points straight into the mapping
+//Only single 2D images are supported: no cube maps, arrays, volumes or KTX2 supercompression
+class TextureFile {
+public:
+	struct Level {
+		int Width, Height;
+		const unsigned char* Data;
+		size_t Size;
+	};
+
+	static const int MaxLevels = 16;
+
+	TextureFile(const std::string& path);
+
+	inline bool IsValid() const { return m_LevelCount > 0; }
+
+	inline TextureFormat GetFormat() const { return m_Format; }
+	inline int GetWidth() const { return m_Levels[0].Width; }
+	inline int GetHeight() const { return m_Levels[0].Height; }
+	inline int GetLevelCount() const { return m_LevelCount; }
+	inline const Level& GetLevel(int level) const { return m_Levels[level]; }
+
+	//Writes a DDS with the given mip chain, levels[0] is the full size image
+	static bool WriteDDS(const std::string& path, TextureFormat format, const Level* levels, int levelCount);
+
+private:
+	bool ParseDDS(const std::string& path);
+	bool ParseKTX(const std::string& path);
+	bool ParseKTX2(const std::string& path);
+
+	//Appends a level after checking that it lies inside the file and has the size the format needs
+	bool AddLevel(const std::string& path, uint64_t offset, uint64_t size, int width, int height);
+
+private:
+	MappedFile m_File;
+	TextureFormat m_Format;
+	int m_LevelCount;
+	Level m_Levels[MaxLevels];
+};
@@ -0,0 +1,242 @@
+#include "TextureStreamer.h"
+
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+
+TextureStreamer::TextureStreamer(size_t memoryBudget, size_t uploadBudget)
+	: m_MemoryBudget(memoryBudget), m_UploadBudget(uploadBudget), m_MemoryUsage(0), m_UploadedBytes(0), m_Frame(0)
+{
+
+}
+
+
+TextureStreamer::~TextureStreamer() {
+	for (const StreamedTexture& texture : m_Textures) {
+		GLCall(glDeleteTextures(1, &texture.RendererID));
+	}
+}
+
+
+TextureStreamer::Handle TextureStreamer::Load(const std::string& path) {
+
+	auto file = std::make_unique<TextureFile>(path);
+	if (!file->IsValid())
+		return InvalidHandle;
+
+	if (!IsTextureFormatSupported(file->GetFormat())) {
+		std::cout << "[TextureStreamer] " << GetTextureFormatName(file->GetFormat()) << " isn't supported by this OpenGL context: " << path << '\n';
+		return InvalidHandle;
+	}
+
+	int levelCount = file->GetLevelCount();
+
+	StreamedTexture texture;
+	texture.Path = path;
+	texture.RendererID = 0;
+	texture.ResidentLevel = levelCount;
+	texture.MinResidentLevel = levelCount - 1;
+	while (texture.MinResidentLevel > 0) {
+		const TextureFile::Level& finer = file->GetLevel(texture.MinResidentLevel - 1);
+		if (std::max(finer.Width, finer.Height) > MinResidentSize)
+			break;
+		--texture.MinResidentLevel;
+	}
+	texture.RequestedLevel = levelCount;
+	texture.DesiredLevel = texture.MinResidentLevel;
+	texture.MemorySize = 0;
+	texture.LastUsedFrame = m_Frame;
+	texture.File = std::move(file);
+
+	GLCall(glGenTextures(1, &texture.RendererID));
+	GLCall(glBindTexture(GL_TEXTURE_2D, texture.RendererID));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+	//The small tail of the chain is uploaded right away and doesn't count against the frame budget
+	for (int level = levelCount - 1; level >= texture.MinResidentLevel; --level)
+		UploadLevel(texture, level);
+
+	m_Textures.push_back(std::move(texture));
+	return (Handle)(m_Textures.size() - 1);
+}
+
+
+void TextureStreamer::Bind(Handle handle, unsigned int slot) const {
+	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+	GLCall(glBindTexture(GL_TEXTURE_2D, m_Textures[handle].RendererID));
+}
+
+
+void TextureStreamer::RequestSize(Handle handle, float screenSize) {
+
+	StreamedTexture& texture = m_Textures[handle];
+	texture.LastUsedFrame = m_Frame;
+	if (screenSize <= 0.0f)
+		return;
+
+	//One level per halving of the texels per pixel, like the hardware would select
+	int levelCount = texture.File->GetLevelCount();
+	float texels = (float)std::max(texture.File->GetWidth(), texture.File->GetHeight());
+	int level = std::max((int)std::floor(std::log2(texels / screenSize)), 0);
+	texture.RequestedLevel = std::min(texture.RequestedLevel, std::min(level, levelCount - 1));
+}
+
+
+void TextureStreamer::UpdateBaseLevel(const StreamedTexture& texture) {
+	GLCall(glBindTexture(GL_TEXTURE_2D, texture.RendererID));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, texture.ResidentLevel));
+}
+
+
+void TextureStreamer::UploadLevel(StreamedTexture& texture, int level) {
+
+	const TextureFile::Level& data = texture.File->GetLevel(level);
+	TextureFormat format = texture.File->GetFormat();
+
+	GLCall(glBindTexture(GL_TEXTURE_2D, texture.RendererID));
+	if (format == TextureFormat::RGBA8) {
+		GLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, data.Width, data.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.Data));
+	}
+	else {
+		GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, GetTextureFormatGL(format), data.Width, data.Height, 0, (GLsizei)data.Size, data.Data));
+	}
+
+	texture.ResidentLevel = level;
+	texture.MemorySize += data.Size;
+	m_MemoryUsage += data.Size;
+	UpdateBaseLevel(texture);
+}
+
+
+void TextureStreamer::EvictLevel(StreamedTexture& texture) {
+
+	int level = texture.ResidentLevel;
+	size_t size = texture.File->GetLevel(level).Size;
+
+	//Move the base level first so the texture stays complete, then replace the level with an empty image to free it
+	texture.ResidentLevel = level + 1;
+	UpdateBaseLevel(texture);
+	GLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+	texture.MemorySize -= size;
+	m_MemoryUsage -= size;
+}
+
+
+bool TextureStreamer::MakeRoom(size_t bytes, uint64_t frame, const StreamedTexture* exclude) {
+
+	while (m_MemoryUsage + bytes > m_MemoryBudget) {
+		//Levels finer than needed go first, then the least recently used, larger levels before smaller ones
+		StreamedTexture* victim = nullptr;
+		for (StreamedTexture& texture : m_Textures) {
+			if (&texture == exclude || texture.ResidentLevel >= texture.MinResidentLevel)
+				continue;
+
+			bool unneeded = texture.ResidentLevel < texture.DesiredLevel;
+			if (!unneeded && texture.LastUsedFrame >= frame)
+				continue;
+
+			if (!victim) {
+				victim = &texture;
+				continue;
+			}
+
+			bool victimUnneeded = victim->ResidentLevel < victim->DesiredLevel;
+			if (unneeded != victimUnneeded) {
+				if (unneeded)
+					victim = &texture;
+			}
+			else if (texture.LastUsedFrame != victim->LastUsedFrame) {
+				if (texture.LastUsedFrame < victim->LastUsedFrame)
+					victim = &texture;
+			}
+			else if (texture.ResidentLevel < victim->ResidentLevel)
+				victim = &texture;
+		}
+
+		if (!victim)
+			return false;
+		EvictLevel(*victim);
+	}
+	return true;
+}
+
+
+void TextureStreamer::Update() {
+
+	m_UploadedBytes = 0;
+
+	for (StreamedTexture& texture : m_Textures) {
+		bool requested = texture.RequestedLevel < texture.File->GetLevelCount();
+		texture.DesiredLevel = requested ? std::min(texture.RequestedLevel, texture.MinResidentLevel) : texture.MinResidentLevel;
+	}
+
+	//Only does something if the budget was lowered, may evict levels that are still visible
+	MakeRoom(0, m_Frame + 1, nullptr);
+
+	//Most recently used first, then the ones missing the most levels
+	std::vector<StreamedTexture*> pending;
+	for (StreamedTexture& texture : m_Textures) {
+		if (texture.DesiredLevel < texture.ResidentLevel)
+			pending.push_back(&texture);
+	}
+	std::sort(pending.begin(), pending.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+		if (a->LastUsedFrame != b->LastUsedFrame)
+			return a->LastUsedFrame > b->LastUsedFrame;
+		return a->ResidentLevel - a->DesiredLevel > b->ResidentLevel - b->DesiredLevel;
+	});
+
+	//One level per texture and pass, so a single large texture can't hold back all others
+	//The first upload of a frame is always allowed, otherwise levels larger than the budget would never arrive
+	bool progress = true;
+	while (progress) {
+		progress = false;
+		for (StreamedTexture* texture : pending) {
+			if (texture->ResidentLevel <= texture->DesiredLevel)
+				continue;
+
+			int level = texture->ResidentLevel - 1;
+			size_t size = texture->File->GetLevel(level).Size;
+			if (m_UploadedBytes > 0 && m_UploadedBytes + size > m_UploadBudget) {
+				progress = false;
+				break;
+			}
+
+			if (!MakeRoom(size, texture->LastUsedFrame, texture))
+				continue;
+
+			UploadLevel(*texture, level);
+			m_UploadedBytes += size;
+			progress = true;
+		}
+	}
+
+	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+
+	++m_Frame;
+	for (StreamedTexture& texture : m_Textures)
+		texture.RequestedLevel = texture.File->GetLevelCount();
+}
+
+
+TextureStreamer::TextureInfo TextureStreamer::GetInfo(Handle handle) const {
+
+	const StreamedTexture& texture = m_Textures[handle];
+	TextureInfo info;
+	info.Path = &texture.Path;
+	info.Width = texture.File->GetWidth();
+	info.Height = texture.File->GetHeight();
+	info.LevelCount = texture.File->GetLevelCount();
+	info.ResidentLevel = texture.ResidentLevel;
+	info.DesiredLevel = texture.DesiredLevel;
+	info.MemorySize = texture.MemorySize;
+	info.LastUsedFrame = texture.LastUsedFrame;
+	return info;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "TextureFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+//Keeps only the mip levels of a texture resident that are needed for its size on screen
+//Sources are DDS/KTX files with a full mip chain (see ConvertImageToDDS), they stay memory mapped so any level can be
+//uploaded later without touching the disk again. Every frame the user reports how large each texture appears with
+//RequestSize, Update then uploads missing levels within a per frame transfer budget and evicts the finest levels of
+//the least recently used textures when the resident memory would exceed the VRAM budget
+class TextureStreamer {
+public:
+	typedef unsigned int Handle;
+	static const Handle InvalidHandle = 0xFFFFFFFF;
+
+	//Levels at or below this size are uploaded on load and never evicted, so every texture can always be drawn
+	static const int MinResidentSize = 64;
+
+	struct TextureInfo {
+		const std::string* Path;
+		int Width, Height;
+		int LevelCount;
+		int ResidentLevel;		//Finest uploaded level, 0 is full resolution
+		int DesiredLevel;		//Level the last size request asked for
+		size_t MemorySize;		//Bytes of the resident levels
+		uint64_t LastUsedFrame;
+	};
+
+	TextureStreamer(size_t memoryBudget = 64 * 1024 * 1024, size_t uploadBudget = 4 * 1024 * 1024);
+	~TextureStreamer();
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	//Returns InvalidHandle if the file can't be opened or its format isn't supported by the context
+	Handle Load(const std::string& path);
+
+	void Bind(Handle handle, unsigned int slot = 0) const;
+
+	//screenSize is the edge length in pixels the texture covers this frame, the largest request of a frame wins
+	void RequestSize(Handle handle, float screenSize);
+
+	//Call once per frame after the requests: evicts, uploads and starts the next frame
+	void Update();
+
+	void SetMemoryBudget(size_t bytes) { m_MemoryBudget = bytes; }
+	void SetUploadBudget(size_t bytes) { m_UploadBudget = bytes; }
+	inline size_t GetMemoryBudget() const { return m_MemoryBudget; }
+	inline size_t GetUploadBudget() const { return m_UploadBudget; }
+	inline size_t GetMemoryUsage() const { return m_MemoryUsage; }
+	//Bytes uploaded by the last Update
+	inline size_t GetUploadedBytes() const { return m_UploadedBytes; }
+
+	inline size_t GetTextureCount() const { return m_Textures.size(); }
+	TextureInfo GetInfo(Handle handle) const;
+
+private:
+	struct StreamedTexture {
+		std::string Path;
+		std::unique_ptr<TextureFile> File;
+		unsigned int RendererID;
+		int ResidentLevel;
+		int MinResidentLevel;	//Coarsest level that may be evicted is MinResidentLevel - 1
+		int RequestedLevel;		//Finest level requested in the current frame, LevelCount if none
+		int DesiredLevel;
+		size_t MemorySize;
+		uint64_t LastUsedFrame;
+	};
+
+	void UploadLevel(StreamedTexture& texture, int level);
+	void EvictLevel(StreamedTexture& texture);
+	void UpdateBaseLevel(const StreamedTexture& texture);
+
+	//Evicts finest levels of textures used before frame (or not needing them anymore) until bytes fit into the budget
+	bool MakeRoom(size_t bytes, uint64_t frame, const StreamedTexture* exclude);
+
+private:
+	std::vector<StreamedTexture> m_Textures;
+	size_t m_MemoryBudget;
+	size_t m_UploadBudget;
+	size_t m_MemoryUsage;
+	size_t m_UploadedBytes;
+	uint64_t m_Frame;
+};
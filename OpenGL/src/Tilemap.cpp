@@ -0,0 +1,186 @@
+#include "Tilemap.h"
+
+#include "VertexBufferLayout.h"
+#include "Timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+
+Tilemap::Tilemap(int width, int height, int chunkSize)
+	: m_Width(width), m_Height(height), m_ChunkSize(chunkSize), m_ChunksX((width + chunkSize - 1) / chunkSize),
+	  m_ChunksY((height + chunkSize - 1) / chunkSize), m_IndexTexture(0), m_RebuiltChunks(0), m_RebuildMs(0.0f)
+{
+	static constexpr auto s_ChunkLayout = MakeVertexLayout<ChunkInstance>(
+		VERTEX_ATTRIB_INTEGER(ChunkInstance, Rect)
+	);
+
+	GLint maxTextureSize = 0;
+	GLCall(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize));
+	if (width > maxTextureSize || height > maxTextureSize)
+		std::cout << "[Tilemap] " << width << "x" << height << " tiles exceed the maximum texture size " << maxTextureSize << std::endl;
+
+	m_Tiles.assign((size_t)width * height, 0);
+	m_Chunks.assign((size_t)m_ChunksX * m_ChunksY, { 0, false });
+	m_Instances.reserve(m_Chunks.size());
+
+	GLCall(glGenTextures(1, &m_IndexTexture));
+	GLCall(glBindTexture(GL_TEXTURE_2D, m_IndexTexture));
+	GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 2));
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, m_Tiles.data()));
+	GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	//Integer textures can't be filtered, the shader only uses texelFetch anyway
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+
+	m_Shader = AssetManager::Get().Load<Shader>("res/shader/Tilemap.shader");
+	m_Shader->Bind();
+	m_Shader->SetUniform1i("u_TileIndices", 0);
+	m_Shader->SetUniform1i("u_TileTextures", 1);
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_VBO = std::make_unique<VertexBuffer>(nullptr, (unsigned int)(m_Chunks.size() * sizeof(ChunkInstance)), true);
+	m_VAO->AddBuffer(*m_VBO, s_ChunkLayout, 0, 1);
+}
+
+
+Tilemap::~Tilemap()
+{
+	GLCall(glDeleteTextures(1, &m_IndexTexture));
+}
+
+
+void Tilemap::MarkDirty(int chunk)
+{
+	if (!m_Chunks[chunk].Dirty) {
+		m_Chunks[chunk].Dirty = true;
+		m_DirtyChunks.push_back(chunk);
+	}
+}
+
+
+void Tilemap::SetTile(int x, int y, uint16_t tile)
+{
+	if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+		return;
+
+	uint16_t& current = m_Tiles[(size_t)y * m_Width + x];
+	if (current == tile)
+		return;
+
+	int chunk = GetChunkIndex(x, y);
+	m_Chunks[chunk].UsedTiles += (tile != 0) - (current != 0);
+	current = tile;
+	MarkDirty(chunk);
+}
+
+
+void Tilemap::SetTiles(const uint16_t* tiles)
+{
+	std::copy(tiles, tiles + m_Tiles.size(), m_Tiles.begin());
+
+	for (Chunk& chunk : m_Chunks)
+		chunk.UsedTiles = 0;
+	for (int y = 0; y < m_Height; ++y) {
+		const uint16_t* row = &m_Tiles[(size_t)y * m_Width];
+		for (int x = 0; x < m_Width; ++x)
+			m_Chunks[GetChunkIndex(x, y)].UsedTiles += row[x] != 0;
+	}
+
+	for (int chunk = 0; chunk < (int)m_Chunks.size(); ++chunk)
+		MarkDirty(chunk);
+}
+
+
+Tilemap::ChunkInstance Tilemap::GetChunkRect(int chunk) const
+{
+	int x = (chunk % m_ChunksX) * m_ChunkSize;
+	int y = (chunk / m_ChunksX) * m_ChunkSize;
+	return { { x, y, std::min(m_ChunkSize, m_Width - x), std::min(m_ChunkSize, m_Height - y) } };
+}
+
+
+unsigned int Tilemap::Update()
+{
+	m_RebuiltChunks = (unsigned int)m_DirtyChunks.size();
+	m_RebuildMs = 0.0f;
+	if (m_DirtyChunks.empty())
+		return 0;
+
+	Timer timer([this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+		m_RebuildMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+	});
+
+	GLCall(glBindTexture(GL_TEXTURE_2D, m_IndexTexture));
+	GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 2));
+
+	//Past half of the map a single upload of everything is cheaper than many small ones
+	if (m_DirtyChunks.size() * 2 > m_Chunks.size()) {
+		GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GL_RED_INTEGER, GL_UNSIGNED_SHORT, m_Tiles.data()));
+	}
+	else {
+		//The chunk is read straight out of the map rows, the row length skips the tiles of the other chunks
+		GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, m_Width));
+		for (unsigned int chunk : m_DirtyChunks) {
+			ChunkInstance rect = GetChunkRect(chunk);
+			GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.Rect[0], rect.Rect[1], rect.Rect[2], rect.Rect[3], GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+				&m_Tiles[(size_t)rect.Rect[1] * m_Width + rect.Rect[0]]));
+		}
+		GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+	}
+
+	GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+
+	for (unsigned int chunk : m_DirtyChunks)
+		m_Chunks[chunk].Dirty = false;
+	m_DirtyChunks.clear();
+	return m_RebuiltChunks;
+}
+
+
+void Tilemap::Draw(const Camera& camera, const TextureArray& tileTextures, float tileSize)
+{
+	//World rectangle the camera sees, from the corners of clip space
+	glm::vec2 viewMin(INFINITY), viewMax(-INFINITY);
+	for (int corner = 0; corner < 4; ++corner) {
+		glm::vec4 world = camera.GetInverseViewProjection() * glm::vec4(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, 0.0f, 1.0f);
+		glm::vec2 point = glm::vec2(world) / world.w;
+		viewMin = glm::min(viewMin, point);
+		viewMax = glm::max(viewMax, point);
+	}
+
+	//The chunks overlapping it follow directly from the grid
+	float chunkWorldSize = m_ChunkSize * tileSize;
+	int minX = std::max((int)std::floor(viewMin.x / chunkWorldSize), 0);
+	int minY = std::max((int)std::floor(viewMin.y / chunkWorldSize), 0);
+	int maxX = std::min((int)std::floor(viewMax.x / chunkWorldSize), m_ChunksX - 1);
+	int maxY = std::min((int)std::floor(viewMax.y / chunkWorldSize), m_ChunksY - 1);
+
+	m_Instances.clear();
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			int chunk = y * m_ChunksX + x;
+			if (m_Chunks[chunk].UsedTiles)
+				m_Instances.push_back(GetChunkRect(chunk));
+		}
+	}
+
+	if (m_Instances.empty())
+		return;
+
+	m_VBO->SetData(m_Instances.data(), (unsigned int)(m_Instances.size() * sizeof(ChunkInstance)));
+
+	GLCall(glActiveTexture(GL_TEXTURE0));
+	GLCall(glBindTexture(GL_TEXTURE_2D, m_IndexTexture));
+	tileTextures.Bind(1);
+
+	m_Shader->Bind();
+	m_Shader->SetUniformMat4f("u_MVP", camera.GetViewProjection());
+	m_Shader->SetUniform1f("u_TileSize", tileSize);
+	m_VAO->Bind();
+	GLCall(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)m_Instances.size()));
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Renderer.h"
+#include "Camera.h"
+#include "TextureArray.h"
+#include "VertexBuffer.h"
+#include "AssetManager.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+//Large 2D tile world drawn with one quad per visible chunk instead of one per tile
+//The tile ids live in an R16UI index texture with one texel per tile, which the fragment shader looks up to pick the
+//layer of a TextureArray (see Tilemap.shader). Every chunk owns a fixed region of that texture, so editing tiles only
+//marks their chunk dirty and Update() re-uploads just the dirty regions. Draw() takes the chunks overlapping the camera
+//straight from the grid, skips empty ones and draws the rest with a single instanced call.
+//Tile 0 is empty, tile n samples layer n - 1.
+class Tilemap {
+public:
+	//width and height in tiles, they must not exceed GL_MAX_TEXTURE_SIZE
+	Tilemap(int width, int height, int chunkSize = 64);
+	~Tilemap();
+
+	Tilemap(const Tilemap&) = delete;
+	Tilemap& operator=(const Tilemap&) = delete;
+
+	void SetTile(int x, int y, uint16_t tile);
+	inline uint16_t GetTile(int x, int y) const { return m_Tiles[(size_t)y * m_Width + x]; }
+	//Replaces every tile, width * height ids in rows from the bottom
+	void SetTiles(const uint16_t* tiles);
+
+	//Uploads the chunks modified since the last call, returns how many there were
+	unsigned int Update();
+	//tileSize is the size of one tile in world units, the map starts at the origin
+	void Draw(const Camera& camera, const TextureArray& tileTextures, float tileSize);
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline int GetChunkSize() const { return m_ChunkSize; }
+	inline int GetChunkCount() const { return m_ChunksX * m_ChunksY; }
+
+	//Of the last Update and Draw
+	inline unsigned int GetRebuiltChunks() const { return m_RebuiltChunks; }
+	inline float GetRebuildMs() const { return m_RebuildMs; }
+	inline unsigned int GetVisibleChunks() const { return (unsigned int)m_Instances.size(); }
+
+private:
+	struct Chunk {
+		unsigned int UsedTiles;		//Non-empty tiles, empty chunks are never drawn
+		bool Dirty;
+	};
+
+	//Tile rectangle of a chunk, also the per instance vertex data
+	struct ChunkInstance {
+		int Rect[4];	//x, y, width, height
+	};
+
+	inline int GetChunkIndex(int x, int y) const { return (y / m_ChunkSize) * m_ChunksX + x / m_ChunkSize; }
+	void MarkDirty(int chunk);
+	ChunkInstance GetChunkRect(int chunk) const;
+
+private:
+	int m_Width, m_Height;
+	int m_ChunkSize;
+	int m_ChunksX, m_ChunksY;
+
+	std::vector<uint16_t> m_Tiles;
+	std::vector<Chunk> m_Chunks;
+	std::vector<unsigned int> m_DirtyChunks;
+
+	unsigned int m_IndexTexture;
+	AssetRef<Shader> m_Shader;
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VBO;
+	std::vector<ChunkInstance> m_Instances;
+
+	unsigned int m_RebuiltChunks;
+	float m_RebuildMs;
+};
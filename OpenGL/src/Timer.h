@@ -10,11 +10,11 @@ public:
     Timer(std::function<void(std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime)> func) {
         this->func = func;
 
-        startTime = std::chrono::high_resolution_clock::now();
+        startTime = std::chrono::steady_clock::now();
     }
 
     ~Timer() {
-        endTime = std::chrono::high_resolution_clock::now();
+        endTime = std::chrono::steady_clock::now();
         func(startTime, endTime);
     }
 
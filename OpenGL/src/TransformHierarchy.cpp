@@ -0,0 +1,242 @@
+#include "TransformHierarchy.h"
+
+#include <cstring>
+#include <iostream>
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include "glm/simd/matrix.h"
+#endif
+
+
+TransformHierarchy::TransformHierarchy()
+	: m_AnyDirty(false)
+{
+}
+
+
+unsigned int TransformHierarchy::Add(unsigned int parent, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+
+	unsigned int node = (unsigned int)GetCount();
+	if (parent != NoParent && parent >= node) {
+		std::cout << "[TransformHierarchy] Parent " << parent << " doesn't exist yet, adding node " << node << " as root" << std::endl;
+		parent = NoParent;
+	}
+
+	m_PositionX.push_back(position.x); m_PositionY.push_back(position.y); m_PositionZ.push_back(position.z);
+	m_RotationX.push_back(rotation.x); m_RotationY.push_back(rotation.y); m_RotationZ.push_back(rotation.z); m_RotationW.push_back(rotation.w);
+	m_ScaleX.push_back(scale.x); m_ScaleY.push_back(scale.y); m_ScaleZ.push_back(scale.z);
+	m_Parent.push_back(parent);
+	m_Dirty.push_back(1);
+	m_Local.emplace_back(1.0f);
+	m_World.emplace_back(1.0f);
+
+	m_AnyDirty = true;
+	return node;
+}
+
+
+void TransformHierarchy::Clear() {
+	m_PositionX.clear(); m_PositionY.clear(); m_PositionZ.clear();
+	m_RotationX.clear(); m_RotationY.clear(); m_RotationZ.clear(); m_RotationW.clear();
+	m_ScaleX.clear(); m_ScaleY.clear(); m_ScaleZ.clear();
+	m_Parent.clear();
+	m_Dirty.clear();
+	m_Local.clear();
+	m_World.clear();
+	m_AnyDirty = false;
+}
+
+
+void TransformHierarchy::Reserve(size_t count) {
+	m_PositionX.reserve(count); m_PositionY.reserve(count); m_PositionZ.reserve(count);
+	m_RotationX.reserve(count); m_RotationY.reserve(count); m_RotationZ.reserve(count); m_RotationW.reserve(count);
+	m_ScaleX.reserve(count); m_ScaleY.reserve(count); m_ScaleZ.reserve(count);
+	m_Parent.reserve(count);
+	m_Dirty.reserve(count);
+	m_Local.reserve(count);
+	m_World.reserve(count);
+}
+
+
+void TransformHierarchy::MarkDirty(unsigned int node) {
+	m_Dirty[node] = 1;
+	m_AnyDirty = true;
+}
+
+
+void TransformHierarchy::SetPosition(unsigned int node, const glm::vec3& position) {
+	m_PositionX[node] = position.x; m_PositionY[node] = position.y; m_PositionZ[node] = position.z;
+	MarkDirty(node);
+}
+
+
+void TransformHierarchy::SetRotation(unsigned int node, const glm::quat& rotation) {
+	m_RotationX[node] = rotation.x; m_RotationY[node] = rotation.y; m_RotationZ[node] = rotation.z; m_RotationW[node] = rotation.w;
+	MarkDirty(node);
+}
+
+
+void TransformHierarchy::SetScale(unsigned int node, const glm::vec3& scale) {
+	m_ScaleX[node] = scale.x; m_ScaleY[node] = scale.y; m_ScaleZ[node] = scale.z;
+	MarkDirty(node);
+}
+
+
+glm::vec3 TransformHierarchy::GetPosition(unsigned int node) const {
+	return { m_PositionX[node], m_PositionY[node], m_PositionZ[node] };
+}
+
+
+glm::quat TransformHierarchy::GetRotation(unsigned int node) const {
+	return glm::quat(m_RotationW[node], m_RotationX[node], m_RotationY[node], m_RotationZ[node]);
+}
+
+
+glm::vec3 TransformHierarchy::GetScale(unsigned int node) const {
+	return { m_ScaleX[node], m_ScaleY[node], m_ScaleZ[node] };
+}
+
+
+void TransformHierarchy::ComputeLocalScalar(size_t node) {
+
+	//translate * rotate * scale without the full matrix products
+	glm::mat3 rotation = glm::mat3_cast(GetRotation((unsigned int)node));
+	glm::mat4& local = m_Local[node];
+	local[0] = glm::vec4(rotation[0] * m_ScaleX[node], 0.0f);
+	local[1] = glm::vec4(rotation[1] * m_ScaleY[node], 0.0f);
+	local[2] = glm::vec4(rotation[2] * m_ScaleZ[node], 0.0f);
+	local[3] = glm::vec4(m_PositionX[node], m_PositionY[node], m_PositionZ[node], 1.0f);
+}
+
+
+void TransformHierarchy::PropagateScalar() {
+
+	for (size_t node = 0; node < GetCount(); ++node) {
+		unsigned int parent = m_Parent[node];
+		if (parent != NoParent)
+			m_Dirty[node] |= m_Dirty[parent];
+		if (!m_Dirty[node])
+			continue;
+
+		m_World[node] = parent != NoParent ? m_World[parent] * m_Local[node] : m_Local[node];
+	}
+}
+
+
+void TransformHierarchy::UpdateScalar() {
+
+	if (!m_AnyDirty)
+		return;
+
+	for (size_t node = 0; node < GetCount(); ++node) {
+		if (m_Dirty[node])
+			ComputeLocalScalar(node);
+	}
+	PropagateScalar();
+
+	memset(m_Dirty.data(), 0, m_Dirty.size());
+	m_AnyDirty = false;
+}
+
+
+void TransformHierarchy::Update() {
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	if (!m_AnyDirty)
+		return;
+
+	size_t count = GetCount();
+	size_t node = 0;
+
+	//Local matrices, 4 nodes per iteration whenever one of them is dirty
+	const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+	for (; node + 4 <= count; node += 4) {
+		uint32_t dirty;
+		memcpy(&dirty, &m_Dirty[node], sizeof(dirty));
+		if (!dirty)
+			continue;
+
+		__m128 x = _mm_loadu_ps(&m_RotationX[node]), y = _mm_loadu_ps(&m_RotationY[node]);
+		__m128 z = _mm_loadu_ps(&m_RotationZ[node]), w = _mm_loadu_ps(&m_RotationW[node]);
+		__m128 sx = _mm_loadu_ps(&m_ScaleX[node]), sy = _mm_loadu_ps(&m_ScaleY[node]), sz = _mm_loadu_ps(&m_ScaleZ[node]);
+
+		__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+		__m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+		__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+		//Same terms as glm::mat3_cast, every column scaled by its axis scale
+		__m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+		__m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+		__m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+		__m128 c0w = _mm_setzero_ps();
+
+		__m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+		__m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+		__m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+		__m128 c1w = _mm_setzero_ps();
+
+		__m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+		__m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+		__m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+		__m128 c2w = _mm_setzero_ps();
+
+		__m128 c3x = _mm_loadu_ps(&m_PositionX[node]), c3y = _mm_loadu_ps(&m_PositionY[node]), c3z = _mm_loadu_ps(&m_PositionZ[node]);
+		__m128 c3w = one;
+
+		//Transposing turns "component k of 4 nodes" into "column of node k"
+		_MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+		_MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+		_MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+		_MM_TRANSPOSE4_PS(c3x, c3y, c3z, c3w);
+
+		const __m128 columns[4][4] = {
+			{ c0x, c1x, c2x, c3x },
+			{ c0y, c1y, c2y, c3y },
+			{ c0z, c1z, c2z, c3z },
+			{ c0w, c1w, c2w, c3w }
+		};
+		for (int k = 0; k < 4; ++k) {
+			float* local = &m_Local[node + k][0][0];
+			for (int column = 0; column < 4; ++column)
+				_mm_storeu_ps(local + column * 4, columns[k][column]);
+		}
+	}
+
+	for (; node < count; ++node) {
+		if (m_Dirty[node])
+			ComputeLocalScalar(node);
+	}
+
+	//World matrices, flags flow down the tree since parents come first
+	for (node = 0; node < count; ++node) {
+		unsigned int parent = m_Parent[node];
+		if (parent != NoParent)
+			m_Dirty[node] |= m_Dirty[parent];
+		if (!m_Dirty[node])
+			continue;
+
+		float* world = &m_World[node][0][0];
+		const float* local = &m_Local[node][0][0];
+		if (parent == NoParent) {
+			memcpy(world, local, sizeof(glm::mat4));
+			continue;
+		}
+
+		//std::vector only guarantees the alignment of glm::mat4 (4 bytes), so go through registers
+		const float* parentWorld = &m_World[parent][0][0];
+		glm_vec4 in1[4], in2[4], out[4];
+		for (int column = 0; column < 4; ++column) {
+			in1[column] = _mm_loadu_ps(parentWorld + column * 4);
+			in2[column] = _mm_loadu_ps(local + column * 4);
+		}
+		glm_mat4_mul(in1, in2, out);
+		for (int column = 0; column < 4; ++column)
+			_mm_storeu_ps(world + column * 4, out[column]);
+	}
+
+	memset(m_Dirty.data(), 0, m_Dirty.size());
+	m_AnyDirty = false;
+#else
+	UpdateScalar();
+#endif
+}
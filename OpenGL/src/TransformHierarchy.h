@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+
+//Scene graph transforms with local translation/rotation/scale stored as structure of arrays
+//Nodes are kept parent before child (a parent has to exist when its child gets added),
+//so Update() computes all world matrices in one forward pass
+class TransformHierarchy {
+public:
+	static const unsigned int NoParent = 0xFFFFFFFF;
+
+	TransformHierarchy();
+
+	unsigned int Add(unsigned int parent = NoParent, const glm::vec3& position = glm::vec3(0.0f),
+		const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), const glm::vec3& scale = glm::vec3(1.0f));
+
+	void Clear();
+	void Reserve(size_t count);
+
+	//Setters mark the node dirty, its subtree gets recomputed on the next Update()
+	void SetPosition(unsigned int node, const glm::vec3& position);
+	void SetRotation(unsigned int node, const glm::quat& rotation);
+	void SetScale(unsigned int node, const glm::vec3& scale);
+
+	glm::vec3 GetPosition(unsigned int node) const;
+	glm::quat GetRotation(unsigned int node) const;
+	glm::vec3 GetScale(unsigned int node) const;
+	inline unsigned int GetParent(unsigned int node) const { return m_Parent[node]; }
+
+	//Recomputes local matrices of dirty nodes 4 at a time with SSE and world matrices of dirty subtrees
+	//with glm's SIMD matrix product (glm/simd/matrix.h)
+	void Update();
+	//Same result with plain glm math, used as benchmark baseline and when SSE2 isn't available
+	void UpdateScalar();
+
+	inline size_t GetCount() const { return m_Parent.size(); }
+	//Contiguous, in node order, can be uploaded as is to an instance buffer
+	inline const glm::mat4* GetWorldMatrices() const { return m_World.data(); }
+	inline const glm::mat4& GetWorldMatrix(unsigned int node) const { return m_World[node]; }
+
+private:
+	void MarkDirty(unsigned int node);
+	void ComputeLocalScalar(size_t node);
+	void PropagateScalar();
+
+private:
+	std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+	std::vector<float> m_RotationX, m_RotationY, m_RotationZ, m_RotationW;
+	std::vector<float> m_ScaleX, m_ScaleY, m_ScaleZ;
+	std::vector<unsigned int> m_Parent;
+	std::vector<uint8_t> m_Dirty;
+	bool m_AnyDirty;
+
+	std::vector<glm::mat4> m_Local;
+	std::vector<glm::mat4> m_World;
+};
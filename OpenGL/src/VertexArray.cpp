@@ -1,6 +1,8 @@
 #include "VertexArray.h"
 #include "VertexBufferLayout.h"
 
+#include <cstdint>
+
 VertexArray::VertexArray() {
 
 	GLCall(glGenVertexArrays(1, &m_RendererID));
@@ -13,21 +15,29 @@ VertexArray::~VertexArray() {
 }
 
 
-void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout) {
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int firstAttribute, unsigned int divisor) {
 
 	Bind();
 	vb.Bind();
 	const auto& elements = layout.GetElements();
-	unsigned int offset = 0;
 
-	for (unsigned int i = 0; i < elements.size(); ++i) {
-		
-		const auto& element = elements[i];
-		GLCall(glEnableVertexAttribArray(i));
-		GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)offset));
+	for (unsigned int i = 0; i < elements.size(); ++i)
+		SetAttribute(firstAttribute + i, elements[i], layout.GetStride(), divisor);
+}
+
+
+void VertexArray::SetAttribute(unsigned int index, const VertexBufferElement& element, unsigned int stride, unsigned int divisor) {
 
-		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+	GLCall(glEnableVertexAttribArray(index));
+
+	if (element.integer) {
+		GLCall(glVertexAttribIPointer(index, element.count, element.type, stride, (const void*)(uintptr_t)element.offset));
+	}
+	else {
+		GLCall(glVertexAttribPointer(index, element.count, element.type, element.normalized, stride, (const void*)(uintptr_t)element.offset));
 	}
+
+	GLCall(glVertexAttribDivisor(index, divisor));
 }
 
 
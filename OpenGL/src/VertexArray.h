@@ -4,6 +4,8 @@
 //#include "VertexBufferLayout.h"		Not included because it includes "Renderer.h" but "Renderer.h" includes this file as well
 //Solution:
 class VertexBufferLayout;
+struct VertexBufferElement;
+template<unsigned int N> struct StaticVertexBufferLayout;
 // + include it in .cpp file
 
 
@@ -14,8 +16,23 @@ public:
 	VertexArray();
 	~VertexArray();
 
-	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	//firstAttribute is the location of the first element, so several buffers can feed one VertexArray
+	//divisor 1 advances the attributes once per instance instead of once per vertex
+	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int firstAttribute = 0, unsigned int divisor = 0);
+
+	//N is known at compile time, so the attribute loop gets unrolled for every vertex struct
+	template<unsigned int N>
+	void AddBuffer(const VertexBuffer& vb, const StaticVertexBufferLayout<N>& layout, unsigned int firstAttribute = 0, unsigned int divisor = 0) {
+		Bind();
+		vb.Bind();
+
+		for (unsigned int i = 0; i < N; ++i)
+			SetAttribute(firstAttribute + i, layout.Elements[i], layout.Stride, divisor);
+	}
 
 	void Bind() const;
 	void Unbind() const;
-};
\ No newline at end of file
+
+private:
+	void SetAttribute(unsigned int index, const VertexBufferElement& element, unsigned int stride, unsigned int divisor);
+};
@@ -3,11 +3,11 @@
 #include "Renderer.h"
 
 
-VertexBuffer::VertexBuffer(const void* data, unsigned int size) {
+VertexBuffer::VertexBuffer(const void* data, unsigned int size, bool dynamic) {
 
     GLCall(glGenBuffers(1, &m_RendererID));
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
 
 }
 
@@ -25,3 +25,9 @@ void VertexBuffer::Bind() const {
 void VertexBuffer::Unbind() const {
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
+
+
+void VertexBuffer::SetData(const void* data, unsigned int size, unsigned int offset) {
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
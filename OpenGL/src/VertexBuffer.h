@@ -5,11 +5,17 @@ class VertexBuffer {
 private:
 	unsigned int m_RendererID;
 public:
-	VertexBuffer(const void* data, unsigned int size);
+	//dynamic buffers are meant to be rewritten with SetData, e.g. per object data that changes every frame
+	VertexBuffer(const void* data, unsigned int size, bool dynamic = false);
 	~VertexBuffer();
 
 	void Bind() const;
 	void Unbind() const;
+
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+	//For binding the same buffer to other targets, e.g. as shader storage buffer
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 };
 
 
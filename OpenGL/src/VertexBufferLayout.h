@@ -2,25 +2,89 @@
 
 #include "Renderer.h"
 #include <vector>
+#include <cstddef>
+#include <type_traits>
+
+#include "glm/glm.hpp"
+#include "VertexPacking.h"
 
 
 struct VertexBufferElement {
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	unsigned int offset;	//Byte offset of the attribute inside one vertex
+	unsigned char integer;	//Read as int/ivec/uvec in the shader (glVertexAttribIPointer) instead of being converted to float
 
-	static unsigned int GetSizeOfType(unsigned int type) {
+	static constexpr unsigned int GetSizeOfType(unsigned int type) {
 		switch (type) {
-		case GL_FLOAT:			return 4;
-		case GL_UNSIGNED_INT:	return 4;
-		case GL_UNSIGNED_BYTE:	return 1;
+		case GL_FLOAT:					return 4;
+		case GL_INT:					return 4;
+		case GL_UNSIGNED_INT:			return 4;
+		case GL_HALF_FLOAT:				return 2;
+		case GL_SHORT:					return 2;
+		case GL_UNSIGNED_SHORT:			return 2;
+		case GL_BYTE:					return 1;
+		case GL_UNSIGNED_BYTE:			return 1;
+		case GL_INT_2_10_10_10_REV:		return 4;	//For all 4 components together, see GetSize()
 		}
 		ASSERT(false);
+		return 0;
+	}
+
+	//Size of the whole attribute in bytes
+	static constexpr unsigned int GetSize(unsigned int type, unsigned int count) {
+		return type == GL_INT_2_10_10_10_REV ? 4 : count * GetSizeOfType(type);
 	}
 
 };
 
 
+//Maps a C++ attribute type to its GL component type and component count
+//Specialize this for every type that may appear as a member of a vertex struct
+template<typename T>
+struct VertexAttribType {
+	//Dependent on T so it only fires when an unsupported type is actually used
+	static_assert(sizeof(T) == 0, "Unsupported vertex attribute type");
+};
+
+#define VERTEX_ATTRIB_TYPE(T, glType, count, normalized) \
+	template<> struct VertexAttribType<T> { static constexpr unsigned int Type = glType; static constexpr unsigned int Count = count; static constexpr unsigned char Normalized = normalized; }
+
+VERTEX_ATTRIB_TYPE(float, GL_FLOAT, 1, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::vec2, GL_FLOAT, 2, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::vec3, GL_FLOAT, 3, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::vec4, GL_FLOAT, 4, GL_FALSE);
+
+VERTEX_ATTRIB_TYPE(int, GL_INT, 1, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::ivec2, GL_INT, 2, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::ivec3, GL_INT, 3, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::ivec4, GL_INT, 4, GL_FALSE);
+
+VERTEX_ATTRIB_TYPE(unsigned int, GL_UNSIGNED_INT, 1, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::uvec2, GL_UNSIGNED_INT, 2, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::uvec3, GL_UNSIGNED_INT, 3, GL_FALSE);
+VERTEX_ATTRIB_TYPE(glm::uvec4, GL_UNSIGNED_INT, 4, GL_FALSE);
+
+VERTEX_ATTRIB_TYPE(Half, GL_HALF_FLOAT, 1, GL_FALSE);
+VERTEX_ATTRIB_TYPE(short, GL_SHORT, 1, GL_TRUE);
+VERTEX_ATTRIB_TYPE(unsigned short, GL_UNSIGNED_SHORT, 1, GL_TRUE);
+VERTEX_ATTRIB_TYPE(signed char, GL_BYTE, 1, GL_TRUE);
+VERTEX_ATTRIB_TYPE(unsigned char, GL_UNSIGNED_BYTE, 1, GL_TRUE);
+VERTEX_ATTRIB_TYPE(PackedNormal, GL_INT_2_10_10_10_REV, 4, GL_TRUE);
+
+#undef VERTEX_ATTRIB_TYPE
+
+//Arrays like "unsigned char Color[4]" become one attribute with N components
+template<typename T, std::size_t N>
+struct VertexAttribType<T[N]> {
+	static constexpr unsigned int Type = VertexAttribType<T>::Type;
+	static constexpr unsigned int Count = VertexAttribType<T>::Count * N;
+	static constexpr unsigned char Normalized = VertexAttribType<T>::Normalized;
+};
+
+
+//Runtime layout, built up with Push<T>() when the vertex format is only known at runtime
 class VertexBufferLayout {
 private:
 	std::vector<VertexBufferElement> m_Elements;
@@ -29,33 +93,67 @@ public:
 	VertexBufferLayout()
 		:m_Stride(0) {}
 
+	//For layouts that were stored somewhere else, e.g. in a MeshFile
+	VertexBufferLayout(const VertexBufferElement* elements, unsigned int count, unsigned int stride)
+		:m_Elements(elements, elements + count), m_Stride(stride) {}
+
 	template<typename T>
 	void Push(unsigned int count) {
-		static_assert(false);
-	}
-
+		using Attrib = VertexAttribType<T>;
 
-	template<>
-	void Push<float>(unsigned int count) {
-		m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+		m_Elements.push_back({ Attrib::Type, count * Attrib::Count, Attrib::Normalized, m_Stride, GL_FALSE });
+		m_Stride += VertexBufferElement::GetSize(Attrib::Type, count * Attrib::Count);
 	}
 
+	//Same as Push but the shader reads the attribute as integers, only valid for integer types
+	template<typename T>
+	void PushInteger(unsigned int count) {
+		using Attrib = VertexAttribType<T>;
+		static_assert(Attrib::Type != GL_FLOAT && Attrib::Type != GL_HALF_FLOAT && Attrib::Type != GL_INT_2_10_10_10_REV, "Integer attributes need an integer type");
 
-	template<>
-	void Push<unsigned int>(unsigned int count) {
-		m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
-	}
-
-	template<>
-	void Push<unsigned char>(unsigned int count) {
-		m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+		m_Elements.push_back({ Attrib::Type, count * Attrib::Count, GL_FALSE, m_Stride, GL_TRUE });
+		m_Stride += VertexBufferElement::GetSize(Attrib::Type, count * Attrib::Count);
 	}
 
 
 	inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
 	inline unsigned int GetStride() const { return m_Stride; }
 
-};
\ No newline at end of file
+};
+
+
+//Compile time layout with a fixed amount of elements, generated from a vertex struct with MakeVertexLayout
+template<unsigned int N>
+struct StaticVertexBufferLayout {
+	VertexBufferElement Elements[N];
+	unsigned int Stride;
+
+	static constexpr unsigned int Count = N;
+
+	constexpr const VertexBufferElement& operator[](unsigned int i) const { return Elements[i]; }
+};
+
+
+template<typename T>
+constexpr VertexBufferElement MakeVertexAttrib(std::size_t offset, unsigned char normalized, unsigned char integer = GL_FALSE) {
+	return { VertexAttribType<T>::Type, VertexAttribType<T>::Count, normalized, (unsigned int)offset, integer };
+}
+
+
+template<typename Vertex, typename... Elements>
+constexpr StaticVertexBufferLayout<sizeof...(Elements)> MakeVertexLayout(Elements... elements) {
+	static_assert(std::is_standard_layout<Vertex>::value, "Vertex structs have to be standard layout for offsetof");
+	return { { elements... }, (unsigned int)sizeof(Vertex) };
+}
+
+
+//Describes one member of a vertex struct, usage:
+//	constexpr auto layout = MakeVertexLayout<Vertex>(VERTEX_ATTRIB(Vertex, Position), VERTEX_ATTRIB(Vertex, TexCoord));
+#define VERTEX_ATTRIB(Vertex, Member) \
+	MakeVertexAttrib<std::remove_cv_t<decltype(Vertex::Member)>>(offsetof(Vertex, Member), VertexAttribType<std::remove_cv_t<decltype(Vertex::Member)>>::Normalized)
+
+#define VERTEX_ATTRIB_NORMALIZED(Vertex, Member, normalized) \
+	MakeVertexAttrib<std::remove_cv_t<decltype(Vertex::Member)>>(offsetof(Vertex, Member), normalized)
+
+#define VERTEX_ATTRIB_INTEGER(Vertex, Member) \
+	MakeVertexAttrib<std::remove_cv_t<decltype(Vertex::Member)>>(offsetof(Vertex, Member), GL_FALSE, GL_TRUE)
@@ -0,0 +1,299 @@
+#include "VertexPacking.h"
+
+#include "CpuFeatures.h"
+
+#include <cmath>
+#include <cstring>
+
+
+uint16_t FloatToHalf(float value) {
+
+	uint32_t f;
+	memcpy(&f, &value, sizeof(f));
+
+	uint32_t sign = (f >> 16) & 0x8000;
+	uint32_t abs = f & 0x7FFFFFFF;
+
+	//NaN keeps a quiet bit, everything too large becomes inf
+	if (abs > 0x7F800000)
+		return (uint16_t)(sign | 0x7E00);
+	if (abs >= 0x47800000)
+		return (uint16_t)(sign | 0x7C00);
+
+	//Subnormal half: let the FPU do the rounding by adding a magic number
+	if (abs < 0x38800000) {
+		const uint32_t magicBits = (127 - 15 + 23 - 10 + 1) << 23;
+		float magic, absf;
+		memcpy(&magic, &magicBits, sizeof(magic));
+		memcpy(&absf, &abs, sizeof(absf));
+		absf += magic;
+		uint32_t bits;
+		memcpy(&bits, &absf, sizeof(bits));
+		return (uint16_t)(sign | (bits - magicBits));
+	}
+
+	//Normal half: rebias exponent and round mantissa to nearest even
+	uint32_t mantissaOdd = (abs >> 13) & 1;
+	abs += ((uint32_t)(15 - 127) << 23) + 0xFFF + mantissaOdd;
+	return (uint16_t)(sign | (abs >> 13));
+}
+
+
+float HalfToFloat(uint16_t bits) {
+
+	uint32_t sign = (uint32_t)(bits & 0x8000) << 16;
+	uint32_t exponent = (bits >> 10) & 0x1F;
+	uint32_t mantissa = bits & 0x3FF;
+	uint32_t f;
+
+	if (exponent == 0x1F)
+		f = sign | 0x7F800000 | (mantissa << 13);
+	else if (exponent != 0)
+		f = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	else {
+		float value = std::ldexp((float)mantissa, -24);
+		memcpy(&f, &value, sizeof(f));
+		f |= sign;
+	}
+
+	float result;
+	memcpy(&result, &f, sizeof(result));
+	return result;
+}
+
+
+PackedNormal PackNormal(const glm::vec3& normal) {
+
+	glm::vec3 n = glm::clamp(normal, -1.0f, 1.0f) * 511.0f;
+
+	uint32_t x = (uint32_t)(int32_t)std::lrint(n.x) & 0x3FF;
+	uint32_t y = (uint32_t)(int32_t)std::lrint(n.y) & 0x3FF;
+	uint32_t z = (uint32_t)(int32_t)std::lrint(n.z) & 0x3FF;
+
+	return { x | (y << 10) | (z << 20) };
+}
+
+
+void PackHalfScalar(const float* src, Half* dst, size_t count) {
+	for (size_t i = 0; i < count; ++i)
+		dst[i].Bits = FloatToHalf(src[i]);
+}
+
+
+void PackSNorm16Scalar(const float* src, int16_t* dst, size_t count) {
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = (int16_t)std::lrint(glm::clamp(src[i], -1.0f, 1.0f) * 32767.0f);
+}
+
+
+void PackUNorm16Scalar(const float* src, uint16_t* dst, size_t count) {
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = (uint16_t)std::lrint(glm::clamp(src[i], 0.0f, 1.0f) * 65535.0f);
+}
+
+
+void PackNormalsScalar(const glm::vec3* src, PackedNormal* dst, size_t count) {
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = PackNormal(src[i]);
+}
+
+
+static unsigned int FindMaxIndexScalar(const unsigned int* indices, size_t count, unsigned int restartIndex) {
+	unsigned int maxIndex = 0;
+	for (size_t i = 0; i < count; ++i)
+		if (indices[i] != restartIndex && indices[i] > maxIndex)
+			maxIndex = indices[i];
+	return maxIndex;
+}
+
+
+static void NarrowIndicesScalar(const unsigned int* src, uint16_t* dst, size_t count) {
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = (uint16_t)src[i];
+}
+
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+//Same algorithm as FloatToHalf for 4 values at once, results are sign extended 32 bit integers
+static __m128i FloatToHalfSSE2(__m128 f) {
+
+	const __m128i magicBits = _mm_set1_epi32((127 - 15 + 23 - 10 + 1) << 23);
+
+	__m128 justSign = _mm_and_ps(f, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000)));
+	__m128 absf = _mm_xor_ps(f, justSign);
+	__m128i abs = _mm_castps_si128(absf);
+
+	__m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absf, absf));
+	__m128i isRegular = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), abs);
+	__m128i isSubnormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), abs);
+	__m128i special = _mm_or_si128(_mm_and_si128(isNaN, _mm_set1_epi32(0x0200)), _mm_set1_epi32(0x7C00));
+
+	__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(magicBits))), magicBits);
+
+	__m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(abs, 31 - 13), 31);
+	__m128i normal = _mm_add_epi32(abs, _mm_set1_epi32((int)(((uint32_t)(15 - 127) << 23) + 0xFFF)));
+	normal = _mm_srli_epi32(_mm_sub_epi32(normal, mantissaOdd), 13);
+
+	__m128i result = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+	result = _mm_or_si128(_mm_and_si128(isRegular, result), _mm_andnot_si128(isRegular, special));
+
+	return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(justSign), 16));
+}
+
+
+//The build doesn't assume F16C, it is compiled for this function only and picked when the CPU has it
+CPU_TARGET("avx,f16c")
+static size_t PackHalfF16C(const float* src, Half* dst, size_t count) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i*)(dst + i), packed);
+	}
+	return i;
+}
+
+
+void PackHalf(const float* src, Half* dst, size_t count) {
+
+	size_t i = 0;
+
+	if (CpuFeatures::HasF16C()) {
+		i = PackHalfF16C(src, dst, count);
+	}
+	else {
+		for (; i + 8 <= count; i += 8) {
+			__m128i lo = FloatToHalfSSE2(_mm_loadu_ps(src + i));
+			__m128i hi = FloatToHalfSSE2(_mm_loadu_ps(src + i + 4));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(lo, hi));
+		}
+	}
+
+	PackHalfScalar(src + i, dst + i, count - i);
+}
+
+
+void PackSNorm16(const float* src, int16_t* dst, size_t count) {
+
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(32767.0f);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), minusOne), one), scale);
+		__m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minusOne), one), scale);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+	}
+
+	PackSNorm16Scalar(src + i, dst + i, count - i);
+}
+
+
+void PackUNorm16(const float* src, uint16_t* dst, size_t count) {
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(65535.0f);
+	//SSE2 only has a signed saturating pack, so shift into signed range and flip the top bit back afterwards
+	const __m128i bias = _mm_set1_epi32(32768);
+	const __m128i flip = _mm_set1_epi16((short)0x8000);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), one), scale);
+		__m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), zero), one), scale);
+		__m128i ia = _mm_sub_epi32(_mm_cvtps_epi32(a), bias);
+		__m128i ib = _mm_sub_epi32(_mm_cvtps_epi32(b), bias);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(_mm_packs_epi32(ia, ib), flip));
+	}
+
+	PackUNorm16Scalar(src + i, dst + i, count - i);
+}
+
+
+void PackNormals(const glm::vec3* src, PackedNormal* dst, size_t count) {
+
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(511.0f);
+	const __m128i mask = _mm_set1_epi32(0x3FF);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		//4 vec3s = 12 floats: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+		const float* f = &src[i].x;
+		__m128 a = _mm_loadu_ps(f);
+		__m128 b = _mm_loadu_ps(f + 4);
+		__m128 c = _mm_loadu_ps(f + 8);
+
+		//Deinterleave into x0 x1 x2 x3, y0 y1 y2 y3, z0 z1 z2 z3
+		__m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+
+		__m128i ix = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(x, minusOne), one), scale));
+		__m128i iy = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(y, minusOne), one), scale));
+		__m128i iz = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(z, minusOne), one), scale));
+
+		__m128i packed = _mm_or_si128(_mm_and_si128(ix, mask),
+			_mm_or_si128(_mm_slli_epi32(_mm_and_si128(iy, mask), 10), _mm_slli_epi32(_mm_and_si128(iz, mask), 20)));
+		_mm_storeu_si128((__m128i*)(dst + i), packed);
+	}
+
+	PackNormalsScalar(src + i, dst + i, count - i);
+}
+
+
+unsigned int FindMaxIndex(const unsigned int* indices, size_t count, unsigned int restartIndex) {
+
+	//SSE2 only compares signed integers, flipping the top bit maps the unsigned order onto the signed one
+	const __m128i flip = _mm_set1_epi32((int)0x80000000);
+	const __m128i restart = _mm_set1_epi32((int)restartIndex);
+	__m128i maxFlipped = flip;
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(indices + i));
+		v = _mm_andnot_si128(_mm_cmpeq_epi32(v, restart), v);
+		v = _mm_xor_si128(v, flip);
+		__m128i greater = _mm_cmpgt_epi32(v, maxFlipped);
+		maxFlipped = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, maxFlipped));
+	}
+
+	unsigned int lanes[4];
+	_mm_storeu_si128((__m128i*)lanes, _mm_xor_si128(maxFlipped, flip));
+
+	unsigned int maxIndex = FindMaxIndexScalar(indices + i, count - i, restartIndex);
+	for (unsigned int lane : lanes)
+		if (lane > maxIndex)
+			maxIndex = lane;
+	return maxIndex;
+}
+
+
+void NarrowIndices(const unsigned int* src, uint16_t* dst, size_t count) {
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		//Sign extend the low 16 bits so the saturating pack keeps them unchanged
+		__m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+		a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+		b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+	}
+
+	NarrowIndicesScalar(src + i, dst + i, count - i);
+}
+
+#else
+
+void PackHalf(const float* src, Half* dst, size_t count) { PackHalfScalar(src, dst, count); }
+void PackSNorm16(const float* src, int16_t* dst, size_t count) { PackSNorm16Scalar(src, dst, count); }
+void PackUNorm16(const float* src, uint16_t* dst, size_t count) { PackUNorm16Scalar(src, dst, count); }
+void PackNormals(const glm::vec3* src, PackedNormal* dst, size_t count) { PackNormalsScalar(src, dst, count); }
+unsigned int FindMaxIndex(const unsigned int* indices, size_t count, unsigned int restartIndex) { return FindMaxIndexScalar(indices, count, restartIndex); }
+void NarrowIndices(const unsigned int* src, uint16_t* dst, size_t count) { NarrowIndicesScalar(src, dst, count); }
+
+#endif
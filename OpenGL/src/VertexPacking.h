@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+
+//IEEE 754 half precision float, uploaded as GL_HALF_FLOAT
+struct Half {
+	uint16_t Bits;
+};
+
+//Signed normalized xyz in 10 bits each + 2 bit w, uploaded as GL_INT_2_10_10_10_REV
+struct PackedNormal {
+	uint32_t Bits;
+};
+
+
+//Single value conversions (round to nearest even, handles denormals, inf and NaN)
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t bits);
+PackedNormal PackNormal(const glm::vec3& normal);
+
+
+//Bulk conversions of float streams, using SSE2 when glm detected it (see GLM_ARCH) and F16C when the CPU has it
+//Values outside of [-1, 1] (SNorm) or [0, 1] (UNorm) are clamped
+void PackHalf(const float* src, Half* dst, size_t count);
+void PackSNorm16(const float* src, int16_t* dst, size_t count);
+void PackUNorm16(const float* src, uint16_t* dst, size_t count);
+void PackNormals(const glm::vec3* src, PackedNormal* dst, size_t count);
+
+//Plain scalar versions, used for the remainder of the SIMD loops and as benchmark baseline
+void PackHalfScalar(const float* src, Half* dst, size_t count);
+void PackSNorm16Scalar(const float* src, int16_t* dst, size_t count);
+void PackUNorm16Scalar(const float* src, uint16_t* dst, size_t count);
+void PackNormalsScalar(const glm::vec3* src, PackedNormal* dst, size_t count);
+
+
+//Index buffers
+//Largest index in the stream, indices equal to restartIndex are skipped (pass 0 if primitive restart isn't used)
+unsigned int FindMaxIndex(const unsigned int* indices, size_t count, unsigned int restartIndex = 0);
+//Keeps the low 16 bits of every index, so 0xFFFFFFFF restart indices become 0xFFFF
+void NarrowIndices(const unsigned int* src, uint16_t* dst, size_t count);
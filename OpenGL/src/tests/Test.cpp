@@ -1,4 +1,6 @@
 #include "Test.h"
+#include "AssetManager.h"
+#include "FramePacer.h"
 #include "imgui/imgui.h"
 
 
@@ -18,6 +20,20 @@ namespace test {
 	}
 
 
+	bool TestMenu::StartTest(const std::string& name)
+	{
+		for (auto& test : m_Tests)
+		{
+			if (test.first == name)
+			{
+				m_CurrentTest = test.second();
+				return true;
+			}
+		}
+		return false;
+	}
+
+
 	void TestMenu::OnImGuiRender()
 	{
 		for (auto& test : m_Tests)
@@ -27,6 +43,14 @@ namespace test {
 				m_CurrentTest = test.second();
 			}
 		}
+
+		ImGui::Text("Cached assets: %d shaders, %d textures", (int)AssetManager::Get().GetShaderCount(), (int)AssetManager::Get().GetTextureCount());
+
+		FramePacer& pacer = FramePacer::Get();
+		bool idle = pacer.IsIdleMode();
+		if (ImGui::Checkbox("Idle Mode", &idle))
+			pacer.SetIdleMode(idle);
+		ImGui::Text("%u frames rendered, %.1f s idle", pacer.GetFramesRendered(), pacer.GetIdleTime());
 	}
 
 }
@@ -22,6 +22,10 @@ namespace test {
 		virtual void OnUpdate(float deltatime) {}
 		virtual void OnRender() {}
 		virtual void OnImGuiRender() {}
+		//Framebuffer size in pixels, called once when the test starts and whenever the window is resized
+		virtual void OnResize(int width, int height) {}
+		//In idle mode frames are only rendered after input while this is false, see FramePacer
+		virtual bool IsAnimating() const { return true; }
 	};
 
 
@@ -31,6 +35,10 @@ namespace test {
 		~TestMenu();
 
 		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+
+		//Starts a registered test by name, returns false if there is none
+		bool StartTest(const std::string& name);
 
 		template<typename T>
 		void RegisterTest(const std::string& name)
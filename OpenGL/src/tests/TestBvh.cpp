@@ -0,0 +1,178 @@
+#include "TestBvh.h"
+
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <random>
+
+
+namespace test {
+
+	TestBvh::TestBvh()
+		: m_SceneType(0), m_ObjectCount(300000), m_MovingPercent(10), m_QueryCount(10000), m_HasPicked(false),
+		  m_Camera(60.0f, 960.0f / 540.0f, 0.1f, 400.0f)
+	{
+		GenerateScene();
+	}
+
+
+	TestBvh::~TestBvh()
+	{
+
+	}
+
+
+	void TestBvh::GenerateScene()
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> size(0.5f, 5.0f);
+		std::normal_distribution<float> spread(0.0f, 20.0f);
+
+		//Clustered scenes put objects around a few hundred centers, like buildings in towns
+		std::vector<glm::vec3> clusters(256);
+		for (glm::vec3& cluster : clusters)
+			cluster = { position(rng), position(rng), position(rng) };
+
+		m_Bounds.resize(m_ObjectCount);
+		for (int i = 0; i < m_ObjectCount; ++i) {
+			glm::vec3 center;
+			if (m_SceneType == 0)
+				center = { position(rng), position(rng), position(rng) };
+			else
+				center = clusters[i % clusters.size()] + glm::vec3(spread(rng), spread(rng), spread(rng));
+
+			glm::vec3 extent(size(rng), size(rng), size(rng));
+			m_Bounds[i] = { center - extent, center + extent };
+		}
+
+		m_Bvh.Build(m_Bounds.data(), m_Bounds.size());
+	}
+
+
+	void TestBvh::RunBenchmark()
+	{
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		m_Results.clear();
+
+		//The refit moves objects, it works on a copy so every run starts from the generated scene
+		std::vector<AABB> bounds = m_Bounds;
+
+		{ Timer timer(measure); m_Bvh.Build(m_Bounds.data(), m_Bounds.size(), false); }
+		m_Results.push_back({ "Build", m_Bvh.GetNodeCount(), ms });
+
+		{ Timer timer(measure); m_Bvh.Build(m_Bounds.data(), m_Bounds.size(), true); }
+		m_Results.push_back({ "Build (threads)", m_Bvh.GetNodeCount(), ms });
+
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+		size_t step = 100 / std::max(m_MovingPercent, 1);
+		size_t moved = 0;
+		for (size_t i = 0; i < bounds.size(); i += step, ++moved) {
+			glm::vec3 delta(offset(rng), offset(rng), offset(rng));
+			bounds[i].Min += delta;
+			bounds[i].Max += delta;
+			m_Bvh.SetObjectBounds((unsigned int)i, bounds[i]);
+		}
+		{ Timer timer(measure); m_Bvh.Refit(); }
+		m_Results.push_back({ "Refit", moved, ms });
+
+		//Frustum query against the flat SIMD culler on the same objects
+		const Frustum& frustum = m_Camera.GetFrustum();
+		std::vector<unsigned int> visible;
+		{ Timer timer(measure); m_Bvh.QueryFrustum(frustum, visible); }
+		m_Results.push_back({ "Frustum", visible.size(), ms });
+
+		BoundingVolumes volumes;
+		volumes.Reserve(bounds.size());
+		for (const AABB& object : bounds)
+			volumes.AddBox(object.Min, object.Max);
+		{ Timer timer(measure); FrustumCuller::Cull(frustum, volumes, visible); }
+		m_Results.push_back({ "Frustum (flat SIMD)", visible.size(), ms });
+
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		size_t hits = 0;
+		{
+			Timer timer(measure);
+			for (int i = 0; i < m_QueryCount; ++i) {
+				Ray ray = { glm::vec3(position(rng), position(rng), position(rng)), glm::normalize(glm::vec3(position(rng), position(rng), position(rng))) };
+				RayHit hit;
+				hits += m_Bvh.Raycast(ray, hit);
+			}
+		}
+		m_Results.push_back({ "Rays", hits, ms });
+
+		size_t found = 0;
+		{
+			Timer timer(measure);
+			for (int i = 0; i < m_QueryCount; ++i) {
+				glm::vec3 center(position(rng), position(rng), position(rng));
+				m_Bvh.QueryRegion({ center - 10.0f, center + 10.0f }, visible);
+				found += visible.size();
+			}
+		}
+		m_Results.push_back({ "Regions", found, ms });
+
+		//Picking uses the generated scene again
+		m_Bvh.Build(m_Bounds.data(), m_Bounds.size());
+	}
+
+
+	void TestBvh::OnUpdate(float deltatime)
+	{
+		ImGuiIO& io = ImGui::GetIO();
+		Ray ray = Ray::FromScreen(glm::vec2(io.MousePos.x, io.MousePos.y), glm::vec2(io.DisplaySize.x, io.DisplaySize.y), m_Camera.GetViewProjection());
+		m_HasPicked = m_Bvh.Raycast(ray, m_Picked);
+	}
+
+
+	void TestBvh::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestBvh::OnImGuiRender()
+	{
+		ImGui::RadioButton("Uniform", &m_SceneType, 0); ImGui::SameLine();
+		ImGui::RadioButton("Clustered", &m_SceneType, 1);
+		ImGui::SliderInt("Objects", &m_ObjectCount, 1024, 2000000);
+		if (ImGui::Button("Generate"))
+			GenerateScene();
+
+		ImGui::SliderInt("Moving %", &m_MovingPercent, 1, 100);
+		ImGui::SliderInt("Queries", &m_QueryCount, 100, 100000);
+
+		if (m_HasPicked)
+			ImGui::Text("Under cursor: object %u at %.1f", m_Picked.Object, m_Picked.Distance);
+		else
+			ImGui::Text("Under cursor: nothing");
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Text("%d objects, %d nodes", (int)m_Bvh.GetObjectCount(), (int)m_Bvh.GetNodeCount());
+		ImGui::Columns(3);
+		ImGui::Text("Pass"); ImGui::NextColumn();
+		ImGui::Text("Count"); ImGui::NextColumn();
+		ImGui::Text("Time"); ImGui::NextColumn();
+
+		for (const Result& result : m_Results) {
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%d", (int)result.Found); ImGui::NextColumn();
+			ImGui::Text("%.3f ms", result.Ms); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+}
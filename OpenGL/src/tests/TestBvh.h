@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Test.h"
+#include "Bvh.h"
+#include "Camera.h"
+
+#include <vector>
+
+
+namespace test {
+
+	//Benchmark for Bvh on synthetic scenes: build, refit after moving objects, frustum/ray/region queries
+	//Also picks the object under the mouse cursor every frame
+	class TestBvh : public Test
+	{
+	public:
+		TestBvh();
+		~TestBvh();
+
+		void OnUpdate(float deltatime) override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void GenerateScene();
+		void RunBenchmark();
+
+	private:
+		struct Result {
+			const char* Name;
+			size_t Found;
+			float Ms;
+		};
+
+		int m_SceneType;
+		int m_ObjectCount;
+		int m_MovingPercent;
+		int m_QueryCount;
+
+		std::vector<AABB> m_Bounds;
+		Bvh m_Bvh;
+		RayHit m_Picked;
+		bool m_HasPicked;
+		PerspectiveCamera m_Camera;
+
+		std::vector<Result> m_Results;
+	};
+
+}
@@ -14,6 +14,7 @@ namespace test {
 		void OnUpdate(float deltatime) override;
 		void OnRender() override;
 		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
 
 	private:
 		float m_ClearColor[4];
@@ -0,0 +1,166 @@
+#include "TestDebugDraw.h"
+
+#include "DebugDraw.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+
+
+namespace test {
+
+	TestDebugDraw::TestDebugDraw()
+		: m_ShapeCount(200), m_StressLines(0), m_BatchedStress(true), m_DepthTest(true), m_Labels(true), m_TrailLifetime(3.0f),
+		  m_Orbit(true), m_Angle(0.0f), m_Camera(60.0f, 960.0f / 540.0f, 0.1f, 500.0f), m_ObservedCamera(40.0f, 16.0f / 9.0f, 1.0f, 25.0f),
+		  m_SubmitMs(0.0f), m_RenderMs(0.0f)
+	{
+		GenerateScene();
+	}
+
+
+	TestDebugDraw::~TestDebugDraw()
+	{
+
+	}
+
+
+	void TestDebugDraw::GenerateScene()
+	{
+		std::mt19937 rng(11);
+		std::uniform_real_distribution<float> position(-40.0f, 40.0f), height(0.0f, 10.0f), size(0.5f, 3.0f), shade(0.3f, 1.0f);
+
+		m_Shapes.clear();
+		for (int i = 0; i < m_ShapeCount; ++i) {
+			Shape shape;
+			shape.Center = glm::vec3(position(rng), height(rng), position(rng));
+			shape.Extent = glm::vec3(size(rng), size(rng), size(rng));
+			shape.Color = glm::vec4(shade(rng), shade(rng), shade(rng), 1.0f);
+			shape.Sphere = i % 3 == 0;
+			m_Shapes.push_back(shape);
+		}
+
+		//Segments of up to 2 units in a 100 unit cube
+		std::uniform_real_distribution<float> cube(-50.0f, 50.0f), offset(-1.0f, 1.0f);
+		m_StressPoints.resize((size_t)m_StressLines * 2);
+		for (size_t i = 0; i < m_StressPoints.size(); i += 2) {
+			m_StressPoints[i] = glm::vec3(cube(rng), cube(rng), cube(rng));
+			m_StressPoints[i + 1] = m_StressPoints[i] + glm::vec3(offset(rng), offset(rng), offset(rng));
+		}
+	}
+
+
+	void TestDebugDraw::OnUpdate(float deltaTime)
+	{
+		if (m_Orbit)
+			m_Angle += 0.003f;
+
+		//Looks at the origin from above, position = rotation * (0, 0, distance)
+		float distance = 90.0f;
+		glm::quat rotation = glm::angleAxis(m_Angle, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::angleAxis(-0.5f, glm::vec3(1.0f, 0.0f, 0.0f));
+		m_Camera.SetRotation(rotation);
+		m_Camera.SetPosition(rotation * glm::vec3(0.0f, 0.0f, distance));
+
+		//The observed camera turns the other way in the middle of the scene
+		m_ObservedCamera.SetRotation(glm::angleAxis(-m_Angle * 3.0f, glm::vec3(0.0f, 1.0f, 0.0f)));
+		m_ObservedCamera.SetPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+	}
+
+
+	void TestDebugDraw::OnRender()
+	{
+		GLCall(glClearColor(0.08f, 0.08f, 0.1f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+		DebugDraw& debug = DebugDraw::Get();
+
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		{
+			Timer timer(measure);
+
+			//Ground grid and the world axes
+			for (int i = -50; i <= 50; i += 5) {
+				glm::vec4 color = i == 0 ? glm::vec4(0.6f, 0.6f, 0.6f, 1.0f) : glm::vec4(0.25f, 0.25f, 0.25f, 1.0f);
+				debug.Line(glm::vec3((float)i, 0.0f, -50.0f), glm::vec3((float)i, 0.0f, 50.0f), color, 0.0f, m_DepthTest);
+				debug.Line(glm::vec3(-50.0f, 0.0f, (float)i), glm::vec3(50.0f, 0.0f, (float)i), color, 0.0f, m_DepthTest);
+			}
+			debug.Axes(glm::mat4(1.0f), 10.0f, 0.0f, m_DepthTest);
+
+			for (size_t i = 0; i < m_Shapes.size(); ++i) {
+				const Shape& shape = m_Shapes[i];
+				if (shape.Sphere)
+					debug.Sphere(shape.Center, shape.Extent.x, shape.Color, 0.0f, m_DepthTest);
+				else
+					debug.Box(shape.Center - shape.Extent, shape.Center + shape.Extent, shape.Color, 0.0f, m_DepthTest);
+				if (m_Labels && i < 20)
+					debug.Text(shape.Center + glm::vec3(0.0f, shape.Extent.y, 0.0f), (shape.Sphere ? "Sphere " : "Box ") + std::to_string(i),
+						shape.Color, 14.0f);
+			}
+
+			//A second camera with its frustum, drawn on top, and a translucent marker on the ground
+			debug.Frustum(m_ObservedCamera.GetInverseViewProjection(), glm::vec4(1.0f, 0.8f, 0.2f, 1.0f), 0.0f, false);
+			debug.Axes(glm::translate(glm::mat4(1.0f), m_ObservedCamera.GetPosition()) * glm::mat4_cast(m_ObservedCamera.GetRotation()), 3.0f, 0.0f, false);
+			debug.Triangle(glm::vec3(-4.0f, 0.01f, -4.0f), glm::vec3(4.0f, 0.01f, -4.0f), glm::vec3(0.0f, 0.01f, 4.0f),
+				glm::vec4(0.2f, 0.6f, 1.0f, 0.4f), 0.0f, m_DepthTest);
+
+			//Persistent trail of the observed camera's view direction, every marker lives m_TrailLifetime seconds
+			if (m_TrailLifetime > 0.0f) {
+				glm::vec3 point = m_ObservedCamera.GetPosition() + m_ObservedCamera.GetRotation() * glm::vec3(0.0f, 0.0f, -20.0f);
+				debug.Cross(point, 1.0f, glm::vec4(1.0f, 0.3f, 0.3f, 1.0f), m_TrailLifetime, m_DepthTest);
+			}
+
+			if (m_BatchedStress) {
+				debug.Lines(m_StressPoints.data(), m_StressPoints.size(), glm::vec4(0.3f, 1.0f, 0.5f, 0.5f), 0.0f, m_DepthTest);
+			}
+			else {
+				for (size_t i = 0; i < m_StressPoints.size(); i += 2)
+					debug.Line(m_StressPoints[i], m_StressPoints[i + 1], glm::vec4(0.3f, 1.0f, 0.5f, 0.5f), 0.0f, m_DepthTest);
+			}
+		}
+		m_SubmitMs = ms;
+
+		{
+			Timer timer(measure);
+			debug.Render(m_Camera.GetViewProjection());
+		}
+		m_RenderMs = ms;
+	}
+
+
+	void TestDebugDraw::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestDebugDraw::OnImGuiRender()
+	{
+		bool regenerate = false;
+		regenerate |= ImGui::SliderInt("Shapes", &m_ShapeCount, 0, 5000);
+		regenerate |= ImGui::SliderInt("Stress lines", &m_StressLines, 0, 2000000);
+		if (regenerate)
+			GenerateScene();
+
+		ImGui::Checkbox("Batched (Lines)", &m_BatchedStress);
+		ImGui::SameLine();
+		ImGui::Checkbox("Depth test", &m_DepthTest);
+		ImGui::SameLine();
+		ImGui::Checkbox("Labels", &m_Labels);
+		ImGui::SliderFloat("Trail lifetime", &m_TrailLifetime, 0.0f, 10.0f, "%.1f s");
+		ImGui::Checkbox("Orbit", &m_Orbit);
+
+		const DebugDraw& debug = DebugDraw::Get();
+		ImGui::Text("%zu lines, %zu triangles, %.1f MB uploaded, %u draw calls", debug.GetLineCount(), debug.GetTriangleCount(),
+			debug.GetUploadSize() / (1024.0f * 1024.0f), debug.GetDrawCalls());
+		ImGui::Text("Submit %.3f ms, upload + draw %.3f ms", m_SubmitMs, m_RenderMs);
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Test.h"
+#include "Camera.h"
+
+#include <vector>
+
+
+namespace test {
+
+	//DebugDraw shapes around an orbiting camera: a grid, boxes, spheres, a second camera's frustum, labels and a trail
+	//of persistent markers, plus up to millions of random line segments to measure what submitting and drawing costs
+	class TestDebugDraw : public Test
+	{
+	public:
+		TestDebugDraw();
+		~TestDebugDraw();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return m_Orbit || m_StressLines > 0; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void GenerateScene();
+
+	private:
+		struct Shape {
+			glm::vec3 Center;
+			glm::vec3 Extent;
+			glm::vec4 Color;
+			bool Sphere;
+		};
+
+		int m_ShapeCount;
+		int m_StressLines;
+		bool m_BatchedStress;
+		bool m_DepthTest;
+		bool m_Labels;
+		float m_TrailLifetime;
+		bool m_Orbit;
+		float m_Angle;
+
+		PerspectiveCamera m_Camera;
+		PerspectiveCamera m_ObservedCamera;
+		std::vector<Shape> m_Shapes;
+		std::vector<glm::vec3> m_StressPoints;
+
+		float m_SubmitMs;
+		float m_RenderMs;
+	};
+
+}
@@ -0,0 +1,218 @@
+#include "TestEcs.h"
+
+#include "VertexBufferLayout.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <random>
+
+
+namespace test {
+
+	struct Position {
+		glm::vec2 Value;
+	};
+
+	struct Velocity {
+		glm::vec2 Value;
+	};
+
+	struct Sprite {
+		float Size;
+	};
+
+	struct SpriteVertex {
+		float Position[2];
+		float TexCoord[2];
+	};
+
+	static constexpr auto s_SpriteVertexLayout = MakeVertexLayout<SpriteVertex>(
+		VERTEX_ATTRIB(SpriteVertex, Position),
+		VERTEX_ATTRIB(SpriteVertex, TexCoord)
+	);
+
+	static const glm::vec2 s_Bounds(960.0f, 540.0f);
+
+
+	//Simulation system, the same for every iteration strategy
+	static inline void Integrate(Position& position, Velocity& velocity)
+	{
+		position.Value += velocity.Value;
+		if (position.Value.x < 0.0f || position.Value.x > s_Bounds.x)
+			velocity.Value.x = -velocity.Value.x;
+		if (position.Value.y < 0.0f || position.Value.y > s_Bounds.y)
+			velocity.Value.y = -velocity.Value.y;
+	}
+
+
+	TestEcs::TestEcs()
+		: m_EntityCount(1000000), m_SpriteEvery(5000), m_Simulate(true), m_SimulateMs(0.0f), m_SpriteCount(0),
+		  m_Camera(s_Bounds.x, s_Bounds.y)
+	{
+		SpriteVertex vertices[] = {
+			{ { -0.5f, -0.5f }, { 0.0f, 0.0f } },
+			{ {  0.5f, -0.5f }, { 1.0f, 0.0f } },
+			{ {  0.5f,  0.5f }, { 1.0f, 1.0f } },
+			{ { -0.5f,  0.5f }, { 0.0f, 1.0f } }
+		};
+		unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(vertices, sizeof(vertices));
+		m_VAO->AddBuffer(*m_VBO, s_SpriteVertexLayout);
+		m_IBO = std::make_unique<IndexBuffer>(indices, 6);
+
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/Basic.shader");
+		m_Shader->Bind();
+		m_Shader->SetUniform1i("u_Texture", 0);
+		m_Texture = AssetManager::Get().Load<Texture>("res/textures/TestImage.png");
+
+		Populate();
+	}
+
+
+	TestEcs::~TestEcs()
+	{
+
+	}
+
+
+	void TestEcs::Populate()
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> x(0.0f, s_Bounds.x), y(0.0f, s_Bounds.y), speed(-2.0f, 2.0f), size(10.0f, 40.0f);
+
+		m_World.Clear();
+		m_SpriteCount = 0;
+		for (int i = 0; i < m_EntityCount; ++i) {
+			Position position = { glm::vec2(x(rng), y(rng)) };
+			Velocity velocity = { glm::vec2(speed(rng), speed(rng)) };
+			if (i % m_SpriteEvery == 0) {
+				m_World.Create(position, velocity, Sprite{ size(rng) });
+				m_SpriteCount++;
+			}
+			else
+				m_World.Create(position, velocity);
+		}
+	}
+
+
+	void TestEcs::RunBenchmark()
+	{
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		m_Results.clear();
+
+		{ Timer timer(measure); m_World.Each<Position, Velocity>(Integrate); }
+		m_Results.push_back({ "Each", ms });
+
+		{
+			Timer timer(measure);
+			m_World.EachChunk<Position, Velocity>([](size_t count, Position* positions, Velocity* velocities) {
+				for (size_t i = 0; i < count; ++i)
+					Integrate(positions[i], velocities[i]);
+			});
+		}
+		m_Results.push_back({ "EachChunk", ms });
+
+		{ Timer timer(measure); m_World.ParallelEach<Position, Velocity>(Integrate); }
+		m_Results.push_back({ "ParallelEach", ms });
+
+		//Baseline: what the test scenes do today, one struct per object with everything in it
+		struct Object {
+			test::Position Position;
+			test::Velocity Velocity;
+			bool HasSprite;
+			test::Sprite Sprite;
+		};
+		std::vector<Object> objects(m_World.GetEntityCount());
+		m_World.Each<Position, Velocity>([&objects, i = (size_t)0](Position& position, Velocity& velocity) mutable {
+			objects[i++] = { position, velocity, false, { 0.0f } };
+		});
+
+		{
+			Timer timer(measure);
+			for (Object& object : objects)
+				Integrate(object.Position, object.Velocity);
+		}
+		m_Results.push_back({ "Array of structs", ms });
+	}
+
+
+	void TestEcs::OnUpdate(float deltatime)
+	{
+		if (!m_Simulate)
+			return;
+
+		auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			m_SimulateMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		Timer timer(measure);
+		m_World.ParallelEach<Position, Velocity>(Integrate);
+	}
+
+
+	void TestEcs::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer renderer;
+		m_Texture->Bind();
+		m_Shader->Bind();
+		const glm::mat4& viewProjection = m_Camera.GetViewProjection();
+
+		//Render system, only archetypes with a Sprite are visited
+		m_World.Each<Position, Sprite>([&](Position& position, Sprite& sprite) {
+			glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(position.Value, 0.0f)), glm::vec3(sprite.Size));
+			m_Shader->SetUniformMat4f("u_MVP", viewProjection * model);
+			renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+		});
+	}
+
+
+	void TestEcs::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestEcs::OnImGuiRender()
+	{
+		ImGui::SliderInt("Entities", &m_EntityCount, 1000, 4000000);
+		ImGui::SliderInt("Sprite every", &m_SpriteEvery, 100, 100000);
+		if (ImGui::Button("Populate"))
+			Populate();
+		ImGui::Checkbox("Simulate", &m_Simulate);
+
+		float entitiesPerSecond = m_SimulateMs > 0.0f ? m_World.GetEntityCount() / m_SimulateMs / 1000.0f : 0.0f;
+		ImGui::Text("%d entities in %d archetypes, %d sprites", (int)m_World.GetEntityCount(), (int)m_World.GetArchetypeCount(), (int)m_SpriteCount);
+		ImGui::Text("Simulation %.3f ms (%.1f M entities/s)", m_SimulateMs, entitiesPerSecond);
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Columns(3);
+		ImGui::Text("Iteration"); ImGui::NextColumn();
+		ImGui::Text("Time"); ImGui::NextColumn();
+		ImGui::Text("M entities/s"); ImGui::NextColumn();
+
+		for (const Result& result : m_Results) {
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%.3f ms", result.Ms); ImGui::NextColumn();
+			ImGui::Text("%.1f", result.Ms > 0.0f ? m_World.GetEntityCount() / result.Ms / 1000.0f : 0.0f); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+}
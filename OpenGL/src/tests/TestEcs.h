@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Test.h"
+#include "AssetManager.h"
+#include "Ecs.h"
+#include "Renderer.h"
+#include "Texture.h"
+#include "Camera.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+#include <vector>
+
+
+namespace test {
+
+	//ECS stress test: a bouncing simulation system over up to millions of entities running on the JobSystem,
+	//a render system drawing the few that have a Sprite, and iteration throughput against a plain array of structs
+	class TestEcs : public Test
+	{
+	public:
+		TestEcs();
+		~TestEcs();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return m_Simulate; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void Populate();
+		void RunBenchmark();
+
+	private:
+		struct Result {
+			const char* Name;
+			float Ms;
+		};
+
+		int m_EntityCount;
+		int m_SpriteEvery;
+		bool m_Simulate;
+
+		World m_World;
+		float m_SimulateMs;
+		size_t m_SpriteCount;
+		std::vector<Result> m_Results;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		AssetRef<Shader> m_Shader;
+		AssetRef<Texture> m_Texture;
+		OrthographicCamera m_Camera;
+	};
+
+}
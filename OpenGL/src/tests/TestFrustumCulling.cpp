@@ -0,0 +1,148 @@
+#include "TestFrustumCulling.h"
+
+#include "JobSystem.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <random>
+
+
+namespace test {
+
+	TestFrustumCulling::TestFrustumCulling()
+		: m_ObjectCount(1000000), m_Iterations(10), m_FieldOfView(60.0f), m_Angle(0.0f), m_Rotate(true),
+		  m_Camera(m_FieldOfView, 960.0f / 540.0f, 0.1f, 400.0f), m_CulledVersion(0)
+	{
+		GenerateObjects();
+	}
+
+
+	TestFrustumCulling::~TestFrustumCulling()
+	{
+
+	}
+
+
+	void TestFrustumCulling::GenerateObjects()
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> size(0.5f, 5.0f);
+
+		m_Volumes.Clear();
+		m_Volumes.Reserve(m_ObjectCount);
+
+		//Half boxes, half spheres, so both paths of the test get exercised
+		for (int i = 0; i < m_ObjectCount; ++i) {
+			glm::vec3 center(position(rng), position(rng), position(rng));
+			if (i & 1)
+				m_Volumes.AddSphere(center, size(rng));
+			else {
+				glm::vec3 extent(size(rng), size(rng), size(rng));
+				m_Volumes.AddBox(center - extent, center + extent);
+			}
+		}
+		m_CulledVersion = 0;
+	}
+
+
+	void TestFrustumCulling::RunBenchmark()
+	{
+		const Frustum& frustum = m_Camera.GetFrustum();
+
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		struct Variant {
+			const char* Name;
+			CullingKernel Kernel;
+			bool Parallel;
+		};
+		const Variant variants[] = {
+			{ "Scalar", CullingKernel::Scalar, false },
+			{ "SSE", CullingKernel::SSE, false },
+			{ "AVX", CullingKernel::AVX, false },
+			{ "Scalar (threads)", CullingKernel::Scalar, true },
+			{ "SSE (threads)", CullingKernel::SSE, true },
+			{ "AVX (threads)", CullingKernel::AVX, true },
+		};
+
+		m_Results.clear();
+		for (const Variant& variant : variants) {
+			if (!FrustumCuller::IsSupported(variant.Kernel))
+				continue;
+
+			{
+				Timer timer(measure);
+				for (int i = 0; i < m_Iterations; ++i) {
+					if (variant.Parallel)
+						FrustumCuller::CullParallel(frustum, m_Volumes, m_Visible, variant.Kernel);
+					else
+						FrustumCuller::Cull(frustum, m_Volumes, m_Visible, variant.Kernel);
+				}
+			}
+			m_Results.push_back({ variant.Name, m_Visible.size(), ms / m_Iterations });
+		}
+	}
+
+
+	void TestFrustumCulling::OnUpdate(float deltatime)
+	{
+		if (m_Rotate)
+			m_Angle += 0.005f;
+
+		m_Camera.SetRotation(glm::angleAxis(-m_Angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+		m_Camera.SetFieldOfView(m_FieldOfView);
+
+		//Nothing to do while the camera stands still
+		if (m_Camera.GetVersion() == m_CulledVersion)
+			return;
+		FrustumCuller::CullParallel(m_Camera.GetFrustum(), m_Volumes, m_Visible);
+		m_CulledVersion = m_Camera.GetVersion();
+	}
+
+
+	void TestFrustumCulling::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestFrustumCulling::OnImGuiRender()
+	{
+		if (ImGui::SliderInt("Objects", &m_ObjectCount, 1024, 4000000))
+			GenerateObjects();
+		ImGui::SliderInt("Iterations", &m_Iterations, 1, 100);
+		ImGui::SliderFloat("FOV", &m_FieldOfView, 10.0f, 120.0f);
+		ImGui::Checkbox("Rotate Camera", &m_Rotate);
+
+		ImGui::Text("%d of %d objects visible, %u threads", (int)m_Visible.size(), m_ObjectCount, JobSystem::Get().GetThreadCount());
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Columns(3);
+		ImGui::Text("Kernel"); ImGui::NextColumn();
+		ImGui::Text("Visible"); ImGui::NextColumn();
+		ImGui::Text("Time"); ImGui::NextColumn();
+
+		for (const Result& result : m_Results) {
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%d", (int)result.Visible); ImGui::NextColumn();
+			ImGui::Text("%.3f ms", result.Ms); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+
+		if (!FrustumCuller::IsSupported(CullingKernel::AVX))
+			ImGui::Text("AVX rows skipped, this CPU has no AVX");
+	}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Test.h"
+#include "Culling.h"
+#include "Camera.h"
+
+#include <vector>
+
+
+namespace test {
+
+	//Benchmark for FrustumCuller: random boxes and spheres around a rotating perspective camera,
+	//every kernel single threaded and on the JobSystem
+	class TestFrustumCulling : public Test
+	{
+	public:
+		TestFrustumCulling();
+		~TestFrustumCulling();
+
+		void OnUpdate(float deltatime) override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return m_Rotate; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void GenerateObjects();
+		void RunBenchmark();
+
+	private:
+		struct Result {
+			const char* Name;
+			size_t Visible;
+			float Ms;
+		};
+
+		int m_ObjectCount;
+		int m_Iterations;
+		float m_FieldOfView;
+		float m_Angle;
+		bool m_Rotate;
+		PerspectiveCamera m_Camera;
+		unsigned int m_CulledVersion;
+
+		BoundingVolumes m_Volumes;
+		std::vector<unsigned int> m_Visible;
+		std::vector<Result> m_Results;
+	};
+
+}
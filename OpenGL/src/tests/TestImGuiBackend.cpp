@@ -0,0 +1,93 @@
+#include "TestImGuiBackend.h"
+
+#include "imgui/imgui.h"
+#include "imgui/imgui_impl_glfw_gl3.h"
+
+
+namespace test {
+
+	TestImGuiBackend::TestImGuiBackend()
+		: m_Streaming(true), m_PreviousStreaming(ImGui_ImplGlfwGL3_GetStreamingRenderer()), m_ShowDemo(true), m_ShowMetrics(false),
+		  m_ShapeCount(5000), m_TotalMs(0.0), m_Frames(-1)
+	{
+		ImGui_ImplGlfwGL3_SetStreamingRenderer(m_Streaming);
+	}
+
+
+	TestImGuiBackend::~TestImGuiBackend()
+	{
+		ImGui_ImplGlfwGL3_SetStreamingRenderer(m_PreviousStreaming);
+	}
+
+
+	void TestImGuiBackend::ResetAverage()
+	{
+		m_TotalMs = 0.0;
+		m_Frames = 0;
+	}
+
+
+	void TestImGuiBackend::OnImGuiRender()
+	{
+		//The time is the one of the previous frame, which still belonged to the test menu when m_Frames is -1
+		if (m_Frames >= 0)
+			m_TotalMs += ImGui_ImplGlfwGL3_GetRenderTime();
+		++m_Frames;
+
+		if (ImGui::RadioButton("Default", !m_Streaming)) {
+			m_Streaming = false;
+			ResetAverage();
+		}
+		ImGui::SameLine();
+		if (ImGui::RadioButton("Streaming ring", m_Streaming)) {
+			m_Streaming = true;
+			ResetAverage();
+		}
+		ImGui_ImplGlfwGL3_SetStreamingRenderer(m_Streaming);
+
+		if (ImGui::SliderInt("Shapes", &m_ShapeCount, 0, 50000))
+			ResetAverage();
+		if (ImGui::Checkbox("Demo Window", &m_ShowDemo))
+			ResetAverage();
+		ImGui::SameLine();
+		if (ImGui::Checkbox("Metrics", &m_ShowMetrics))
+			ResetAverage();
+
+		ImGuiIO& io = ImGui::GetIO();
+		ImGui::Text("%d vertices, %d indices", io.MetricsRenderVertices, io.MetricsRenderIndices);
+		ImGui::Text("RenderDrawData: %.3f ms average over %d frames", m_Frames > 0 ? m_TotalMs / m_Frames : 0.0, m_Frames);
+
+		if (m_ShowDemo)
+			ImGui::ShowDemoWindow(&m_ShowDemo);
+		if (m_ShowMetrics)
+			ImGui::ShowMetricsWindow(&m_ShowMetrics);
+
+		//Rectangles, circles and text at fixed pseudo random spots, every item adds its own vertices
+		//ImDrawIdx is 16 bit, so the shapes are split over overlapping child windows which each get their own draw list
+		//and stay below 64K vertices (a shape is about 21 on average)
+		const int shapesPerChild = 1000;
+		ImGui::SetNextWindowSize(ImVec2(500.0f, 400.0f), ImGuiCond_FirstUseEver);
+		ImGui::Begin("Shapes");
+		ImVec2 origin = ImGui::GetCursorScreenPos();
+		ImVec2 size = ImGui::GetContentRegionAvail();
+		unsigned int seed = 12345;
+		auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / 16777216.0f; };
+		for (int first = 0; first < m_ShapeCount; first += shapesPerChild) {
+			ImGui::SetCursorScreenPos(origin);
+			ImGui::BeginChild((ImGuiID)(first / shapesPerChild + 1), size, false, ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoScrollbar);
+			ImDrawList* drawList = ImGui::GetWindowDrawList();
+			for (int i = first; i < m_ShapeCount && i < first + shapesPerChild; ++i) {
+				ImVec2 position(origin.x + next() * size.x, origin.y + next() * size.y);
+				ImU32 color = IM_COL32((int)(next() * 255), (int)(next() * 255), (int)(next() * 255), 200);
+				switch (i % 3) {
+					case 0: drawList->AddRectFilled(position, ImVec2(position.x + 12.0f, position.y + 8.0f), color); break;
+					case 1: drawList->AddCircle(position, 6.0f, color, 12); break;
+					case 2: drawList->AddText(position, color, "ImGui"); break;
+				}
+			}
+			ImGui::EndChild();
+		}
+		ImGui::End();
+	}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Test.h"
+
+
+namespace test {
+
+	//Heavy UI (the ImGui demo and a window full of shapes) to compare the CPU time of the default and the streaming ImGui renderer
+	class TestImGuiBackend : public Test
+	{
+	public:
+		TestImGuiBackend();
+		~TestImGuiBackend();
+
+		void OnImGuiRender() override;
+
+	private:
+		void ResetAverage();
+
+	private:
+		bool m_Streaming;
+		bool m_PreviousStreaming;
+		bool m_ShowDemo;
+		bool m_ShowMetrics;
+		int m_ShapeCount;
+
+		//Average over the frames since the last change of the settings
+		double m_TotalMs;
+		int m_Frames;
+	};
+
+}
@@ -0,0 +1,99 @@
+#include "TestImageDecoding.h"
+
+#include "ImageDecoder.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+
+namespace test {
+
+	static const char* s_ImagePath = "res/textures/TestImage.png";
+
+
+	TestImageDecoding::TestImageDecoding()
+		: m_FileCount(8), m_DecodedBytes(0)
+	{
+
+	}
+
+
+	TestImageDecoding::~TestImageDecoding()
+	{
+
+	}
+
+
+	void TestImageDecoding::RunBenchmark()
+	{
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		m_Results.clear();
+
+		//The same file m_FileCount times, the mapping stays in the page cache so this measures decoding only
+		std::vector<ImageDecodeRequest> requests(m_FileCount);
+		for (ImageDecodeRequest& request : requests)
+			request.Path = s_ImagePath;
+
+		MappedFile file(s_ImagePath);
+		ImageInfo info;
+		if (!file.IsOpen() || !GetImageInfo(file.GetData(), file.GetSize(), info))
+			return;
+
+		std::vector<unsigned char> pixels((size_t)info.Width * info.Height * 4);
+		m_DecodedBytes = pixels.size() * m_FileCount;
+
+		{
+			Timer timer(measure);
+			for (int i = 0; i < m_FileCount; ++i)
+				DecodeImageStb(file.GetData(), file.GetSize(), pixels.data());
+		}
+		m_Results.push_back({ "stb_image", ms });
+
+		{
+			Timer timer(measure);
+			for (int i = 0; i < m_FileCount; ++i)
+				DecodeImage(file.GetData(), file.GetSize(), pixels.data());
+		}
+		m_Results.push_back({ "Fast path", ms });
+
+		{
+			Timer timer(measure);
+			DecodeImages(requests);
+		}
+		m_Results.push_back({ "Fast path, batch", ms });
+	}
+
+
+	void TestImageDecoding::OnImGuiRender()
+	{
+		ImGui::SliderInt("Files", &m_FileCount, 1, 64);
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+
+		ImGui::Text("Decoding %s into RGBA8, batch uses %u threads", s_ImagePath, JobSystem::Get().GetThreadCount());
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Columns(3);
+		ImGui::Text("Decoder"); ImGui::NextColumn();
+		ImGui::Text("Time"); ImGui::NextColumn();
+		ImGui::Text("Throughput"); ImGui::NextColumn();
+
+		float mb = m_DecodedBytes / (1024.0f * 1024.0f);
+		for (const Result& result : m_Results) {
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%.2f ms", result.Ms); ImGui::NextColumn();
+			ImGui::Text("%.0f MB/s (x%.2f)", mb / (result.Ms / 1000.0f), m_Results[0].Ms / result.Ms); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+}
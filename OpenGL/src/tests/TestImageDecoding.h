@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Test.h"
+
+#include <vector>
+
+
+namespace test {
+
+	//Decode throughput of stb_image vs the PNG fast path, single threaded and as a batch on the JobSystem
+	class TestImageDecoding : public Test
+	{
+	public:
+		TestImageDecoding();
+		~TestImageDecoding();
+
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+
+	private:
+		void RunBenchmark();
+
+	private:
+		struct Result {
+			const char* Name;
+			float Ms;
+		};
+
+		int m_FileCount;
+		size_t m_DecodedBytes;
+		std::vector<Result> m_Results;
+	};
+
+}
@@ -0,0 +1,193 @@
+#include "TestIndirectDraw.h"
+
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <random>
+#include <vector>
+
+
+namespace test {
+
+	static void AppendQuad(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, const glm::vec3& normal, const glm::vec3& u, const glm::vec3& v)
+	{
+		unsigned int base = (unsigned int)vertices.size();
+		vertices.push_back({ normal - u - v, glm::vec2(0.0f, 0.0f), normal });
+		vertices.push_back({ normal + u - v, glm::vec2(1.0f, 0.0f), normal });
+		vertices.push_back({ normal + u + v, glm::vec2(1.0f, 1.0f), normal });
+		vertices.push_back({ normal - u + v, glm::vec2(0.0f, 1.0f), normal });
+		indices.insert(indices.end(), { base, base + 1, base + 2, base + 2, base + 3, base });
+	}
+
+
+	//Surface of revolution: radius(ring) and height(ring) along one axis, segments around it
+	template<typename Profile>
+	static void BuildRevolution(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, unsigned int rings, unsigned int segments, Profile profile)
+	{
+		for (unsigned int ring = 0; ring <= rings; ++ring) {
+			for (unsigned int segment = 0; segment <= segments; ++segment) {
+				float u = (float)segment / segments, v = (float)ring / rings;
+				float angle = u * 6.2831853f;
+				glm::vec3 position, normal;
+				profile(v, angle, position, normal);
+				vertices.push_back({ position, glm::vec2(u, v), normal });
+			}
+		}
+
+		for (unsigned int ring = 0; ring < rings; ++ring) {
+			for (unsigned int segment = 0; segment < segments; ++segment) {
+				unsigned int a = ring * (segments + 1) + segment, b = a + segments + 1;
+				indices.insert(indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+			}
+		}
+	}
+
+
+	TestIndirectDraw::TestIndirectDraw()
+		: m_GridSize(64), m_Culling((int)IndirectCulling::Gpu), m_Rotate(true), m_Angle(0.0f), m_DrawMs(0.0f),
+		  m_Camera(60.0f, 960.0f / 540.0f, 0.1f, 500.0f)
+	{
+		BuildMeshes();
+
+		if (!IndirectRenderer::IsSupported())
+			return;
+
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/Indirect.shader");
+		PlaceObjects();
+	}
+
+
+	TestIndirectDraw::~TestIndirectDraw()
+	{
+
+	}
+
+
+	void TestIndirectDraw::BuildMeshes()
+	{
+		std::vector<MeshVertex> vertices;
+		std::vector<unsigned int> indices;
+
+		//Cube
+		const glm::vec3 axes[3] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+		for (int axis = 0; axis < 3; ++axis) {
+			const glm::vec3& u = axes[(axis + 1) % 3];
+			const glm::vec3& v = axes[(axis + 2) % 3];
+			AppendQuad(vertices, indices, axes[axis], u, v);
+			AppendQuad(vertices, indices, -axes[axis], v, u);
+		}
+		m_Pool.AddMesh(vertices.data(), vertices.size(), indices.data(), indices.size());
+
+		//Sphere
+		vertices.clear();
+		indices.clear();
+		BuildRevolution(vertices, indices, 16, 32, [](float v, float angle, glm::vec3& position, glm::vec3& normal) {
+			float theta = v * 3.14159265f;
+			normal = glm::vec3(glm::sin(theta) * glm::cos(angle), glm::cos(theta), glm::sin(theta) * glm::sin(angle));
+			position = normal;
+		});
+		m_Pool.AddMesh(vertices.data(), vertices.size(), indices.data(), indices.size());
+
+		//Torus
+		vertices.clear();
+		indices.clear();
+		BuildRevolution(vertices, indices, 24, 48, [](float v, float angle, glm::vec3& position, glm::vec3& normal) {
+			float tube = v * 6.2831853f;
+			glm::vec3 ring(glm::cos(angle), 0.0f, glm::sin(angle));
+			normal = ring * glm::cos(tube) + glm::vec3(0.0f, glm::sin(tube), 0.0f);
+			position = ring * 0.75f + normal * 0.25f;
+		});
+		m_Pool.AddMesh(vertices.data(), vertices.size(), indices.data(), indices.size());
+
+		m_Pool.Upload();
+	}
+
+
+	void TestIndirectDraw::PlaceObjects()
+	{
+		std::mt19937 rng(42);
+		std::uniform_int_distribution<unsigned int> mesh(0, (unsigned int)m_Pool.GetMeshCount() - 1);
+		std::uniform_real_distribution<float> height(-20.0f, 20.0f), angle(0.0f, 6.2831853f);
+
+		unsigned int count = (unsigned int)(m_GridSize * m_GridSize);
+		m_Renderer = std::make_unique<IndirectRenderer>(m_Pool, count);
+
+		for (int z = 0; z < m_GridSize; ++z) {
+			for (int x = 0; x < m_GridSize; ++x) {
+				glm::vec3 position((x - m_GridSize / 2) * 4.0f, height(rng), (z - m_GridSize / 2) * 4.0f);
+				glm::mat4 model = glm::rotate(glm::translate(glm::mat4(1.0f), position), angle(rng), glm::vec3(0.0f, 1.0f, 0.0f));
+				if (m_Renderer->AddObject(mesh(rng), model) == IndirectRenderer::InvalidObject)
+					return;
+			}
+		}
+	}
+
+
+	void TestIndirectDraw::OnUpdate(float deltatime)
+	{
+		if (m_Rotate)
+			m_Angle += 0.003f;
+
+		m_Camera.SetPosition(glm::vec3(0.0f, 30.0f, 0.0f));
+		m_Camera.LookAt(glm::vec3(glm::sin(m_Angle) * 50.0f, 0.0f, glm::cos(m_Angle) * 50.0f));
+	}
+
+
+	void TestIndirectDraw::OnRender()
+	{
+		GLCall(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+		if (!m_Renderer)
+			return;
+
+		auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			m_DrawMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		GLCall(glEnable(GL_DEPTH_TEST));
+		{
+			Timer timer(measure);
+			m_Shader->Bind();
+			m_Shader->SetUniformMat4f("u_ViewProjection", m_Camera.GetViewProjection());
+			m_Renderer->Draw(m_Camera.GetFrustum(), *m_Shader, (IndirectCulling)m_Culling);
+		}
+		GLCall(glDisable(GL_DEPTH_TEST));
+	}
+
+
+	void TestIndirectDraw::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestIndirectDraw::OnImGuiRender()
+	{
+		if (!m_Renderer) {
+			ImGui::Text("Indirect drawing needs OpenGL 4.2 or ARB_draw_indirect + ARB_base_instance");
+			return;
+		}
+
+		ImGui::SliderInt("Grid Size", &m_GridSize, 8, 512);
+		if (ImGui::Button("Place Objects"))
+			PlaceObjects();
+
+		if (IndirectRenderer::IsGpuCullingSupported()) {
+			ImGui::RadioButton("GPU Culling", &m_Culling, (int)IndirectCulling::Gpu); ImGui::SameLine();
+		}
+		else
+			m_Culling = (int)IndirectCulling::Cpu;
+		ImGui::RadioButton("CPU Culling", &m_Culling, (int)IndirectCulling::Cpu);
+		ImGui::Checkbox("Rotate Camera", &m_Rotate);
+
+		ImGui::Text("%d objects, %u draw calls", (int)m_Renderer->GetObjectCount(), m_Renderer->GetDrawCalls());
+		if (m_Culling == (int)IndirectCulling::Cpu)
+			ImGui::Text("%d visible", (int)m_Renderer->GetVisibleCount());
+		ImGui::Text("CPU time for cull + submit: %.3f ms", m_DrawMs);
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+
+}
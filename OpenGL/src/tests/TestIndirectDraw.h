@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Test.h"
+#include "AssetManager.h"
+#include "IndirectRenderer.h"
+#include "Camera.h"
+
+#include <memory>
+
+
+namespace test {
+
+	//Thousands of objects from a shared MeshPool, culled on the GPU or the CPU and drawn with one multi draw indirect call
+	class TestIndirectDraw : public Test
+	{
+	public:
+		TestIndirectDraw();
+		~TestIndirectDraw();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return m_Rotate; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void BuildMeshes();
+		void PlaceObjects();
+
+	private:
+		int m_GridSize;
+		int m_Culling;
+		bool m_Rotate;
+		float m_Angle;
+		float m_DrawMs;
+
+		PerspectiveCamera m_Camera;
+		MeshPool m_Pool;
+		std::unique_ptr<IndirectRenderer> m_Renderer;
+		AssetRef<Shader> m_Shader;
+	};
+
+}
@@ -0,0 +1,184 @@
+#include "TestMeshLoading.h"
+
+#include "MeshConverter.h"
+#include "Renderer.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+
+namespace test {
+
+	//Torus with positions, texture coordinates and normals, large enough that parsing time matters
+	static void GenerateTorusObj(const std::string& path, int rings, int sides)
+	{
+		const float pi = 3.14159265f;
+		const float major = 1.0f, minor = 0.4f;
+
+		std::ofstream stream(path);
+		char line[128];
+
+		for (int r = 0; r <= rings; ++r) {
+			float u = r / (float)rings * 2.0f * pi;
+			for (int s = 0; s <= sides; ++s) {
+				float v = s / (float)sides * 2.0f * pi;
+				glm::vec3 normal(cosf(u) * cosf(v), sinf(u) * cosf(v), sinf(v));
+				glm::vec3 position = glm::vec3(cosf(u) * major, sinf(u) * major, 0.0f) + normal * minor;
+
+				snprintf(line, sizeof(line), "v %f %f %f\nvt %f %f\nvn %f %f %f\n", position.x, position.y, position.z,
+					r / (float)rings * 8.0f, s / (float)sides * 2.0f, normal.x, normal.y, normal.z);
+				stream << line;
+			}
+		}
+
+		for (int r = 0; r < rings; ++r) {
+			for (int s = 0; s < sides; ++s) {
+				int a = r * (sides + 1) + s + 1, b = a + sides + 1;
+				snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, b + 1, b + 1, b + 1, a + 1, a + 1, a + 1);
+				stream << line;
+			}
+		}
+	}
+
+
+	TestMeshLoading::TestMeshLoading()
+		: m_ObjPath("res/generated/torus.obj"), m_MeshPath("res/generated/torus.mesh"),
+		  m_ObjLoadMs(0.0f), m_MeshLoadMs(0.0f), m_ConvertMs(0.0f), m_Rotation(0.0f),
+		  m_Camera(45.0f, 960.0f / 540.0f, 0.1f, 100.0f)
+	{
+		m_Camera.SetPosition(glm::vec3(0.0f, -3.5f, 2.0f));
+		m_Camera.LookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+
+		if (!std::filesystem::exists(m_ObjPath)) {
+			std::filesystem::create_directories("res/generated");
+			GenerateTorusObj(m_ObjPath, 1024, 256);
+		}
+
+		if (!std::filesystem::exists(m_MeshPath))
+			Convert();
+
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/Basic.shader");
+		m_Shader->Bind();
+		m_Shader->SetUniform1i("u_Texture", 0);
+		m_Texture = AssetManager::Get().Load<Texture>("res/textures/TestImage.png");
+
+		LoadFromMeshFile();
+	}
+
+
+	TestMeshLoading::~TestMeshLoading()
+	{
+
+	}
+
+
+	void TestMeshLoading::Convert()
+	{
+		auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			m_ConvertMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		Timer timer(measure);
+		ConvertObjToMesh(m_ObjPath, m_MeshPath);
+	}
+
+
+	void TestMeshLoading::LoadFromObj()
+	{
+		auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			m_ObjLoadMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		Timer timer(measure);
+
+		std::vector<MeshVertex> vertices;
+		std::vector<unsigned int> indices;
+		if (!LoadObj(m_ObjPath, vertices, indices))
+			return;
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(MeshVertex)));
+		m_VAO->AddBuffer(*m_VBO, s_MeshVertexLayout);
+		m_IBO = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+	}
+
+
+	void TestMeshLoading::LoadFromMeshFile()
+	{
+		auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			m_MeshLoadMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		Timer timer(measure);
+
+		MeshFile mesh(m_MeshPath);
+		if (!mesh.IsValid())
+			return;
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = mesh.CreateVertexBuffer();
+		m_VAO->AddBuffer(*m_VBO, mesh.GetLayout());
+		m_IBO = mesh.CreateIndexBuffer();
+	}
+
+
+	void TestMeshLoading::OnUpdate(float deltatime)
+	{
+		m_Rotation += 0.01f;
+	}
+
+
+	void TestMeshLoading::OnRender()
+	{
+		GLCall(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+		if (!m_VAO)
+			return;
+
+		glm::mat4 model = glm::rotate(glm::mat4(1.0f), m_Rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+
+		GLCall(glEnable(GL_DEPTH_TEST));
+
+		Renderer renderer;
+		m_Texture->Bind();
+		m_Shader->Bind();
+		m_Shader->SetUniformMat4f("u_MVP", m_Camera.GetViewProjection() * model);
+		renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+
+		GLCall(glDisable(GL_DEPTH_TEST));
+	}
+
+
+	void TestMeshLoading::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestMeshLoading::OnImGuiRender()
+	{
+		if (ImGui::Button("Load OBJ"))
+			LoadFromObj();
+		ImGui::SameLine();
+		if (ImGui::Button("Load Mesh File"))
+			LoadFromMeshFile();
+		ImGui::SameLine();
+		if (ImGui::Button("Convert"))
+			Convert();
+
+		std::error_code error;
+		ImGui::Text("OBJ:  %.1f MB, parse + upload %.2f ms", std::filesystem::file_size(m_ObjPath, error) / (1024.0f * 1024.0f), m_ObjLoadMs);
+		ImGui::Text("Mesh: %.1f MB, map + upload %.2f ms", std::filesystem::file_size(m_MeshPath, error) / (1024.0f * 1024.0f), m_MeshLoadMs);
+		ImGui::Text("Convert: %.2f ms", m_ConvertMs);
+		if (m_IBO)
+			ImGui::Text("%d triangles, %s indices", m_IBO->GetCount() / 3, m_IBO->GetType() == GL_UNSIGNED_SHORT ? "16 bit" : "32 bit");
+	}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Test.h"
+#include "AssetManager.h"
+#include "MeshFile.h"
+#include "Texture.h"
+#include "Camera.h"
+
+#include <memory>
+#include <string>
+
+
+namespace test {
+
+	//Loads a generated high resolution OBJ either by parsing the text or through the memory mapped MeshFile, and compares load times
+	class TestMeshLoading : public Test
+	{
+	public:
+		TestMeshLoading();
+		~TestMeshLoading();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		void OnResize(int width, int height) override;
+
+	private:
+		void LoadFromObj();
+		void LoadFromMeshFile();
+		void Convert();
+
+	private:
+		std::string m_ObjPath;
+		std::string m_MeshPath;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		AssetRef<Shader> m_Shader;
+		AssetRef<Texture> m_Texture;
+
+		float m_ObjLoadMs;
+		float m_MeshLoadMs;
+		float m_ConvertMs;
+		float m_Rotation;
+		PerspectiveCamera m_Camera;
+	};
+
+}
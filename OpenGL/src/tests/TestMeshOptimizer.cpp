@@ -0,0 +1,235 @@
+#include "TestMeshOptimizer.h"
+
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+
+namespace test {
+
+	TestMeshOptimizer::TestMeshOptimizer()
+		: m_MeshType(0), m_GridSize(512), m_RandomTriangles(1 << 20), m_ShuffleTriangles(true),
+		  m_UniqueVertices(0), m_DeduplicateMs(0.0f)
+	{
+
+	}
+
+
+	TestMeshOptimizer::~TestMeshOptimizer()
+	{
+
+	}
+
+
+	//Triangles as positions, rotated so the smallest corner comes first (the winding stays) and sorted, so two index
+	//buffers compare equal when they draw the same triangles, whatever the triangle order and vertex numbering
+	static std::vector<std::array<float, 9>> GetTriangles(const unsigned int* indices, size_t indexCount, const glm::vec3* vertices)
+	{
+		std::vector<std::array<float, 9>> triangles(indexCount / 3);
+		for (size_t t = 0; t < triangles.size(); ++t) {
+			const glm::vec3* corners[3] = { &vertices[indices[t * 3]], &vertices[indices[t * 3 + 1]], &vertices[indices[t * 3 + 2]] };
+			auto less = [](const glm::vec3* a, const glm::vec3* b) {
+				return a->x != b->x ? a->x < b->x : a->y != b->y ? a->y < b->y : a->z < b->z;
+			};
+			int first = less(corners[1], corners[0]) ? 1 : 0;
+			first = less(corners[2], corners[first]) ? 2 : first;
+			for (int c = 0; c < 3; ++c) {
+				const glm::vec3& v = *corners[(first + c) % 3];
+				triangles[t][c * 3] = v.x;
+				triangles[t][c * 3 + 1] = v.y;
+				triangles[t][c * 3 + 2] = v.z;
+			}
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+
+	void TestMeshOptimizer::Check(bool passed, const std::string& what)
+	{
+		if (!passed)
+			m_Checks += "FAILED: " + what + "\n";
+	}
+
+
+	void TestMeshOptimizer::GenerateGrid()
+	{
+		//Unindexed on purpose, every triangle has its own 3 vertices like a naive exporter would write them
+		m_Vertices.clear();
+		m_Vertices.reserve((size_t)m_GridSize * m_GridSize * 6);
+
+		for (int y = 0; y < m_GridSize; ++y) {
+			for (int x = 0; x < m_GridSize; ++x) {
+				glm::vec3 a((float)x, (float)y, 0.0f), b(x + 1.0f, (float)y, 0.0f);
+				glm::vec3 c((float)x, y + 1.0f, 0.0f), d(x + 1.0f, y + 1.0f, 0.0f);
+				m_Vertices.insert(m_Vertices.end(), { a, b, d, a, d, c });
+			}
+		}
+
+		m_Indices.resize(m_Vertices.size());
+		for (size_t i = 0; i < m_Indices.size(); ++i)
+			m_Indices[i] = (unsigned int)i;
+	}
+
+
+	void TestMeshOptimizer::GenerateRandom()
+	{
+		std::mt19937 rng(42);
+		size_t vertexCount = m_RandomTriangles / 2;
+		std::uniform_int_distribution<unsigned int> index(0, (unsigned int)vertexCount - 1);
+		std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+
+		m_Vertices.resize(vertexCount);
+		for (glm::vec3& v : m_Vertices)
+			v = { position(rng), position(rng), position(rng) };
+
+		m_Indices.resize((size_t)m_RandomTriangles * 3);
+		for (unsigned int& i : m_Indices)
+			i = index(rng);
+	}
+
+
+	void TestMeshOptimizer::RunBenchmark()
+	{
+		if (m_MeshType == 0)
+			GenerateGrid();
+		else
+			GenerateRandom();
+
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		m_Checks.clear();
+
+		//Deduplicate
+		{
+			std::vector<unsigned int> remap;
+			std::vector<glm::vec3> unique;
+			std::vector<std::array<float, 9>> before = GetTriangles(m_Indices.data(), m_Indices.size(), m_Vertices.data());
+			{
+				Timer timer(measure);
+				m_UniqueVertices = GenerateVertexRemap(remap, m_Vertices.data(), m_Vertices.size(), sizeof(glm::vec3));
+
+				unique.resize(m_UniqueVertices);
+				RemapVertices(unique.data(), m_Vertices.data(), m_Vertices.size(), sizeof(glm::vec3), remap);
+				RemapIndices(m_Indices.data(), m_Indices.data(), m_Indices.size(), remap);
+			}
+			m_DeduplicateMs = ms;
+
+			//Every old vertex maps to an identical new one and every new vertex is the target of at least one old one
+			std::vector<bool> hit(m_UniqueVertices, false);
+			bool valid = remap.size() == m_Vertices.size();
+			for (size_t i = 0; valid && i < remap.size(); ++i) {
+				valid = remap[i] < m_UniqueVertices && unique[remap[i]] == m_Vertices[i];
+				if (valid)
+					hit[remap[i]] = true;
+			}
+			Check(valid && std::find(hit.begin(), hit.end(), false) == hit.end(), "Deduplicate remap");
+
+			m_Vertices.swap(unique);
+			Check(GetTriangles(m_Indices.data(), m_Indices.size(), m_Vertices.data()) == before, "Deduplicate triangles");
+		}
+
+		if (m_ShuffleTriangles) {
+			std::mt19937 rng(7);
+			size_t triangleCount = m_Indices.size() / 3;
+			for (size_t t = triangleCount - 1; t > 0; --t) {
+				size_t other = std::uniform_int_distribution<size_t>(0, t)(rng);
+				std::swap_ranges(&m_Indices[t * 3], &m_Indices[t * 3] + 3, &m_Indices[other * 3]);
+			}
+		}
+
+		size_t vertexCount = m_Vertices.size();
+		size_t indexCount = m_Indices.size();
+		std::vector<unsigned int> forsyth(indexCount), tipsify(indexCount), overdraw(indexCount);
+		std::vector<std::array<float, 9>> input = GetTriangles(m_Indices.data(), indexCount, m_Vertices.data());
+
+		auto addResult = [&](const char* name, const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& vertices, float ms) {
+			float overfetch = AnalyzeVertexFetch(indices.data(), indexCount, vertices.size(), sizeof(glm::vec3)).Overfetch;
+			m_Results.push_back({ name, AnalyzeVertexCache(indices.data(), indexCount, vertices.size()), overfetch, ms });
+			Check(GetTriangles(indices.data(), indexCount, vertices.data()) == input, std::string(name) + " triangles");
+		};
+
+		m_Results.clear();
+		addResult("Input", m_Indices, m_Vertices, 0.0f);
+
+		{ Timer timer(measure); OptimizeVertexCache(forsyth.data(), m_Indices.data(), indexCount, vertexCount); }
+		addResult("Forsyth", forsyth, m_Vertices, ms);
+
+		{ Timer timer(measure); OptimizeVertexCacheTipsify(tipsify.data(), m_Indices.data(), indexCount, vertexCount); }
+		addResult("Tipsify", tipsify, m_Vertices, ms);
+
+		{ Timer timer(measure); OptimizeOverdraw(overdraw.data(), forsyth.data(), indexCount, &m_Vertices[0].x, vertexCount, sizeof(glm::vec3)); }
+		addResult("Forsyth + Overdraw", overdraw, m_Vertices, ms);
+
+		//Rewrites the indices in place, so it runs on a copy
+		std::vector<unsigned int> fetchIndices = forsyth;
+		std::vector<glm::vec3> fetched(vertexCount);
+		size_t fetchedCount;
+		{ Timer timer(measure); fetchedCount = OptimizeVertexFetch(fetched.data(), fetchIndices.data(), indexCount, m_Vertices.data(), vertexCount, sizeof(glm::vec3)); }
+		fetched.resize(fetchedCount);
+		addResult("Forsyth + Vertex Fetch", fetchIndices, fetched, ms);
+
+		//The reordered vertices are the referenced input vertices, each exactly once
+		std::vector<bool> referenced(vertexCount, false);
+		for (unsigned int index : forsyth)
+			referenced[index] = true;
+		std::vector<std::array<float, 3>> expected, actual;
+		for (size_t v = 0; v < vertexCount; ++v) {
+			if (referenced[v])
+				expected.push_back({ m_Vertices[v].x, m_Vertices[v].y, m_Vertices[v].z });
+		}
+		for (const glm::vec3& v : fetched)
+			actual.push_back({ v.x, v.y, v.z });
+		std::sort(expected.begin(), expected.end());
+		std::sort(actual.begin(), actual.end());
+		Check(actual == expected, "Vertex Fetch permutation");
+	}
+
+
+	void TestMeshOptimizer::OnImGuiRender()
+	{
+		ImGui::RadioButton("Grid", &m_MeshType, 0); ImGui::SameLine();
+		ImGui::RadioButton("Random", &m_MeshType, 1);
+
+		if (m_MeshType == 0)
+			//1024 is already 6M unindexed vertices, 72 MB before deduplication
+			ImGui::SliderInt("Grid Size", &m_GridSize, 16, 1024);
+		else
+			ImGui::SliderInt("Triangles", &m_RandomTriangles, 1024, 1 << 22);
+		ImGui::Checkbox("Shuffle Triangles", &m_ShuffleTriangles);
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Text("%d triangles, %d unique vertices (dedup took %.2f ms)", (int)(m_Indices.size() / 3), (int)m_UniqueVertices, m_DeduplicateMs);
+
+		ImGui::Text("%s", m_Checks.empty() ? "Checks passed: same triangles, remaps only move vertices" : m_Checks.c_str());
+
+		ImGui::Columns(5);
+		ImGui::Text("Pass"); ImGui::NextColumn();
+		ImGui::Text("ACMR"); ImGui::NextColumn();
+		ImGui::Text("ATVR"); ImGui::NextColumn();
+		ImGui::Text("Overfetch"); ImGui::NextColumn();
+		ImGui::Text("Time"); ImGui::NextColumn();
+
+		for (const Result& result : m_Results) {
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.Stats.ACMR); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.Stats.ATVR); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.Overfetch); ImGui::NextColumn();
+			ImGui::Text("%.2f ms", result.Ms); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Test.h"
+#include "MeshOptimizer.h"
+
+#include "glm/glm.hpp"
+
+#include <string>
+#include <vector>
+
+
+namespace test {
+
+	//Benchmark for MeshOptimizer on generated grids and random meshes: ACMR/ATVR and overfetch before and after, and run times
+	//Every run also checks that the passes kept the triangles and that the vertex remaps only moved vertices
+	class TestMeshOptimizer : public Test
+	{
+	public:
+		TestMeshOptimizer();
+		~TestMeshOptimizer();
+
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+
+	private:
+		void GenerateGrid();
+		void GenerateRandom();
+		void RunBenchmark();
+		//Records a failed check in m_Checks
+		void Check(bool passed, const std::string& what);
+
+	private:
+		struct Result {
+			const char* Name;
+			VertexCacheStatistics Stats;
+			float Overfetch;
+			float Ms;
+		};
+
+		int m_MeshType;
+		int m_GridSize;
+		int m_RandomTriangles;
+		bool m_ShuffleTriangles;
+
+		std::vector<glm::vec3> m_Vertices;
+		std::vector<unsigned int> m_Indices;
+
+		size_t m_UniqueVertices;
+		float m_DeduplicateMs;
+		std::vector<Result> m_Results;
+		std::string m_Checks;
+	};
+
+}
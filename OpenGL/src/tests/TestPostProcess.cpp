@@ -0,0 +1,198 @@
+#include "TestPostProcess.h"
+
+#include "imgui/imgui.h"
+
+#include <cstring>
+
+
+namespace test {
+
+	static const char* s_ResolutionNames[] = { "Window", "1080p", "4K" };
+	static const char* s_StageNames[] = { "Scene", "Bloom", "Blur", "Tonemap", "Present" };
+
+
+	TestPostProcess::TestPostProcess()
+		: m_WindowWidth(960), m_WindowHeight(540), m_Resolution(FullHD), m_Animate(true), m_Time(0.0f), m_SweepFrames(0),
+		  m_SweepResolution(FullHD), m_ResolutionBeforeSweep(FullHD)
+	{
+		m_SceneShader = AssetManager::Get().Load<Shader>("res/shader/PostScene.shader");
+		m_PresentShader = AssetManager::Get().Load<Shader>("res/shader/Fullscreen.shader");
+
+		memset(m_StageMs, 0, sizeof(m_StageMs));
+		m_Graph.SetProfiling(true);
+	}
+
+
+	TestPostProcess::~TestPostProcess()
+	{
+
+	}
+
+
+	void TestPostProcess::OnUpdate(float deltaTime)
+	{
+		if (m_Animate)
+			m_Time += 1.0f / 60.0f;
+
+		//The sweep renders SweepLength frames at 1080p, then at 4K, and returns to the previous resolution
+		if (m_SweepFrames > 0 && --m_SweepFrames == 0) {
+			if (m_SweepResolution == FullHD) {
+				m_SweepResolution = UltraHD;
+				m_SweepFrames = SweepLength;
+			}
+			else {
+				m_SweepResolution = m_ResolutionBeforeSweep;
+			}
+			m_Resolution = m_SweepResolution;
+		}
+	}
+
+
+	void TestPostProcess::BuildGraph()
+	{
+		RenderGraph& graph = m_Graph;
+		graph.Reset();
+
+		int width = m_WindowWidth, height = m_WindowHeight;
+		if (m_Resolution == FullHD) {
+			width = 1920;
+			height = 1080;
+		}
+		else if (m_Resolution == UltraHD) {
+			width = 3840;
+			height = 2160;
+		}
+
+		RenderResource backbuffer = graph.ImportTexture("Backbuffer", 0, { m_WindowWidth, m_WindowHeight, GL_RGBA8 });
+
+		RenderResource scene;
+		graph.AddPass("Scene", [&](RenderPassBuilder& builder) {
+			scene = builder.CreateTexture("Scene", { width, height, GL_RGBA16F });
+		}, [this, width, height](RenderPassContext& context) {
+			m_SceneShader->Bind();
+			m_SceneShader->SetUniform1f("u_Time", m_Time);
+			m_SceneShader->SetUniform1f("u_Aspect", (float)width / height);
+			context.DrawFullscreenTriangle();
+		});
+
+		if (m_Resolution == Window) {
+			m_PostProcess.AddPasses(graph, scene, backbuffer);
+		}
+		else {
+			RenderResource tonemapped = m_PostProcess.AddPasses(graph, scene);
+			graph.AddPass("Present", [&](RenderPassBuilder& builder) {
+				builder.Read(tonemapped);
+				builder.Write(backbuffer);
+			}, [this, tonemapped](RenderPassContext& context) {
+				m_PresentShader->Bind();
+				m_PresentShader->SetUniform1i("u_Source", 0);
+				m_PresentShader->SetUniform1f("u_Far", 0.0f);
+				context.BindTexture(tonemapped, 0);
+				context.DrawFullscreenTriangle();
+			});
+		}
+
+		graph.Compile();
+	}
+
+
+	void TestPostProcess::AccumulateTimes()
+	{
+		//Pass times arrive a few frames late, they may belong to the previous resolution right after a switch
+		float stages[StageCount] = {};
+		for (const RenderPassTime& time : m_Graph.GetPassTimes()) {
+			for (int stage = 0; stage < StageCount; ++stage) {
+				if (time.Name.compare(0, strlen(s_StageNames[stage]), s_StageNames[stage]) == 0)
+					stages[stage] += time.Ms;
+			}
+		}
+
+		float* row = m_StageMs[m_Resolution];
+		for (int stage = 0; stage < StageCount; ++stage)
+			row[stage] = row[stage] == 0.0f ? stages[stage] : row[stage] * 0.95f + stages[stage] * 0.05f;
+	}
+
+
+	void TestPostProcess::OnRender()
+	{
+		BuildGraph();
+		m_Graph.Execute();
+		AccumulateTimes();
+	}
+
+
+	void TestPostProcess::OnResize(int width, int height)
+	{
+		m_WindowWidth = width;
+		m_WindowHeight = height;
+	}
+
+
+	void TestPostProcess::OnImGuiRender()
+	{
+		PostProcessSettings& settings = m_PostProcess.GetSettings();
+
+		ImGui::RadioButton("Window", &m_Resolution, Window); ImGui::SameLine();
+		ImGui::RadioButton("1080p", &m_Resolution, FullHD); ImGui::SameLine();
+		ImGui::RadioButton("4K", &m_Resolution, UltraHD); ImGui::SameLine();
+		if (ImGui::Button("Measure 1080p and 4K") && m_SweepFrames == 0) {
+			m_ResolutionBeforeSweep = m_Resolution;
+			m_SweepResolution = m_Resolution = FullHD;
+			m_SweepFrames = SweepLength;
+		}
+		ImGui::Checkbox("Animate", &m_Animate);
+
+		ImGui::Checkbox("Bloom", &settings.Bloom);
+		ImGui::SliderFloat("Threshold", &settings.BloomThreshold, 0.0f, 5.0f);
+		ImGui::SliderFloat("Knee", &settings.BloomKnee, 0.0f, 2.0f);
+		ImGui::SliderFloat("Intensity", &settings.BloomIntensity, 0.0f, 3.0f);
+		ImGui::SliderInt("Levels", &settings.BloomLevels, 1, PostProcess::MaxBloomLevels);
+		ImGui::SliderFloat("Radius", &settings.BloomRadius, 0.5f, 3.0f);
+
+		ImGui::Checkbox("Blur", &settings.Blur);
+		ImGui::SliderFloat("Sigma", &settings.BlurSigma, 0.5f, PostProcess::MaxBlurRadius / 3.0f);
+		ImGui::RadioButton("Full", &settings.BlurDownscale, 1); ImGui::SameLine();
+		ImGui::RadioButton("Half", &settings.BlurDownscale, 2); ImGui::SameLine();
+		ImGui::RadioButton("Quarter", &settings.BlurDownscale, 4);
+		ImGui::SliderFloat("Amount", &settings.BlurAmount, 0.0f, 1.0f);
+		if (settings.Blur)
+			ImGui::Text("%d fetches per pixel and direction instead of %d", m_PostProcess.GetBlurFetches(), m_PostProcess.GetBlurNaiveFetches());
+
+		ImGui::SliderFloat("Exposure", &settings.Exposure, 0.1f, 4.0f);
+		ImGui::RadioButton("Reinhard", &settings.Tonemapper, 0); ImGui::SameLine();
+		ImGui::RadioButton("ACES", &settings.Tonemapper, 1);
+
+		ImGui::Separator();
+		ImGui::Text("GPU ms per stage (%dx%d window)", m_WindowWidth, m_WindowHeight);
+		ImGui::Columns(ResolutionCount + 1);
+		ImGui::Text("Stage"); ImGui::NextColumn();
+		for (int resolution = 0; resolution < ResolutionCount; ++resolution) {
+			ImGui::Text("%s", s_ResolutionNames[resolution]); ImGui::NextColumn();
+		}
+		for (int stage = 0; stage <= StageCount; ++stage) {
+			ImGui::Text("%s", stage < StageCount ? s_StageNames[stage] : "Total"); ImGui::NextColumn();
+			for (int resolution = 0; resolution < ResolutionCount; ++resolution) {
+				float ms = 0.0f;
+				for (int i = 0; i < StageCount; ++i) {
+					if (i == stage || stage == StageCount)
+						ms += m_StageMs[resolution][i];
+				}
+				ImGui::Text("%.3f", ms); ImGui::NextColumn();
+			}
+		}
+		ImGui::Columns(1);
+
+		if (ImGui::CollapsingHeader("Passes")) {
+			ImGui::Columns(2);
+			for (const RenderPassTime& time : m_Graph.GetPassTimes()) {
+				ImGui::Text("%s", time.Name.c_str()); ImGui::NextColumn();
+				ImGui::Text("%.3f ms", time.Ms); ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+		}
+		ImGui::Text("Transient %.1f MB in %.1f MB of textures", m_Graph.GetTransientMemory() / (1024.0f * 1024.0f),
+			m_Graph.GetAliasedMemory() / (1024.0f * 1024.0f));
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+
+}
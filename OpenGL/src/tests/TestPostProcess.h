@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Test.h"
+#include "AssetManager.h"
+#include "PostProcess.h"
+#include "RenderGraph.h"
+
+
+namespace test {
+
+	//PostProcess on an animated HDR test image rendered at the window size, 1080p or 4K, with the GPU time of every
+	//stage. Offscreen resolutions are tonemapped into their own target and scaled into the window by a present pass.
+	class TestPostProcess : public Test
+	{
+	public:
+		TestPostProcess();
+		~TestPostProcess();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return m_Animate || m_SweepFrames > 0; }
+		void OnResize(int width, int height) override;
+
+	private:
+		enum Resolution {
+			Window, FullHD, UltraHD, ResolutionCount
+		};
+
+		enum Stage {
+			SceneStage, BloomStage, BlurStage, TonemapStage, PresentStage, StageCount
+		};
+
+		void BuildGraph();
+		void AccumulateTimes();
+
+	private:
+		int m_WindowWidth, m_WindowHeight;
+		int m_Resolution;
+		bool m_Animate;
+		float m_Time;
+		//Frames left at each resolution of a 1080p + 4K sweep, 0 if none runs
+		int m_SweepFrames;
+		int m_SweepResolution;
+		int m_ResolutionBeforeSweep;
+
+		RenderGraph m_Graph;
+		PostProcess m_PostProcess;
+		AssetRef<Shader> m_SceneShader;
+		AssetRef<Shader> m_PresentShader;
+
+		//Smoothed GPU milliseconds per stage, one row per resolution
+		float m_StageMs[ResolutionCount][StageCount];
+
+		static const int SweepLength = 120;
+	};
+
+}
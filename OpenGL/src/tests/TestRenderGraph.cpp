@@ -0,0 +1,191 @@
+#include "TestRenderGraph.h"
+
+#include "DebugDraw.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <random>
+
+
+namespace test {
+
+	TestRenderGraph::TestRenderGraph()
+		: m_Width(960), m_Height(540), m_Aliasing(true), m_ShowDepth(false), m_GlowIntensity(1.5f), m_Orbit(true), m_Angle(0.0f),
+		  m_Camera(60.0f, 960.0f / 540.0f, 0.5f, 200.0f), m_BuildMs(0.0f), m_ExecuteMs(0.0f)
+	{
+		m_FullscreenShader = AssetManager::Get().Load<Shader>("res/shader/Fullscreen.shader");
+		m_CompositeShader = AssetManager::Get().Load<Shader>("res/shader/Composite.shader");
+
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> position(-30.0f, 30.0f), height(0.0f, 8.0f), size(0.5f, 3.0f), shade(0.2f, 1.0f);
+		for (int i = 0; i < 150; ++i) {
+			Shape shape;
+			shape.Center = glm::vec3(position(rng), height(rng), position(rng));
+			shape.Extent = glm::vec3(size(rng), size(rng), size(rng));
+			shape.Color = glm::vec4(shade(rng), shade(rng), shade(rng), 1.0f);
+			m_Shapes.push_back(shape);
+		}
+	}
+
+
+	TestRenderGraph::~TestRenderGraph()
+	{
+
+	}
+
+
+	void TestRenderGraph::OnUpdate(float deltaTime)
+	{
+		if (m_Orbit)
+			m_Angle += 0.003f;
+
+		glm::quat rotation = glm::angleAxis(m_Angle, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::angleAxis(-0.4f, glm::vec3(1.0f, 0.0f, 0.0f));
+		m_Camera.SetRotation(rotation);
+		m_Camera.SetPosition(rotation * glm::vec3(0.0f, 0.0f, 70.0f));
+	}
+
+
+	void TestRenderGraph::BuildGraph()
+	{
+		RenderGraph& graph = m_Graph;
+		graph.Reset();
+		graph.SetAliasing(m_Aliasing);
+
+		int width = m_Width, height = m_Height;
+		RenderResource backbuffer = graph.ImportTexture("Backbuffer", 0, { width, height, GL_RGBA8 });
+
+		//Handles are filled by the setup functions, which run right away, and read by the execute functions later
+		RenderResource sceneColor, sceneDepth;
+		graph.AddPass("Scene", [&](RenderPassBuilder& builder) {
+			sceneColor = builder.CreateTexture("Scene Color", { width, height, GL_RGBA16F });
+			sceneDepth = builder.CreateTexture("Scene Depth", { width, height, GL_DEPTH_COMPONENT24 });
+		}, [this](RenderPassContext&) {
+			GLCall(glClearColor(0.02f, 0.02f, 0.03f, 1.0f));
+			GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+			DebugDraw& debug = DebugDraw::Get();
+			for (int i = -40; i <= 40; i += 4) {
+				debug.Line(glm::vec3((float)i, 0.0f, -40.0f), glm::vec3((float)i, 0.0f, 40.0f), glm::vec4(0.2f, 0.2f, 0.25f, 1.0f));
+				debug.Line(glm::vec3(-40.0f, 0.0f, (float)i), glm::vec3(40.0f, 0.0f, (float)i), glm::vec4(0.2f, 0.2f, 0.25f, 1.0f));
+			}
+			for (const Shape& shape : m_Shapes)
+				debug.Box(shape.Center - shape.Extent, shape.Center + shape.Extent, shape.Color);
+			debug.Triangle(glm::vec3(-10.0f, 0.01f, -10.0f), glm::vec3(10.0f, 0.01f, -10.0f), glm::vec3(0.0f, 0.01f, 10.0f),
+				glm::vec4(1.0f, 0.5f, 0.1f, 1.0f));
+			debug.Render(m_Camera.GetViewProjection());
+		});
+
+		//Each step halves the size, the linear filter averages 2x2 texels
+		auto addCopy = [&](const std::string& name, RenderResource source, int divisor) {
+			RenderResource target;
+			graph.AddPass(name, [&](RenderPassBuilder& builder) {
+				builder.Read(source);
+				target = builder.CreateTexture(name, { std::max(width / divisor, 1), std::max(height / divisor, 1), GL_RGBA16F });
+			}, [this, source](RenderPassContext& context) {
+				m_FullscreenShader->Bind();
+				m_FullscreenShader->SetUniform1i("u_Source", 0);
+				m_FullscreenShader->SetUniform1f("u_Far", 0.0f);
+				context.BindTexture(source, 0);
+				context.DrawFullscreenTriangle();
+			});
+			return target;
+		};
+
+		RenderResource half = addCopy("Half", sceneColor, 2);
+		RenderResource quarter = addCopy("Quarter", half, 4);
+		RenderResource eighth = addCopy("Eighth", quarter, 8);
+		//Same sizes as Quarter and Half, which nobody reads anymore at this point
+		RenderResource glowQuarter = addCopy("Glow Quarter", eighth, 4);
+		RenderResource glow = addCopy("Glow", glowQuarter, 2);
+
+		RenderResource depthView;
+		graph.AddPass("Depth View", [&](RenderPassBuilder& builder) {
+			builder.Read(sceneDepth);
+			depthView = builder.CreateTexture("Depth View", { width, height, GL_RGBA8 });
+		}, [this, sceneDepth](RenderPassContext& context) {
+			m_FullscreenShader->Bind();
+			m_FullscreenShader->SetUniform1i("u_Source", 0);
+			m_FullscreenShader->SetUniform1f("u_Near", 0.5f);
+			m_FullscreenShader->SetUniform1f("u_Far", 200.0f);
+			context.BindTexture(sceneDepth, 0);
+			context.DrawFullscreenTriangle();
+		});
+
+		bool showDepth = m_ShowDepth;
+		graph.AddPass("Composite", [&](RenderPassBuilder& builder) {
+			builder.Read(sceneColor);
+			builder.Read(glow);
+			if (showDepth)
+				builder.Read(depthView);
+			builder.Write(backbuffer);
+		}, [this, sceneColor, glow, depthView, showDepth](RenderPassContext& context) {
+			GLCall(glDisable(GL_DEPTH_TEST));
+			m_CompositeShader->Bind();
+			m_CompositeShader->SetUniform1i("u_Scene", 0);
+			m_CompositeShader->SetUniform1i("u_Glow", 1);
+			m_CompositeShader->SetUniform1i("u_Depth", 2);
+			m_CompositeShader->SetUniform1f("u_Intensity", m_GlowIntensity);
+			m_CompositeShader->SetUniform1i("u_ShowDepth", showDepth ? 1 : 0);
+			context.BindTexture(sceneColor, 0);
+			context.BindTexture(glow, 1);
+			if (showDepth)
+				context.BindTexture(depthView, 2);
+			context.DrawFullscreenTriangle();
+			GLCall(glActiveTexture(GL_TEXTURE0));
+		});
+
+		graph.Compile();
+	}
+
+
+	void TestRenderGraph::OnRender()
+	{
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		{
+			Timer timer(measure);
+			BuildGraph();
+		}
+		m_BuildMs = ms;
+
+		{
+			Timer timer(measure);
+			m_Graph.Execute();
+		}
+		m_ExecuteMs = ms;
+
+		m_Dump = m_Graph.Dump();
+	}
+
+
+	void TestRenderGraph::OnResize(int width, int height)
+	{
+		m_Width = width;
+		m_Height = height;
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestRenderGraph::OnImGuiRender()
+	{
+		ImGui::Checkbox("Aliasing", &m_Aliasing);
+		ImGui::SameLine();
+		ImGui::Checkbox("Show depth (keeps the Depth View pass)", &m_ShowDepth);
+		ImGui::SliderFloat("Glow", &m_GlowIntensity, 0.0f, 5.0f);
+		ImGui::Checkbox("Orbit", &m_Orbit);
+
+		ImGui::Text("%zu passes, %zu culled", m_Graph.GetPassCount(), m_Graph.GetCulledPassCount());
+		ImGui::Text("Transient %.2f MB in %.2f MB of textures, pool %.2f MB", m_Graph.GetTransientMemory() / (1024.0f * 1024.0f),
+			m_Graph.GetAliasedMemory() / (1024.0f * 1024.0f), m_Graph.GetPoolMemory() / (1024.0f * 1024.0f));
+		ImGui::Text("Build + compile %.3f ms, execute %.3f ms", m_BuildMs, m_ExecuteMs);
+
+		if (ImGui::CollapsingHeader("Graph"))
+			ImGui::TextUnformatted(m_Dump.c_str());
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+
+}
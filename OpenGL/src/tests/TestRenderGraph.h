@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Test.h"
+#include "Camera.h"
+#include "AssetManager.h"
+#include "RenderGraph.h"
+
+#include <string>
+#include <vector>
+
+
+namespace test {
+
+	//A small frame built with the RenderGraph: scene into an HDR target, a chain of downsamples and upsamples into a glow
+	//texture and a composite into the window. The glow targets alias the downsample targets they follow, and the depth
+	//view pass is culled unless its result is shown. The graph is rebuilt every frame and dumped below.
+	class TestRenderGraph : public Test
+	{
+	public:
+		TestRenderGraph();
+		~TestRenderGraph();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return m_Orbit; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void BuildGraph();
+
+	private:
+		struct Shape {
+			glm::vec3 Center;
+			glm::vec3 Extent;
+			glm::vec4 Color;
+		};
+
+		int m_Width, m_Height;
+		bool m_Aliasing;
+		bool m_ShowDepth;
+		float m_GlowIntensity;
+		bool m_Orbit;
+		float m_Angle;
+
+		PerspectiveCamera m_Camera;
+		std::vector<Shape> m_Shapes;
+
+		RenderGraph m_Graph;
+		AssetRef<Shader> m_FullscreenShader;
+		AssetRef<Shader> m_CompositeShader;
+
+		std::string m_Dump;
+		float m_BuildMs;
+		float m_ExecuteMs;
+	};
+
+}
@@ -0,0 +1,213 @@
+#include "TestText.h"
+
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include <cstdio>
+#include <random>
+
+
+namespace test {
+
+	static const char* s_Sentences[] = {
+		"The quick brown fox jumps over the lazy dog.",
+		"Signed distance fields keep glyph edges sharp at any scale.",
+		"Sphinx of black quartz, judge my vow!",
+		"Pack my box with five dozen liquor jugs.",
+		"AVAST Ye, To Wa: kerning pairs like AV, To and Wa move closer.",
+		"0123456789 +-*/=()[]{}<>!?@#$%&",
+		"How vexingly quick daft zebras jump.",
+		"Glyphs are rasterized once and packed into the atlas on demand."
+	};
+
+	//Ranges most text fonts cover: ASCII, Latin-1, Latin Extended-A/B, Greek and Cyrillic
+	static const uint32_t s_CharacterRanges[][2] = {
+		{ 0x21, 0x7E }, { 0xA1, 0x24F }, { 0x391, 0x3C9 }, { 0x400, 0x4FF }
+	};
+
+
+	static void AppendUtf8(std::string& text, uint32_t c)
+	{
+		if (c < 0x80) {
+			text += (char)c;
+		}
+		else if (c < 0x800) {
+			text += (char)(0xC0 | (c >> 6));
+			text += (char)(0x80 | (c & 0x3F));
+		}
+		else {
+			text += (char)(0xE0 | (c >> 12));
+			text += (char)(0x80 | ((c >> 6) & 0x3F));
+			text += (char)(0x80 | (c & 0x3F));
+		}
+	}
+
+
+	static uint32_t GetCharacter(int index)
+	{
+		for (const auto& range : s_CharacterRanges) {
+			int count = (int)(range[1] - range[0] + 1);
+			if (index < count)
+				return range[0] + index;
+			index -= count;
+		}
+		return '?';
+	}
+
+
+	TestText::TestText()
+		: m_Mode(TextMode::Static), m_GlyphTarget(100000), m_CharacterCount(95), m_MinSize(8.0f), m_MaxSize(24.0f), m_ShowAtlas(false),
+		  m_FontPath(""), m_Camera(960.0f, 540.0f), m_Frame(0), m_SubmitMs(0.0f), m_AverageSubmitMs(0.0f)
+	{
+		LoadFont(std::make_unique<Font>());
+	}
+
+
+	TestText::~TestText()
+	{
+
+	}
+
+
+	void TestText::LoadFont(std::unique_ptr<Font> font)
+	{
+		//The renderer registers itself with the font, so it goes first
+		m_Renderer.reset();
+		m_Font = std::move(font);
+		m_Renderer = std::make_unique<TextRenderer>(*m_Font);
+		BuildLines();
+	}
+
+
+	void TestText::BuildLines()
+	{
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> size(m_MinSize, std::max(m_MaxSize, m_MinSize)), shade(0.5f, 1.0f);
+
+		int characterLimit = 0;
+		for (const auto& range : s_CharacterRanges)
+			characterLimit += (int)(range[1] - range[0] + 1);
+		std::uniform_int_distribution<int> character(0, std::min(m_CharacterCount, characterLimit) - 1);
+
+		m_Lines.clear();
+		m_Font->ResetStats();
+
+		//Rows from the top, wrapping back to the top so text keeps overlapping once the screen is full
+		glm::vec2 pen(4.0f, m_Camera.GetHeight());
+		int glyphs = 0;
+		for (int i = 0; glyphs < m_GlyphTarget; ++i) {
+			Line line;
+			line.Size = size(rng);
+			line.Color = glm::vec4(shade(rng), shade(rng), shade(rng), 1.0f);
+
+			if (m_Mode == TextMode::Characters) {
+				for (int c = 0; c < 48; ++c)
+					AppendUtf8(line.Text, GetCharacter(character(rng)));
+			}
+			else {
+				line.Text = s_Sentences[i % (sizeof(s_Sentences) / sizeof(s_Sentences[0]))];
+			}
+
+			pen.y -= line.Size * m_Font->GetLineHeight();
+			if (pen.y < 0.0f)
+				pen = glm::vec2(pen.x + 8.0f, m_Camera.GetHeight() - line.Size * m_Font->GetLineHeight());
+			line.Position = pen;
+
+			//Counted with the static sentences, the counter strings are about as long
+			glyphs += (int)line.Text.size();
+			m_Lines.push_back(std::move(line));
+		}
+	}
+
+
+	void TestText::OnRender()
+	{
+		GLCall(glClearColor(0.05f, 0.05f, 0.08f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			m_SubmitMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		++m_Frame;
+		{
+			Timer timer(measure);
+			m_Renderer->Begin(m_Camera.GetViewProjection());
+
+			if (m_Mode == TextMode::Counters) {
+				char text[64];
+				for (size_t i = 0; i < m_Lines.size(); ++i) {
+					const Line& line = m_Lines[i];
+					snprintf(text, sizeof(text), "Line %zu: frame %u, %.4f ms", i, m_Frame, m_AverageSubmitMs);
+					m_Renderer->DrawString(text, line.Position, line.Size, line.Color);
+				}
+			}
+			else {
+				for (const Line& line : m_Lines)
+					m_Renderer->DrawString(line.Text, line.Position, line.Size, line.Color);
+			}
+
+			m_Renderer->End();
+		}
+		m_AverageSubmitMs += (m_SubmitMs - m_AverageSubmitMs) * 0.05f;
+	}
+
+
+	void TestText::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+		BuildLines();
+	}
+
+
+	void TestText::OnImGuiRender()
+	{
+		bool rebuild = false;
+		rebuild |= ImGui::RadioButton("Static", (int*)&m_Mode, (int)TextMode::Static);
+		ImGui::SameLine();
+		rebuild |= ImGui::RadioButton("Counters", (int*)&m_Mode, (int)TextMode::Counters);
+		ImGui::SameLine();
+		rebuild |= ImGui::RadioButton("Characters", (int*)&m_Mode, (int)TextMode::Characters);
+
+		rebuild |= ImGui::SliderInt("Glyphs", &m_GlyphTarget, 1000, 500000);
+		if (m_Mode == TextMode::Characters)
+			rebuild |= ImGui::SliderInt("Distinct characters", &m_CharacterCount, 10, 1000);
+		rebuild |= ImGui::DragFloatRange2("Size", &m_MinSize, &m_MaxSize, 0.25f, 4.0f, 200.0f, "%.1f px");
+
+		ImGui::InputText("TTF", m_FontPath, sizeof(m_FontPath));
+		ImGui::SameLine();
+		if (ImGui::Button("Load"))
+			LoadFont(m_FontPath[0] ? std::make_unique<Font>(std::string(m_FontPath)) : std::make_unique<Font>());
+		if (!m_Font->IsLoaded())
+			ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Font not loaded");
+
+		if (rebuild)
+			BuildLines();
+
+		unsigned int glyphs = m_Renderer->GetGlyphsDrawn();
+		ImGui::Text("%u glyphs in %u draw calls, submit %.3f ms (%.1f M glyphs/s)", glyphs, m_Renderer->GetDrawCalls(), m_AverageSubmitMs,
+			m_AverageSubmitMs > 0.0f ? glyphs / (m_AverageSubmitMs * 1000.0f) : 0.0f);
+
+		uint64_t glyphLookups = m_Font->GetGlyphLookups(), runLookups = m_Font->GetRunLookups();
+		ImGui::Text("Glyph cache: %zu glyphs, %llu misses / %llu lookups (%.3f%%)", m_Font->GetGlyphCount(),
+			(unsigned long long)m_Font->GetGlyphMisses(), (unsigned long long)glyphLookups,
+			glyphLookups ? 100.0 * m_Font->GetGlyphMisses() / glyphLookups : 0.0);
+		ImGui::Text("Run cache: %zu runs, %llu misses / %llu lookups (%.3f%%)", m_Font->GetRunCount(),
+			(unsigned long long)m_Font->GetRunMisses(), (unsigned long long)runLookups,
+			runLookups ? 100.0 * m_Font->GetRunMisses() / runLookups : 0.0);
+		ImGui::Text("Atlas: %dx%d, %.1f%% of the rows used, %u resets", m_Font->GetAtlasSize(), m_Font->GetAtlasSize(),
+			m_Font->GetAtlasUsage() * 100.0f, m_Font->GetAtlasResets());
+		if (ImGui::Button("Reset Stats"))
+			m_Font->ResetStats();
+		ImGui::SameLine();
+		if (ImGui::Button("Clear Atlas"))
+			m_Font->ClearAtlas();
+
+		ImGui::Checkbox("Show Atlas", &m_ShowAtlas);
+		if (m_ShowAtlas)
+			ImGui::Image((ImTextureID)(intptr_t)m_Font->GetAtlasID(), ImVec2(512.0f, 512.0f));
+
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Test.h"
+#include "Camera.h"
+#include "Font.h"
+#include "TextRenderer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace test {
+
+	//Screen full of SDF text to measure glyph throughput, glyph/run cache hit rates and how the atlas copes with
+	//many distinct characters
+	class TestText : public Test
+	{
+	public:
+		TestText();
+		~TestText();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+		void OnResize(int width, int height) override;
+
+	private:
+		enum class TextMode {
+			Static,			//The same strings every frame, served from the run cache
+			Counters,		//Numbers that change every frame, shaped every frame from cached glyphs
+			Characters		//Strings of m_CharacterCount distinct characters, stresses the atlas
+		};
+
+		struct Line {
+			std::string Text;
+			glm::vec2 Position;
+			float Size;
+			glm::vec4 Color;
+		};
+
+		void LoadFont(std::unique_ptr<Font> font);
+		void BuildLines();
+
+	private:
+		TextMode m_Mode;
+		int m_GlyphTarget;
+		int m_CharacterCount;
+		float m_MinSize, m_MaxSize;
+		bool m_ShowAtlas;
+		char m_FontPath[256];
+
+		OrthographicCamera m_Camera;
+		std::unique_ptr<Font> m_Font;
+		std::unique_ptr<TextRenderer> m_Renderer;
+
+		std::vector<Line> m_Lines;
+		unsigned int m_Frame;
+
+		float m_SubmitMs;
+		float m_AverageSubmitMs;
+	};
+
+}
@@ -9,9 +9,20 @@
 
 namespace test {
 
+	//8 bytes instead of 16: half float positions and normalized 16 bit texture coordinates
+	struct TexturedVertex {
+		Half Position[2];
+		unsigned short TexCoord[2];
+	};
+
+	static constexpr auto s_TexturedVertexLayout = MakeVertexLayout<TexturedVertex>(
+		VERTEX_ATTRIB(TexturedVertex, Position),
+		VERTEX_ATTRIB(TexturedVertex, TexCoord)
+	);
+
+
 	TestTexture2D::TestTexture2D()
-		: m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
-		  m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0))),
+		: m_Camera(960.0f, 540.0f),
 		  m_TranslationA(200, 200, 0), m_TranslationB(400, 200, 0)
 	{
 		float positions[] = {
@@ -21,6 +32,12 @@ namespace test {
 			-50.0f,  50.0f, 0.0f, 1.0f
 		};
 
+		TexturedVertex vertices[4];
+		for (int i = 0; i < 4; ++i) {
+			PackHalf(&positions[i * 4], vertices[i].Position, 2);
+			PackUNorm16(&positions[i * 4 + 2], vertices[i].TexCoord, 2);
+		}
+
 		unsigned int indices[] = {
 			0, 1, 2,
 			2, 3, 0
@@ -30,22 +47,20 @@ namespace test {
 		GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
 		m_VAO = std::make_unique<VertexArray>();
-		m_VBO = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+		m_VBO = std::make_unique<VertexBuffer>(vertices, sizeof(vertices));
 
-		VertexBufferLayout layout;
-		layout.Push<float>(2);
-		layout.Push<float>(2);
-	
-		m_VAO->AddBuffer(*m_VBO, layout);
+		m_VAO->AddBuffer(*m_VBO, s_TexturedVertexLayout);
 		m_IBO = std::make_unique<IndexBuffer>(indices, 6);
 		
-		m_Shader = std::make_unique<Shader>("res/shader/Basic.shader");
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/Basic.shader");
 		m_Shader->Bind();
 		m_Shader->SetUniform4f("u_Color", 0.8f, 0.3f, 0.8f, 1.0f);
 
-		m_Texture = std::make_unique<Texture>("res/textures/TestImage.png");
+		m_Texture = AssetManager::Get().Load<Texture>("res/textures/TestImage.png");
 		m_Shader->SetUniform1i("u_Texture", 0);
 		
+		m_NodeA = m_Transforms.Add(TransformHierarchy::NoParent, m_TranslationA);
+		m_NodeB = m_Transforms.Add(TransformHierarchy::NoParent, m_TranslationB);
 	}
 
 
@@ -57,7 +72,11 @@ namespace test {
 
 	void TestTexture2D::OnUpdate(float deltatime)
 	{
-	
+		if (m_Transforms.GetPosition(m_NodeA) != m_TranslationA)
+			m_Transforms.SetPosition(m_NodeA, m_TranslationA);
+		if (m_Transforms.GetPosition(m_NodeB) != m_TranslationB)
+			m_Transforms.SetPosition(m_NodeB, m_TranslationB);
+		m_Transforms.Update();
 	}
 
 
@@ -71,17 +90,11 @@ namespace test {
 		
 		m_Texture->Bind();
 
-		{
-			glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-			glm::mat4 mvp = m_Proj * m_View * model;
-			m_Shader->Bind();
-			m_Shader->SetUniformMat4f("u_MVP", mvp);
-			renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
-		}
+		//Model matrices come from the transform hierarchy, the camera caches the view projection
+		const glm::mat4& viewProjection = m_Camera.GetViewProjection();
 
-		{
-			glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationB);
-			glm::mat4 mvp = m_Proj * m_View * model;
+		for (unsigned int node : { m_NodeA, m_NodeB }) {
+			glm::mat4 mvp = viewProjection * m_Transforms.GetWorldMatrix(node);
 			m_Shader->Bind();
 			m_Shader->SetUniformMat4f("u_MVP", mvp);
 			renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
@@ -89,10 +102,16 @@ namespace test {
 	}
 
 
+	void TestTexture2D::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
 	void TestTexture2D::OnImGuiRender()
 	{
-		ImGui::SliderFloat3("Translation A", &m_TranslationA.x, 0.0f, 960.0f);
-		ImGui::SliderFloat3("Translation B", &m_TranslationB.x, 0.0f, 960.0f);
+		ImGui::SliderFloat3("Translation A", &m_TranslationA.x, 0.0f, m_Camera.GetWidth());
+		ImGui::SliderFloat3("Translation B", &m_TranslationB.x, 0.0f, m_Camera.GetWidth());
 		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f, ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 	}
 
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "Test.h"
+#include "AssetManager.h"
 #include "VertexBufferLayout.h"
 #include "Texture.h"
 #include "VertexBuffer.h"
+#include "TransformHierarchy.h"
+#include "Camera.h"
 
 #include <memory>
 
@@ -19,17 +22,21 @@ namespace test {
 		void OnUpdate(float deltatime) override;
 		void OnRender() override;
 		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+		void OnResize(int width, int height) override;
 
 	private:
 		std::unique_ptr<VertexArray> m_VAO;
 		std::unique_ptr<IndexBuffer> m_IBO;
-		std::unique_ptr<Shader> m_Shader;
-		std::unique_ptr<Texture> m_Texture;
+		AssetRef<Shader> m_Shader;
+		AssetRef<Texture> m_Texture;
 		std::unique_ptr<VertexBuffer> m_VBO;
 
-		glm::mat4 m_Proj, m_View;
+		OrthographicCamera m_Camera;
 
 		glm::vec3 m_TranslationA, m_TranslationB;
+		TransformHierarchy m_Transforms;
+		unsigned int m_NodeA, m_NodeB;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "TestTextureArray.h"
+
+#include "VertexBufferLayout.h"
+#include "imgui/imgui.h"
+
+#include <random>
+#include <vector>
+
+
+namespace test {
+
+	struct LayeredVertex {
+		glm::vec2 Position;
+		glm::vec2 TexCoord;
+		float Layer;
+	};
+
+	static constexpr auto s_LayeredVertexLayout = MakeVertexLayout<LayeredVertex>(
+		VERTEX_ATTRIB(LayeredVertex, Position),
+		VERTEX_ATTRIB(LayeredVertex, TexCoord),
+		VERTEX_ATTRIB(LayeredVertex, Layer)
+	);
+
+	static const int s_LayerSize = 128;
+	static const int s_LayerCount = 64;
+
+
+	TestTextureArray::TestTextureArray()
+		: m_SpriteCount(10000), m_Mipmaps(true), m_Camera(960.0f, 540.0f)
+	{
+		m_Textures = std::make_unique<TextureArray>(s_LayerSize, s_LayerSize, s_LayerCount);
+
+		//Layer 0 is the test image scaled down, the rest are generated patterns in different colors
+		m_Textures->LoadLayer(0, "res/textures/TestImage.png");
+
+		std::vector<unsigned char> pixels(s_LayerSize * s_LayerSize * 4);
+		for (int layer = 1; layer < s_LayerCount; ++layer) {
+			unsigned char r = (unsigned char)(64 + (layer * 37) % 192);
+			unsigned char g = (unsigned char)(64 + (layer * 91) % 192);
+			unsigned char b = (unsigned char)(64 + (layer * 53) % 192);
+			int cell = 4 << (layer % 4);
+
+			for (int y = 0; y < s_LayerSize; ++y) {
+				for (int x = 0; x < s_LayerSize; ++x) {
+					bool on = layer % 2 ? ((x / cell + y / cell) & 1) != 0 : ((x + y) / cell & 1) != 0;
+					unsigned char* pixel = &pixels[(y * s_LayerSize + x) * 4];
+					pixel[0] = on ? r : r / 4;
+					pixel[1] = on ? g : g / 4;
+					pixel[2] = on ? b : b / 4;
+					pixel[3] = 255;
+				}
+			}
+			m_Textures->SetLayer(layer, pixels.data());
+		}
+		m_Textures->GenerateMipmaps();
+
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/TextureArray.shader");
+		m_Shader->Bind();
+		m_Shader->SetUniform1i("u_Textures", 0);
+
+		BuildSprites();
+	}
+
+
+	TestTextureArray::~TestTextureArray()
+	{
+
+	}
+
+
+	void TestTextureArray::BuildSprites()
+	{
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> x(0.0f, m_Camera.GetWidth()), y(0.0f, m_Camera.GetHeight()), size(8.0f, 64.0f);
+		std::uniform_int_distribution<int> layer(0, s_LayerCount - 1);
+
+		std::vector<LayeredVertex> vertices;
+		std::vector<unsigned int> indices;
+		vertices.reserve(m_SpriteCount * 4);
+		indices.reserve(m_SpriteCount * 6);
+
+		for (int i = 0; i < m_SpriteCount; ++i) {
+			glm::vec2 center(x(rng), y(rng));
+			float half = size(rng) * 0.5f;
+			float index = (float)layer(rng);
+
+			unsigned int base = (unsigned int)vertices.size();
+			vertices.push_back({ center + glm::vec2(-half, -half), glm::vec2(0.0f, 0.0f), index });
+			vertices.push_back({ center + glm::vec2( half, -half), glm::vec2(1.0f, 0.0f), index });
+			vertices.push_back({ center + glm::vec2( half,  half), glm::vec2(1.0f, 1.0f), index });
+			vertices.push_back({ center + glm::vec2(-half,  half), glm::vec2(0.0f, 1.0f), index });
+			indices.insert(indices.end(), { base, base + 1, base + 2, base + 2, base + 3, base });
+		}
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(LayeredVertex)));
+		m_VAO->AddBuffer(*m_VBO, s_LayeredVertexLayout);
+		m_IBO = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+	}
+
+
+	void TestTextureArray::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer renderer;
+
+		m_Textures->Bind();
+		GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, m_Mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+
+		m_Shader->Bind();
+		m_Shader->SetUniformMat4f("u_MVP", m_Camera.GetViewProjection());
+		renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+	}
+
+
+	void TestTextureArray::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestTextureArray::OnImGuiRender()
+	{
+		ImGui::SliderInt("Sprites", &m_SpriteCount, 100, 100000);
+		if (ImGui::Button("Build Sprites"))
+			BuildSprites();
+		ImGui::Checkbox("Mipmaps", &m_Mipmaps);
+
+		ImGui::Text("%d sprites, %d images (%dx%d, %d mips), 1 draw call", m_SpriteCount, m_Textures->GetLayerCount(),
+			m_Textures->GetWidth(), m_Textures->GetHeight(), m_Textures->GetMipLevels());
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Test.h"
+#include "AssetManager.h"
+#include "TextureArray.h"
+#include "VertexBuffer.h"
+#include "Camera.h"
+
+#include <memory>
+
+
+namespace test {
+
+	//Sprites using many different images, drawn with one call from a single TextureArray
+	class TestTextureArray : public Test
+	{
+	public:
+		TestTextureArray();
+		~TestTextureArray();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void BuildSprites();
+
+	private:
+		int m_SpriteCount;
+		bool m_Mipmaps;
+
+		OrthographicCamera m_Camera;
+
+		std::unique_ptr<TextureArray> m_Textures;
+		AssetRef<Shader> m_Shader;
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+	};
+
+}
@@ -0,0 +1,108 @@
+#include "TestTextureCache.h"
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "TextureCache.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+
+namespace test {
+
+	static const char* s_ImagePath = "res/textures/TestImage.png";
+
+
+	TestTextureCache::TestTextureCache()
+		: m_LoadCount(8), m_Mipmaps(TextureCache::Get().GetGenerateMipmaps())
+	{
+
+	}
+
+
+	TestTextureCache::~TestTextureCache()
+	{
+
+	}
+
+
+	void TestTextureCache::RunBenchmark()
+	{
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		TextureCache& cache = TextureCache::Get();
+		bool enabled = cache.IsEnabled();
+		m_Results.clear();
+
+		//Every texture is created and destroyed right away, glFinish makes the times include the upload
+		cache.SetEnabled(false);
+		{
+			Timer timer(measure);
+			for (int i = 0; i < m_LoadCount; ++i) {
+				Texture texture(s_ImagePath);
+				GLCall(glFinish());
+			}
+		}
+		m_Results.push_back({ "Uncached", ms / m_LoadCount });
+
+		cache.SetEnabled(true);
+		float coldMs = 0.0f;
+		for (int i = 0; i < m_LoadCount; ++i) {
+			cache.Clear();
+			{
+				Timer timer(measure);
+				Texture texture(s_ImagePath);
+				GLCall(glFinish());
+			}
+			coldMs += ms;
+		}
+		m_Results.push_back({ "Cold cache", coldMs / m_LoadCount });
+
+		{
+			Timer timer(measure);
+			for (int i = 0; i < m_LoadCount; ++i) {
+				Texture texture(s_ImagePath);
+				GLCall(glFinish());
+			}
+		}
+		m_Results.push_back({ "Warm cache", ms / m_LoadCount });
+
+		cache.SetEnabled(enabled);
+	}
+
+
+	void TestTextureCache::OnImGuiRender()
+	{
+		TextureCache& cache = TextureCache::Get();
+
+		ImGui::SliderInt("Loads", &m_LoadCount, 1, 32);
+		if (ImGui::Checkbox("Mipmaps", &m_Mipmaps))
+			cache.SetGenerateMipmaps(m_Mipmaps);
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+		ImGui::SameLine();
+		if (ImGui::Button("Clear Cache"))
+			cache.Clear();
+
+		ImGui::Text("%s: %u hits, %u misses, %.1f MB on disk", cache.GetDirectory().c_str(), cache.GetHits(), cache.GetMisses(),
+			cache.GetDiskSize() / (1024.0f * 1024.0f));
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Columns(2);
+		ImGui::Text("Load"); ImGui::NextColumn();
+		ImGui::Text("Time per Texture"); ImGui::NextColumn();
+
+		for (const Result& result : m_Results) {
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%.2f ms (x%.2f)", result.Ms, m_Results[0].Ms / result.Ms); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Test.h"
+
+#include <vector>
+
+
+namespace test {
+
+	//Texture load times without the TextureCache, with a cold cache (decode + write entry) and a warm one (map + upload)
+	class TestTextureCache : public Test
+	{
+	public:
+		TestTextureCache();
+		~TestTextureCache();
+
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+
+	private:
+		void RunBenchmark();
+
+	private:
+		struct Result {
+			const char* Name;
+			float Ms;
+		};
+
+		int m_LoadCount;
+		bool m_Mipmaps;
+		std::vector<Result> m_Results;
+	};
+
+}
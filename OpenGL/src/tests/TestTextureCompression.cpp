@@ -0,0 +1,224 @@
+#include "TestTextureCompression.h"
+
+#include "JobSystem.h"
+#include "TextureCache.h"
+#include "TextureConverter.h"
+#include "VertexBufferLayout.h"
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "stb_image/stb_image.h"
+
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+
+namespace test {
+
+	struct QuadVertex {
+		glm::vec2 Position;
+		glm::vec2 TexCoord;
+	};
+
+	static constexpr auto s_QuadVertexLayout = MakeVertexLayout<QuadVertex>(
+		VERTEX_ATTRIB(QuadVertex, Position),
+		VERTEX_ATTRIB(QuadVertex, TexCoord)
+	);
+
+
+	//Peak signal to noise ratio of the RGB channels in dB, alpha is left out since the test image is opaque
+	static float ComputePSNR(const unsigned char* reference, const unsigned char* decoded, size_t pixelCount)
+	{
+		double error = 0.0;
+		for (size_t i = 0; i < pixelCount; ++i) {
+			for (int c = 0; c < 3; ++c) {
+				int difference = reference[i * 4 + c] - decoded[i * 4 + c];
+				error += difference * difference;
+			}
+		}
+		if (error == 0.0)
+			return INFINITY;
+		double mse = error / (pixelCount * 3.0);
+		return (float)(10.0 * std::log10(255.0 * 255.0 / mse));
+	}
+
+
+	TestTextureCompression::TestTextureCompression()
+		: m_Sources{ { "PNG", "res/textures/TestImage.png", 0.0f, 0 },
+					 { "BC1 DDS", "res/generated/TestImage.bc1.dds", 0.0f, 0 },
+					 { "BC3 DDS", "res/generated/TestImage.bc3.dds", 0.0f, 0 } },
+		  m_Current(0), m_ConvertMs(0.0f), m_ScalarMs(0.0f), m_SimdMs(0.0f), m_Bc1Psnr(0.0f), m_Bc3Psnr(0.0f), m_Camera(960.0f, 540.0f)
+	{
+		if (!std::filesystem::exists(m_Sources[1].Path) || !std::filesystem::exists(m_Sources[2].Path))
+			Convert();
+
+		QuadVertex vertices[] = {
+			{ glm::vec2(-256.0f, -256.0f), glm::vec2(0.0f, 0.0f) },
+			{ glm::vec2( 256.0f, -256.0f), glm::vec2(1.0f, 0.0f) },
+			{ glm::vec2( 256.0f,  256.0f), glm::vec2(1.0f, 1.0f) },
+			{ glm::vec2(-256.0f,  256.0f), glm::vec2(0.0f, 1.0f) }
+		};
+		unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(vertices, sizeof(vertices));
+		m_VAO->AddBuffer(*m_VBO, s_QuadVertexLayout);
+		m_IBO = std::make_unique<IndexBuffer>(indices, 6);
+
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/Basic.shader");
+		m_Shader->Bind();
+		m_Shader->SetUniform1i("u_Texture", 0);
+
+		for (int i = 2; i >= 0; --i)
+			Load(i);
+	}
+
+
+	TestTextureCompression::~TestTextureCompression()
+	{
+
+	}
+
+
+	void TestTextureCompression::Convert()
+	{
+		auto measure = [this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			m_ConvertMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		std::filesystem::create_directories("res/generated");
+
+		Timer timer(measure);
+		ConvertImageToDDS(m_Sources[0].Path, m_Sources[1].Path, TextureFormat::BC1);
+		ConvertImageToDDS(m_Sources[0].Path, m_Sources[2].Path, TextureFormat::BC3);
+	}
+
+
+	void TestTextureCompression::BenchmarkEncoders()
+	{
+		int width, height, bpp;
+		unsigned char* pixels = stbi_load(m_Sources[0].Path.c_str(), &width, &height, &bpp, 4);
+		if (!pixels)
+			return;
+
+		std::vector<unsigned char> blocks(GetTextureLevelSize(TextureFormat::BC3, width, height));
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		{
+			Timer timer(measure);
+			CompressBC3Scalar(pixels, width, height, blocks.data());
+		}
+		m_ScalarMs = ms;
+
+		{
+			Timer timer(measure);
+			CompressBC3(pixels, width, height, blocks.data());
+		}
+		m_SimdMs = ms;
+
+		//Quality of both formats: encode, decode again and compare against the source
+		size_t pixelCount = (size_t)width * height;
+		std::vector<unsigned char> decoded(pixelCount * 4);
+		DecompressBC3(blocks.data(), width, height, decoded.data());
+		m_Bc3Psnr = ComputePSNR(pixels, decoded.data(), pixelCount);
+
+		CompressBC1(pixels, width, height, blocks.data());
+		DecompressBC1(blocks.data(), width, height, decoded.data());
+		m_Bc1Psnr = ComputePSNR(pixels, decoded.data(), pixelCount);
+
+		stbi_image_free(pixels);
+	}
+
+
+	void TestTextureCompression::Load(int source)
+	{
+		Source& entry = m_Sources[source];
+		auto measure = [&entry](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			entry.LoadMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		//The PNG row measures decoding, a warm TextureCache would turn it into a cache hit after the first run
+		TextureCache& cache = TextureCache::Get();
+		bool cacheEnabled = cache.IsEnabled();
+		cache.SetEnabled(false);
+
+		{
+			//Bypasses the AssetManager on purpose, every click has to load the file again
+			Timer timer(measure);
+			m_Texture = std::make_unique<Texture>(entry.Path);
+			//The upload is asynchronous, wait for it so the time includes the transfer
+			GLCall(glFinish());
+		}
+
+		cache.SetEnabled(cacheEnabled);
+
+		entry.MemorySize = m_Texture->GetMemorySize();
+		m_Current = source;
+	}
+
+
+	void TestTextureCompression::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer renderer;
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(m_Camera.GetWidth() * 0.5f, m_Camera.GetHeight() * 0.5f, 0.0f));
+
+		m_Texture->Bind();
+		m_Shader->Bind();
+		m_Shader->SetUniformMat4f("u_MVP", m_Camera.GetViewProjection() * model);
+		renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+	}
+
+
+	void TestTextureCompression::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestTextureCompression::OnImGuiRender()
+	{
+		for (int i = 0; i < 3; ++i) {
+			if (i > 0)
+				ImGui::SameLine();
+			if (ImGui::Button(m_Sources[i].Name))
+				Load(i);
+		}
+		if (ImGui::Button("Convert"))
+			Convert();
+		ImGui::SameLine();
+		if (ImGui::Button("Benchmark Encoders"))
+			BenchmarkEncoders();
+
+		ImGui::Text("Showing %s (%s, %dx%d)", m_Sources[m_Current].Name, GetTextureFormatName(m_Texture->GetFormat()), m_Texture->GetWidth(), m_Texture->GetHeight());
+
+		std::error_code error;
+		ImGui::Columns(4, "sources");
+		ImGui::Separator();
+		ImGui::Text("File"); ImGui::NextColumn();
+		ImGui::Text("File Size"); ImGui::NextColumn();
+		ImGui::Text("VRAM"); ImGui::NextColumn();
+		ImGui::Text("Load + Upload"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (const Source& source : m_Sources) {
+			ImGui::Text("%s", source.Name); ImGui::NextColumn();
+			ImGui::Text("%.1f MB", std::filesystem::file_size(source.Path, error) / (1024.0f * 1024.0f)); ImGui::NextColumn();
+			ImGui::Text("%.1f MB", source.MemorySize / (1024.0f * 1024.0f)); ImGui::NextColumn();
+			ImGui::Text("%.2f ms", source.LoadMs); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+		ImGui::Separator();
+
+		ImGui::Text("Convert both (with mips, %u threads): %.2f ms", JobSystem::Get().GetThreadCount(), m_ConvertMs);
+		ImGui::Text("BC3 encode, level 0 only: scalar %.2f ms, SSE2 %.2f ms", m_ScalarMs, m_SimdMs);
+		ImGui::Text("RGB PSNR after encode + decode: BC1 %.2f dB, BC3 %.2f dB", m_Bc1Psnr, m_Bc3Psnr);
+	}
+
+}
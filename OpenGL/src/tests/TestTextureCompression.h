@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Test.h"
+#include "AssetManager.h"
+#include "Texture.h"
+#include "VertexBuffer.h"
+#include "Camera.h"
+
+#include <memory>
+#include <string>
+
+
+namespace test {
+
+	//Converts the test image to BC1/BC3 DDS files and compares encoder speed, load time and VRAM use against the PNG
+	class TestTextureCompression : public Test
+	{
+	public:
+		TestTextureCompression();
+		~TestTextureCompression();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void Convert();
+		void BenchmarkEncoders();
+		void Load(int source);
+
+	private:
+		struct Source {
+			const char* Name;
+			std::string Path;
+			float LoadMs;
+			size_t MemorySize;
+		};
+
+		Source m_Sources[3];
+		int m_Current;
+		float m_ConvertMs;
+		float m_ScalarMs, m_SimdMs;
+		float m_Bc1Psnr, m_Bc3Psnr;
+
+		OrthographicCamera m_Camera;
+
+		std::unique_ptr<Texture> m_Texture;
+		AssetRef<Shader> m_Shader;
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+	};
+
+}
@@ -0,0 +1,165 @@
+#include "TestTextureStreaming.h"
+
+#include "TextureConverter.h"
+#include "VertexBufferLayout.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <filesystem>
+
+
+namespace test {
+
+	struct GroundVertex {
+		glm::vec3 Position;
+		glm::vec2 TexCoord;
+	};
+
+	static constexpr auto s_GroundVertexLayout = MakeVertexLayout<GroundVertex>(
+		VERTEX_ATTRIB(GroundVertex, Position),
+		VERTEX_ATTRIB(GroundVertex, TexCoord)
+	);
+
+	static const int s_GridSize = 4;
+	static const float s_QuadSize = 10.0f;
+	static const float s_QuadSpacing = 12.0f;
+
+
+	TestTextureStreaming::TestTextureStreaming()
+		: m_MemoryBudgetMB(32), m_UploadBudgetKB(2048), m_Animate(true), m_Time(0.0f), m_ViewportHeight(540.0f),
+		  m_Camera(60.0f, 960.0f / 540.0f, 0.1f, 500.0f),
+		  m_Streamer((size_t)m_MemoryBudgetMB * 1024 * 1024, (size_t)m_UploadBudgetKB * 1024)
+	{
+		//Every quad gets its own copy of the test image, so each one has its own residency
+		const std::string path = "res/generated/TestImage.bc1.dds";
+		if (!std::filesystem::exists(path)) {
+			std::filesystem::create_directories("res/generated");
+			ConvertImageToDDS("res/textures/TestImage.png", path, TextureFormat::BC1);
+		}
+
+		for (int z = 0; z < s_GridSize; ++z) {
+			for (int x = 0; x < s_GridSize; ++x) {
+				TextureStreamer::Handle texture = m_Streamer.Load(path);
+				if (texture == TextureStreamer::InvalidHandle)
+					continue;
+				glm::vec3 center((x - (s_GridSize - 1) * 0.5f) * s_QuadSpacing, 0.0f, (z - (s_GridSize - 1) * 0.5f) * s_QuadSpacing);
+				m_Quads.push_back({ center, texture });
+			}
+		}
+
+		//Lies in the xz plane, facing up
+		float half = s_QuadSize * 0.5f;
+		GroundVertex vertices[] = {
+			{ glm::vec3(-half, 0.0f,  half), glm::vec2(0.0f, 0.0f) },
+			{ glm::vec3( half, 0.0f,  half), glm::vec2(1.0f, 0.0f) },
+			{ glm::vec3( half, 0.0f, -half), glm::vec2(1.0f, 1.0f) },
+			{ glm::vec3(-half, 0.0f, -half), glm::vec2(0.0f, 1.0f) }
+		};
+		unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(vertices, sizeof(vertices));
+		m_VAO->AddBuffer(*m_VBO, s_GroundVertexLayout);
+		m_IBO = std::make_unique<IndexBuffer>(indices, 6);
+
+		m_Shader = AssetManager::Get().Load<Shader>("res/shader/Basic.shader");
+		m_Shader->Bind();
+		m_Shader->SetUniform1i("u_Texture", 0);
+	}
+
+
+	TestTextureStreaming::~TestTextureStreaming()
+	{
+
+	}
+
+
+	void TestTextureStreaming::OnUpdate(float deltatime)
+	{
+		if (m_Animate)
+			m_Time += 0.004f;
+
+		//Sweeps low over single quads and pulls back until the whole field is in view
+		float height = 3.0f + 40.0f * (0.5f - 0.5f * glm::cos(m_Time * 0.7f));
+		glm::vec3 target(glm::sin(m_Time) * 20.0f, 0.0f, glm::cos(m_Time * 0.6f) * 20.0f);
+		m_Camera.SetPosition(target + glm::vec3(0.0f, height, height * 0.3f + 2.0f));
+		m_Camera.LookAt(target);
+
+		m_Streamer.SetMemoryBudget((size_t)m_MemoryBudgetMB * 1024 * 1024);
+		m_Streamer.SetUploadBudget((size_t)m_UploadBudgetKB * 1024);
+	}
+
+
+	void TestTextureStreaming::OnRender()
+	{
+		GLCall(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+		GLCall(glEnable(GL_DEPTH_TEST));
+
+		Renderer renderer;
+		const Frustum& frustum = m_Camera.GetFrustum();
+		float radius = s_QuadSize * 0.7072f;
+		float pixelsPerUnit = m_ViewportHeight / (2.0f * glm::tan(glm::radians(m_Camera.GetFieldOfView()) * 0.5f));
+
+		for (const Quad& quad : m_Quads) {
+			bool visible = true;
+			for (const glm::vec4& plane : frustum.Planes)
+				visible = visible && glm::dot(glm::vec3(plane), quad.Center) + plane.w >= -radius;
+			if (!visible)
+				continue;
+
+			//Size feedback: projected edge length at the distance of the quad center
+			float distance = glm::max(glm::length(quad.Center - m_Camera.GetPosition()), m_Camera.GetNearPlane());
+			m_Streamer.RequestSize(quad.Texture, s_QuadSize * pixelsPerUnit / distance);
+
+			m_Streamer.Bind(quad.Texture);
+			m_Shader->Bind();
+			m_Shader->SetUniformMat4f("u_MVP", m_Camera.GetViewProjection() * glm::translate(glm::mat4(1.0f), quad.Center));
+			renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+		}
+
+		GLCall(glDisable(GL_DEPTH_TEST));
+
+		m_Streamer.Update();
+	}
+
+
+	void TestTextureStreaming::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+		m_ViewportHeight = (float)height;
+	}
+
+
+	void TestTextureStreaming::OnImGuiRender()
+	{
+		ImGui::SliderInt("VRAM Budget (MB)", &m_MemoryBudgetMB, 1, 128);
+		ImGui::SliderInt("Upload Budget (KB/frame)", &m_UploadBudgetKB, 64, 16384);
+		ImGui::Checkbox("Animate Camera", &m_Animate);
+
+		float usage = m_Streamer.GetMemoryUsage() / (1024.0f * 1024.0f);
+		char overlay[64];
+		snprintf(overlay, sizeof(overlay), "%.1f / %d MB", usage, m_MemoryBudgetMB);
+		ImGui::ProgressBar(usage / m_MemoryBudgetMB, ImVec2(-1.0f, 0.0f), overlay);
+		ImGui::Text("Uploaded last frame: %.1f KB", m_Streamer.GetUploadedBytes() / 1024.0f);
+
+		ImGui::Columns(4, "textures");
+		ImGui::Separator();
+		ImGui::Text("Texture"); ImGui::NextColumn();
+		ImGui::Text("Resident"); ImGui::NextColumn();
+		ImGui::Text("Wanted"); ImGui::NextColumn();
+		ImGui::Text("Memory"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (size_t i = 0; i < m_Streamer.GetTextureCount(); ++i) {
+			TextureStreamer::TextureInfo info = m_Streamer.GetInfo((TextureStreamer::Handle)i);
+			ImGui::Text("%d", (int)i); ImGui::NextColumn();
+			ImGui::Text("mip %d (%d)", info.ResidentLevel, glm::max(info.Width >> info.ResidentLevel, 1)); ImGui::NextColumn();
+			ImGui::Text("mip %d (%d)", info.DesiredLevel, glm::max(info.Width >> info.DesiredLevel, 1)); ImGui::NextColumn();
+			ImGui::Text("%.2f MB", info.MemorySize / (1024.0f * 1024.0f)); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+		ImGui::Separator();
+	}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Test.h"
+#include "AssetManager.h"
+#include "Renderer.h"
+#include "TextureStreamer.h"
+#include "VertexBuffer.h"
+#include "Camera.h"
+
+#include <memory>
+#include <vector>
+
+
+namespace test {
+
+	//A field of large textured quads, the camera flies in and out so the streamer has to raise and drop mip levels
+	class TestTextureStreaming : public Test
+	{
+	public:
+		TestTextureStreaming();
+		~TestTextureStreaming();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		void OnResize(int width, int height) override;
+
+	private:
+		struct Quad {
+			glm::vec3 Center;
+			TextureStreamer::Handle Texture;
+		};
+
+		int m_MemoryBudgetMB;
+		int m_UploadBudgetKB;
+		bool m_Animate;
+		float m_Time;
+		float m_ViewportHeight;
+
+		PerspectiveCamera m_Camera;
+		TextureStreamer m_Streamer;
+		std::vector<Quad> m_Quads;
+
+		AssetRef<Shader> m_Shader;
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+	};
+
+}
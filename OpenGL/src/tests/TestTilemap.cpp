@@ -0,0 +1,215 @@
+#include "TestTilemap.h"
+
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+
+namespace test {
+
+	static const int s_TileTypes = 16;
+	static const int s_TileTextureSize = 32;
+
+
+	//Hash of a lattice point mapped to [0, 1)
+	static float LatticeValue(int x, int y, unsigned int seed)
+	{
+		unsigned int h = (unsigned int)x * 374761393u + (unsigned int)y * 668265263u + seed * 2246822519u;
+		h = (h ^ (h >> 13)) * 1274126177u;
+		return ((h ^ (h >> 16)) & 0xFFFFFF) / 16777216.0f;
+	}
+
+
+	//Bilinear value noise with a lattice point every cell tiles
+	static float ValueNoise(int x, int y, int cell, unsigned int seed)
+	{
+		int cx = x / cell, cy = y / cell;
+		float fx = (float)(x % cell) / cell, fy = (float)(y % cell) / cell;
+		fx = fx * fx * (3.0f - 2.0f * fx);
+		fy = fy * fy * (3.0f - 2.0f * fy);
+
+		float top = LatticeValue(cx, cy, seed) + (LatticeValue(cx + 1, cy, seed) - LatticeValue(cx, cy, seed)) * fx;
+		float bottom = LatticeValue(cx, cy + 1, seed) + (LatticeValue(cx + 1, cy + 1, seed) - LatticeValue(cx, cy + 1, seed)) * fx;
+		return top + (bottom - top) * fy;
+	}
+
+
+	TestTilemap::TestTilemap()
+		: m_MapSize(4096), m_ChunkSize(64), m_TileSize(16.0f), m_Zoom(1.0f), m_Center(2048.0f), m_Pan(true), m_PanAngle(0.0f),
+		  m_EditsPerFrame(100), m_EditSeed(1), m_Camera(960.0f, 540.0f), m_FrameMs(0.0f), m_AverageFrameMs(0.0f), m_GenerateMs(0.0f),
+		  m_FullRebuildMs(0.0f)
+	{
+		//Terrain colors for the first half of the types, the rest are brighter decorations with a pattern
+		m_TileTextures = std::make_unique<TextureArray>(s_TileTextureSize, s_TileTextureSize, s_TileTypes);
+		std::vector<unsigned char> pixels(s_TileTextureSize * s_TileTextureSize * 4);
+		for (int layer = 0; layer < s_TileTypes; ++layer) {
+			unsigned char r = (unsigned char)(40 + (layer * 67) % 200);
+			unsigned char g = (unsigned char)(60 + (layer * 113) % 180);
+			unsigned char b = (unsigned char)(30 + (layer * 29) % 120);
+			bool decoration = layer >= s_TileTypes / 2;
+
+			for (int y = 0; y < s_TileTextureSize; ++y) {
+				for (int x = 0; x < s_TileTextureSize; ++x) {
+					//A darker border makes the tile grid visible when zoomed in
+					bool border = x == 0 || y == 0;
+					bool mark = decoration && std::abs(x - s_TileTextureSize / 2) + std::abs(y - s_TileTextureSize / 2) < s_TileTextureSize / 4;
+					float shade = border ? 0.7f : mark ? 1.4f : 1.0f - 0.1f * (((x / 4) ^ (y / 4)) & 1);
+					unsigned char* pixel = &pixels[(y * s_TileTextureSize + x) * 4];
+					pixel[0] = (unsigned char)std::min(r * shade, 255.0f);
+					pixel[1] = (unsigned char)std::min(g * shade, 255.0f);
+					pixel[2] = (unsigned char)std::min(b * shade, 255.0f);
+					pixel[3] = 255;
+				}
+			}
+			m_TileTextures->SetLayer(layer, pixels.data());
+		}
+		m_TileTextures->GenerateMipmaps();
+
+		GenerateMap();
+	}
+
+
+	TestTilemap::~TestTilemap()
+	{
+
+	}
+
+
+	void TestTilemap::GenerateMap()
+	{
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		m_Tilemap = std::make_unique<Tilemap>(m_MapSize, m_MapSize, m_ChunkSize);
+
+		//Two octaves of noise as height: low is water (empty), the rest terrain bands with a few decorations
+		std::vector<uint16_t> tiles((size_t)m_MapSize * m_MapSize);
+		{
+			Timer timer(measure);
+			for (int y = 0; y < m_MapSize; ++y) {
+				for (int x = 0; x < m_MapSize; ++x) {
+					float height = ValueNoise(x, y, 256, 1) * 0.7f + ValueNoise(x, y, 32, 2) * 0.3f;
+					uint16_t tile = 0;
+					if (height > 0.4f) {
+						int band = std::min((int)((height - 0.4f) / 0.6f * (s_TileTypes / 2)), s_TileTypes / 2 - 1);
+						bool decoration = LatticeValue(x, y, 3) < 0.03f;
+						tile = (uint16_t)(1 + band + (decoration ? s_TileTypes / 2 : 0));
+					}
+					tiles[(size_t)y * m_MapSize + x] = tile;
+				}
+			}
+		}
+		m_GenerateMs = ms;
+
+		{
+			Timer timer(measure);
+			m_Tilemap->SetTiles(tiles.data());
+			m_Tilemap->Update();
+		}
+		m_FullRebuildMs = ms;
+
+		m_Center = glm::min(m_Center, glm::vec2((float)m_MapSize));
+	}
+
+
+	void TestTilemap::UpdateCamera()
+	{
+		m_Camera.SetZoom(m_Zoom);
+		glm::vec2 halfView = glm::vec2(m_Camera.GetWidth(), m_Camera.GetHeight()) * 0.5f / m_Zoom;
+		m_Camera.SetPosition(glm::vec3(m_Center * m_TileSize - halfView, 0.0f));
+	}
+
+
+	void TestTilemap::OnUpdate(float deltaTime)
+	{
+		if (m_Pan) {
+			//Circles around the middle of the map, a quarter of the map wide
+			//Fixed step per frame like the other tests, the Application passes a delta time of 0
+			m_PanAngle += 0.002f;
+			m_Center = glm::vec2((float)m_MapSize * 0.5f) + glm::vec2(std::cos(m_PanAngle), std::sin(m_PanAngle)) * (m_MapSize * 0.25f);
+		}
+
+		//Random edits around the view, so the rebuilt chunks are the visible ones
+		glm::vec2 halfView = glm::vec2(m_Camera.GetWidth(), m_Camera.GetHeight()) * 0.5f / (m_Zoom * m_TileSize);
+		for (int i = 0; i < m_EditsPerFrame; ++i) {
+			m_EditSeed = m_EditSeed * 1664525u + 1013904223u;
+			float u = (m_EditSeed >> 8) / 16777216.0f;
+			m_EditSeed = m_EditSeed * 1664525u + 1013904223u;
+			float v = (m_EditSeed >> 8) / 16777216.0f;
+			int x = (int)(m_Center.x + (u * 2.0f - 1.0f) * halfView.x);
+			int y = (int)(m_Center.y + (v * 2.0f - 1.0f) * halfView.y);
+			m_Tilemap->SetTile(x, y, (uint16_t)(m_EditSeed % (s_TileTypes + 1)));
+		}
+	}
+
+
+	void TestTilemap::OnRender()
+	{
+		GLCall(glClearColor(0.1f, 0.2f, 0.45f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		UpdateCamera();
+
+		{
+			Timer timer([this](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+				m_FrameMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+			});
+			m_Tilemap->Update();
+			m_Tilemap->Draw(m_Camera, *m_TileTextures, m_TileSize);
+		}
+		m_AverageFrameMs += (m_FrameMs - m_AverageFrameMs) * 0.05f;
+	}
+
+
+	void TestTilemap::OnResize(int width, int height)
+	{
+		m_Camera.SetViewportSize((float)width, (float)height);
+	}
+
+
+	void TestTilemap::OnImGuiRender()
+	{
+		static const int s_MapSizes[] = { 256, 1024, 2048, 4096 };
+		static const int s_ChunkSizes[] = { 16, 32, 64, 128, 256 };
+
+		bool regenerate = false;
+		ImGui::Text("Map");
+		for (int size : s_MapSizes) {
+			ImGui::SameLine();
+			if (ImGui::RadioButton((std::to_string(size) + "##Map").c_str(), m_MapSize == size)) {
+				m_MapSize = size;
+				regenerate = true;
+			}
+		}
+		ImGui::Text("Chunk");
+		for (int size : s_ChunkSizes) {
+			ImGui::SameLine();
+			if (ImGui::RadioButton((std::to_string(size) + "##Chunk").c_str(), m_ChunkSize == size)) {
+				m_ChunkSize = size;
+				regenerate = true;
+			}
+		}
+		if (regenerate || ImGui::Button("Regenerate"))
+			GenerateMap();
+
+		ImGui::SliderFloat("Zoom", &m_Zoom, 1.0f / 64.0f, 4.0f, "%.4f", 3.0f);
+		ImGui::SliderFloat2("Center", &m_Center.x, 0.0f, (float)m_MapSize, "%.0f");
+		ImGui::Checkbox("Pan", &m_Pan);
+		ImGui::SliderInt("Edits per frame", &m_EditsPerFrame, 0, 10000);
+
+		ImGui::Text("%dx%d tiles, %d chunks of %dx%d", m_Tilemap->GetWidth(), m_Tilemap->GetHeight(), m_Tilemap->GetChunkCount(),
+			m_ChunkSize, m_ChunkSize);
+		ImGui::Text("Generated in %.1f ms, full upload %.2f ms", m_GenerateMs, m_FullRebuildMs);
+		ImGui::Text("Frame CPU: %.3f ms (average %.3f ms), %u visible chunks, 1 draw call", m_FrameMs, m_AverageFrameMs,
+			m_Tilemap->GetVisibleChunks());
+		ImGui::Text("Rebuild: %u chunks in %.3f ms", m_Tilemap->GetRebuiltChunks(), m_Tilemap->GetRebuildMs());
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+
+}
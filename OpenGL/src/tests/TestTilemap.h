@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Test.h"
+#include "Camera.h"
+#include "Tilemap.h"
+#include "TextureArray.h"
+
+#include <memory>
+
+
+namespace test {
+
+	//A generated tile world of up to 4096x4096 tiles drawn by Tilemap, with a panning camera and random tile edits
+	//every frame to show what drawing and incremental chunk rebuilds cost
+	class TestTilemap : public Test
+	{
+	public:
+		TestTilemap();
+		~TestTilemap();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return m_Pan || m_EditsPerFrame > 0; }
+		void OnResize(int width, int height) override;
+
+	private:
+		void GenerateMap();
+		void UpdateCamera();
+
+	private:
+		int m_MapSize;
+		int m_ChunkSize;
+		float m_TileSize;
+		float m_Zoom;
+		glm::vec2 m_Center;		//In tiles
+		bool m_Pan;
+		float m_PanAngle;
+		int m_EditsPerFrame;
+		unsigned int m_EditSeed;
+
+		OrthographicCamera m_Camera;
+		std::unique_ptr<TextureArray> m_TileTextures;
+		std::unique_ptr<Tilemap> m_Tilemap;
+
+		float m_FrameMs;
+		float m_AverageFrameMs;
+		float m_GenerateMs;
+		float m_FullRebuildMs;
+	};
+
+}
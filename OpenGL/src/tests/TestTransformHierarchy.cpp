@@ -0,0 +1,118 @@
+#include "TestTransformHierarchy.h"
+
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include <random>
+
+
+namespace test {
+
+	TestTransformHierarchy::TestTransformHierarchy()
+		: m_NodeCount(100000), m_MaxChildren(8), m_MovingPercent(5.0f), m_Iterations(20)
+	{
+
+	}
+
+
+	TestTransformHierarchy::~TestTransformHierarchy()
+	{
+
+	}
+
+
+	void TestTransformHierarchy::GenerateHierarchy(TransformHierarchy& hierarchy)
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+		std::uniform_int_distribution<int> children(1, m_MaxChildren);
+
+		hierarchy.Clear();
+		hierarchy.Reserve(m_NodeCount);
+		hierarchy.Add();
+
+		//Breadth first, every node gets 1 to m_MaxChildren children until the node count is reached
+		for (unsigned int parent = 0; (int)hierarchy.GetCount() < m_NodeCount; ++parent) {
+			for (int child = children(rng); child > 0 && (int)hierarchy.GetCount() < m_NodeCount; --child) {
+				glm::quat rotation = glm::angleAxis(angle(rng), glm::normalize(glm::vec3(offset(rng), offset(rng), offset(rng))));
+				hierarchy.Add(parent, glm::vec3(offset(rng), offset(rng), offset(rng)), rotation, glm::vec3(0.9f));
+			}
+		}
+	}
+
+
+	void TestTransformHierarchy::MoveNodes(TransformHierarchy& hierarchy, float percent)
+	{
+		std::mt19937 rng(7);
+		std::uniform_int_distribution<unsigned int> node(0, (unsigned int)hierarchy.GetCount() - 1);
+		std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+
+		size_t count = (size_t)(hierarchy.GetCount() * percent / 100.0f);
+		for (size_t i = 0; i < count; ++i)
+			hierarchy.SetPosition(node(rng), glm::vec3(offset(rng), offset(rng), offset(rng)));
+	}
+
+
+	void TestTransformHierarchy::RunBenchmark()
+	{
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		TransformHierarchy hierarchy;
+		GenerateHierarchy(hierarchy);
+		m_Results.clear();
+
+		//Timers only cover the updates, marking nodes dirty is part of the setup
+		auto run = [&](const char* name, float percent, bool simd) {
+			float total = 0.0f;
+			for (int i = 0; i < m_Iterations; ++i) {
+				MoveNodes(hierarchy, percent);
+				{
+					Timer timer(measure);
+					if (simd)
+						hierarchy.Update();
+					else
+						hierarchy.UpdateScalar();
+				}
+				total += ms;
+			}
+			m_Results.push_back({ name, total / m_Iterations });
+		};
+
+		run("All nodes (SSE)", 100.0f, true);
+		run("All nodes (scalar)", 100.0f, false);
+		run("Moving nodes (SSE)", m_MovingPercent, true);
+		run("Moving nodes (scalar)", m_MovingPercent, false);
+		run("Nothing moved", 0.0f, true);
+	}
+
+
+	void TestTransformHierarchy::OnImGuiRender()
+	{
+		ImGui::SliderInt("Nodes", &m_NodeCount, 1024, 1000000);
+		ImGui::SliderInt("Max Children", &m_MaxChildren, 1, 32);
+		ImGui::SliderFloat("Moving %", &m_MovingPercent, 0.1f, 100.0f);
+		ImGui::SliderInt("Iterations", &m_Iterations, 1, 100);
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Columns(2);
+		ImGui::Text("Update"); ImGui::NextColumn();
+		ImGui::Text("Time"); ImGui::NextColumn();
+
+		for (const Result& result : m_Results) {
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%.3f ms", result.Ms); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+#include "TransformHierarchy.h"
+
+#include <vector>
+
+
+namespace test {
+
+	//Benchmark for TransformHierarchy: full and partial (dirty subtree) updates, SSE batches vs plain glm
+	class TestTransformHierarchy : public Test
+	{
+	public:
+		TestTransformHierarchy();
+		~TestTransformHierarchy();
+
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+
+	private:
+		void GenerateHierarchy(TransformHierarchy& hierarchy);
+		void MoveNodes(TransformHierarchy& hierarchy, float percent);
+		void RunBenchmark();
+
+	private:
+		struct Result {
+			const char* Name;
+			float Ms;
+		};
+
+		int m_NodeCount;
+		int m_MaxChildren;
+		float m_MovingPercent;
+		int m_Iterations;
+
+		std::vector<Result> m_Results;
+	};
+
+}
@@ -0,0 +1,133 @@
+#include "TestVertexPacking.h"
+
+#include "Timer.h"
+#include "imgui/imgui.h"
+
+#include <random>
+
+
+namespace test {
+
+	//Typical lit + textured vertex, once with floats and once packed
+	struct FloatVertex {
+		glm::vec3 Position;
+		glm::vec3 Normal;
+		glm::vec2 TexCoord;
+	};
+
+	struct PackedVertex {
+		Half Position[4];
+		PackedNormal Normal;
+		unsigned short TexCoord[2];
+	};
+
+
+	TestVertexPacking::TestVertexPacking()
+		: m_VertexCount(1 << 20)
+	{
+
+	}
+
+
+	TestVertexPacking::~TestVertexPacking()
+	{
+
+	}
+
+
+	void TestVertexPacking::RunBenchmark()
+	{
+		std::mt19937 rng(1337);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		m_Positions.resize(m_VertexCount);
+		m_Normals.resize(m_VertexCount);
+		m_TexCoords.resize(m_VertexCount);
+
+		for (int i = 0; i < m_VertexCount; ++i) {
+			m_Positions[i] = { position(rng), position(rng), position(rng) };
+			m_Normals[i] = glm::normalize(glm::vec3(unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f, unit(rng) + 0.01f));
+			m_TexCoords[i] = { unit(rng), unit(rng) };
+		}
+
+		const size_t count = m_VertexCount;
+		std::vector<Half> halfs(count * 3);
+		std::vector<int16_t> snorms(count * 3);
+		std::vector<uint16_t> unorms(count * 2);
+		std::vector<PackedNormal> normals(count);
+
+		float ms = 0.0f;
+		auto measure = [&ms](std::chrono::time_point<std::chrono::steady_clock>& startTime, std::chrono::time_point<std::chrono::steady_clock>& endTime) {
+			ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		};
+
+		m_Results.clear();
+		const float* positions = &m_Positions[0].x;
+		const float* normalFloats = &m_Normals[0].x;
+		const float* texCoords = &m_TexCoords[0].x;
+
+		Result result;
+
+		result = { "Half (positions)", 0.0f, 0.0f, count * sizeof(glm::vec3) };
+		{ Timer timer(measure); PackHalfScalar(positions, halfs.data(), count * 3); }
+		result.ScalarMs = ms;
+		{ Timer timer(measure); PackHalf(positions, halfs.data(), count * 3); }
+		result.SimdMs = ms;
+		m_Results.push_back(result);
+
+		result = { "SNorm16 (normals)", 0.0f, 0.0f, count * sizeof(glm::vec3) };
+		{ Timer timer(measure); PackSNorm16Scalar(normalFloats, snorms.data(), count * 3); }
+		result.ScalarMs = ms;
+		{ Timer timer(measure); PackSNorm16(normalFloats, snorms.data(), count * 3); }
+		result.SimdMs = ms;
+		m_Results.push_back(result);
+
+		result = { "UNorm16 (tex coords)", 0.0f, 0.0f, count * sizeof(glm::vec2) };
+		{ Timer timer(measure); PackUNorm16Scalar(texCoords, unorms.data(), count * 2); }
+		result.ScalarMs = ms;
+		{ Timer timer(measure); PackUNorm16(texCoords, unorms.data(), count * 2); }
+		result.SimdMs = ms;
+		m_Results.push_back(result);
+
+		result = { "2_10_10_10 (normals)", 0.0f, 0.0f, count * sizeof(glm::vec3) };
+		{ Timer timer(measure); PackNormalsScalar(m_Normals.data(), normals.data(), count); }
+		result.ScalarMs = ms;
+		{ Timer timer(measure); PackNormals(m_Normals.data(), normals.data(), count); }
+		result.SimdMs = ms;
+		m_Results.push_back(result);
+	}
+
+
+	void TestVertexPacking::OnImGuiRender()
+	{
+		ImGui::SliderInt("Vertices", &m_VertexCount, 1024, 1 << 24);
+
+		if (ImGui::Button("Run"))
+			RunBenchmark();
+
+		ImGui::Separator();
+		ImGui::Text("Float vertex:  %d bytes (vec3 position, vec3 normal, vec2 uv)", (int)sizeof(FloatVertex));
+		ImGui::Text("Packed vertex: %d bytes (half4 position, 2_10_10_10 normal, unorm16 uv)", (int)sizeof(PackedVertex));
+		ImGui::Text("%d vertices: %.1f MB -> %.1f MB", m_VertexCount,
+			m_VertexCount * sizeof(FloatVertex) / (1024.0f * 1024.0f), m_VertexCount * sizeof(PackedVertex) / (1024.0f * 1024.0f));
+
+		if (m_Results.empty())
+			return;
+
+		ImGui::Separator();
+		ImGui::Columns(3);
+		ImGui::Text("Format"); ImGui::NextColumn();
+		ImGui::Text("Scalar"); ImGui::NextColumn();
+		ImGui::Text("SIMD"); ImGui::NextColumn();
+
+		for (const Result& result : m_Results) {
+			float mb = result.InputBytes / (1024.0f * 1024.0f);
+			ImGui::Text("%s", result.Name); ImGui::NextColumn();
+			ImGui::Text("%.2f ms (%.0f MB/s)", result.ScalarMs, mb / (result.ScalarMs / 1000.0f)); ImGui::NextColumn();
+			ImGui::Text("%.2f ms (%.0f MB/s)", result.SimdMs, mb / (result.SimdMs / 1000.0f)); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+#include "VertexPacking.h"
+
+#include <vector>
+
+
+namespace test {
+
+	//Benchmark for the packed vertex formats: memory footprint and packing throughput, scalar vs SIMD
+	class TestVertexPacking : public Test
+	{
+	public:
+		TestVertexPacking();
+		~TestVertexPacking();
+
+		void OnImGuiRender() override;
+		bool IsAnimating() const override { return false; }
+
+	private:
+		void RunBenchmark();
+
+	private:
+		struct Result {
+			const char* Name;
+			float ScalarMs;
+			float SimdMs;
+			size_t InputBytes;
+		};
+
+		int m_VertexCount;
+		std::vector<glm::vec3> m_Positions;
+		std::vector<glm::vec3> m_Normals;
+		std::vector<glm::vec2> m_TexCoords;
+
+		std::vector<Result> m_Results;
+	};
+
+}